@@ -25,91 +25,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <cassert>
-#include <iostream>
-
+// The model functions are defined constexpr in pat.hpp so that callers
+// can inline and constant-fold them; this translation unit remains only
+// to keep the build target stable.
 #include "pat.hpp"
-
-namespace pat
-{
-
-double SRAMArea(std::uint64_t height, std::uint64_t width, std::uint64_t num_banks, std::uint64_t num_ports)
-{
-  (void) height;
-  (void) width;
-  (void) num_banks;
-  (void) num_ports;
-  return 0;
-}
-
-double SRAMEnergy(std::uint64_t height, std::uint64_t width, std::uint64_t num_banks, std::uint64_t num_ports)
-{
-  (void) num_banks;
-  (void) num_ports;
-  
-  // Eyeriss data points:
-
-  // 0.5 KB (x0) = 1.0 units (y0)
-  const double x0 = 0.5;
-  const double y0 = 1.0;
-  
-  // 100 KB (x1) = 6.0 units (y1)
-  const double x1 = 100.0;
-  const double y1 = 6.0;
-
-  // slope m = (y1-y0)/(x1-x0)
-  const double m = (y1 - y0) / (x1 - x0);
-
-  // y = m(x-x0)+y0    
-  double x = double(width * height) / (8 * 1024);
-  double y = m * (x - x0) + y0;
-
-  // The baseline data was for a 16b access.
-  // Scale this based on the width of the access.
-  // This will make the model insensitive to block
-  // size.
-  double energy = (y * width) / 16;
-  return energy;
-}
-
-double DRAMEnergy(std::uint64_t width)
-{
-  double energy = (200.0 * width) / 16;
-  return energy;
-}
-
-double WireEnergy(std::uint64_t bits, double length_mm)
-{
-  (void) bits;
-  (void) length_mm;
-  return 0;
-}
-
-double MultiplierEnergy(std::uint64_t bits_A, std::uint64_t bits_B)
-{
-  double energy = 1.0 * (double(bits_A) / 16.0) * (double(bits_B) / 16.0);
-  return energy;
-}
-
-double MultiplierArea(std::uint64_t bits_A, std::uint64_t bits_B)
-{
-  (void) bits_A;
-  (void) bits_B;
-  return 0;
-}
-
-double AdderEnergy(std::uint64_t bits_A, std::uint64_t bits_B)
-{
-  (void) bits_A;
-  (void) bits_B;
-  return 0;
-}
-
-double AdderArea(std::uint64_t bits_A, std::uint64_t bits_B)
-{
-  (void) bits_A;
-  (void) bits_B;
-  return 0;
-}
-
-} // namespace pat
@@ -29,20 +29,94 @@
 
 #include <cstdint>
 
+//
+// The public power-area-timing model is a set of closed-form curves fit
+// to published data points. The functions are defined constexpr in this
+// header so model spec'ing pays no call or parsing cost at startup:
+// lookups inline into the callers and fold to constants whenever the
+// arguments are compile-time known.
+//
+
 namespace pat
 {
 
-double SRAMEnergy(std::uint64_t height, std::uint64_t width, std::uint64_t num_banks, std::uint64_t num_ports);
-double SRAMArea(std::uint64_t height, std::uint64_t width, std::uint64_t num_banks, std::uint64_t num_ports);
+constexpr double SRAMArea(std::uint64_t height, std::uint64_t width, std::uint64_t num_banks, std::uint64_t num_ports)
+{
+  (void) height;
+  (void) width;
+  (void) num_banks;
+  (void) num_ports;
+  return 0;
+}
+
+constexpr double SRAMEnergy(std::uint64_t height, std::uint64_t width, std::uint64_t num_banks, std::uint64_t num_ports)
+{
+  (void) num_banks;
+  (void) num_ports;
+
+  // Eyeriss data points:
+
+  // 0.5 KB (x0) = 1.0 units (y0)
+  const double x0 = 0.5;
+  const double y0 = 1.0;
+
+  // 100 KB (x1) = 6.0 units (y1)
+  const double x1 = 100.0;
+  const double y1 = 6.0;
+
+  // slope m = (y1-y0)/(x1-x0)
+  const double m = (y1 - y0) / (x1 - x0);
+
+  // y = m(x-x0)+y0
+  double x = double(width * height) / (8 * 1024);
+  double y = m * (x - x0) + y0;
+
+  // The baseline data was for a 16b access.
+  // Scale this based on the width of the access.
+  // This will make the model insensitive to block
+  // size.
+  double energy = (y * width) / 16;
+  return energy;
+}
+
+constexpr double DRAMEnergy(std::uint64_t width)
+{
+  double energy = (200.0 * width) / 16;
+  return energy;
+}
+
+constexpr double WireEnergy(std::uint64_t bits, double length_mm)
+{
+  (void) bits;
+  (void) length_mm;
+  return 0;
+}
 
-double DRAMEnergy(std::uint64_t width);
+constexpr double MultiplierEnergy(std::uint64_t bits_A, std::uint64_t bits_B)
+{
+  double energy = 1.0 * (double(bits_A) / 16.0) * (double(bits_B) / 16.0);
+  return energy;
+}
 
-double MultiplierEnergy(std::uint64_t bits_A, std::uint64_t bits_B);
-double MultiplierArea(std::uint64_t bits_A, std::uint64_t bits_B);
+constexpr double MultiplierArea(std::uint64_t bits_A, std::uint64_t bits_B)
+{
+  (void) bits_A;
+  (void) bits_B;
+  return 0;
+}
 
-double AdderEnergy(std::uint64_t bits_A, std::uint64_t bits_B);
-double AdderArea(std::uint64_t bits_A, std::uint64_t bits_B);
+constexpr double AdderEnergy(std::uint64_t bits_A, std::uint64_t bits_B)
+{
+  (void) bits_A;
+  (void) bits_B;
+  return 0;
+}
 
-double WireEnergy(std::uint64_t bits, double length_mm);
+constexpr double AdderArea(std::uint64_t bits_A, std::uint64_t bits_B)
+{
+  (void) bits_A;
+  (void) bits_B;
+  return 0;
+}
 
 } // namespace pat
@@ -0,0 +1,335 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+
+#include "compound-config/compound-config.hpp"
+#include "loop-analysis/nest-analysis.hpp"
+#include "loop-analysis/point-set.hpp"
+#include "mapspaces/mapspace-factory.hpp"
+#include "model/engine.hpp"
+#include "util/numeric.hpp"
+
+extern bool gEnableNestMemo;
+
+//--------------------------------------------//
+//                Application                 //
+//--------------------------------------------//
+
+// Microbenchmarks for the evaluation hot kernels, driven by the same
+// config files the mapper consumes (configs/mapper/*) so the fixtures
+// track the real workloads. Build and run with:
+//
+//   scons bench
+//   ./build/timeloop-bench configs/mapper/sample.cfg
+//
+// Each benchmark prints nanoseconds per operation; the harness runs each
+// kernel until it has accumulated enough wall time for a stable average.
+// These are before/after numbers for performance work, not a regression
+// gate -- absolute values vary across machines.
+class Application
+{
+ protected:
+
+  problem::Workload workload_;
+  model::Engine::Specs arch_specs_;
+  mapspace::MapSpace* mapspace_ = nullptr;
+
+  // Accumulated results sink: keeps the measured kernels observable so
+  // the compiler cannot elide them. Printed at the end of the run.
+  std::uint64_t checksum_ = 0;
+
+ public:
+
+  Application(config::CompoundConfig* config)
+  {
+    auto rootNode = config->getRoot();
+
+    // Problem configuration.
+    auto problem = rootNode.lookup("problem");
+    problem::ParseWorkload(problem, workload_);
+
+    // Architecture configuration.
+    config::CompoundConfigNode arch;
+    arch = rootNode.lookup("architecture");
+    arch_specs_ = model::Engine::ParseSpecs(arch);
+
+    // MapSpace configuration (same directive spellings as the mappers).
+    config::CompoundConfigNode arch_constraints;
+    config::CompoundConfigNode mapspace;
+
+    if (arch.exists("constraints"))
+      arch_constraints = arch.lookup("constraints");
+    else if (rootNode.exists("arch_constraints"))
+      arch_constraints = rootNode.lookup("arch_constraints");
+    else if (rootNode.exists("architecture_constraints"))
+      arch_constraints = rootNode.lookup("architecture_constraints");
+
+    if (rootNode.exists("mapspace"))
+      mapspace = rootNode.lookup("mapspace");
+    else if (rootNode.exists("mapspace_constraints"))
+      mapspace = rootNode.lookup("mapspace_constraints");
+
+    mapspace_ = mapspace::ParseAndConstruct(mapspace, arch_constraints, arch_specs_, workload_);
+  }
+
+  ~Application()
+  {
+    if (mapspace_)
+    {
+      delete mapspace_;
+    }
+  }
+
+  void Run()
+  {
+    std::cout << std::setw(44) << std::left << "benchmark" << std::right
+              << std::setw(14) << "ns/op" << std::endl;
+
+    BenchmarkAAHR();
+    BenchmarkCartesianCounter();
+    BenchmarkNestAnalysis();
+    BenchmarkConstructMapping();
+
+    std::cout << "(checksum " << checksum_ << ")" << std::endl;
+  }
+
+ protected:
+
+  // Run f() repeatedly, doubling the batch until at least min_time has
+  // elapsed, and report the per-call average.
+  template <typename F>
+  void Measure_(const std::string& name, F f,
+                double min_time_sec = 0.2)
+  {
+    std::uint64_t iterations = 1;
+    double elapsed = 0;
+    while (true)
+    {
+      auto start = std::chrono::steady_clock::now();
+      for (std::uint64_t i = 0; i < iterations; i++)
+      {
+        f();
+      }
+      elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+      if (elapsed >= min_time_sec)
+        break;
+      iterations *= 2;
+    }
+
+    std::cout << std::setw(44) << std::left << name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(1)
+              << (elapsed * 1e9 / iterations) << std::endl;
+  }
+
+  //
+  // AAHR set algebra (point-set-aahr.hpp): the delta computation at the
+  // heart of every temporal iteration of the nest analysis.
+  //
+  void BenchmarkAAHR()
+  {
+    const std::uint32_t order = 4;
+    Point low(order), high(order), shifted_low(order), shifted_high(order);
+    for (unsigned dim = 0; dim < order; dim++)
+    {
+      low[dim] = 0;
+      high[dim] = 8;
+      // Slide along dimension 0, the common working-set movement pattern.
+      shifted_low[dim] = (dim == 0) ? 2 : 0;
+      shifted_high[dim] = (dim == 0) ? 10 : 8;
+    }
+
+    Measure_("aahr/subtract (sliding window)", [&]()
+    {
+      AxisAlignedHyperRectangle a(order, low, high);
+      AxisAlignedHyperRectangle b(order, shifted_low, shifted_high);
+      auto delta = b - a;
+      checksum_ += delta.size();
+    });
+
+    Measure_("aahr/delta-size (closed form)", [&]()
+    {
+      AxisAlignedHyperRectangle a(order, low, high);
+      AxisAlignedHyperRectangle b(order, shifted_low, shifted_high);
+      checksum_ += b.DeltaSize(a);
+    });
+
+    Measure_("aahr/bounds-only-delta-size", [&]()
+    {
+      AxisAlignedHyperRectangle a(order, low, high);
+      AxisAlignedHyperRectangle b(order, shifted_low, shifted_high);
+      checksum_ += b.BoundsOnlyDeltaSize(a);
+    });
+
+    Measure_("aahr/union (+=)", [&]()
+    {
+      AxisAlignedHyperRectangle a(order, low, high);
+      AxisAlignedHyperRectangle b(order, shifted_low, shifted_high);
+      a += b;
+      checksum_ += a.size();
+    });
+  }
+
+  //
+  // CartesianCounterDynamic (util/numeric.hpp): mapping-ID decode
+  // arithmetic, exercised on every mapping the search algorithms visit.
+  //
+  void BenchmarkCartesianCounter()
+  {
+    std::vector<uint128_t> base = { 7, 16, 3, 5, 32, 2 };
+    CartesianCounterDynamic counter(base);
+    uint128_t end = counter.EndInteger();
+
+    uint128_t next = 0;
+    Measure_("counter/set-read round trip", [&]()
+    {
+      counter.Set(next);
+      next = next + 123;
+      if (next >= end)
+        next = next - end;
+      checksum_ += static_cast<std::uint64_t>(counter[0]);
+    });
+
+    Measure_("counter/increment", [&]()
+    {
+      if (!counter.Increment())
+        counter.Set(0);
+      checksum_ += static_cast<std::uint64_t>(counter[0]);
+    });
+
+    Measure_("counter/read-batch (x64)", [&]()
+    {
+      auto digits = counter.ReadBatch(0, 64, 3);
+      checksum_ += static_cast<std::uint64_t>(digits.at(0).at(63));
+    });
+  }
+
+  //
+  // NestAnalysis::ComputeWorkingSets on canned two-level nests built from
+  // the configured workload's bounds. The two nests differ in how the
+  // first non-trivial dimension is split across levels, so alternating
+  // them exercises the incremental re-initialization path the mapper
+  // sees; memoization is disabled so every call runs the real analysis.
+  //
+  void BenchmarkNestAnalysis()
+  {
+    unsigned num_dims = problem::GetShape()->NumDimensions;
+
+    // Split each bound b into (inner, outer) = (1, b); the alternate nest
+    // flips the split of the first dimension with a bound > 1.
+    int flip_dim = -1;
+    for (unsigned dim = 0; dim < num_dims; dim++)
+    {
+      if (workload_.GetBound(dim) > 1)
+      {
+        flip_dim = int(dim);
+        break;
+      }
+    }
+
+    auto build_nest = [&](bool flipped)
+    {
+      loop::Nest nest;
+      for (unsigned dim = 0; dim < num_dims; dim++)
+      {
+        bool flip = (int(dim) == flip_dim) && flipped;
+        nest.AddLoop(dim, 0, flip ? workload_.GetBound(dim) : 1, 1,
+                     spacetime::Dimension::Time);
+      }
+      nest.AddStorageTilingBoundary();
+      for (unsigned dim = 0; dim < num_dims; dim++)
+      {
+        bool flip = (int(dim) == flip_dim) && flipped;
+        nest.AddLoop(dim, 0, flip ? 1 : workload_.GetBound(dim), 1,
+                     spacetime::Dimension::Time);
+      }
+      nest.AddStorageTilingBoundary();
+      return nest;
+    };
+
+    loop::Nest nest_a = build_nest(false);
+    loop::Nest nest_b = build_nest(true);
+
+    bool saved_memo = gEnableNestMemo;
+    gEnableNestMemo = false;
+
+    analysis::NestAnalysis nest_analysis;
+    bool use_b = false;
+    Measure_("nest-analysis/compute-working-sets", [&]()
+    {
+      nest_analysis.Init(&workload_, use_b ? &nest_b : &nest_a);
+      use_b = !use_b;
+      auto& working_sets = nest_analysis.GetWorkingSets();
+      checksum_ += working_sets.at(0).at(0).size;
+    }, 1.0);
+
+    gEnableNestMemo = saved_memo;
+  }
+
+  //
+  // Uber::ConstructMapping decode throughput: walk the index-factorization
+  // and permutation subspaces the way an exhaustive search does. Failed
+  // constructions (infeasible fanouts) are counted too -- rejecting them
+  // quickly is part of what we measure.
+  //
+  void BenchmarkConstructMapping()
+  {
+    auto num_factorizations = mapspace_->Size(mapspace::Dimension::IndexFactorization);
+    auto num_permutations = mapspace_->Size(mapspace::Dimension::LoopPermutation);
+
+    uint128_t if_id = 0;
+    uint128_t perm_id = 0;
+    Mapping mapping;
+
+    Measure_("mapspace/construct-mapping decode", [&]()
+    {
+      mapspace::ID mapping_id = mapspace::ID(mapspace_->AllSizes());
+      mapping_id.Set(int(mapspace::Dimension::IndexFactorization), if_id);
+      mapping_id.Set(int(mapspace::Dimension::LoopPermutation), perm_id);
+      mapping_id.Set(int(mapspace::Dimension::Spatial), 0);
+      mapping_id.Set(int(mapspace::Dimension::DatatypeBypass), 0);
+
+      auto status = mapspace_->ConstructMapping(mapping_id, &mapping);
+      checksum_ += status.size() + mapping.loop_nest.loops.size();
+
+      // Advance permutation fastest, like the exhaustive search order.
+      perm_id = perm_id + 1;
+      if (perm_id >= num_permutations)
+      {
+        perm_id = 0;
+        if_id = if_id + 1;
+        if (if_id >= num_factorizations)
+          if_id = 0;
+      }
+    });
+  }
+};
@@ -31,6 +31,11 @@
 #include <iomanip>
 #include <algorithm>
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/map.hpp>
@@ -53,10 +58,10 @@ struct PointResult
   EvaluationResult result_;
   
   PointResult(std::string name, EvaluationResult result) : config_name_(name), result_(result) {}
-  
-  void PrintEvaluationResultsHeader(std::ostream& out)
+
+  static void PrintEvaluationResultsHeader(std::ostream& out)
   {
-      out << "Summary stats for best mapping found by mapper:" << std::endl; 
+      out << "Summary stats for best mapping found by mapper:" << std::endl;
       out << "config_name, MACCs, utilization, pj/MACC" << std::endl;
   }
 
@@ -82,15 +87,77 @@ class DesignSpaceExplorer
   std::string problemspec_filename_;
   std::string archspec_filename_;
 
-  std::vector<PointResult> designs_;
-  std::vector<Application*> mappers_;
+  // Number of design points evaluated concurrently. Each point runs a
+  // full mapper in a forked child process: the mapper (and the workload
+  // machinery under it) keeps process-global state -- the problem shape,
+  // termination flags, ncurses -- so in-process concurrent mappers would
+  // race; separate processes sidestep all of that. Cores are partitioned
+  // by running N points at once, so configure each point's
+  // mapper.num-threads to (cores / N) for a fully loaded machine.
+  int max_concurrent_points_;
+
+  // Evaluate one (arch, problem) point: write the combined spec next to
+  // the point's outputs, run a full mapper on it, and leave a one-line
+  // summary in <file_name>.summary for the aggregation pass (which may
+  // run in a different process than this evaluation).
+  //
+  // If seed_file names a neighboring point's emitted .map.yaml and that
+  // file exists by the time we launch, splice it into the combined spec
+  // and set mapper.warm-start so this point's search starts from the
+  // neighbor's best mapping instead of cold.
+  void EvaluatePoint_(const ArchSpaceNode& curr_arch,
+                      const ProblemSpaceNode& curr_problem,
+                      const std::string& file_name,
+                      const std::string& seed_file = "")
+  {
+    // The mapper prefixes its artifacts with <output_dir>/<app-name>, so
+    // give each point its own directory to drop them in.
+    mkdir(file_name.c_str(), 0755);
+
+    std::ifstream seed_stream;
+    if (!seed_file.empty())
+    {
+      seed_stream.open(seed_file);
+    }
+
+    std::ofstream combined_yaml_file(file_name + ".input.yaml");
+    if (seed_stream)
+    {
+      // Patch warm-start into the arch spec's mapper node (appending a
+      // second top-level "mapper:" key would be shadowed by the first).
+      YAML::Node arch_yaml = YAML::Clone(curr_arch.yaml_);
+      arch_yaml["mapper"]["warm-start"] = true;
+      combined_yaml_file << arch_yaml << std::endl;
+      combined_yaml_file << seed_stream.rdbuf();
+    }
+    else
+    {
+      combined_yaml_file << curr_arch.yaml_ << std::endl;
+    }
+    combined_yaml_file << curr_problem.yaml_ << std::endl;
+    combined_yaml_file.close();
+    //pull the combined file into a compound config
+    config::CompoundConfig config((file_name + ".input.yaml").c_str());
+
+    Application* mapper = new Application(&config, file_name);
+    mapper->Run();
+    PointResult result(mapper->name_, mapper->GetGlobalBest());
+
+    std::ofstream summary_file(file_name + ".summary");
+    result.PrintEvaluationResult(summary_file);
+    summary_file.close();
+
+    delete mapper;
+  }
 
  public:
 
-  DesignSpaceExplorer(std::string problemfile, std::string archfile)
+  DesignSpaceExplorer(std::string problemfile, std::string archfile,
+                      int max_concurrent_points = 1)
   {
     problemspec_filename_ = problemfile;
     archspec_filename_ = archfile;
+    max_concurrent_points_ = std::max(1, max_concurrent_points);
   }
 
 
@@ -141,59 +208,106 @@ class DesignSpaceExplorer
     
     std::cout << "*** total arch: " << aspec_space.GetSize() << "   total prob: " << pspec_space.GetSize() << std::endl;        
 
-    std::cout << "****** SOLVING ******" << std::endl;        
-    //main loop, do the full product of problems x arches
+    std::cout << "****** SOLVING ******" << std::endl;
+    //main loop, do the full product of problems x arches, dispatching up
+    //to max_concurrent_points_ points to concurrent child processes.
+    std::vector<std::string> point_files;
+    int active_children = 0;
+
+    // Adjacent points in a sweep usually differ in a single swept
+    // parameter, so a neighbor's best mapping is a strong warm-start
+    // incumbent for the branch-and-bound search. Remember each problem's
+    // most recently dispatched point so the next arch point can seed from
+    // its emitted mapping. With concurrent points the neighbor may not
+    // have finished yet; EvaluatePoint_ checks for its .map.yaml at
+    // launch and starts cold if it is missing.
+    std::map<int, std::string> prev_point_files;
+
     for (int arch_id = 0; arch_id < aspec_space.GetSize(); arch_id ++)
     {
       //retrieved via reference
       ArchSpaceNode curr_arch = aspec_space.GetNode(arch_id);
 
-      std::cout << "*** working on arch : " << curr_arch.name_ << "  " << arch_id << std::endl;        
+      std::cout << "*** working on arch : " << curr_arch.name_ << "  " << arch_id << std::endl;
 
       for (int problem_id = 0; problem_id < pspec_space.GetSize(); problem_id ++)
       {
         //retrieved via reference
         ProblemSpaceNode curr_problem = pspec_space.GetNode(problem_id);
-        
+
         // use problem and arch to run a mapper
         std::string config_name = curr_arch.name_ + "--" + curr_problem.name_;
-        std::cout << "*** working on config : " << config_name << std::endl;        
-        replace(config_name.begin(),config_name.end(),'/', '.'); 
+        std::cout << "*** working on config : " << config_name << std::endl;
+        replace(config_name.begin(),config_name.end(),'/', '.');
 
         std::string file_name = "results/" + config_name;
-
-        //output the two yaml to a single file
-        //CompoundConfigNode arch = CompoundConfigNode(nullptr, YAML::Clone(curr_arch.yaml_));
-        //CompoundConfigNode problem = CompoundConfigNode(nullptr, YAML::Clone(curr_problem.yaml_));
-        std::ofstream combined_yaml_file("temp_dse.yaml");
-        combined_yaml_file << curr_arch.yaml_ << std::endl; // <------------ HERE.
-        combined_yaml_file << curr_problem.yaml_ << std::endl; // <------------ HERE.
-        combined_yaml_file.close();
-        //pull tempfile into a compound config
-        config::CompoundConfig config("temp_dse.yaml");
-
-        //std::cout << "arch yaml: \n" << curr_arch.yaml_ << std::endl;
-        Application* mapper = new Application(&config, file_name);
-        //SimpleMapper mapper = SimpleMapper(config_name, arch, problem);
-        mapper->Run();
-        PointResult result(mapper->name_, mapper->GetGlobalBest());
-        mappers_.push_back(mapper);
-        designs_.push_back(result);
-    std::cout << "*** total arch: " << aspec_space.GetSize() << "   total prob: " << pspec_space.GetSize() << std::endl;        
-        
+        point_files.push_back(file_name);
+
+        std::string seed_file = "";
+        auto prev = prev_point_files.find(problem_id);
+        if (prev != prev_point_files.end())
+        {
+          seed_file = prev->second + "/timeloop-mapper.map.yaml";
+        }
+        prev_point_files[problem_id] = file_name;
+
+        if (max_concurrent_points_ <= 1)
+        {
+          EvaluatePoint_(curr_arch, curr_problem, file_name, seed_file);
+          continue;
+        }
+
+        // Throttle: reap a finished child before launching the next point.
+        while (active_children >= max_concurrent_points_)
+        {
+          if (waitpid(-1, nullptr, 0) > 0)
+            active_children--;
+        }
+
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+          EvaluatePoint_(curr_arch, curr_problem, file_name, seed_file);
+          _exit(0);
+        }
+        else if (pid > 0)
+        {
+          active_children++;
+        }
+        else
+        {
+          // fork failed (e.g., out of memory); fall back to evaluating
+          // this point in-process.
+          perror("fork");
+          EvaluatePoint_(curr_arch, curr_problem, file_name, seed_file);
+        }
       }
     }
 
-    
+    // Drain the remaining children.
+    while (active_children > 0)
+    {
+      if (waitpid(-1, nullptr, 0) > 0)
+        active_children--;
+    }
 
     std::string result_filename =  "overview_" + archspec_filename_ + problemspec_filename_ + ".txt";
-    replace(result_filename.begin(),result_filename.end(),'/', '.'); 
+    replace(result_filename.begin(),result_filename.end(),'/', '.');
     std::ofstream result_txt_file("results/" + result_filename);
-    //print final results
-    designs_[0].PrintEvaluationResultsHeader(result_txt_file);
-    for (size_t i = 0; i < designs_.size(); i++)
+    //print final results by aggregating the per-point summary files (the
+    //points may have been evaluated in child processes).
+    PointResult::PrintEvaluationResultsHeader(result_txt_file);
+    for (auto& file_name: point_files)
     {
-      designs_[i].PrintEvaluationResult(result_txt_file);
+      std::ifstream summary_file(file_name + ".summary");
+      if (summary_file)
+      {
+        result_txt_file << summary_file.rdbuf();
+      }
+      else
+      {
+        result_txt_file << file_name << ", <no summary -- point failed?>" << std::endl;
+      }
     }
     result_txt_file.close();
 
@@ -46,7 +46,18 @@ int main(int argc, char* argv[])
   archspec_filename = std::string(argv[1]);
   problemspec_filename = std::string(argv[2]);
 
-  DesignSpaceExplorer application(problemspec_filename, archspec_filename);  
+  // Optional third argument: number of design points to evaluate
+  // concurrently (each in its own child process), default 1 (serial).
+  // Set each point's mapper.num-threads to (cores / concurrency) to
+  // partition the machine.
+  int max_concurrent_points = 1;
+  if (argc >= 4)
+  {
+    max_concurrent_points = std::atoi(argv[3]);
+  }
+
+  DesignSpaceExplorer application(problemspec_filename, archspec_filename,
+                                  max_concurrent_points);
   application.Run();
 
   return 0;
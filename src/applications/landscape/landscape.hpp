@@ -0,0 +1,315 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "compound-config/compound-config.hpp"
+#include "mapspaces/mapspace-factory.hpp"
+#include "model/engine.hpp"
+
+//--------------------------------------------//
+//            Landscape file format           //
+//--------------------------------------------//
+
+// Compact binary dataset of uniformly sampled mapspace points, for
+// offline cost-landscape visualization and search-algorithm tuning.
+// Fixed header followed by fixed-size records in native byte order,
+// like util/results-log.hpp -- but keyed by the *per-dimension* ID
+// coordinates rather than the flat ID, since landscape plots slice
+// along mapspace dimensions.
+
+namespace landscape
+{
+
+const std::uint32_t kMagic = 0x534c4c54u;  // "TLLS"
+const std::uint32_t kVersion = 1;
+const unsigned kNumDimensions = 4;
+
+struct FileHeader
+{
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t record_size;
+  std::uint32_t num_dimensions;
+};
+
+// One sampled mapping. Coordinates are stored as (lo, hi) 64-bit halves
+// per mapspace dimension, in mapspace::Dimension order. Cost metrics are
+// meaningful only if valid is set; construct_success distinguishes
+// decode failures from evaluation failures among the invalid points.
+struct Record
+{
+  std::uint64_t coord_lo[kNumDimensions];
+  std::uint64_t coord_hi[kNumDimensions];
+  std::uint64_t cycles;
+  std::uint64_t maccs;
+  std::uint64_t last_level_accesses;
+  double energy;
+  double utilization;
+  double area;
+  std::uint8_t valid;
+  std::uint8_t construct_success;
+  std::uint8_t pad[6];
+};
+
+static_assert(sizeof(FileHeader) == 16, "landscape file header layout changed");
+static_assert(sizeof(Record) == 120, "landscape record layout changed");
+
+} // namespace landscape
+
+//--------------------------------------------//
+//                Application                 //
+//--------------------------------------------//
+
+// Uniformly sample the mapspace and export the cost landscape:
+//
+//   ./build/timeloop-landscape <configfile> [<output-file>]
+//
+// Sampling is controlled by an optional top-level "landscape" config node
+// (num-samples, num-threads, seed); the problem/architecture/mapspace
+// sections are the same as the mapper's. Samples are drawn uniformly and
+// independently per mapspace dimension and evaluated in parallel, each
+// worker with its own engine and mapspace instance (ConstructMapping
+// keeps a decode cache, so mapspaces must not be shared across threads).
+class Application
+{
+ protected:
+
+  problem::Workload workload_;
+  model::Engine::Specs arch_specs_;
+
+  // One mapspace instance per worker thread (see class comment).
+  std::vector<mapspace::MapSpace*> mapspaces_;
+
+  std::uint64_t num_samples_ = 10000;
+  std::uint32_t num_threads_ = 0;
+  std::uint64_t seed_ = 0;
+  std::string out_file_;
+
+ public:
+
+  Application(config::CompoundConfig* config, std::string out_file) :
+      out_file_(out_file)
+  {
+    auto rootNode = config->getRoot();
+
+    // Problem configuration.
+    auto problem = rootNode.lookup("problem");
+    problem::ParseWorkload(problem, workload_);
+
+    // Architecture configuration.
+    config::CompoundConfigNode arch;
+    arch = rootNode.lookup("architecture");
+    arch_specs_ = model::Engine::ParseSpecs(arch);
+
+    // Sampling knobs.
+    num_threads_ = std::thread::hardware_concurrency();
+    if (rootNode.exists("landscape"))
+    {
+      auto landscape = rootNode.lookup("landscape");
+      int num_samples = 0;
+      if (landscape.lookupValue("num-samples", num_samples))
+        num_samples_ = std::uint64_t(num_samples);
+      landscape.lookupValue("num-threads", num_threads_);
+      int seed = 0;
+      if (landscape.lookupValue("seed", seed))
+        seed_ = std::uint64_t(seed);
+    }
+    if (num_threads_ == 0)
+    {
+      num_threads_ = 1;
+    }
+
+    // MapSpace configuration (same directive spellings as the mappers).
+    config::CompoundConfigNode arch_constraints;
+    config::CompoundConfigNode mapspace;
+
+    if (arch.exists("constraints"))
+      arch_constraints = arch.lookup("constraints");
+    else if (rootNode.exists("arch_constraints"))
+      arch_constraints = rootNode.lookup("arch_constraints");
+    else if (rootNode.exists("architecture_constraints"))
+      arch_constraints = rootNode.lookup("architecture_constraints");
+
+    if (rootNode.exists("mapspace"))
+      mapspace = rootNode.lookup("mapspace");
+    else if (rootNode.exists("mapspace_constraints"))
+      mapspace = rootNode.lookup("mapspace_constraints");
+
+    for (unsigned t = 0; t < num_threads_; t++)
+    {
+      mapspaces_.push_back(
+        mapspace::ParseAndConstruct(mapspace, arch_constraints, arch_specs_, workload_));
+    }
+  }
+
+  ~Application()
+  {
+    for (auto mapspace: mapspaces_)
+    {
+      delete mapspace;
+    }
+  }
+
+  void Run()
+  {
+    static_assert(unsigned(mapspace::Dimension::Num) == landscape::kNumDimensions,
+                  "landscape record layout assumes 4 mapspace dimensions");
+
+    // Draw all sample IDs up front from a single seeded generator, so the
+    // sample set is reproducible and independent of the thread count.
+    std::mt19937_64 generator(seed_);
+    auto draw = [&generator](uint128_t size)
+    {
+      uint128_t r = (uint128_t(generator()) << 64) | generator();
+      return r % size;
+    };
+
+    std::vector<std::array<uint128_t, landscape::kNumDimensions>> samples(num_samples_);
+    for (auto& sample: samples)
+    {
+      for (unsigned dim = 0; dim < landscape::kNumDimensions; dim++)
+      {
+        sample[dim] = draw(mapspaces_.at(0)->Size(mapspace::Dimension(dim)));
+      }
+    }
+
+    // Evaluate in parallel. Each worker owns a contiguous slice of the
+    // sample list and writes records into its pre-sized slots, so no
+    // locking is needed.
+    std::vector<landscape::Record> records(num_samples_);
+
+    auto worker = [this, &samples, &records](unsigned thread_id)
+    {
+      model::Engine engine;
+      engine.Spec(arch_specs_);
+      auto mapspace = mapspaces_.at(thread_id);
+
+      for (std::uint64_t i = thread_id; i < samples.size(); i += num_threads_)
+      {
+        auto& sample = samples[i];
+        auto& record = records[i];
+        record = {};
+        for (unsigned dim = 0; dim < landscape::kNumDimensions; dim++)
+        {
+          record.coord_lo[dim] = static_cast<std::uint64_t>(sample[dim]);
+          record.coord_hi[dim] = static_cast<std::uint64_t>(sample[dim] >> 64);
+        }
+
+        mapspace::ID mapping_id = mapspace::ID(mapspace->AllSizes());
+        for (unsigned dim = 0; dim < landscape::kNumDimensions; dim++)
+        {
+          mapping_id.Set(dim, sample[dim]);
+        }
+
+        Mapping mapping;
+        auto construction_status = mapspace->ConstructMapping(mapping_id, &mapping);
+        bool success =
+          std::accumulate(construction_status.begin(), construction_status.end(), true,
+                          [](bool cur, const mapspace::Status& status)
+                          { return cur && status.success; });
+        record.construct_success = success ? 1 : 0;
+
+        if (success)
+        {
+          auto status_per_level = engine.Evaluate(mapping, workload_);
+          success =
+            std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                            [](bool cur, const model::EvalStatus& status)
+                            { return cur && status.success; });
+        }
+
+        if (success)
+        {
+          auto stats = engine.GetTopology().GetStats();
+          record.valid = 1;
+          record.cycles = stats.cycles;
+          record.maccs = stats.maccs;
+          record.last_level_accesses = stats.last_level_accesses;
+          record.energy = stats.energy;
+          record.utilization = stats.utilization;
+          record.area = stats.area;
+        }
+      }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < num_threads_; t++)
+    {
+      threads.push_back(std::thread(worker, t));
+    }
+    worker(0);
+    for (auto& thread: threads)
+    {
+      thread.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+    // Write the dataset.
+    std::ofstream out(out_file_, std::ios::binary | std::ios::trunc);
+    landscape::FileHeader header =
+      { landscape::kMagic, landscape::kVersion, sizeof(landscape::Record),
+        landscape::kNumDimensions };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()),
+              records.size() * sizeof(landscape::Record));
+    out.close();
+
+    std::uint64_t valid = 0;
+    std::uint64_t construct_fails = 0;
+    for (auto& record: records)
+    {
+      if (record.valid)
+        valid++;
+      else if (!record.construct_success)
+        construct_fails++;
+    }
+
+    std::cout << "Sampled " << num_samples_ << " mappings on "
+              << num_threads_ << " threads in "
+              << std::fixed << std::setprecision(2) << elapsed << " s ("
+              << std::setprecision(1)
+              << (num_samples_ > 0 ? elapsed * 1e6 / num_samples_ : 0.0)
+              << " us/mapping)." << std::endl;
+    std::cout << "  valid = " << valid
+              << ", construct fails = " << construct_fails
+              << ", eval fails = " << (num_samples_ - valid - construct_fails)
+              << std::endl;
+    std::cout << "Wrote " << out_file_ << std::endl;
+  }
+};
@@ -0,0 +1,159 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "mapping/mapping.hpp"
+#include "model/topology.hpp"
+
+//--------------------------------------------//
+//             Evaluation Cache               //
+//--------------------------------------------//
+
+// A concurrent evaluation cache shared by all mapper threads of one
+// search. Different mapspace IDs can construct semantically identical
+// mappings (degenerate permutations of unit loops, unit spatial splits),
+// and different threads' splits can contain equivalent points -- so the
+// cache is keyed by a canonical form of the constructed Mapping (the loop
+// nest with unit loops dropped, plus the bypass masks) rather than by the
+// mapping ID, and a hit returns the full Topology::Stats of a previous
+// evaluation without re-running the nest analysis.
+//
+// The table is a bounded direct-mapped array of atomically published
+// shared_ptr entries, following the same lock-free RCU-style pattern as
+// BestResultExchange: readers atomically load an immutable entry and
+// collision-check its stored canonical key; writers atomically overwrite
+// the hashed slot (last writer wins), which doubles as the eviction
+// policy. A retired entry is reclaimed once the last reader drops its
+// reference. Stats are only inserted for complete, successful
+// evaluations; failures and cutoff aborts are never cached.
+//
+// The cache is scoped to one workload's search: canonical keys do not
+// encode the workload or architecture, so the application must construct
+// a fresh cache per SearchWorkload_ invocation.
+class EvalCache
+{
+ public:
+  struct Entry
+  {
+    std::string key;
+    model::Topology::Stats stats;
+  };
+
+ private:
+  std::vector<std::shared_ptr<const Entry>> slots_;
+
+  // FNV-1a over the canonical key.
+  static std::uint64_t Hash_(const std::string& key)
+  {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c: key)
+    {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+ public:
+  EvalCache(std::uint64_t num_entries) :
+      slots_(num_entries > 0 ? num_entries : 1)
+  {
+  }
+
+  // This class does not support being copied.
+  EvalCache(const EvalCache&) = delete;
+  EvalCache& operator=(const EvalCache&) = delete;
+
+  // Canonical form of a constructed mapping: per tiling level, every
+  // non-unit loop's (dimension, start, end, stride, spacetime) tuple in
+  // nest order, then the per-dataspace bypass masks. Unit loops are
+  // dropped, so IDs that differ only in how they permute or spatially
+  // split trivial loops collapse onto the same key.
+  static std::string CanonicalKey(const Mapping& mapping)
+  {
+    std::ostringstream key;
+
+    auto& nest = mapping.loop_nest;
+    std::uint64_t start = 0;
+    for (auto boundary: nest.storage_tiling_boundaries)
+    {
+      for (std::uint64_t i = start; i <= boundary && i < nest.loops.size(); i++)
+      {
+        auto& loop = nest.loops.at(i);
+        if (loop.end > 1)
+        {
+          key << int(loop.dimension) << ',' << loop.start << ',' << loop.end
+              << ',' << loop.stride << ',' << int(loop.spacetime_dimension) << ';';
+        }
+      }
+      key << '|';
+      start = boundary + 1;
+    }
+
+    for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
+    {
+      key << mapping.datatype_bypass_nest.at(pvi).to_ulong() << '/';
+    }
+
+    return key.str();
+  }
+
+  // Look a canonical key up; on a (collision-checked) hit, copy the cached
+  // stats out and return true.
+  bool Lookup(const std::string& key, model::Topology::Stats& stats) const
+  {
+    auto& slot = slots_.at(Hash_(key) % slots_.size());
+    auto entry = std::atomic_load_explicit(&slot, std::memory_order_acquire);
+    if (entry && entry->key == key)
+    {
+      stats = entry->stats;
+      return true;
+    }
+    return false;
+  }
+
+  // Publish the stats of a completed successful evaluation. Overwrites
+  // whatever previously occupied the slot.
+  void Insert(const std::string& key, const model::Topology::Stats& stats)
+  {
+    auto entry = std::make_shared<Entry>();
+    entry->key = key;
+    entry->stats = stats;
+    auto& slot = slots_.at(Hash_(key) % slots_.size());
+    std::atomic_store_explicit(&slot,
+                               std::shared_ptr<const Entry>(std::move(entry)),
+                               std::memory_order_release);
+  }
+};
@@ -73,10 +73,15 @@ int main(int argc, char* argv[])
   sigemptyset(&action.sa_mask);
   action.sa_flags = 0;
   sigaction(SIGINT, &action, NULL);
+  // Cluster preemptions deliver SIGTERM; treat it like an interactive
+  // interrupt so a preempted run still drains its threads, reports
+  // merged stats, emits artifacts and writes a resumable checkpoint.
+  sigaction(SIGTERM, &action, NULL);
 
   std::vector<std::string> input_files;
   std::string output_dir = ".";
-  bool success = ParseArgs(argc, argv, input_files, output_dir);
+  bool resume = false;
+  bool success = ParseArgs(argc, argv, input_files, output_dir, resume);
   if (!success)
   {
     std::cerr << "ERROR: error parsing command line." << std::endl;
@@ -92,7 +97,12 @@ int main(int argc, char* argv[])
   std::cout << std::endl;
   
   Application application(config, output_dir);
-  
+
+  if (resume)
+  {
+    application.EnableResume();
+  }
+
   application.Run();
 
   return 0;
@@ -25,11 +25,44 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
 #include <random>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "model/engine.hpp"
+#include "util/cycle-timer.hpp"
+#include "util/perf-counters.hpp"
+#include "util/profiler.hpp"
+#include "util/results-log.hpp"
+#include "util/search-trace.hpp"
+#include "applications/mapper/eval-cache.hpp"
+#include "applications/mapper/pipeline.hpp"
+#include "applications/mapper/surrogate.hpp"
 
 extern bool gTerminate;
+extern bool gTerminateEval;
+
+// Prune evaluations using the incumbent best cost (branch-and-bound).
+static bool gEnableCostCutoff =
+  (getenv("TIMELOOP_DISABLE_COST_CUTOFF") == NULL);
+
+// Relative-improvement tolerance within which two costs are considered
+// equal and comparison falls through to the next optimization metric.
+static const double kBetternessTolerance = 0.001;
+
+// Largest multiple of the configured sync interval that the adaptive
+// backoff is allowed to reach.
+static const std::uint64_t kMaxSyncBackoff = 1024;
 
 enum class Betterness
 {
@@ -64,7 +97,7 @@ static Betterness IsBetterRecursive_(const model::Topology::Stats& candidate, co
                                      const std::vector<std::string>::const_iterator metric,
                                      const std::vector<std::string>::const_iterator end)
 {
-  const double tolerance = 0.001;
+  const double tolerance = kBetternessTolerance;
 
   double candidate_cost = Cost(candidate, *metric);
   double incumbent_cost = Cost(incumbent, *metric);
@@ -120,12 +153,38 @@ static inline bool IsBetter(const model::Topology::Stats& candidate, const model
   return IsBetter(candidate, incumbent, metrics);
 }
 
+// A search result as carried between threads: the mapspace coordinates
+// of the mapping plus its evaluated stats. The (ID, mapspace) pair fully
+// determines the Mapping, so the hot paths (per-mapping incumbent
+// updates, the lock-free global exchange, top-K retention) copy only
+// this compact record; the full Mapping is reconstructed on demand by
+// GetMapping() on the cold output paths (artifacts, reports, sweeps).
+// The mapspace pointer is non-owning -- the application keeps the split
+// mapspaces alive until all results have been reported (ReleaseSearch_()
+// runs only between batch layers and at teardown).
 struct EvaluationResult
 {
   bool valid = false;
-  Mapping mapping;
+  mapspace::ID mapping_id;
+  mapspace::MapSpace* mapspace = nullptr;
   model::Topology::Stats stats;
 
+  // Lazily reconstructed Mapping, shared across copies of this result.
+  mutable std::shared_ptr<Mapping> mapping_cache;
+
+  // Reconstruct (and cache) the full Mapping from its mapspace ID.
+  // Returns a mutable reference because the Mapping print/evaluate
+  // methods are non-const; callers run on single-threaded output paths.
+  Mapping& GetMapping() const
+  {
+    if (!mapping_cache)
+    {
+      mapping_cache = std::make_shared<Mapping>();
+      mapspace->ConstructMapping(mapping_id, mapping_cache.get(), false);
+    }
+    return *mapping_cache;
+  }
+
   bool UpdateIfBetter(const EvaluationResult& other, const std::vector<std::string>& metrics)
   {
     bool updated = false;
@@ -133,14 +192,75 @@ struct EvaluationResult
         (!valid || IsBetter(other.stats, stats, metrics)))
     {
       valid = true;
-      mapping = other.mapping;
+      mapping_id = other.mapping_id;
+      mapspace = other.mapspace;
       stats = other.stats;
+      mapping_cache = other.mapping_cache;
       updated = true;
     }
     return updated;
   }
 };
 
+// Lock-free publication point for the global-best result shared by all
+// mapper threads (RCU-style). Readers atomically load an immutable
+// snapshot; writers CAS-publish a freshly allocated snapshot if and only
+// if it beats the incumbent. The shared_ptr CAS doubles as an epoch
+// stamp: a failed exchange hands back the newer incumbent to re-compare
+// against, and a retired snapshot is reclaimed once the last reader
+// drops its reference.
+class BestResultExchange
+{
+ private:
+  std::shared_ptr<const EvaluationResult> best_;
+
+ public:
+  // Snapshot of the current global best. May be null before the first
+  // publication.
+  std::shared_ptr<const EvaluationResult> Load() const
+  {
+    return std::atomic_load_explicit(&best_, std::memory_order_acquire);
+  }
+
+  // Discard the incumbent (e.g., between layers of a batch run). Must not
+  // race with searcher threads.
+  void Reset()
+  {
+    std::atomic_store_explicit(&best_,
+                               std::shared_ptr<const EvaluationResult>(),
+                               std::memory_order_release);
+  }
+
+  // Publish the candidate if it beats the incumbent. Returns true if
+  // the candidate was published.
+  bool UpdateIfBetter(const EvaluationResult& candidate,
+                      const std::vector<std::string>& metrics)
+  {
+    if (!candidate.valid)
+    {
+      return false;
+    }
+
+    std::shared_ptr<const EvaluationResult> proposed =
+      std::make_shared<EvaluationResult>(candidate);
+
+    auto incumbent = std::atomic_load_explicit(&best_, std::memory_order_acquire);
+    while (!incumbent || !incumbent->valid ||
+           IsBetter(candidate.stats, incumbent->stats, metrics))
+    {
+      if (std::atomic_compare_exchange_weak_explicit(
+            &best_, &incumbent, proposed,
+            std::memory_order_acq_rel, std::memory_order_acquire))
+      {
+        return true;
+      }
+      // The failed CAS reloaded the (newer) incumbent; loop to re-check
+      // betterness against it.
+    }
+    return false;
+  }
+};
+
 //--------------------------------------------//
 //              Failure Tracking              //
 //--------------------------------------------//
@@ -151,6 +271,8 @@ enum class FailClass
   Capacity
 };
 
+const unsigned NumFailClasses = 2;
+
 std::map<FailClass, std::string> FailClassToString =
 {
   { FailClass::Fanout, "Fanout" },
@@ -163,11 +285,147 @@ std::ostream& operator << (std::ostream& out, const FailClass& fail_class)
   return out;
 }
 
+// A fail reason interned into an enum + parameter record. The model and
+// mapspace layers report failures as formatted strings; the handful of
+// templates they use are recognized here and reduced to a kind plus the
+// two numbers that vary (the mapped value and the violated limit), with
+// the verbatim string kept only for unrecognized (e.g. merged) messages.
+// Interning runs exclusively on the cold reservoir-sample replacement
+// path, never on the per-mapping failure path.
+struct FailReason
+{
+  enum class Kind
+  {
+    None,
+    TileExceedsCapacity,
+    TileUnderUtilization,
+    MinTileExceedsCapacity,
+    InstancesExceeded,
+    FanoutExceeded,
+    ParallelismUnderMin,
+    Other
+  };
+
+  Kind kind = Kind::None;
+  double value = 0;
+  double limit = 0;
+  std::string other;  // verbatim fallback for unrecognized messages
+
+  // The known templates, as (prefix, infix) pairs surrounding the two
+  // parameters. Kept in sync with buffer.cpp and uber.hpp.
+  struct Template
+  {
+    Kind kind;
+    const char* prefix;
+    const char* infix;
+  };
+
+  static const std::vector<Template>& Templates()
+  {
+    static const std::vector<Template> templates =
+    {
+      { Kind::TileExceedsCapacity, "mapped tile size ", " exceeds buffer capacity " },
+      { Kind::TileUnderUtilization, "mapped tile size ", " is less than constrained minimum utilization " },
+      { Kind::MinTileExceedsCapacity, "minimum tile size ", " exceeds buffer capacity " },
+      { Kind::InstancesExceeded, "mapped instances ", " exceeds available hardware instances " },
+      { Kind::FanoutExceeded, "mapped fanout ", " exceeds hardware fanout " },
+      { Kind::ParallelismUnderMin, "parallelism ", " is less than constrained min-parallelism " }
+    };
+    return templates;
+  }
+
+  void Intern(const std::string& reason)
+  {
+    for (auto& t: Templates())
+    {
+      std::size_t prefix_len = std::strlen(t.prefix);
+      if (reason.compare(0, prefix_len, t.prefix) != 0)
+        continue;
+
+      auto infix_pos = reason.find(t.infix, prefix_len);
+      if (infix_pos == std::string::npos)
+        continue;
+
+      try
+      {
+        std::size_t value_end, limit_end;
+        double v = std::stod(reason.substr(prefix_len, infix_pos - prefix_len), &value_end);
+        std::string limit_str = reason.substr(infix_pos + std::strlen(t.infix));
+        double l = std::stod(limit_str, &limit_end);
+        if (value_end != infix_pos - prefix_len || limit_end != limit_str.size())
+          break;  // trailing text we can't reproduce; keep verbatim
+        kind = t.kind;
+        value = v;
+        limit = l;
+        other.clear();
+        return;
+      }
+      catch (const std::exception&)
+      {
+        break;
+      }
+    }
+
+    kind = Kind::Other;
+    other = reason;
+  }
+
+  std::string Format() const
+  {
+    if (kind == Kind::None)
+      return "";
+    if (kind == Kind::Other)
+      return other;
+
+    for (auto& t: Templates())
+    {
+      if (t.kind == kind)
+      {
+        // Wide precision so integer-valued sizes round-trip exactly.
+        std::ostringstream out;
+        out << std::setprecision(15) << t.prefix << value << t.infix << limit;
+        return out.str();
+      }
+    }
+    return other;
+  }
+};
+
 struct FailInfo
 {
   uint128_t count = 0;
-  Mapping mapping;
-  std::string reason;
+
+  // Reservoir-sampled example of a mapping that failed in this bucket,
+  // stored as the compact mapspace ID plus the mapspace it decodes
+  // against (with work-stealing this may be a stolen split, so the
+  // thread's current mapspace at record time is captured alongside).
+  // The Mapping object is reconstructed only at diagnostics-print time.
+  mapspace::ID mapping_id;
+  mapspace::MapSpace* mapspace = nullptr;
+  FailReason reason;
+};
+
+// Monotone per-thread progress counters, updated with relaxed atomic
+// increments on the search hot path and sampled by the application's
+// periodic status reporter. Unlike the loop-local counters in Run()
+// (which reset on every valid mapping to drive the timeout trigger),
+// these only ever grow, so a sampler can difference two snapshots to
+// get rates. Samples are approximate: the four counters are not read
+// as one consistent snapshot.
+struct LiveCounters
+{
+  std::atomic<std::uint64_t> total_mappings;
+  std::atomic<std::uint64_t> valid_mappings;
+  std::atomic<std::uint64_t> fanout_fails;
+  std::atomic<std::uint64_t> capacity_fails;
+
+  LiveCounters() :
+      total_mappings(0),
+      valid_mappings(0),
+      fanout_fails(0),
+      capacity_fails(0)
+  {
+  }
 };
 
 //--------------------------------------------//
@@ -180,7 +438,57 @@ class MapperThread
   struct Stats
   {
     EvaluationResult thread_best;
-    std::map<FailClass, std::map<unsigned, FailInfo>> fail_stats;
+
+    // Failure statistics, as a flat array of buckets indexed
+    // [fail_class * fail_levels + level] so that the hot-path update is
+    // a single indexed count increment. Sized by InitFailStats() before
+    // the search starts; empty when diagnostics are off.
+    std::vector<FailInfo> fail_stats;
+    unsigned fail_levels = 0;
+
+    // Nest-analysis cache effectiveness, snapshotted at the end of Run()
+    // (the cache and its counters are thread-local to the worker thread).
+    std::uint64_t nest_memo_hits = 0;
+    std::uint64_t nest_memo_misses = 0;
+
+    // Per-phase evaluation cycles, snapshotted at the end of Run(). All
+    // zeros unless the build enables timers (scons --timers).
+    timer::PhaseCycles phase_cycles = {};
+
+    // Hardware performance counters over the whole Run() loop and sliced
+    // per phase, snapshotted at the end of Run(). All zeros unless the
+    // build enables them (scons --perf-counters) and the kernel permits
+    // perf_event_open (see util/perf-counters.hpp).
+    perf::CounterValues run_perf = {};
+    perf::PhaseCounters phase_perf = {};
+
+    // Surrogate pre-filter effectiveness (see surrogate.hpp): evaluations
+    // skipped on the model's prediction, skip decisions audited by full
+    // evaluation, and audits that exposed a false reject.
+    std::uint64_t surrogate_skips = 0;
+    std::uint64_t surrogate_audits = 0;
+    std::uint64_t surrogate_false_rejects = 0;
+
+    // Shared evaluation-cache effectiveness (see eval-cache.hpp):
+    // lookups performed and hits that skipped a full evaluation.
+    std::uint64_t eval_cache_lookups = 0;
+    std::uint64_t eval_cache_hits = 0;
+
+    // Observed adaptive-sync schedule: number of syncs performed, number
+    // of times the interval was reset by an incumbent change, and the
+    // largest/final intervals the geometric backoff reached.
+    std::uint64_t sync_count = 0;
+    std::uint64_t sync_resets = 0;
+    uint128_t max_sync_interval = 0;
+    uint128_t final_sync_interval = 0;
+
+    // Top-K retention (see num_best_mappings_): the K best valid mappings
+    // seen by this thread, sorted best-first by the optimization-metric
+    // chain, and -- when more than one metric is configured -- the
+    // (energy, cycles) Pareto frontier of valid mappings. Both are merged
+    // across threads by the application after the search.
+    std::vector<EvaluationResult> best_mappings;
+    std::vector<EvaluationResult> pareto_frontier;
 
     std::default_random_engine generator;
     std::uniform_real_distribution<double> distribution;
@@ -190,60 +498,46 @@ class MapperThread
     {
     }
 
-    void UpdateFails(FailClass fail_class, std::string fail_reason, unsigned level, const Mapping& mapping)
+    void InitFailStats(unsigned num_levels)
     {
-        // Find the data corresponding to this fail class.
-        auto fail_bucket_it = fail_stats.find(fail_class);
-        if (fail_bucket_it == fail_stats.end())
-        {
-          // We've never seen this fail class before.
-          std::map<unsigned, FailInfo> fail_bucket;
-          fail_bucket[level] = { .count = 1, .mapping = mapping, .reason = fail_reason };
-          fail_stats[fail_class] = fail_bucket;
-        }
-        else
+      fail_levels = num_levels;
+      fail_stats.assign(NumFailClasses * num_levels, FailInfo());
+    }
+
+    void UpdateFails(FailClass fail_class, const std::string& fail_reason, unsigned level,
+                     const mapspace::ID& mapping_id, mapspace::MapSpace* mapspace)
+    {
+        auto& fail_info = fail_stats.at(unsigned(fail_class) * fail_levels + level);
+        fail_info.count += 1;
+
+        // p(x) = prob. that I switch to x when it arrives
+        // p(0) = 1
+
+        // P(x) = prob. that x is finally selected.
+        // 1/N = P(0) = p(0).(1-p(1)).(1-p(2))...(1-p(N-1))
+        // 1/N = P(1) =        (p(1)).(1-p(2))...(1-p(N-1))
+
+        // p(x).(1-p(x+1)) = p(x+1)
+        // ...
+        // => p(x+1) = p(x) / [1+p(x)]
+        // ...
+        // => p(x) = 1/(1+x)
+
+        // Compute the probability of switching (we've already computed count=x+1).
+        // The first arrival has count=1 and so always takes the sample slot.
+        double prob = 1 / fail_info.count.convert_to<double>();
+
+        // Probabilistically update the sample. This is the only path that
+        // does more than an increment, and it runs an expected O(log count)
+        // times per bucket.
+        double roll = distribution(generator);
+        if (roll < prob)
         {
-          // We've seen this fail class, see if this level has
-          // failed in this class.
-          auto& fail_bucket = fail_bucket_it->second;
-          auto fail_info_it = fail_bucket.find(level);
-          if (fail_info_it == fail_bucket.end())
-          {
-            // No, this is the first time this level has failed in
-            // this fail class, create a new entry.
-            fail_bucket[level] = { .count = 1, .mapping = mapping, .reason = fail_reason };
-          }
-          else
-          {
-            // This level has already failed in this class,
-            // increment its count.
-            fail_info_it->second.count += 1;
- 
-            // p(x) = prob. that I switch to x when it arrives
-            // p(0) = 1
-
-            // P(x) = prob. that x is finally selected.
-            // 1/N = P(0) = p(0).(1-p(1)).(1-p(2))...(1-p(N-1))
-            // 1/N = P(1) =        (p(1)).(1-p(2))...(1-p(N-1))
-
-            // p(x).(1-p(x+1)) = p(x+1)
-            // ...
-            // => p(x+1) = p(x) / [1+p(x)]
-            // ...
-            // => p(x) = 1/(1+x)
-
-            // Compute the probability of switching (we've already computed count=x+1)
-            double prob = 1 / fail_info_it->second.count.convert_to<double>();
-
-            // Probabilistically update the mapping.
-            double roll = distribution(generator);
-            if (roll < prob)
-            {
-              fail_info_it->second.mapping = mapping;
-            }
-          }
+          fail_info.mapping_id = mapping_id;
+          fail_info.mapspace = mapspace;
+          fail_info.reason.Intern(fail_reason);
         }
-    }    
+    }
   };
 
  private:
@@ -265,12 +559,173 @@ class MapperThread
   std::vector<std::string> optimization_metrics_;
   model::Engine::Specs arch_specs_;
   problem::Workload &workload_;
-  EvaluationResult* best_;
-    
+  BestResultExchange* best_;
+
+  // Work stealing: the shared pool of per-split search algorithms (and
+  // their mapspaces) that the mapspace was over-split into, plus the
+  // index of the next unclaimed split. Null when over-splitting is off.
+  std::vector<search::SearchAlgorithm*>* search_pool_;
+  std::vector<mapspace::MapSpace*>* mapspace_pool_;
+  std::atomic<std::uint32_t>* next_split_;
+
+  // Checkpointing: snapshot file prefix, snapshot period (in mappings,
+  // 0 = off), and whether to restore a snapshot before searching.
+  std::string checkpoint_prefix_;
+  uint128_t checkpoint_interval_;
+  bool resume_;
+
+  // Distributed operation: cost components of the best incumbent published
+  // by other worker processes (maintained by the application's exchange
+  // loop, guarded by mutex_). Null when running single-node.
+  const model::Topology::Stats* remote_best_stats_;
+  const bool* remote_best_valid_;
+
+  // Multi-fidelity search: screen the mapspace with approximate
+  // evaluations and re-evaluate only the top-K candidates exactly after
+  // the search terminates. 0 = single-fidelity (exact) search.
+  std::uint32_t screen_top_k_;
+
+  // Auto-tune the sync interval at runtime: sync at the configured rate
+  // while the incumbent keeps improving, back off geometrically while it
+  // is stable.
+  bool adaptive_sync_;
+
+  // Number of best mappings to retain per thread (1 = incumbent only,
+  // i.e., the classic behavior). Values > 1 also enable Pareto-frontier
+  // tracking when multiple optimization metrics are configured.
+  std::uint32_t num_best_mappings_;
+
+  // Stream every successfully evaluated mapping into a per-thread binary
+  // results log (see util/results-log.hpp) for offline analysis.
+  bool results_log_;
+
+  // Stream every *attempted* mapping and its outcome into a per-thread
+  // binary trace (see util/search-trace.hpp), replayable without the
+  // search algorithm via timeloop-replay.
+  bool search_trace_;
+
+  // Learned pre-filter: skip full evaluation for mappings an online-
+  // trained surrogate predicts are far worse than the incumbent, with a
+  // calibrated false-reject bound (see surrogate.hpp).
+  bool surrogate_filter_;
+  double surrogate_false_reject_;
+
+  // Two-stage pipeline: run the search and mapping construction on a
+  // paired helper thread, a few mappings ahead of evaluation (see
+  // pipeline.hpp). Engaged only if the search algorithm tolerates
+  // deferred Report calls.
+  bool pipeline_;
+
+  // Evaluation cache shared by all threads of this search, keyed by the
+  // canonical form of the constructed mapping (see eval-cache.hpp). Null
+  // when disabled.
+  EvalCache* eval_cache_;
+
+  // CPU to pin this thread to (-1 = no pinning). Pinning happens at the
+  // top of Run(), before any evaluation state is allocated, so first-touch
+  // page placement puts the thread's scratch state on its local NUMA node.
+  int pin_cpu_;
+
   // Thread-local data (stats etc.).
   std::thread thread_;
   Stats stats_;
-  
+
+  // Live progress counters, sampled concurrently by the status reporter.
+  LiveCounters live_;
+
+  // Insert a valid mapping into the bounded, best-first-sorted top-K list.
+  void UpdateBestMappings_(const EvaluationResult& result)
+  {
+    auto& retained = stats_.best_mappings;
+    auto pos = std::upper_bound(retained.begin(), retained.end(), result,
+                                [this](const EvaluationResult& a, const EvaluationResult& b)
+                                { return IsBetter(a.stats, b.stats, optimization_metrics_); });
+    if (pos != retained.end() || retained.size() < num_best_mappings_)
+    {
+      retained.insert(pos, result);
+      if (retained.size() > num_best_mappings_)
+      {
+        retained.pop_back();
+      }
+    }
+  }
+
+  // Maintain the (energy, cycles) Pareto frontier of valid mappings:
+  // candidates dominated by an existing point are dropped, points the
+  // candidate dominates are evicted. The frontier is capped at
+  // num_best_mappings_ points (shedding the highest-energy one) to bound
+  // memory.
+  void UpdateParetoFrontier_(const EvaluationResult& result)
+  {
+    auto& frontier = stats_.pareto_frontier;
+    for (auto& entry: frontier)
+    {
+      if (entry.stats.energy <= result.stats.energy &&
+          entry.stats.cycles <= result.stats.cycles)
+      {
+        return;
+      }
+    }
+
+    frontier.erase(std::remove_if(frontier.begin(), frontier.end(),
+                                  [&result](const EvaluationResult& entry)
+                                  { return result.stats.energy <= entry.stats.energy &&
+                                           result.stats.cycles <= entry.stats.cycles; }),
+                   frontier.end());
+    frontier.push_back(result);
+
+    if (frontier.size() > num_best_mappings_)
+    {
+      frontier.erase(std::max_element(frontier.begin(), frontier.end(),
+                                      [](const EvaluationResult& a, const EvaluationResult& b)
+                                      { return a.stats.energy < b.stats.energy; }));
+    }
+  }
+
+  // Claim the next unexplored mapspace split from the shared pool instead
+  // of going idle. Returns false if every split has been claimed.
+  bool StealNextSplit_()
+  {
+    if (search_pool_ == nullptr)
+      return false;
+
+    auto next = next_split_->fetch_add(1);
+    if (next >= search_pool_->size())
+      return false;
+
+    search_ = search_pool_->at(next);
+    mapspace_ = mapspace_pool_->at(next);
+    return true;
+  }
+
+  std::string CheckpointPath_() const
+  {
+    return checkpoint_prefix_ + ".checkpoint." + std::to_string(thread_id_);
+  }
+
+  // Snapshot this thread's search progress: the ID of the best mapping
+  // found so far (it is re-constructed and re-evaluated on resume, which
+  // is far cheaper than serializing the mapping and its stats) followed by
+  // the search algorithm's own state. The file is written to the side and
+  // renamed into place so a kill mid-write leaves the previous snapshot
+  // intact.
+  void WriteCheckpoint_()
+  {
+    auto path = CheckpointPath_();
+    auto temp_path = path + ".tmp";
+
+    std::ofstream out(temp_path);
+    if (!out)
+      return;
+
+    out << (stats_.thread_best.valid ? 1 : 0) << ' '
+        << stats_.thread_best.mapping_id.Integer() << '\n';
+    search_->Checkpoint(out);
+    out.close();
+
+    rename(temp_path.c_str(), path.c_str());
+  }
+
  public:
   MapperThread(
     unsigned thread_id,
@@ -290,7 +745,25 @@ class MapperThread
     std::vector<std::string> optimization_metrics,
     model::Engine::Specs arch_specs,
     problem::Workload &workload,
-    EvaluationResult* best
+    BestResultExchange* best,
+    std::vector<search::SearchAlgorithm*>* search_pool = nullptr,
+    std::vector<mapspace::MapSpace*>* mapspace_pool = nullptr,
+    std::atomic<std::uint32_t>* next_split = nullptr,
+    std::string checkpoint_prefix = "",
+    uint128_t checkpoint_interval = 0,
+    bool resume = false,
+    const model::Topology::Stats* remote_best_stats = nullptr,
+    const bool* remote_best_valid = nullptr,
+    std::uint32_t screen_top_k = 0,
+    bool adaptive_sync = true,
+    std::uint32_t num_best_mappings = 1,
+    bool results_log = false,
+    bool search_trace = false,
+    bool surrogate_filter = false,
+    double surrogate_false_reject = 0.01,
+    bool pipeline = false,
+    EvalCache* eval_cache = nullptr,
+    int pin_cpu = -1
     ) :
       thread_id_(thread_id),
       search_(search),
@@ -310,9 +783,28 @@ class MapperThread
       arch_specs_(arch_specs),
       workload_(workload),
       best_(best),
+      search_pool_(search_pool),
+      mapspace_pool_(mapspace_pool),
+      next_split_(next_split),
+      checkpoint_prefix_(checkpoint_prefix),
+      checkpoint_interval_(checkpoint_interval),
+      resume_(resume),
+      remote_best_stats_(remote_best_stats),
+      remote_best_valid_(remote_best_valid),
+      screen_top_k_(screen_top_k),
+      adaptive_sync_(adaptive_sync),
+      num_best_mappings_(num_best_mappings),
+      results_log_(results_log),
+      search_trace_(search_trace),
+      surrogate_filter_(surrogate_filter),
+      surrogate_false_reject_(surrogate_false_reject),
+      pipeline_(pipeline),
+      eval_cache_(eval_cache),
+      pin_cpu_(pin_cpu),
       thread_(),
       stats_()
   {
+    stats_.InitFailStats(arch_specs_.topology.NumLevels());
   }
 
   void Start()
@@ -331,14 +823,92 @@ class MapperThread
     return stats_;
   }
 
+  const LiveCounters& GetLiveCounters() const
+  {
+    return live_;
+  }
+
   void Run()
   {
+    // Pin before touching any evaluation state: the engine, nest-analysis
+    // caches and search scratch allocated below are then first-touched
+    // from the pinned CPU, i.e., placed on its local NUMA node, and the
+    // thread can no longer migrate away from those pages.
+#ifdef __linux__
+    if (pin_cpu_ >= 0)
+    {
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      CPU_SET(pin_cpu_, &cpuset);
+      if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0)
+      {
+        mutex_->lock();
+        log_stream_ << "[" << std::setw(3) << thread_id_ << "] WARNING: "
+                    << "failed to pin thread to CPU " << pin_cpu_
+                    << ", leaving placement to the OS." << std::endl;
+        mutex_->unlock();
+      }
+    }
+#endif
+
+    // Baseline for this thread's whole-Run() hardware counters. The first
+    // perf:: call opens the counters on the calling (now pinned) thread;
+    // on perf-counter builds this is that first call.
+    perf::CounterValues perf_start = perf::Read();
+
     uint128_t total_mappings = 0;
     uint128_t valid_mappings = 0;
     uint128_t invalid_mappings_mapcnstr = 0;
     uint128_t invalid_mappings_eval = 0;
     std::uint32_t mappings_since_last_best_update = 0;
 
+    // Multi-fidelity screening: the top-K candidates (sorted by ascending
+    // approximate cost) retained for exact re-evaluation. The mapspace
+    // pointer is recorded alongside the ID because split-stealing may
+    // move this thread to a different split mid-search.
+    struct ScreenedCandidate
+    {
+      double cost;
+      mapspace::ID mapping_id;
+      mapspace::MapSpace* mapspace;
+      Mapping mapping;
+    };
+    std::vector<ScreenedCandidate> screened;
+
+    // Adaptive sync state: the current interval and the mapping count at
+    // which the next sync fires.
+    uint128_t cur_sync_interval = sync_interval_;
+    uint128_t next_sync = sync_interval_;
+
+    // Optional binary results log: one fixed-size record per successfully
+    // evaluated mapping, buffered so logging stays off the hot path.
+    std::unique_ptr<resultslog::Writer> results_log;
+    if (results_log_)
+    {
+      results_log.reset(new resultslog::Writer(
+        checkpoint_prefix_ + ".results." + std::to_string(thread_id_) + ".bin",
+        thread_id_));
+    }
+
+    // Optional search trace: one fixed-size record per *attempted* mapping,
+    // including failed constructions, in visit order.
+    std::unique_ptr<searchtrace::Writer> search_trace;
+    if (search_trace_)
+    {
+      search_trace.reset(new searchtrace::Writer(
+        checkpoint_prefix_ + ".search-trace." + std::to_string(thread_id_) + ".bin",
+        thread_id_));
+    }
+
+    // Optional surrogate pre-filter, trained online from this thread's
+    // completed evaluations.
+    std::unique_ptr<SurrogateFilter> surrogate;
+    if (surrogate_filter_)
+    {
+      surrogate.reset(new SurrogateFilter(surrogate_false_reject_));
+    }
+
+
     const int ncurses_line_offset = 6;
       
     model::Engine engine;
@@ -346,6 +916,81 @@ class MapperThread
 
     mapspace::ID prev_mapping_id;
 
+    // Restore a checkpoint snapshot, if we were asked to resume and one
+    // exists. The best mapping is re-constructed from its ID and
+    // re-evaluated to re-seed thread_best (and the global best); then the
+    // search algorithm's own state is restored. Assumes the same
+    // configuration (mapspace, constraints, thread count) as the run that
+    // wrote the snapshot.
+    if (resume_)
+    {
+      std::ifstream checkpoint(CheckpointPath_());
+      if (checkpoint)
+      {
+        int best_valid = 0;
+        uint128_t best_mapping_id = 0;
+        checkpoint >> best_valid >> best_mapping_id;
+
+        if (checkpoint && best_valid)
+        {
+          Mapping best_mapping;
+          auto construction_status = mapspace_->ConstructMapping(best_mapping_id, &best_mapping);
+          bool ok = std::accumulate(construction_status.begin(), construction_status.end(), true,
+                                    [](bool cur, const mapspace::Status& status)
+                                    { return cur && status.success; });
+          if (ok)
+          {
+            auto status_per_level = engine.Evaluate(best_mapping, workload_);
+            ok = std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                                 [](bool cur, const model::EvalStatus& status)
+                                 { return cur && status.success; });
+          }
+          if (ok)
+          {
+            stats_.thread_best.valid = true;
+            stats_.thread_best.mapping_id = mapspace_->MakeID(best_mapping_id);
+            stats_.thread_best.mapspace = mapspace_;
+            stats_.thread_best.stats = engine.GetTopology().GetStats();
+            stats_.thread_best.mapping_cache = std::make_shared<Mapping>(best_mapping);
+
+            best_->UpdateIfBetter(stats_.thread_best, optimization_metrics_);
+          }
+        }
+
+        search_->Restore(checkpoint);
+
+        mutex_->lock();
+        log_stream_ << "[" << std::setw(3) << thread_id_ << "] STATEMENT: "
+                    << "resumed search state from checkpoint."
+                    << std::endl;
+        mutex_->unlock();
+      }
+    }
+
+    // Optional construct/evaluate pipeline: a paired helper thread runs
+    // search::Next and ConstructMapping ahead into a small ring while this
+    // thread evaluates. Started after the checkpoint restore above so the
+    // helper picks up from the restored frontier. Only engaged when the
+    // search algorithm tolerates Report() arriving several Next() calls
+    // late.
+    std::unique_ptr<ConstructPipeline> pipeline;
+    if (pipeline_)
+    {
+      if (search_->SupportsDeferredReport())
+      {
+        pipeline.reset(new ConstructPipeline(search_, mapspace_, !diagnostics_on_));
+      }
+      else
+      {
+        mutex_->lock();
+        log_stream_ << "[" << std::setw(3) << thread_id_ << "] STATEMENT: "
+                    << "search algorithm requires synchronous feedback, "
+                    << "running without the construct pipeline."
+                    << std::endl;
+        mutex_->unlock();
+      }
+    }
+
     // =================
     // Main mapper loop.
     // =================
@@ -373,8 +1018,12 @@ class MapperThread
         mutex_->unlock();
       }
 
-      // Termination conditions.
+      // Termination conditions. Conditions that only exhaust this thread's
+      // current search frontier (as opposed to the global budget) set
+      // frontier_done instead, and terminate only if no unexplored mapspace
+      // split can be stolen from the shared pool.
       bool terminate = false;
+      bool frontier_done = false;
 
       if (gTerminate)
       {
@@ -400,10 +1049,10 @@ class MapperThread
       {
         mutex_->lock();
         log_stream_ << "[" << std::setw(3) << thread_id_ << "] STATEMENT: " << victory_condition_
-                    << " suboptimal mappings found since the last upgrade, terminating search."
+                    << " suboptimal mappings found since the last upgrade, abandoning this search frontier."
                     << std::endl;
         mutex_->unlock();
-        terminate = true;
+        frontier_done = true;
       }
         
       if ((invalid_mappings_mapcnstr + invalid_mappings_eval) > 0 &&
@@ -413,19 +1062,75 @@ class MapperThread
         log_stream_ << "[" << std::setw(3) << thread_id_ << "] STATEMENT: " << timeout_
                     << " invalid mappings (" << invalid_mappings_mapcnstr << " fanout, "
                     << invalid_mappings_eval << " capacity) found since the last valid mapping, "
-                    << "terminating search." << std::endl;
+                    << "abandoning this search frontier." << std::endl;
         mutex_->unlock();
-        terminate = true;
+        frontier_done = true;
       }
 
-      // Try to obtain the next mapping from the search algorithm.
+      // Try to obtain the next mapping: from the pipeline's ring if the
+      // helper thread is running construction ahead, directly from the
+      // search algorithm otherwise.
       mapspace::ID mapping_id;
-      if (!search_->Next(mapping_id))
+      ConstructPipeline::Entry pipelined;
+      bool have_next = true;
+      if (!terminate && !frontier_done)
+      {
+        if (pipeline)
+        {
+          have_next = pipeline->Pop(pipelined);
+          if (have_next)
+          {
+            mapping_id = pipelined.mapping_id;
+          }
+        }
+        else
+        {
+          profiler::Scope profile_scope("search::Next");
+          have_next = search_->Next(mapping_id);
+        }
+      }
+      if (!terminate && !frontier_done && !have_next)
       {
         mutex_->lock();
         log_stream_ << "[" << std::setw(3) << thread_id_ << "] STATEMENT: "
-                    << "search algorithm is done, terminating search."
-                    << std::endl;        
+                    << "search algorithm is done, abandoning this search frontier."
+                    << std::endl;
+        mutex_->unlock();
+        frontier_done = true;
+      }
+
+      // Steal work: claim an unexplored mapspace split (if any remain) and
+      // keep this core busy instead of terminating.
+      if (frontier_done && !terminate)
+      {
+        // Wind the helper down before leaving this frontier; mappings it
+        // constructed ahead are discarded.
+        if (pipeline)
+        {
+          pipeline->Stop();
+        }
+
+        if (StealNextSplit_())
+        {
+          mutex_->lock();
+          log_stream_ << "[" << std::setw(3) << thread_id_ << "] STATEMENT: "
+                      << "stole an unexplored mapspace split, resuming search."
+                      << std::endl;
+          mutex_->unlock();
+          mappings_since_last_best_update = 0;
+          invalid_mappings_mapcnstr = 0;
+          invalid_mappings_eval = 0;
+          if (pipeline)
+          {
+            pipeline.reset(new ConstructPipeline(search_, mapspace_, !diagnostics_on_));
+          }
+          continue;
+        }
+
+        mutex_->lock();
+        log_stream_ << "[" << std::setw(3) << thread_id_ << "] STATEMENT: "
+                    << "no unexplored mapspace splits remain, terminating search."
+                    << std::endl;
         mutex_->unlock();
         terminate = true;
       }
@@ -433,6 +1138,19 @@ class MapperThread
       // Terminate.
       if (terminate)
       {
+        if (pipeline)
+        {
+          pipeline->Stop();
+        }
+
+        // Final snapshot, so a signal-driven shutdown (e.g., a cluster
+        // preemption) leaves resumable state at the exact search
+        // frontier instead of the last periodic snapshot.
+        if (checkpoint_interval_ > 0 && total_mappings != 0)
+        {
+          WriteCheckpoint_();
+        }
+
         if (live_status_)
         {
           mutex_->lock();
@@ -444,29 +1162,63 @@ class MapperThread
       }
 
       //
-      // Periodically sync thread_best with global best.
+      // Periodically snapshot search state for kill-and-resume.
       //
-      if (total_mappings != 0 && sync_interval_ > 0 && total_mappings % sync_interval_ == 0)
+      if (total_mappings != 0 && checkpoint_interval_ > 0 &&
+          total_mappings % checkpoint_interval_ == 0)
       {
-        mutex_->lock();
-          
-        // Sync from global best to thread_best.
+        // With the pipeline engaged the helper may be inside Next();
+        // snapshot under the search lock. The snapshot's frontier is then
+        // up to the ring depth ahead of the reported outcomes, which a
+        // random search tolerates.
+        auto lock = pipeline ? pipeline->LockSearch() : std::unique_lock<std::mutex>();
+        WriteCheckpoint_();
+      }
+
+      //
+      // Periodically sync thread_best with global best. With adaptive sync
+      // the interval starts at the configured value and backs off
+      // geometrically while the incumbent is stable, snapping back to the
+      // configured rate when either side improves.
+      //
+      if (sync_interval_ > 0 && total_mappings >= next_sync)
+      {
+        // Sync from global best to thread_best (lock-free snapshot read).
         bool global_pulled = false;
-        if (best_->valid)
+        auto global_snapshot = best_->Load();
+        if (global_snapshot && global_snapshot->valid)
         {
-          if (stats_.thread_best.UpdateIfBetter(*best_, optimization_metrics_))
+          if (stats_.thread_best.UpdateIfBetter(*global_snapshot, optimization_metrics_))
           {
             global_pulled = true;
           }
         }
 
-        // Sync from thread_best to global best.
+        // Sync from thread_best to global best (CAS publication).
+        bool published = false;
         if (stats_.thread_best.valid && !global_pulled)
         {
-          best_->UpdateIfBetter(stats_.thread_best, optimization_metrics_);
+          published = best_->UpdateIfBetter(stats_.thread_best, optimization_metrics_);
         }
-          
-        mutex_->unlock();
+
+        stats_.sync_count++;
+        if (adaptive_sync_)
+        {
+          if (global_pulled || published)
+          {
+            if (cur_sync_interval != sync_interval_)
+            {
+              stats_.sync_resets++;
+            }
+            cur_sync_interval = sync_interval_;
+          }
+          else if (cur_sync_interval < sync_interval_ * kMaxSyncBackoff)
+          {
+            cur_sync_interval *= 2;
+          }
+          stats_.max_sync_interval = std::max(stats_.max_sync_interval, cur_sync_interval);
+        }
+        next_sync = total_mappings + cur_sync_interval;
       }
 
       //
@@ -486,6 +1238,35 @@ class MapperThread
       }
       prev_mapping_id = mapping_id;
 
+      // Trace the outcome of this mapping attempt (no-op unless tracing).
+      auto trace_outcome = [&](bool construct_ok, bool eval_ok)
+      {
+        if (search_trace)
+        {
+          searchtrace::Record record = {};
+          record.mapping_id_lo = static_cast<std::uint64_t>(mapping_id.Integer());
+          record.mapping_id_hi = static_cast<std::uint64_t>(mapping_id.Integer() >> 64);
+          record.construct_success = construct_ok ? 1 : 0;
+          record.eval_success = eval_ok ? 1 : 0;
+          search_trace->Append(record);
+        }
+      };
+
+      // Outcome feedback to the search algorithm. With the pipeline
+      // engaged the helper thread may be inside search_->Next()
+      // concurrently, so feedback takes the pipeline's search lock.
+      auto report_search = [&](search::Status status, double cost = 0)
+      {
+        profiler::Scope profile_scope("search::Report");
+        auto lock = pipeline ? pipeline->LockSearch() : std::unique_lock<std::mutex>();
+        search_->Report(status, cost);
+      };
+      auto report_failure_detail = [&](search::FailClass fail_class, unsigned level)
+      {
+        auto lock = pipeline ? pipeline->LockSearch() : std::unique_lock<std::mutex>();
+        search_->ReportFailureDetail(fail_class, level);
+      };
+
       //
       // Begin Mapping. We do this in several stages with increasing algorithmic
       // complexity and attempt to bail out as quickly as possible at each stage.
@@ -497,23 +1278,42 @@ class MapperThread
       //          so a mapping ID may point to an illegal mapping.
       Mapping mapping;
 
-      auto construction_status = mapspace_->ConstructMapping(mapping_id, &mapping, !diagnostics_on_);
-      success &= std::accumulate(construction_status.begin(), construction_status.end(), true,
-                                 [](bool cur, const mapspace::Status& status)
-                                 { return cur && status.success; });
+      std::vector<mapspace::Status> construction_status;
+      if (pipeline)
+      {
+        // The helper thread already constructed this mapping.
+        mapping = std::move(pipelined.mapping);
+        construction_status = std::move(pipelined.construction_status);
+        success &= pipelined.construct_success;
+      }
+      else
+      {
+        profiler::Scope profile_scope("ConstructMapping");
+        construction_status = mapspace_->ConstructMapping(mapping_id, &mapping, !diagnostics_on_);
+        success &= std::accumulate(construction_status.begin(), construction_status.end(), true,
+                                   [](bool cur, const mapspace::Status& status)
+                                   { return cur && status.success; });
+      }
 
       total_mappings++;
+      live_.total_mappings.fetch_add(1, std::memory_order_relaxed);
 
       if (!success)
       {
         invalid_mappings_mapcnstr++;
+        live_.fanout_fails.fetch_add(1, std::memory_order_relaxed);
         if (diagnostics_on_)
         {
           for (unsigned level = 0; level < construction_status.size(); level++)
             if (!construction_status.at(level).success)
-              stats_.UpdateFails(FailClass::Fanout, construction_status.at(level).fail_reason, level, mapping);
+              stats_.UpdateFails(FailClass::Fanout, construction_status.at(level).fail_reason, level,
+                                 mapping_id, mapspace_);
         }
-        search_->Report(search::Status::MappingConstructionFailure);
+        for (unsigned level = 0; level < construction_status.size(); level++)
+          if (!construction_status.at(level).success)
+            report_failure_detail(search::FailClass::Fanout, level);
+        report_search(search::Status::MappingConstructionFailure);
+        trace_outcome(false, false);
         continue;
       }
 
@@ -521,11 +1321,28 @@ class MapperThread
       //          on, and run some lightweight pre-checks that the
       //          model can use to quickly reject a nest.
       //engine.Spec(arch_specs_);
-      auto status_per_level = engine.PreEvaluationCheck(mapping, workload_, !diagnostics_on_);
+
+      // First, an even cheaper screen derived directly from the index
+      // factorization, to reject capacity-doomed mappings before any
+      // analysis state is constructed.
+      std::vector<model::EvalStatus> status_per_level;
+      {
+        profiler::Scope profile_scope("QuickCapacityCheck");
+        status_per_level = engine.QuickCapacityCheck(mapping, workload_, !diagnostics_on_);
+      }
       success &= std::accumulate(status_per_level.begin(), status_per_level.end(), true,
                                  [](bool cur, const model::EvalStatus& status)
                                  { return cur && status.success; });
 
+      if (success)
+      {
+        profiler::Scope profile_scope("PreEvaluationCheck");
+        status_per_level = engine.PreEvaluationCheck(mapping, workload_, !diagnostics_on_);
+        success &= std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                                   [](bool cur, const model::EvalStatus& status)
+                                   { return cur && status.success; });
+      }
+
       if (!success)
       {
         // Pre-evaluation failed.
@@ -536,25 +1353,196 @@ class MapperThread
         {
           invalid_mappings_eval++;
         }
+        live_.capacity_fails.fetch_add(1, std::memory_order_relaxed);
 
         if (diagnostics_on_)
         {
           for (unsigned level = 0; level < status_per_level.size(); level++)
             if (!status_per_level.at(level).success)
-              stats_.UpdateFails(FailClass::Capacity, status_per_level.at(level).fail_reason, level, mapping);
+              stats_.UpdateFails(FailClass::Capacity, status_per_level.at(level).fail_reason, level,
+                                 mapping_id, mapspace_);
         }
-        search_->Report(search::Status::EvalFailure);
+        for (unsigned level = 0; level < status_per_level.size(); level++)
+          if (!status_per_level.at(level).success)
+            report_failure_detail(search::FailClass::Capacity, level);
+        report_search(search::Status::EvalFailure);
+        trace_outcome(true, false);
         continue;
       }
 
-      // Stage 3: Heavyweight evaluation.
-      status_per_level = engine.Evaluate(mapping, workload_, !diagnostics_on_);
+      // Shared evaluation cache: different mapping IDs (and different
+      // threads' splits) can construct semantically identical mappings,
+      // so look the canonical form up before paying for Stage 3. A hit
+      // reuses the cached stats and skips the evaluation entirely.
+      std::string cache_key;
+      bool cache_hit = false;
+      model::Topology::Stats cached_stats;
+      if (eval_cache_)
+      {
+        cache_key = EvalCache::CanonicalKey(mapping);
+        stats_.eval_cache_lookups++;
+        cache_hit = eval_cache_->Lookup(cache_key, cached_stats);
+        if (cache_hit)
+        {
+          stats_.eval_cache_hits++;
+        }
+      }
+
+      // Stage 3: Heavyweight evaluation. If we already have an incumbent,
+      // hand its cost down as a branch-and-bound cutoff so evaluation can
+      // abort as soon as the partial per-level accumulation proves this
+      // mapping cannot win. The bound is slackened by the betterness
+      // tolerance: a mapping within tolerance of the incumbent can still
+      // win on a secondary metric, so it must be allowed to finish.
+      model::Topology::EvalCutoff cutoff;
+      double incumbent_cost = 0;
+      if (gEnableCostCutoff && !diagnostics_on_)
+      {
+        const double slack = 1.0 + kBetternessTolerance;
+        auto& metric = optimization_metrics_.at(0);
+
+        // Incumbent cost components: start from the thread-local best, then
+        // fold in the best incumbent published by other worker processes
+        // (distributed operation), which may be better than anything this
+        // process has seen.
+        bool have_incumbent = stats_.thread_best.valid;
+        double inc_energy = have_incumbent ? stats_.thread_best.stats.energy : 0;
+        double inc_cycles = have_incumbent ?
+          static_cast<double>(stats_.thread_best.stats.cycles) : 0;
+
+        if (remote_best_valid_ != nullptr)
+        {
+          mutex_->lock();
+          if (*remote_best_valid_)
+          {
+            double remote_energy = remote_best_stats_->energy;
+            double remote_cycles = static_cast<double>(remote_best_stats_->cycles);
+            bool remote_better = false;
+            if (metric == "delay")
+              remote_better = !have_incumbent || remote_cycles < inc_cycles;
+            else if (metric == "energy")
+              remote_better = !have_incumbent || remote_energy < inc_energy;
+            else if (metric == "edp")
+              remote_better = !have_incumbent ||
+                (remote_energy * remote_cycles) < (inc_energy * inc_cycles);
+            if (remote_better)
+            {
+              inc_energy = remote_energy;
+              inc_cycles = remote_cycles;
+              have_incumbent = true;
+            }
+          }
+          mutex_->unlock();
+        }
+
+        if (have_incumbent)
+        {
+          if (metric == "delay")
+          {
+            cutoff.cycles = static_cast<std::uint64_t>(inc_cycles * slack);
+            incumbent_cost = inc_cycles;
+          }
+          else if (metric == "energy")
+          {
+            cutoff.energy = inc_energy * slack;
+            incumbent_cost = inc_energy;
+          }
+          else if (metric == "edp")
+          {
+            cutoff.edp = inc_energy * inc_cycles * slack;
+            incumbent_cost = inc_energy * inc_cycles;
+          }
+          // "last-level-accesses" has no per-level lower bound; leave disabled.
+        }
+      }
+
+      // Stage 2.5: Learned pre-filter. If the surrogate predicts this
+      // mapping is far worse than the incumbent, skip the heavyweight
+      // evaluation -- except for a periodic audit slice, which is
+      // evaluated anyway to re-validate the filter and recalibrate its
+      // margin against the configured false-reject bound.
+      std::vector<double> surrogate_features;
+      bool surrogate_audit = false;
+      if (surrogate)
+      {
+        surrogate_features = surrogate->Features(mapping);
+        // A cache hit will deliver exact stats for free; never skip it.
+        if (!cache_hit && surrogate->PredictSkip(surrogate_features, incumbent_cost))
+        {
+          if (surrogate->ShouldAudit())
+          {
+            surrogate_audit = true;
+          }
+          else
+          {
+            // Treat like the cost-cutoff path: predicted valid-but-worse.
+            stats_.surrogate_skips++;
+            valid_mappings++;
+            live_.valid_mappings.fetch_add(1, std::memory_order_relaxed);
+            invalid_mappings_mapcnstr = 0;
+            invalid_mappings_eval = 0;
+            report_search(search::Status::Success, incumbent_cost);
+            if (penalize_consecutive_bypass_fails_ || !only_bypass_changed)
+            {
+              mappings_since_last_best_update++;
+            }
+            trace_outcome(true, true);
+            continue;
+          }
+        }
+      }
+
+      // On a cache hit, status_per_level still holds the (all-successful)
+      // pre-check results, so the accumulation below leaves success true.
+      if (!cache_hit)
+      {
+        profiler::Scope profile_scope("Engine::Evaluate");
+        status_per_level = engine.Evaluate(mapping, workload_, !diagnostics_on_, cutoff,
+                                           screen_top_k_ > 0);
+      }
       success &= std::accumulate(status_per_level.begin(), status_per_level.end(), true,
                                  [](bool cur, const model::EvalStatus& status)
                                  { return cur && status.success; });
+
+      // A cutoff abort means the mapping was valid but provably worse than
+      // the incumbent. Don't let it count as an invalid mapping or feed the
+      // search's eval-failure pruning; treat it like a valid mapping that
+      // failed to beat the incumbent.
+      if (!success &&
+          std::any_of(status_per_level.begin(), status_per_level.end(),
+                      [](const model::EvalStatus& status)
+                      { return status.fail_reason.rfind("cost cutoff", 0) == 0; }))
+      {
+        valid_mappings++;
+        live_.valid_mappings.fetch_add(1, std::memory_order_relaxed);
+        invalid_mappings_mapcnstr = 0;
+        invalid_mappings_eval = 0;
+        report_search(search::Status::Success, incumbent_cost);
+        if (penalize_consecutive_bypass_fails_ || !only_bypass_changed)
+        {
+          mappings_since_last_best_update++;
+        }
+        if (surrogate_audit)
+        {
+          // The cutoff abort proves this mapping is worse than the
+          // incumbent, so the audited skip decision was correct.
+          stats_.surrogate_audits++;
+          surrogate->AuditOutcome(false);
+        }
+        trace_outcome(true, true);
+        continue;
+      }
+
       if (!success)
       {
         // Evaluation failed.
+        if (surrogate_audit)
+        {
+          // The audited mapping turned out invalid: the skip decision was
+          // correct.
+          stats_.surrogate_audits++;
+          surrogate->AuditOutcome(false);
+        }
         // If the only change in this mapping vs. the previous mapping was in
         // its dataspace bypass scheme, then we may not want to make this
         // failure count towards the timeout termination trigger.
@@ -562,22 +1550,95 @@ class MapperThread
         {
           invalid_mappings_eval++;
         }
+        live_.capacity_fails.fetch_add(1, std::memory_order_relaxed);
 
         if (diagnostics_on_)
         {
           for (unsigned level = 0; level < status_per_level.size(); level++)
             if (!status_per_level.at(level).success)
-              stats_.UpdateFails(FailClass::Capacity, status_per_level.at(level).fail_reason, level, mapping);
+              stats_.UpdateFails(FailClass::Capacity, status_per_level.at(level).fail_reason, level,
+                                 mapping_id, mapspace_);
         }
-        search_->Report(search::Status::EvalFailure);
+        for (unsigned level = 0; level < status_per_level.size(); level++)
+          if (!status_per_level.at(level).success)
+            report_failure_detail(search::FailClass::Capacity, level);
+        report_search(search::Status::EvalFailure);
+        trace_outcome(true, false);
         continue;
       }
 
       // SUCCESS!!!
-      auto stats = engine.GetTopology().GetStats();
-      EvaluationResult result = { true, mapping, stats };
+      trace_outcome(true, true);
+      auto stats = cache_hit ? cached_stats : engine.GetTopology().GetStats();
+      EvaluationResult result = { true, mapping_id, mapspace_, stats, {} };
+
+      if (eval_cache_ && !cache_hit)
+      {
+        eval_cache_->Insert(cache_key, stats);
+      }
+
+      if (surrogate)
+      {
+        double actual_cost = Cost(stats, optimization_metrics_.at(0));
+        surrogate->Observe(surrogate_features, actual_cost);
+        if (surrogate_audit)
+        {
+          stats_.surrogate_audits++;
+          bool false_reject = incumbent_cost > 0 && actual_cost < incumbent_cost;
+          if (false_reject)
+          {
+            stats_.surrogate_false_rejects++;
+          }
+          surrogate->AuditOutcome(false_reject);
+        }
+      }
+
+      if (results_log)
+      {
+        resultslog::Record record;
+        record.mapping_id_lo = static_cast<std::uint64_t>(mapping_id.Integer());
+        record.mapping_id_hi = static_cast<std::uint64_t>(mapping_id.Integer() >> 64);
+        record.cycles = stats.cycles;
+        record.maccs = stats.maccs;
+        record.last_level_accesses = stats.last_level_accesses;
+        record.energy = stats.energy;
+        record.utilization = stats.utilization;
+        record.area = stats.area;
+        results_log->Append(record);
+      }
+
+      // Top-K retention and Pareto tracking. Note: in multi-fidelity mode
+      // these hold approximate stats; the screened candidates below are
+      // the ones that get exact re-evaluation.
+      if (num_best_mappings_ > 1)
+      {
+        UpdateBestMappings_(result);
+        if (optimization_metrics_.size() > 1)
+        {
+          UpdateParetoFrontier_(result);
+        }
+      }
+
+      // Multi-fidelity screening: remember the top-K candidates by
+      // approximate cost for exact re-evaluation after the search ends.
+      if (screen_top_k_ > 0)
+      {
+        double cost = Cost(stats, optimization_metrics_.at(0));
+        auto pos = std::upper_bound(screened.begin(), screened.end(), cost,
+                                    [](double c, const ScreenedCandidate& s)
+                                    { return c < s.cost; });
+        if (pos != screened.end() || screened.size() < screen_top_k_)
+        {
+          screened.insert(pos, ScreenedCandidate{ cost, mapping_id, mapspace_, mapping });
+          if (screened.size() > screen_top_k_)
+          {
+            screened.pop_back();
+          }
+        }
+      }
 
       valid_mappings++;
+      live_.valid_mappings.fetch_add(1, std::memory_order_relaxed);
       if (log_stats_)
       {
         mutex_->lock();
@@ -587,7 +1648,7 @@ class MapperThread
       }        
       invalid_mappings_mapcnstr = 0;
       invalid_mappings_eval = 0;
-      search_->Report(search::Status::Success, Cost(stats, optimization_metrics_.at(0)));
+      report_search(search::Status::Success, Cost(stats, optimization_metrics_.at(0)));
 
       if (log_suboptimal_)
       {
@@ -639,9 +1700,53 @@ class MapperThread
         }
       }
     } // while ()
-      
+
+    // Phase 2 of multi-fidelity search: the loop above screened the
+    // mapspace with approximate evaluations, so the incumbent's stats are
+    // approximate. Re-evaluate the screened candidates at full fidelity
+    // and replace the incumbent with the exact winner.
+    if (screen_top_k_ > 0)
+    {
+      stats_.thread_best = EvaluationResult();
+      for (auto& candidate: screened)
+      {
+        auto status_per_level = engine.Evaluate(candidate.mapping, workload_);
+        bool success = std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                                       [](bool cur, const model::EvalStatus& status)
+                                       { return cur && status.success; });
+        if (!success)
+        {
+          continue;
+        }
+        EvaluationResult result = { true, candidate.mapping_id, candidate.mapspace,
+                                    engine.GetTopology().GetStats(), {} };
+        stats_.thread_best.UpdateIfBetter(result, optimization_metrics_);
+      }
+
+      best_->UpdateIfBetter(stats_.thread_best, optimization_metrics_);
+
+      mutex_->lock();
+      log_stream_ << "[" << std::setw(3) << thread_id_ << "] re-evaluated "
+                  << screened.size() << " screened candidates at full fidelity."
+                  << std::endl;
+      mutex_->unlock();
+    }
+
     //
     // End Mapping.
     //
+
+    // Capture this thread's nest-cache counters and phase timers before the
+    // thread exits.
+    stats_.nest_memo_hits = analysis::NestAnalysis::MemoHits();
+    stats_.nest_memo_misses = analysis::NestAnalysis::MemoMisses();
+    stats_.phase_cycles = timer::Read();
+    auto perf_end = perf::Read();
+    for (unsigned c = 0; c < perf::NumCounters; c++)
+    {
+      stats_.run_perf[c] = perf_end[c] - perf_start[c];
+    }
+    stats_.phase_perf = perf::ReadPhases();
+    stats_.final_sync_interval = cur_sync_interval;
   }
 };
@@ -29,6 +29,9 @@
 
 #include <fstream>
 #include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <mutex>
 #include <iomanip>
 #include <ncurses.h>
@@ -41,6 +44,8 @@
 #include <boost/archive/xml_oarchive.hpp>
 
 #include "util/accelergy_interface.hpp"
+#include "workload/workload-registry.hpp"
+#include "mapping/parser.hpp"
 #include "mapspaces/mapspace-factory.hpp"
 #include "search/search-factory.hpp"
 #include "compound-config/compound-config.hpp"
@@ -59,19 +64,57 @@ class Application
 
   problem::Workload workload_;
 
+  // Batch mode: all workload instances parsed from a problem.instances
+  // list (empty in single-workload mode), interned through the workload
+  // registry so that repeated layer shapes share a single instance.
+  // workload_ holds a copy of the instance currently being mapped.
+  std::vector<std::shared_ptr<const problem::Workload>> batch_workloads_;
+  std::vector<std::string> batch_names_;
+
   model::Engine::Specs arch_specs_;
   mapspace::MapSpace* mapspace_;
   std::vector<mapspace::MapSpace*> split_mapspaces_;
   std::vector<search::SearchAlgorithm*> search_;
 
+  // Saved configuration nodes, for rebuilding the per-workload structures
+  // (mapspace and searches) between batch layers.
+  config::CompoundConfigNode arch_constraints_config_;
+  config::CompoundConfigNode mapspace_config_;
+  config::CompoundConfigNode search_config_;
+
   uint128_t search_size_;
   std::uint32_t num_threads_;
+  std::uint32_t split_factor_;
+  uint128_t checkpoint_interval_;
+  bool resume_;
+  bool warm_start_;
+  std::uint32_t worker_id_;
+  std::uint32_t worker_count_;
+  std::uint32_t screen_top_k_;
+  std::uint32_t num_best_mappings_;
+  bool results_log_;
+  bool search_trace_;
+  bool surrogate_filter_;
+  double surrogate_false_reject_;
+  bool pipeline_;
+  bool eval_cache_;
+  std::uint32_t eval_cache_entries_;
+  bool stats_json_;
+
+  // Workload-bounds sweep (see SweepBounds_()).
+  std::string sweep_dimension_;
+  std::vector<int> sweep_bounds_;
   std::uint32_t timeout_;
   std::uint32_t victory_condition_;
   uint128_t sync_interval_;
+  bool adaptive_sync_;
   bool log_stats_;
   bool log_suboptimal_;
   bool live_status_;
+  std::uint32_t status_interval_;
+  std::uint32_t artifact_interval_;
+  std::uint32_t shutdown_grace_period_;
+  std::string thread_pinning_;
   bool diagnostics_on_;
   bool penalize_consecutive_bypass_fails_;
   bool emit_whoop_nest_;
@@ -81,9 +124,17 @@ class Application
 
   char* cfg_string_;
 
-  EvaluationResult best_;
+  BestResultExchange best_;
   EvaluationResult global_best_;
 
+  // Distributed operation: best incumbent cost published by peer worker
+  // processes. Only the cost components are exchanged (a peer's mapping
+  // lives in a different split and cannot be reconstructed here), so this
+  // feeds the threads' branch-and-bound cutoffs but never global_best_.
+  // Guarded by the Run() mutex.
+  model::Topology::Stats remote_best_stats_;
+  bool remote_best_valid_;
+
  private:
 
   // Serialization
@@ -109,6 +160,29 @@ class Application
     // Problem configuration.
     auto problem = rootNode.lookup("problem");
     problem::ParseWorkload(problem, workload_);
+
+    // Batch mode: a problem.instances list maps several workload instances
+    // (sharing the problem shape, e.g., all layers of a network) in one
+    // invocation, re-using the parsed architecture, Accelergy tables and
+    // mapper configuration across them. Each instance may carry an
+    // optional name used to qualify its output files.
+    if (problem.exists("instances"))
+    {
+      auto instances = problem.lookup("instances");
+      for (int i = 0; i < instances.getLength(); i++)
+      {
+        problem::Workload workload;
+        problem::ParseWorkloadInstance(instances[i], workload);
+        batch_workloads_.push_back(problem::GetWorkloadRegistry().Intern(workload));
+        std::string instance_name = "layer" + std::to_string(i);
+        instances[i].lookupValue("name", instance_name);
+        batch_names_.push_back(instance_name);
+      }
+      std::cout << "Batch mode: " << batch_workloads_.size()
+                << " workload instances, "
+                << problem::GetWorkloadRegistry().NumUnique()
+                << " unique shapes." << std::endl;
+    }
     std::cout << "Problem configuration complete." << std::endl;
 
     // Mapper (this application) configuration.
@@ -183,6 +257,139 @@ class Application
       optimization_metrics_ = { "edp" };
     }
 
+    // Mapspace splits per thread. With a factor > 1 the mapspace is
+    // over-split and threads that exhaust their split (or hit their
+    // victory/timeout condition on it) steal an unexplored split from the
+    // shared pool instead of going idle.
+    split_factor_ = 1;
+    mapper.lookupValue("split-factor", split_factor_);
+    if (split_factor_ == 0)
+      split_factor_ = 1;
+
+    // Checkpoint interval (in mappings per thread, 0 = no checkpointing).
+    // Resume is requested via --resume on the command line (or the resume
+    // knob) and restores the per-thread snapshots written by a previous
+    // run with the same configuration.
+    std::uint32_t checkpoint_interval = 0;
+    mapper.lookupValue("checkpoint-interval", checkpoint_interval);
+    checkpoint_interval_ = checkpoint_interval;
+    resume_ = false;
+    mapper.lookupValue("resume", resume_);
+
+    // Warm-start: seed the search from a fully-specified mapping provided
+    // in the configuration's "mapping" node (the same format the model
+    // application consumes), e.g., the best mapping from a previous run.
+    // The mapping is translated back into mapspace coordinates and handed
+    // to the owning split's search algorithm as its starting point. A
+    // checkpoint resume takes precedence over a warm-start.
+    warm_start_ = false;
+    mapper.lookupValue("warm-start", warm_start_);
+
+    // Distributed operation: multiple worker processes on machines sharing
+    // a filesystem can cooperate on one search. Each worker claims a
+    // disjoint contiguous share of the mapspace splits and periodically
+    // publishes its incumbent's cost to <out_prefix>.incumbent.<id>, which
+    // peers fold into their branch-and-bound cutoffs. All workers must be
+    // launched with identical configurations except for the worker id.
+    worker_id_ = 0;
+    worker_count_ = 1;
+    mapper.lookupValue("distributed-worker-id", worker_id_);
+    mapper.lookupValue("distributed-worker-count", worker_count_);
+    if (worker_count_ == 0)
+      worker_count_ = 1;
+    if (worker_id_ >= worker_count_)
+    {
+      std::cerr << "ERROR: distributed-worker-id must be less than "
+                << "distributed-worker-count." << std::endl;
+      exit(1);
+    }
+    remote_best_valid_ = false;
+
+    // Stream every successfully evaluated mapping into per-thread binary
+    // logs (<out_prefix>.results.<tid>.bin, readable with
+    // timeloop-results-log) for offline cost-landscape analysis.
+    results_log_ = false;
+    mapper.lookupValue("results-log", results_log_);
+
+    // Record the exact per-thread sequence of attempted mappings and
+    // their outcomes (<out_prefix>.search-trace.<tid>.bin), replayable
+    // through timeloop-replay without the search algorithm.
+    search_trace_ = false;
+    mapper.lookupValue("search-trace", search_trace_);
+
+    // Learned pre-filter: each thread trains a surrogate cost model from
+    // its completed evaluations and skips mappings predicted far worse
+    // than the incumbent, auditing a slice of the skip decisions to hold
+    // the false-reject rate under the configured bound (see
+    // applications/mapper/surrogate.hpp).
+    surrogate_filter_ = false;
+    mapper.lookupValue("surrogate-filter", surrogate_filter_);
+    surrogate_false_reject_ = 0.01;
+    mapper.lookupValue("surrogate-false-reject", surrogate_false_reject_);
+
+    // Two-stage pipeline: each mapper thread pairs with a helper thread
+    // that runs the search and mapping construction a few mappings ahead,
+    // overlapping the decode-bound construct phase with the compute-bound
+    // evaluation (see applications/mapper/pipeline.hpp). Doubles the
+    // thread count; only takes effect for search algorithms that tolerate
+    // deferred outcome feedback (currently: random).
+    pipeline_ = false;
+    mapper.lookupValue("pipeline", pipeline_);
+
+    // Shared evaluation cache: different mapping IDs can construct
+    // semantically identical mappings, and different threads' splits can
+    // contain equivalent points. The cache maps a canonical form of the
+    // constructed mapping to its evaluated stats so repeats skip the nest
+    // analysis (see applications/mapper/eval-cache.hpp). Bounded at
+    // eval-cache-entries direct-mapped slots.
+    eval_cache_ = false;
+    mapper.lookupValue("eval-cache", eval_cache_);
+    eval_cache_entries_ = 65536;
+    mapper.lookupValue("eval-cache-entries", eval_cache_entries_);
+
+    // Also emit the final best mapping's full stats as a single compact
+    // JSON object (<out_prefix>.stats.json), for scripts that would
+    // otherwise scrape the text stats.
+    stats_json_ = false;
+    mapper.lookupValue("stats-json", stats_json_);
+
+    // Workload-bounds sweep: after the search, re-evaluate the best
+    // mapping at each listed bound of one problem dimension (e.g. batch
+    // sizes 1, 4, 16, 64) instead of running a full search per bound.
+    // See SweepBounds_().
+    sweep_dimension_ = "";
+    mapper.lookupValue("sweep-dimension", sweep_dimension_);
+    sweep_bounds_.clear();
+    if (mapper.exists("sweep-bounds"))
+    {
+      std::vector<std::string> bound_strings;
+      mapper.lookupArrayValue("sweep-bounds", bound_strings);
+      for (auto& bound_string: bound_strings)
+        sweep_bounds_.push_back(std::stoi(bound_string));
+      if (!sweep_bounds_.empty() && sweep_dimension_.empty())
+      {
+        std::cerr << "ERROR: mapper.sweep-bounds requires mapper.sweep-dimension."
+                  << std::endl;
+        exit(1);
+      }
+    }
+
+    // Number of best mappings to retain (per thread, and merged globally
+    // into <out_prefix>.best-mappings.txt after the search). Values > 1
+    // also enable (energy, cycles) Pareto-frontier tracking when multiple
+    // optimization metrics are configured.
+    num_best_mappings_ = 1;
+    mapper.lookupValue("num-best-mappings", num_best_mappings_);
+    if (num_best_mappings_ == 0)
+      num_best_mappings_ = 1;
+
+    // Multi-fidelity search: when set, threads screen the mapspace with
+    // approximate (sampled-multicast) evaluations and re-evaluate only
+    // their top-K candidates exactly once the search terminates. The final
+    // reported mapping and stats are always full-fidelity.
+    screen_top_k_ = 0;
+    mapper.lookupValue("screen-top-k", screen_top_k_);
+
     // Search size (divide between threads).
     std::uint32_t search_size = 0;
     mapper.lookupValue("search-size", search_size);
@@ -201,10 +408,15 @@ class Application
     victory_condition_ = 500;
     mapper.lookupValue("victory-condition", victory_condition_);
 
-    // Inter-thread sync interval.
+    // Inter-thread sync interval. By default the interval is adaptive:
+    // sync-interval sets the initial (and minimum) rate, and each thread
+    // backs off geometrically while the incumbent is stable.
     std::uint32_t sync_interval = 0;
     mapper.lookupValue("sync-interval", sync_interval);
     sync_interval_ = static_cast<uint128_t>(sync_interval);
+
+    adaptive_sync_ = true;
+    mapper.lookupValue("adaptive-sync", adaptive_sync_);
   
     // Misc.
     log_stats_ = false;
@@ -217,6 +429,51 @@ class Application
     live_status_ = false;
     mapper.lookupValue("live-status", live_status_);
 
+    // Periodic progress reporting (in seconds, 0 = off): print aggregate
+    // throughput, valid/fail rates and an ETA, and refresh a
+    // machine-readable <out_prefix>.status file that external tooling can
+    // poll. Unlike live-status this works on headless/batch runs (no
+    // terminal needed) and costs the search threads nothing beyond a few
+    // relaxed counter increments.
+    status_interval_ = 0;
+    mapper.lookupValue("status-interval", status_interval_);
+
+    // Asynchronous artifact writing (in seconds, 0 = off): a low-priority
+    // writer thread regenerates <out_prefix>.map.txt and .stats.txt
+    // whenever the global-best incumbent changes, so the best mapping
+    // found so far can be inspected mid-run (and survives a crash)
+    // without any search thread ever blocking on formatted I/O.
+    artifact_interval_ = 0;
+    mapper.lookupValue("artifact-interval", artifact_interval_);
+
+    // Bounded shutdown: once a termination signal arrives (SIGINT or a
+    // cluster preemption's SIGTERM), threads normally finish their
+    // ongoing evaluations before draining. If they have not drained
+    // within this many seconds, ongoing evaluations are abandoned
+    // (equivalent to a second signal) so that stats merging, artifacts
+    // and checkpoints still complete before the process is killed.
+    // 0 disables the watchdog.
+    shutdown_grace_period_ = 30;
+    mapper.lookupValue("shutdown-grace-period", shutdown_grace_period_);
+
+    // Thread placement policy. "none" (default) leaves scheduling to the
+    // OS. "sequential" pins thread t to CPU t, packing threads onto
+    // consecutive CPU IDs. "spread" spaces threads evenly across the CPU
+    // ID range, which distributes them across sockets when the kernel
+    // enumerates CPUs socket-major and fewer threads than CPUs are used.
+    // Pinning happens before each thread allocates its evaluation state,
+    // so first-touch placement keeps that state on the thread's local
+    // NUMA node.
+    thread_pinning_ = "none";
+    mapper.lookupValue("pin-threads", thread_pinning_);
+    if (thread_pinning_ != "none" && thread_pinning_ != "sequential" &&
+        thread_pinning_ != "spread")
+    {
+      std::cerr << "ERROR: unrecognized pin-threads policy: " << thread_pinning_
+                << ". Choose none, sequential or spread." << std::endl;
+      exit(1);
+    }
+
     diagnostics_on_ = false;
     mapper.lookupValue("diagnostics", diagnostics_on_);
 
@@ -253,18 +510,56 @@ class Application
     //   exit(1);
     // }
 
-    mapspace_ = mapspace::ParseAndConstruct(mapspace, arch_constraints, arch_specs_, workload_);
-    split_mapspaces_ = mapspace_->Split(num_threads_);
+    arch_constraints_config_ = arch_constraints;
+    mapspace_config_ = mapspace;
+    search_config_ = rootNode.lookup("mapper");
+    mapspace_ = nullptr;
 
-    std::cout << "Mapspace construction complete." << std::endl;
+    ConfigureSearch_();
 
-    // Search configuration.
-    auto search = rootNode.lookup("mapper");
-    for (unsigned t = 0; t < num_threads_; t++)
+    // Warm-start: translate the provided mapping into mapspace coordinates
+    // and seed the owning split's search algorithm with it.
+    if (warm_start_ && !resume_)
+    {
+      if (!rootNode.exists("mapping"))
+      {
+        std::cerr << "ERROR: warm-start requested but no \"mapping\" "
+                  << "directive found in configuration." << std::endl;
+        exit(1);
+      }
+      auto seed_mapping = mapping::ParseAndConstruct(rootNode.lookup("mapping"),
+                                                     arch_specs_, workload_);
+      bool seeded = false;
+      for (unsigned t = 0; t < num_threads_ * split_factor_ && !seeded; t++)
+      {
+        mapspace::ID seed_id;
+        if (split_mapspaces_.at(t)->TranslateMapping(seed_mapping, seed_id))
+        {
+          if (search_.at(t)->Seed(seed_id))
+          {
+            std::cout << "Warm-start: seeded split " << t
+                      << " with the provided mapping." << std::endl;
+          }
+          else
+          {
+            std::cout << "Warm-start: the configured search algorithm does "
+                      << "not support seeding; starting cold." << std::endl;
+          }
+          seeded = true;
+        }
+      }
+      if (!seeded)
+      {
+        std::cout << "Warm-start: the provided mapping is outside "
+                  << (worker_count_ > 1 ? "this worker's share of " : "")
+                  << "the constrained mapspace; starting cold." << std::endl;
+      }
+    }
+    else if (warm_start_ && resume_)
     {
-      search_.push_back(search::ParseAndConstruct(search, split_mapspaces_.at(t), t));
+      std::cout << "Warm-start: ignored because resume is set; checkpoint "
+                << "state takes precedence." << std::endl;
     }
-    std::cout << "Search configuration complete." << std::endl;
     // Store the complete configuration in a string.
     if (config->hasLConfig()) {
       std::size_t len;
@@ -304,17 +599,372 @@ class Application
     return global_best_;
   }
 
+  // Restore per-thread checkpoint snapshots (written by a previous run
+  // with checkpoint-interval set) before searching.
+  void EnableResume()
+  {
+    resume_ = true;
+  }
+
+ protected:
+
+  // Construct the mapspace and search algorithms for the current
+  // workload_. Called once at configuration time, and again between the
+  // layers of a batch run (the mapspace's factorization subspace depends
+  // on the workload bounds).
+  void ConfigureSearch_()
+  {
+    mapspace_ = mapspace::ParseAndConstruct(mapspace_config_, arch_constraints_config_,
+                                            arch_specs_, workload_);
+    auto splits_per_worker = num_threads_ * split_factor_;
+    if (worker_count_ > 1)
+    {
+      // Split across all workers, then keep this worker's contiguous
+      // share. The other splits stay owned by the parent mapspace; this
+      // worker simply never searches them.
+      auto all_splits = mapspace_->Split(splits_per_worker * worker_count_);
+      auto begin = all_splits.begin() + (worker_id_ * splits_per_worker);
+      split_mapspaces_.assign(begin, begin + splits_per_worker);
+    }
+    else
+    {
+      split_mapspaces_ = mapspace_->Split(splits_per_worker);
+    }
+
+    std::cout << "Mapspace construction complete." << std::endl;
+
+    // Search configuration: one search algorithm per mapspace split.
+    for (unsigned t = 0; t < num_threads_ * split_factor_; t++)
+    {
+      search_.push_back(search::ParseAndConstruct(search_config_, split_mapspaces_.at(t), t));
+    }
+    std::cout << "Search configuration complete." << std::endl;
+  }
+
+  // Tear down the per-workload structures in preparation for the next
+  // batch layer.
+  void ReleaseSearch_()
+  {
+    for (auto& search: search_)
+    {
+      delete search;
+    }
+    search_.clear();
+    // The splits are owned (and deleted) by the parent mapspace.
+    split_mapspaces_.clear();
+    delete mapspace_;
+    mapspace_ = nullptr;
+  }
+
+  // Emit the map-text and stats artifacts for a result. Shared between
+  // the final artifact pass after the search and the asynchronous
+  // incumbent writer; the latter passes atomic_replace so each file is
+  // staged to the side and renamed into place, keeping the artifacts
+  // readable mid-run.
+  void WriteArtifacts_(EvaluationResult& result, bool atomic_replace)
+  {
+    std::string map_txt_file_name = out_prefix_ + ".map.txt";
+    std::string stats_file_name = out_prefix_ + ".stats.txt";
+    std::string suffix = atomic_replace ? ".tmp" : "";
+
+    // Reconstruct the full mapping from its mapspace ID (the search
+    // threads exchange only the compact ID + stats record).
+    auto& mapping = result.GetMapping();
+
+    std::ofstream map_txt_file(map_txt_file_name + suffix);
+    mapping.PrettyPrint(map_txt_file, arch_specs_.topology.StorageLevelNames(),
+                        result.stats.tile_sizes);
+    map_txt_file.close();
+
+    // Re-evaluate the mapping so that we get a live engine with complete
+    // specs and stats that can be printed out hierarchically.
+    model::Engine engine;
+    engine.Spec(arch_specs_);
+    engine.Evaluate(mapping, workload_);
+
+    std::ofstream stats_file(stats_file_name + suffix);
+    stats_file << engine << std::endl;
+    stats_file.close();
+
+    if (atomic_replace)
+    {
+      rename((map_txt_file_name + suffix).c_str(), map_txt_file_name.c_str());
+      rename((stats_file_name + suffix).c_str(), stats_file_name.c_str());
+    }
+  }
+
+  // Workload-bounds sweep (mapper.sweep-dimension / mapper.sweep-bounds):
+  // re-evaluate the best mapping at each listed bound of the swept problem
+  // dimension instead of running a full search per bound. The dimension
+  // enters the analysis only through loop end counts and operation-space
+  // extents, so the mapping is transplanted by rescaling its outermost
+  // temporal loop over that dimension to cover the new bound -- the inner
+  // tiling (and hence the mapspace structure of every other dimension) is
+  // reused as-is, and each bound costs one evaluation. Bounds that the
+  // mapping's inner tiling does not divide are reported and skipped.
+  void SweepBounds_()
+  {
+    if (sweep_bounds_.empty() || !global_best_.valid)
+      return;
+
+    auto& name_to_id = problem::GetShape()->DimensionNameToID;
+    auto dim_it = name_to_id.find(sweep_dimension_);
+    if (dim_it == name_to_id.end())
+    {
+      std::cerr << "WARNING: sweep-dimension " << sweep_dimension_
+                << " is not a dimension of this problem shape; skipping the "
+                << "bounds sweep." << std::endl;
+      return;
+    }
+    auto dim = dim_it->second;
+
+    // Locate the outermost temporal loop over the swept dimension; the
+    // product of all its other loops is the inner tiling, which stays
+    // fixed across the sweep.
+    auto& loops = global_best_.GetMapping().loop_nest.loops;
+    int outer_index = -1;
+    int inner_product = 1;
+    for (int i = loops.size() - 1; i >= 0; i--)
+    {
+      auto& loop = loops.at(i);
+      if (loop.dimension != dim)
+        continue;
+      if (outer_index < 0 && !loop::IsSpatial(loop.spacetime_dimension))
+        outer_index = i;
+      else
+        inner_product *= loop.end;
+    }
+    if (outer_index < 0)
+    {
+      std::cerr << "WARNING: the best mapping has no temporal loop over "
+                << sweep_dimension_ << "; skipping the bounds sweep."
+                << std::endl;
+      return;
+    }
+
+    std::cout << std::endl << "Sweeping " << sweep_dimension_
+              << " bounds over the best mapping:" << std::endl;
+
+    for (auto bound: sweep_bounds_)
+    {
+      std::string tag = sweep_dimension_ + std::to_string(bound);
+
+      if (bound <= 0 || bound % inner_product != 0)
+      {
+        std::cout << "  " << std::setw(8) << std::left << tag << std::right
+                  << " skipped: the mapping's inner " << sweep_dimension_
+                  << "-tiling (" << inner_product
+                  << ") does not divide this bound." << std::endl;
+        continue;
+      }
+
+      Mapping mapping = global_best_.GetMapping();
+      mapping.loop_nest.loops.at(outer_index).end = bound / inner_product;
+
+      problem::Workload workload = workload_;
+      problem::Workload::Bounds bounds;
+      for (unsigned d = 0; d < problem::GetShape()->NumDimensions; d++)
+        bounds[d] = workload_.GetBound(d);
+      bounds[dim] = bound;
+      workload.SetBounds(bounds);
+
+      model::Engine engine;
+      engine.Spec(arch_specs_);
+      engine.Evaluate(mapping, workload, false);
+      if (!engine.IsEvaluated())
+      {
+        std::cout << "  " << std::setw(8) << std::left << tag << std::right
+                  << " transplanted mapping is invalid at this bound."
+                  << std::endl;
+        continue;
+      }
+
+      auto& stats = engine.GetTopology().GetStats();
+      std::cout << "  " << std::setw(8) << std::left << tag << std::right
+                << " energy = " << stats.energy
+                << " | cycles = " << stats.cycles << std::endl;
+
+      std::string stats_file_name = out_prefix_ + ".sweep." + tag + ".stats.txt";
+      std::ofstream stats_file(stats_file_name);
+      stats_file << engine << std::endl;
+      stats_file.close();
+
+      if (stats_json_)
+      {
+        std::ofstream stats_json_file(out_prefix_ + ".sweep." + tag + ".stats.json");
+        engine.GetTopology().PrintStatsJSON(stats_json_file);
+        stats_json_file.close();
+      }
+    }
+  }
+
+  std::string IncumbentPath_(std::uint32_t worker) const
+  {
+    return out_prefix_ + ".incumbent." + std::to_string(worker);
+  }
+
+  // Publish this worker's incumbent cost for peer workers to read.
+  // Written atomically (tmp + rename) so readers never see a torn file.
+  void PublishIncumbent_()
+  {
+    auto snapshot = best_.Load();
+    if (!snapshot || !snapshot->valid)
+      return;
+
+    double energy = snapshot->stats.energy;
+    std::uint64_t cycles = snapshot->stats.cycles;
+    std::uint64_t last_level_accesses = snapshot->stats.last_level_accesses;
+
+    std::string path = IncumbentPath_(worker_id_);
+    std::string tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path);
+    out << 1 << ' ' << std::setprecision(17) << energy << ' '
+        << cycles << ' ' << last_level_accesses << '\n';
+    out.close();
+    rename(tmp_path.c_str(), path.c_str());
+  }
+
+  // Read an incumbent file published by a worker. Returns false if the
+  // file does not exist (yet) or cannot be parsed.
+  bool ReadIncumbent_(std::uint32_t worker, model::Topology::Stats& stats) const
+  {
+    std::ifstream in(IncumbentPath_(worker));
+    int valid = 0;
+    double energy;
+    std::uint64_t cycles;
+    std::uint64_t last_level_accesses;
+    if (!(in >> valid >> energy >> cycles >> last_level_accesses) || valid != 1)
+      return false;
+    stats.energy = energy;
+    stats.cycles = cycles;
+    stats.last_level_accesses = last_level_accesses;
+    return true;
+  }
+
+  // Fold peer workers' published incumbents into the shared remote-best.
+  void FetchRemoteIncumbents_(std::mutex& mutex)
+  {
+    for (std::uint32_t w = 0; w < worker_count_; w++)
+    {
+      if (w == worker_id_)
+        continue;
+      model::Topology::Stats remote;
+      if (!ReadIncumbent_(w, remote))
+        continue;
+      mutex.lock();
+      if (!remote_best_valid_ ||
+          Cost(remote, optimization_metrics_.at(0)) <
+          Cost(remote_best_stats_, optimization_metrics_.at(0)))
+      {
+        remote_best_stats_ = remote;
+        remote_best_valid_ = true;
+      }
+      mutex.unlock();
+    }
+  }
+
+ public:
+
   // ---------------
   // Run the mapper.
   // ---------------
   void Run()
+  {
+    if (batch_workloads_.empty())
+    {
+      SearchWorkload_();
+      return;
+    }
+
+    // Batch mode: map each instance in sequence, rebuilding only the
+    // per-workload structures between layers (the architecture, Accelergy
+    // tables and mapper configuration are parsed once). The registry
+    // interned duplicate layer shapes to the same shared instance, so
+    // an already-mapped twin is detected by instance identity and its
+    // result replicated instead of searched again (repeated blocks of a
+    // ResNet collapse to one search each).
+    auto base_prefix = out_prefix_;
+    std::vector<EvaluationResult> batch_results;
+    std::map<const problem::Workload*, unsigned> first_mapped;
+    for (unsigned i = 0; i < batch_workloads_.size(); i++)
+    {
+      unsigned twin = i;
+      auto first_it = first_mapped.find(batch_workloads_.at(i).get());
+      if (first_it != first_mapped.end())
+        twin = first_it->second;
+      else
+        first_mapped[batch_workloads_.at(i).get()] = i;
+      if (twin != i)
+      {
+        std::cout << std::endl << "=== " << batch_names_.at(i)
+                  << ": identical to " << batch_names_.at(twin)
+                  << ", re-using its mapping (see the " << batch_names_.at(twin)
+                  << ".* output files) ===" << std::endl;
+        batch_results.push_back(batch_results.at(twin));
+        continue;
+      }
+
+      if (i > 0)
+      {
+        // Rebuild the per-workload structures and reset the incumbents.
+        workload_ = *batch_workloads_.at(i);
+        ReleaseSearch_();
+        best_.Reset();
+        global_best_ = EvaluationResult();
+        remote_best_valid_ = false;
+        ConfigureSearch_();
+      }
+
+      std::cout << std::endl << "=== Mapping " << batch_names_.at(i)
+                << " ===" << std::endl;
+      out_prefix_ = base_prefix + "." + batch_names_.at(i);
+      SearchWorkload_();
+      batch_results.push_back(global_best_);
+    }
+    out_prefix_ = base_prefix;
+
+    std::cout << std::endl << "Batch summary:" << std::endl;
+    double total_energy = 0;
+    std::uint64_t total_cycles = 0;
+    bool all_valid = true;
+    for (unsigned i = 0; i < batch_results.size(); i++)
+    {
+      auto& result = batch_results.at(i);
+      std::cout << "  " << std::setw(16) << std::left << batch_names_.at(i)
+                << std::right;
+      if (result.valid)
+      {
+        std::cout << " energy = " << result.stats.energy
+                  << " | cycles = " << result.stats.cycles << std::endl;
+        total_energy += result.stats.energy;
+        total_cycles += result.stats.cycles;
+      }
+      else
+      {
+        std::cout << " no valid mapping found" << std::endl;
+        all_valid = false;
+      }
+    }
+    if (all_valid)
+    {
+      std::cout << "  " << std::setw(16) << std::left << "total" << std::right
+                << " energy = " << total_energy
+                << " | cycles = " << total_cycles << std::endl;
+    }
+  }
+
+ protected:
+
+  // ------------------------------------------------
+  // Search the workload currently held in workload_.
+  // ------------------------------------------------
+  void SearchWorkload_()
   {
     // Output file names.
     std::string log_file_name = out_prefix_ + ".log";
-    std::string stats_file_name = out_prefix_ + ".stats.txt";
     std::string xml_file_name = out_prefix_ + ".map+stats.xml";
-    std::string map_txt_file_name = out_prefix_ + ".map.txt";
     std::string map_cfg_file_name = out_prefix_ + ".map.cfg";
+    std::string map_yaml_file_name = out_prefix_ + ".map.yaml";
     std::string map_cpp_file_name = out_prefix_ + ".map.cpp";
     
     // Prepare live status/log stream.
@@ -353,11 +1003,31 @@ class Application
       refresh();
     }
 
-    // Prepare the threads.
+    // Prepare the threads. Each thread starts on its own split; the
+    // remaining (over-split) splits form a shared pool that idle threads
+    // steal from.
     std::mutex mutex;
+    std::atomic<std::uint32_t> next_split(num_threads_);
     std::vector<MapperThread*> threads_;
+
+    // Evaluation cache shared by this search's threads. Scoped to this
+    // workload: canonical keys do not encode the workload, so a fresh
+    // cache is built for each SearchWorkload_ invocation.
+    std::unique_ptr<EvalCache> eval_cache;
+    if (eval_cache_)
+    {
+      eval_cache.reset(new EvalCache(eval_cache_entries_));
+    }
+
+    unsigned num_cpus = std::max(1u, std::thread::hardware_concurrency());
     for (unsigned t = 0; t < num_threads_; t++)
     {
+      int pin_cpu = -1;
+      if (thread_pinning_ == "sequential")
+        pin_cpu = t % num_cpus;
+      else if (thread_pinning_ == "spread")
+        pin_cpu = (t * num_cpus / num_threads_) % num_cpus;
+
       threads_.push_back(new MapperThread(t, search_.at(t),
                                           split_mapspaces_.at(t),
                                           &mutex,
@@ -374,7 +1044,25 @@ class Application
                                           optimization_metrics_,
                                           arch_specs_,
                                           workload_,
-                                          &best_));
+                                          &best_,
+                                          &search_,
+                                          &split_mapspaces_,
+                                          &next_split,
+                                          out_prefix_,
+                                          checkpoint_interval_,
+                                          resume_,
+                                          &remote_best_stats_,
+                                          &remote_best_valid_,
+                                          screen_top_k_,
+                                          adaptive_sync_,
+                                          num_best_mappings_,
+                                          results_log_,
+                                          search_trace_,
+                                          surrogate_filter_,
+                                          surrogate_false_reject_,
+                                          pipeline_,
+                                          eval_cache.get(),
+                                          pin_cpu));
     }
 
     // Launch the threads.
@@ -383,12 +1071,254 @@ class Application
       threads_.at(t)->Start();
     }
 
+    // Shutdown watchdog: after a termination signal, give the threads a
+    // bounded grace period to finish their ongoing evaluations, then
+    // force evaluations to abort so the post-search reporting below
+    // still runs before the scheduler kills the process.
+    std::atomic<bool> watchdog_done(false);
+    std::thread watchdog;
+    if (shutdown_grace_period_ > 0)
+    {
+      watchdog = std::thread([&]()
+      {
+        while (!watchdog_done && !gTerminate)
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        for (unsigned i = 0; i < shutdown_grace_period_ * 10 && !watchdog_done; i++)
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (!watchdog_done && !gTerminateEval)
+        {
+          std::cerr << "Shutdown grace period (" << shutdown_grace_period_
+                    << "s) expired, abandoning ongoing evaluations."
+                    << std::endl;
+          gTerminateEval = true;
+        }
+      });
+    }
+
+    // Distributed incumbent exchange: periodically publish our best cost
+    // and pick up our peers'. The mapper threads fold the remote incumbent
+    // into their branch-and-bound cutoffs.
+    std::atomic<bool> exchange_done(false);
+    std::thread exchanger;
+    if (worker_count_ > 1)
+    {
+      exchanger = std::thread([&]()
+      {
+        while (!exchange_done)
+        {
+          PublishIncumbent_();
+          FetchRemoteIncumbents_(mutex);
+          for (unsigned i = 0; i < 100 && !exchange_done; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+      });
+    }
+
+    // Periodic progress reporting: sample each thread's live counters,
+    // print aggregate throughput, valid/fail-class rates and an ETA, and
+    // refresh <out_prefix>.status for external polling. The status file is
+    // written to the side and renamed into place so a poller never sees a
+    // partial write.
+    std::atomic<bool> status_done(false);
+    std::thread status_reporter;
+    if (status_interval_ > 0)
+    {
+      status_reporter = std::thread([&]()
+      {
+        std::string status_file_name = out_prefix_ + ".status";
+        std::string status_temp_name = status_file_name + ".tmp";
+
+        auto start = std::chrono::steady_clock::now();
+        auto prev_time = start;
+        std::vector<std::uint64_t> prev_total(num_threads_, 0);
+        std::vector<std::uint64_t> prev_valid(num_threads_, 0);
+
+        while (!status_done)
+        {
+          for (unsigned i = 0; i < status_interval_ * 10 && !status_done; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+          if (status_done)
+            break;
+
+          auto now = std::chrono::steady_clock::now();
+          double interval = std::chrono::duration<double>(now - prev_time).count();
+          double elapsed = std::chrono::duration<double>(now - start).count();
+          prev_time = now;
+
+          std::uint64_t total = 0;
+          std::uint64_t valid = 0;
+          std::uint64_t fanout = 0;
+          std::uint64_t capacity = 0;
+          std::uint64_t delta_total = 0;
+          std::uint64_t delta_valid = 0;
+          uint128_t remaining = 0;
+
+          std::ofstream status_file(status_temp_name);
+          status_file << "# elapsed_sec thread total valid fanout_fails "
+                      << "capacity_fails maps_per_sec" << std::endl;
+
+          for (unsigned t = 0; t < num_threads_; t++)
+          {
+            auto& live = threads_.at(t)->GetLiveCounters();
+            auto t_total = live.total_mappings.load(std::memory_order_relaxed);
+            auto t_valid = live.valid_mappings.load(std::memory_order_relaxed);
+            auto t_fanout = live.fanout_fails.load(std::memory_order_relaxed);
+            auto t_capacity = live.capacity_fails.load(std::memory_order_relaxed);
+
+            double t_rate = interval > 0 ?
+              (t_total - prev_total.at(t)) / interval : 0;
+            delta_total += t_total - prev_total.at(t);
+            delta_valid += t_valid - prev_valid.at(t);
+            prev_total.at(t) = t_total;
+            prev_valid.at(t) = t_valid;
+
+            total += t_total;
+            valid += t_valid;
+            fanout += t_fanout;
+            capacity += t_capacity;
+
+            // search_size_ is a per-thread budget of valid mappings.
+            if (search_size_ > 0 && search_size_ > t_valid)
+              remaining += search_size_ - t_valid;
+
+            status_file << std::fixed << std::setprecision(1) << elapsed
+                        << ' ' << t << ' ' << t_total << ' ' << t_valid
+                        << ' ' << t_fanout << ' ' << t_capacity
+                        << ' ' << t_rate << std::endl;
+          }
+
+          double rate = interval > 0 ? delta_total / interval : 0;
+          double valid_rate = interval > 0 ? delta_valid / interval : 0;
+
+          // ETA against the search-size budget; with no budget the search
+          // ends on a victory/timeout trigger we cannot predict.
+          bool have_eta = search_size_ > 0 && valid_rate > 0;
+          double eta = have_eta ? remaining.convert_to<double>() / valid_rate : 0;
+
+          std::ostringstream msg;
+          msg << "STATUS: " << std::fixed << std::setprecision(0) << elapsed
+              << "s elapsed | " << std::setprecision(1) << rate
+              << " maps/sec | total " << total;
+          if (total > 0)
+          {
+            msg << " | valid " << std::setprecision(1)
+                << (100.0 * valid / total)
+                << "% | fanout-fail " << (100.0 * fanout / total)
+                << "% | capacity-fail " << (100.0 * capacity / total) << "%";
+          }
+          if (have_eta)
+            msg << " | ETA " << std::setprecision(0) << eta << "s";
+          else if (search_size_ > 0)
+            msg << " | ETA unknown (no valid mappings in last interval)";
+
+          status_file << msg.str() << std::endl;
+          status_file.close();
+          rename(status_temp_name.c_str(), status_file_name.c_str());
+
+          mutex.lock();
+          std::cerr << msg.str() << std::endl;
+          mutex.unlock();
+        }
+      });
+    }
+
+    // Asynchronous artifact writer: regenerate the map-text and stats
+    // artifacts whenever the published incumbent changes, off the search
+    // threads' critical path. The BestResultExchange snapshot doubles as
+    // the handoff queue -- threads already CAS-publish an immutable copy
+    // of every new incumbent, so the writer just watches for a new
+    // snapshot pointer and formats from its own private copy. The final
+    // synchronous pass after the search overwrites these with the
+    // canonical artifacts (including the XML archive).
+    std::atomic<bool> artifacts_done(false);
+    std::thread artifact_writer;
+    if (artifact_interval_ > 0)
+    {
+      artifact_writer = std::thread([&]()
+      {
+#ifdef __linux__
+        // Formatted I/O should never compete with search threads for a
+        // core: demote the writer to idle scheduling.
+        struct sched_param idle_param = {};
+        pthread_setschedparam(pthread_self(), SCHED_IDLE, &idle_param);
+#endif
+        std::shared_ptr<const EvaluationResult> last_written;
+        while (!artifacts_done)
+        {
+          for (unsigned i = 0; i < artifact_interval_ * 10 && !artifacts_done; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+          auto incumbent = best_.Load();
+          if (!incumbent || !incumbent->valid || incumbent == last_written)
+            continue;
+
+          EvaluationResult snapshot = *incumbent;
+          WriteArtifacts_(snapshot, true);
+          last_written = incumbent;
+        }
+      });
+    }
+
     // Wait for the threads to join.
     for (unsigned t = 0; t < num_threads_; t++)
     {
       threads_.at(t)->Join();
     }
 
+    if (shutdown_grace_period_ > 0)
+    {
+      watchdog_done = true;
+      watchdog.join();
+    }
+
+    if (status_interval_ > 0)
+    {
+      status_done = true;
+      status_reporter.join();
+    }
+
+    if (artifact_interval_ > 0)
+    {
+      artifacts_done = true;
+      artifact_writer.join();
+    }
+
+    // Publish our final incumbent and report the merged outcome: worker 0
+    // compares all incumbents published so far and names the winner.
+    if (worker_count_ > 1)
+    {
+      exchange_done = true;
+      exchanger.join();
+      PublishIncumbent_();
+
+      if (worker_id_ == 0)
+      {
+        bool found = false;
+        std::uint32_t best_worker = 0;
+        double best_cost = 0;
+        for (std::uint32_t w = 0; w < worker_count_; w++)
+        {
+          model::Topology::Stats stats;
+          if (!ReadIncumbent_(w, stats))
+            continue;
+          double cost = Cost(stats, optimization_metrics_.at(0));
+          if (!found || cost < best_cost)
+          {
+            found = true;
+            best_worker = w;
+            best_cost = cost;
+          }
+        }
+        if (found)
+        {
+          std::cerr << "Distributed search: best incumbent published so far "
+                    << "is from worker " << best_worker << " with cost "
+                    << best_cost << " (" << optimization_metrics_.at(0)
+                    << ")." << std::endl;
+        }
+      }
+    }
+
     // Close log and end curses.
     if (live_status_)
     {
@@ -404,48 +1334,28 @@ class Application
     // Diagnostics.
     if (diagnostics_on_)
     {
-      // Aggregate diagnostic data from all threads.
-      std::map<FailClass, std::map<unsigned, FailInfo>> fail_stats;
-      
+      // Aggregate diagnostic data from all threads. The per-thread stats
+      // are flat (fail class x level) bucket arrays: sum the counts and
+      // keep the first sampled mapping seen for each bucket.
+      auto num_levels = arch_specs_.topology.NumLevels();
+      std::vector<FailInfo> fail_stats(NumFailClasses * num_levels);
+
       for (unsigned t = 0; t < num_threads_; t++)
       {
-        for (auto& i: threads_.at(t)->GetStats().fail_stats)
+        auto& thread_fail_stats = threads_.at(t)->GetStats().fail_stats;
+        for (unsigned bucket = 0; bucket < thread_fail_stats.size(); bucket++)
         {
-          auto& thread_fail_class = i.first;
-          auto& thread_fail_bucket = i.second;
-
-          auto fail_bucket_it = fail_stats.find(thread_fail_class);
-          if (fail_bucket_it == fail_stats.end())
+          auto& thread_fail_info = thread_fail_stats.at(bucket);
+          auto& fail_info = fail_stats.at(bucket);
+          fail_info.count += thread_fail_info.count;
+          if (fail_info.mapspace == nullptr && thread_fail_info.mapspace != nullptr)
           {
-            // We've never seen this fail class before.
-            fail_stats[thread_fail_class] = thread_fail_bucket;
-          }
-          else
-          {
-            auto& fail_bucket = fail_bucket_it->second;
-            
-            // We've seen this fail class. Walk through each level in this fail bucket.
-            for (auto& j: thread_fail_bucket)
-            {
-              auto& thread_fail_level_id = j.first;
-              auto& thread_fail_info = j.second;
-
-              auto fail_info_it = fail_bucket.find(thread_fail_level_id);
-              if (fail_info_it == fail_bucket.end())
-              {
-                // We haven't seen this level within this fail bucket.
-                fail_bucket[thread_fail_level_id] = thread_fail_info;
-              }
-              else
-              {
-                // We've seen this level within this fail bucket.
-                fail_info_it->second.count += thread_fail_info.count;
-              }
-            }
+            fail_info.mapping_id = thread_fail_info.mapping_id;
+            fail_info.mapspace = thread_fail_info.mapspace;
+            fail_info.reason = thread_fail_info.reason;
           }
         }
       }
-        
 
       // Print.
       std::cout << std::endl;
@@ -453,23 +1363,38 @@ class Application
       std::cout << "               BEGIN DIAGNOSTICS               " << std::endl;
       std::cout << "-----------------------------------------------" << std::endl;
 
-      for (auto& i: fail_stats)
+      for (unsigned fail_class_id = 0; fail_class_id < NumFailClasses; fail_class_id++)
       {
-        auto& fail_class = i.first;
-        auto& fail_bucket = i.second;
-        
+        auto fail_class = FailClass(fail_class_id);
+
+        bool any_fails = false;
+        for (unsigned level = 0; level < num_levels; level++)
+          any_fails |= (fail_stats.at(fail_class_id * num_levels + level).count != 0);
+        if (!any_fails)
+          continue;
+
         std::cout << "Fail class: " << fail_class << std::endl;
-        for (auto& j: fail_bucket)
+        for (unsigned level = 0; level < num_levels; level++)
         {
+          auto& fail_info = fail_stats.at(fail_class_id * num_levels + level);
+          if (fail_info.count == 0)
+            continue;
+
           std::cout << std::endl;
-          std::cout << "  Level: " << arch_specs_.topology.GetLevel(j.first)->level_name << std::endl;
-          std::cout << "    Fail count: " << j.second.count << std::endl;
+          std::cout << "  Level: " << arch_specs_.topology.GetLevel(level)->level_name << std::endl;
+          std::cout << "    Fail count: " << fail_info.count << std::endl;
           std::cout << "    Sample mapping that experienced this fail class:" << std::endl;
 
-          auto& mapping = j.second.mapping;
+          // Reconstruct the sample mapping from its mapspace ID. This is
+          // the one place the full Mapping object is needed, so we pay the
+          // construction cost here instead of on the search's failure path.
+          // Construction may legally fail (that's what a Fanout-class
+          // sample is); we print whatever was constructed, as before.
+          Mapping mapping;
+          fail_info.mapspace->ConstructMapping(fail_info.mapping_id, &mapping, false);
 
           // Ugh. This is an abstration-breaking hack that looks at the fail class
-          // to determine what to print. If 
+          // to determine what to print. If
 //          if (fail_class != FailClass::Fanout)
 //          {
             model::Engine engine;
@@ -484,7 +1409,7 @@ class Application
 //                                engine.GetTopology().GetStats().tile_sizes, "      ");
 //          }
 
-          std::cout << "    Fail reason: " << j.second.reason << std::endl;
+          std::cout << "    Fail reason: " << fail_info.reason.Format() << std::endl;
           std::cout << std::endl;
         }
       }
@@ -501,6 +1426,254 @@ class Application
       global_best_.UpdateIfBetter(thread_best, optimization_metrics_);
     }
 
+    // Merge the per-thread top-K retention lists (and Pareto frontiers)
+    // and emit them for offline inspection.
+    if (num_best_mappings_ > 1)
+    {
+      std::vector<EvaluationResult> merged;
+      for (unsigned t = 0; t < num_threads_; t++)
+      {
+        auto& retained = threads_.at(t)->GetStats().best_mappings;
+        merged.insert(merged.end(), retained.begin(), retained.end());
+      }
+      std::sort(merged.begin(), merged.end(),
+                [this](const EvaluationResult& a, const EvaluationResult& b)
+                { return IsBetter(a.stats, b.stats, optimization_metrics_); });
+      if (merged.size() > num_best_mappings_)
+      {
+        merged.resize(num_best_mappings_);
+      }
+
+      std::string best_mappings_file_name = out_prefix_ + ".best-mappings.txt";
+      std::ofstream best_mappings_file(best_mappings_file_name);
+
+      best_mappings_file << "Top-" << merged.size() << " mappings (metric order:";
+      for (auto& metric: optimization_metrics_)
+      {
+        best_mappings_file << " " << metric;
+      }
+      best_mappings_file << "):" << std::endl;
+      for (unsigned rank = 0; rank < merged.size(); rank++)
+      {
+        auto& result = merged.at(rank);
+        best_mappings_file << "[" << std::setw(3) << rank << "]"
+                           << " energy = " << result.stats.energy
+                           << " | cycles = " << result.stats.cycles
+                           << " | edp = " << (result.stats.energy * result.stats.cycles)
+                           << " | " << result.GetMapping().PrintCompact()
+                           << std::endl;
+      }
+
+      if (optimization_metrics_.size() > 1)
+      {
+        // Merge the per-thread frontiers with the same dominance filter
+        // the threads apply locally.
+        std::vector<EvaluationResult> frontier;
+        for (unsigned t = 0; t < num_threads_; t++)
+        {
+          for (auto& candidate: threads_.at(t)->GetStats().pareto_frontier)
+          {
+            bool dominated = false;
+            for (auto& entry: frontier)
+            {
+              if (entry.stats.energy <= candidate.stats.energy &&
+                  entry.stats.cycles <= candidate.stats.cycles)
+              {
+                dominated = true;
+                break;
+              }
+            }
+            if (dominated)
+            {
+              continue;
+            }
+            frontier.erase(std::remove_if(frontier.begin(), frontier.end(),
+                                          [&candidate](const EvaluationResult& entry)
+                                          { return candidate.stats.energy <= entry.stats.energy &&
+                                                   candidate.stats.cycles <= entry.stats.cycles; }),
+                           frontier.end());
+            frontier.push_back(candidate);
+          }
+        }
+        std::sort(frontier.begin(), frontier.end(),
+                  [](const EvaluationResult& a, const EvaluationResult& b)
+                  { return a.stats.energy < b.stats.energy; });
+
+        best_mappings_file << std::endl;
+        best_mappings_file << "(energy, cycles) Pareto frontier:" << std::endl;
+        for (auto& entry: frontier)
+        {
+          best_mappings_file << "  energy = " << entry.stats.energy
+                             << " | cycles = " << entry.stats.cycles
+                             << " | " << entry.GetMapping().PrintCompact()
+                             << std::endl;
+        }
+      }
+
+      best_mappings_file.close();
+      std::cout << "Retained top-" << merged.size() << " mappings in "
+                << best_mappings_file_name << "." << std::endl;
+    }
+
+    // Aggregate and report nest-analysis cache effectiveness.
+    std::uint64_t nest_memo_hits = 0;
+    std::uint64_t nest_memo_misses = 0;
+    for (unsigned t = 0; t < num_threads_; t++)
+    {
+      nest_memo_hits += threads_.at(t)->GetStats().nest_memo_hits;
+      nest_memo_misses += threads_.at(t)->GetStats().nest_memo_misses;
+    }
+    if (nest_memo_hits + nest_memo_misses > 0)
+    {
+      std::cout << "Nest analysis cache: " << nest_memo_hits << " hits, "
+                << nest_memo_misses << " misses ("
+                << std::fixed << std::setprecision(2)
+                << (100.0 * nest_memo_hits) / (nest_memo_hits + nest_memo_misses)
+                << "% hit rate)." << std::endl;
+    }
+
+    // Report the observed inter-thread sync schedule.
+    if (sync_interval_ > 0)
+    {
+      std::cout << "Inter-thread sync schedule (configured interval = "
+                << sync_interval_ << (adaptive_sync_ ? ", adaptive" : ", fixed")
+                << "):" << std::endl;
+      for (unsigned t = 0; t < num_threads_; t++)
+      {
+        auto& stats = threads_.at(t)->GetStats();
+        std::cout << "  [" << std::setw(3) << t << "]"
+                  << " syncs = " << stats.sync_count
+                  << ", resets = " << stats.sync_resets
+                  << ", max interval = " << stats.max_sync_interval
+                  << ", final interval = " << stats.final_sync_interval
+                  << std::endl;
+      }
+    }
+
+    // Report surrogate pre-filter effectiveness.
+    if (surrogate_filter_)
+    {
+      std::uint64_t skips = 0, audits = 0, false_rejects = 0;
+      for (unsigned t = 0; t < num_threads_; t++)
+      {
+        auto& stats = threads_.at(t)->GetStats();
+        skips += stats.surrogate_skips;
+        audits += stats.surrogate_audits;
+        false_rejects += stats.surrogate_false_rejects;
+      }
+      std::cout << "Surrogate pre-filter (all threads): "
+                << "skipped = " << skips
+                << ", audited = " << audits
+                << ", false rejects = " << false_rejects;
+      if (audits > 0)
+      {
+        std::cout << " (" << std::fixed << std::setprecision(2)
+                  << (100.0 * double(false_rejects) / double(audits))
+                  << "% of audits, bound = "
+                  << (100.0 * surrogate_false_reject_) << "%)";
+      }
+      std::cout << std::endl;
+    }
+
+    // Report shared evaluation-cache effectiveness.
+    if (eval_cache_)
+    {
+      std::uint64_t lookups = 0, hits = 0;
+      for (unsigned t = 0; t < num_threads_; t++)
+      {
+        auto& stats = threads_.at(t)->GetStats();
+        lookups += stats.eval_cache_lookups;
+        hits += stats.eval_cache_hits;
+      }
+      std::cout << "Evaluation cache (all threads): "
+                << "hits = " << hits << " / " << lookups << " lookups";
+      if (lookups > 0)
+      {
+        std::cout << " (" << std::fixed << std::setprecision(2)
+                  << (100.0 * double(hits) / double(lookups)) << "%)";
+      }
+      std::cout << std::endl;
+    }
+
+    // Report per-phase evaluation cycles (only populated by timer-enabled
+    // builds, see util/cycle-timer.hpp).
+    timer::PhaseCycles phase_cycles = {};
+    std::uint64_t total_phase_cycles = 0;
+    for (unsigned t = 0; t < num_threads_; t++)
+    {
+      for (unsigned p = 0; p < timer::NumPhases; p++)
+      {
+        phase_cycles[p] += threads_.at(t)->GetStats().phase_cycles[p];
+        total_phase_cycles += threads_.at(t)->GetStats().phase_cycles[p];
+      }
+    }
+    if (total_phase_cycles > 0)
+    {
+      std::cout << "Evaluation cycles by phase (all threads):" << std::endl;
+      for (unsigned p = 0; p < timer::NumPhases; p++)
+      {
+        std::cout << "  " << std::setw(36) << std::left << timer::PhaseName(p)
+                  << std::right << std::setw(16) << phase_cycles[p]
+                  << std::endl;
+      }
+    }
+
+    // Report hardware performance counters (only populated by perf-counter
+    // enabled builds on a permissive kernel, see util/perf-counters.hpp).
+    perf::CounterValues run_perf = {};
+    perf::PhaseCounters phase_perf = {};
+    for (unsigned t = 0; t < num_threads_; t++)
+    {
+      for (unsigned c = 0; c < perf::NumCounters; c++)
+      {
+        run_perf[c] += threads_.at(t)->GetStats().run_perf[c];
+        for (unsigned p = 0; p < timer::NumPhases; p++)
+        {
+          phase_perf[p][c] += threads_.at(t)->GetStats().phase_perf[p][c];
+        }
+      }
+    }
+    if (run_perf[unsigned(perf::Counter::Cycles)] > 0)
+    {
+      auto print_perf_row = [](const char* name, const perf::CounterValues& v)
+      {
+        double cycles = double(v[unsigned(perf::Counter::Cycles)]);
+        double instructions = double(v[unsigned(perf::Counter::Instructions)]);
+        double llc_misses = double(v[unsigned(perf::Counter::LLCMisses)]);
+        double branch_misses = double(v[unsigned(perf::Counter::BranchMisses)]);
+        std::cout << "  " << std::setw(36) << std::left << name << std::right
+                  << std::setw(16) << v[unsigned(perf::Counter::Cycles)]
+                  << std::setw(16) << v[unsigned(perf::Counter::Instructions)]
+                  << std::setw(8) << std::fixed << std::setprecision(2)
+                  << (cycles > 0 ? instructions / cycles : 0.0)
+                  << std::setw(12) << std::setprecision(2)
+                  << (instructions > 0 ? 1000.0 * llc_misses / instructions : 0.0)
+                  << std::setw(12) << std::setprecision(2)
+                  << (instructions > 0 ? 1000.0 * branch_misses / instructions : 0.0)
+                  << std::endl;
+      };
+      std::cout << "Hardware counters (all threads):" << std::endl;
+      std::cout << "  " << std::setw(36) << std::left << "phase" << std::right
+                << std::setw(16) << "cycles"
+                << std::setw(16) << "instructions"
+                << std::setw(8) << "IPC"
+                << std::setw(12) << "LLC/kinst"
+                << std::setw(12) << "BR/kinst"
+                << std::endl;
+      print_perf_row("Run()", run_perf);
+      for (unsigned p = 0; p < timer::NumPhases; p++)
+      {
+        if (phase_perf[p][unsigned(perf::Counter::Cycles)] > 0)
+        {
+          print_perf_row(timer::PhaseName(p), phase_perf[p]);
+        }
+      }
+    }
+
+    // Hierarchical scope profile (only populated by profiler-enabled
+    // builds, see util/profiler.hpp).
+    profiler::Report(std::cout);
+
     std::cout << std::endl;
 
     for (unsigned t = 0; t < num_threads_; t++)
@@ -511,27 +1684,38 @@ class Application
 
     if (global_best_.valid)
     {
-      std::ofstream map_txt_file(map_txt_file_name);
-      global_best_.mapping.PrettyPrint(map_txt_file, arch_specs_.topology.StorageLevelNames(),
-                                      global_best_.stats.tile_sizes);
-      map_txt_file.close();
+      WriteArtifacts_(global_best_, false);
+
+      // The artifact pass above reconstructed (and cached) the full
+      // Mapping from its mapspace ID; reuse it for the remaining outputs.
+      auto& best_mapping = global_best_.GetMapping();
+
+      // Emit the best mapping in the parser's YAML directive format, so a
+      // later run can feed it back through mapper.warm-start (e.g. the
+      // next point of a design-space sweep seeding from this one).
+      std::ofstream map_yaml_file(map_yaml_file_name);
+      mapping::FormatAsYAML(best_mapping, arch_specs_, map_yaml_file);
+      map_yaml_file.close();
 
       // Re-evaluate the mapping so that we get a live engine with complete specs and stats
-      // that can be printed out hierarchically.
+      // for the XML archive below.
       model::Engine engine;
       engine.Spec(arch_specs_);
-      engine.Evaluate(global_best_.mapping, workload_);
+      engine.Evaluate(best_mapping, workload_);
 
-      std::ofstream stats_file(stats_file_name);
-      stats_file << engine << std::endl;
-      stats_file.close();
+      if (stats_json_)
+      {
+        std::ofstream stats_json_file(out_prefix_ + ".stats.json");
+        engine.GetTopology().PrintStatsJSON(stats_json_file);
+        stats_json_file.close();
+      }
 
       if (emit_whoop_nest_)
       {
         std::ofstream map_cpp_file(map_cpp_file_name);
-        global_best_.mapping.PrintWhoopNest(map_cpp_file, arch_specs_.topology.StorageLevelNames(),
-                                           global_best_.stats.tile_sizes,
-                                           global_best_.stats.utilized_instances);
+        best_mapping.PrintWhoopNest(map_cpp_file, arch_specs_.topology.StorageLevelNames(),
+                                    global_best_.stats.tile_sizes,
+                                    global_best_.stats.utilized_instances);
         map_cpp_file.close();
       }
 
@@ -545,7 +1729,7 @@ class Application
       std::ofstream ofs(xml_file_name);
       boost::archive::xml_oarchive ar(ofs);
       ar << boost::serialization::make_nvp("engine", engine);
-      ar << boost::serialization::make_nvp("mapping", global_best_.mapping);
+      ar << boost::serialization::make_nvp("mapping", best_mapping);
       const Application* a = this;
       ar << BOOST_SERIALIZATION_NVP(a);
     }
@@ -568,12 +1752,15 @@ class Application
       }
     }
 
-    if (!cfg_string_)  return; // empty because input was yml
+    SweepBounds_();
+
+    if (!cfg_string_)  return; // empty because input was yml (or already consumed)
 
     // Create an output cfg starting with the original cfg contents.
     libconfig::Config config;
     config.readString(cfg_string_);
     free(cfg_string_);
+    cfg_string_ = nullptr;
     libconfig::Setting& root = config.getRoot();
 
     // Update the mapper constraints.
@@ -606,7 +1793,7 @@ class Application
       libconfig::Setting& mapspace = root.add("mapspace", libconfig::Setting::TypeGroup);
     
       // Format the best mapping as libconfig constraints.
-      global_best_.mapping.FormatAsConstraints(mapspace);
+      global_best_.GetMapping().FormatAsConstraints(mapspace);
     }
 
     config.writeFile(map_cfg_file_name.c_str());
@@ -0,0 +1,196 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "mapping/mapping.hpp"
+#include "mapspaces/mapspace-base.hpp"
+#include "search/search.hpp"
+#include "util/profiler.hpp"
+
+//--------------------------------------------//
+//            Construct Pipeline              //
+//--------------------------------------------//
+
+// Two-stage pipeline for a mapper thread: a paired helper thread runs the
+// search and mapping construction (cheap, branchy, decode-bound) a few
+// mappings ahead into a small single-producer single-consumer ring, while
+// the owning thread drains the ring and runs the expensive, compute-dense
+// evaluation. The two stages stress different CPU resources, so they
+// overlap well on an SMT sibling or a spare core.
+//
+// Engaged only for search algorithms that tolerate deferred feedback
+// (SearchAlgorithm::SupportsDeferredReport): the helper calls Next() up to
+// kDepth mappings ahead of the evaluations whose outcomes have been
+// reported, and mappings still in the ring when the pipeline winds down
+// are never reported at all. The search algorithm is shared between the
+// two threads, so every consumer-side call into it -- Report(),
+// ReportFailureDetail(), Checkpoint() -- must hold LockSearch().
+class ConstructPipeline
+{
+ public:
+  struct Entry
+  {
+    mapspace::ID mapping_id;
+    Mapping mapping;
+    std::vector<mapspace::Status> construction_status;
+    bool construct_success;
+  };
+
+ private:
+  // Ring depth: just enough to ride out construct/evaluate latency jitter.
+  // Anything deeper only widens the window between a Next() and its
+  // Report() without improving overlap.
+  static const unsigned kDepth = 8;
+
+  search::SearchAlgorithm* search_;
+  mapspace::MapSpace* mapspace_;
+  bool break_on_failure_;
+
+  // Guards search_ against concurrent producer Next() and consumer
+  // Report()/Checkpoint() calls.
+  std::mutex search_mutex_;
+
+  std::vector<Entry> ring_;
+  std::atomic<std::uint64_t> head_;  // next slot the producer fills
+  std::atomic<std::uint64_t> tail_;  // next slot the consumer drains
+  std::atomic<bool> stop_;
+  std::atomic<bool> exhausted_;      // the producer saw Next() return false
+  std::thread producer_;
+
+  void Produce_()
+  {
+    while (!stop_.load(std::memory_order_acquire))
+    {
+      Entry entry;
+      {
+        profiler::Scope profile_scope("search::Next");
+        std::lock_guard<std::mutex> lock(search_mutex_);
+        if (!search_->Next(entry.mapping_id))
+        {
+          break;
+        }
+      }
+
+      {
+        profiler::Scope profile_scope("ConstructMapping");
+        entry.construction_status =
+          mapspace_->ConstructMapping(entry.mapping_id, &entry.mapping, break_on_failure_);
+      }
+      entry.construct_success =
+        std::accumulate(entry.construction_status.begin(), entry.construction_status.end(), true,
+                        [](bool cur, const mapspace::Status& status)
+                        { return cur && status.success; });
+
+      // Wait for a free slot.
+      while (head_.load(std::memory_order_relaxed) -
+             tail_.load(std::memory_order_acquire) == kDepth)
+      {
+        if (stop_.load(std::memory_order_acquire))
+        {
+          return;
+        }
+        std::this_thread::yield();
+      }
+
+      ring_[head_.load(std::memory_order_relaxed) % kDepth] = std::move(entry);
+      head_.fetch_add(1, std::memory_order_release);
+    }
+    exhausted_.store(true, std::memory_order_release);
+  }
+
+ public:
+  ConstructPipeline(search::SearchAlgorithm* search, mapspace::MapSpace* mapspace,
+                    bool break_on_failure) :
+      search_(search),
+      mapspace_(mapspace),
+      break_on_failure_(break_on_failure),
+      ring_(kDepth),
+      head_(0),
+      tail_(0),
+      stop_(false),
+      exhausted_(false)
+  {
+    producer_ = std::thread(&ConstructPipeline::Produce_, this);
+  }
+
+  // This class does not support being copied
+  ConstructPipeline(const ConstructPipeline&) = delete;
+  ConstructPipeline& operator=(const ConstructPipeline&) = delete;
+
+  ~ConstructPipeline()
+  {
+    Stop();
+  }
+
+  // Guard for consumer-side calls into the shared search algorithm.
+  std::unique_lock<std::mutex> LockSearch()
+  {
+    return std::unique_lock<std::mutex>(search_mutex_);
+  }
+
+  // Pop the next constructed mapping. Blocks (yielding) while the producer
+  // is behind; returns false once the search frontier is exhausted and the
+  // ring has been drained.
+  bool Pop(Entry& entry)
+  {
+    while (true)
+    {
+      if (tail_.load(std::memory_order_relaxed) !=
+          head_.load(std::memory_order_acquire))
+      {
+        entry = std::move(ring_[tail_.load(std::memory_order_relaxed) % kDepth]);
+        tail_.fetch_add(1, std::memory_order_release);
+        return true;
+      }
+      if (exhausted_.load(std::memory_order_acquire) &&
+          tail_.load(std::memory_order_relaxed) ==
+          head_.load(std::memory_order_acquire))
+      {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  // Wind the helper down (idempotent). Mappings still in flight are
+  // discarded; their Next() calls will never see a Report().
+  void Stop()
+  {
+    stop_.store(true, std::memory_order_release);
+    if (producer_.joinable())
+    {
+      producer_.join();
+    }
+  }
+};
@@ -0,0 +1,244 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "mapping/mapping.hpp"
+
+//--------------------------------------------//
+//              Surrogate Filter              //
+//--------------------------------------------//
+
+// Online-trained surrogate cost model used as an optional pre-filter in
+// MapperThread::Run. A linear model over cheap mapping features (per-level
+// log factor products, a permutation class per level, the bypass mask)
+// predicts log cost; it is trained incrementally from every completed
+// evaluation, and once warmed up the thread skips full evaluation for
+// mappings predicted far worse than the incumbent. The skip margin is
+// calibrated at runtime: every kAuditInterval-th qualifying mapping is
+// evaluated anyway, and the margin widens whenever the observed
+// false-reject rate exceeds the configured bound (and slowly tightens
+// while it stays under it). Late in large searches, where almost every
+// evaluation is hopeless, this trades a bounded miss rate for throughput.
+//
+// One instance per mapper thread: no locking, and the model tracks the
+// incumbent the thread is actually filtering against.
+class SurrogateFilter
+{
+ private:
+  // Don't filter until the model has seen this many evaluations.
+  static const std::uint64_t kWarmupObservations = 500;
+
+  // Fully evaluate every kAuditInterval-th mapping that qualified for
+  // skipping, to re-validate the filter.
+  static const std::uint64_t kAuditInterval = 64;
+
+  double target_false_reject_rate_;
+
+  // Linear model over standardized features, predicting log cost.
+  // Per-feature running mean/variance (Welford) standardize the inputs,
+  // so one SGD step size works across features of very different scales.
+  std::vector<double> weights_;
+  std::vector<double> feature_mean_;
+  std::vector<double> feature_m2_;
+  double target_mean_ = 0;
+  std::uint64_t observations_ = 0;
+
+  // EWMA of the model's absolute prediction error (in log space), folded
+  // into the skip threshold so an inaccurate model filters less.
+  double abs_error_ewma_ = 0;
+
+  // Adaptive skip margin in log space: skip only if the predicted log
+  // cost exceeds the incumbent's by margin_ plus an error allowance.
+  double margin_ = 1.4;  // ~log(4)
+  static constexpr double kMinMargin = 0.1;
+
+  std::uint64_t skip_decisions_ = 0;
+  std::uint64_t audits_ = 0;
+  std::uint64_t false_rejects_ = 0;
+
+  void EnsureSize_(std::size_t num_features)
+  {
+    if (weights_.size() < num_features)
+    {
+      weights_.resize(num_features, 0.0);
+      feature_mean_.resize(num_features, 0.0);
+      feature_m2_.resize(num_features, 0.0);
+    }
+  }
+
+  double Standardize_(unsigned i, double value) const
+  {
+    double var = observations_ > 1 ? feature_m2_[i] / double(observations_ - 1) : 0.0;
+    return var > 1e-12 ? (value - feature_mean_[i]) / std::sqrt(var) : 0.0;
+  }
+
+ public:
+  SurrogateFilter(double target_false_reject_rate) :
+      target_false_reject_rate_(target_false_reject_rate)
+  {
+  }
+
+  // Cheap feature vector: per storage level, the log2 temporal and
+  // spatial factor products and a permutation class (the innermost
+  // non-trivial loop's dimension); then per dataspace, the fraction of
+  // levels that keep (do not bypass) it. All derivable from the
+  // constructed mapping with one pass over the nest.
+  std::vector<double> Features(const Mapping& mapping) const
+  {
+    auto& nest = mapping.loop_nest;
+    auto num_levels = nest.storage_tiling_boundaries.size();
+
+    unsigned num_data_spaces = problem::GetShape()->NumDataSpaces;
+
+    std::vector<double> features;
+    features.reserve(3 * num_levels + num_data_spaces);
+
+    std::uint64_t start = 0;
+    for (auto boundary: nest.storage_tiling_boundaries)
+    {
+      double log_temporal = 0;
+      double log_spatial = 0;
+      double permutation_class = 0;
+      bool innermost_found = false;
+      for (std::uint64_t i = start; i <= boundary && i < nest.loops.size(); i++)
+      {
+        auto& loop = nest.loops.at(i);
+        double extent = double(loop.end > 1 ? loop.end : 1);
+        if (loop::IsSpatial(loop.spacetime_dimension))
+          log_spatial += std::log2(extent);
+        else
+          log_temporal += std::log2(extent);
+        if (!innermost_found && loop.end > 1)
+        {
+          permutation_class = double(unsigned(loop.dimension) + 1);
+          innermost_found = true;
+        }
+      }
+      features.push_back(log_temporal);
+      features.push_back(log_spatial);
+      features.push_back(permutation_class);
+      start = boundary + 1;
+    }
+
+    for (unsigned pvi = 0; pvi < num_data_spaces; pvi++)
+    {
+      auto& mask = mapping.datatype_bypass_nest.at(pvi);
+      features.push_back(num_levels > 0 ? double(mask.count()) / double(num_levels) : 0.0);
+    }
+
+    return features;
+  }
+
+  bool Trained() const
+  {
+    return observations_ >= kWarmupObservations;
+  }
+
+  double Predict(const std::vector<double>& features) const
+  {
+    double prediction = target_mean_;
+    for (unsigned i = 0; i < features.size() && i < weights_.size(); i++)
+    {
+      prediction += weights_[i] * Standardize_(i, features[i]);
+    }
+    return prediction;
+  }
+
+  // Train on a completed evaluation (valid mappings only: invalid ones
+  // have no cost). One standardized SGD step with a decaying rate.
+  void Observe(const std::vector<double>& features, double cost)
+  {
+    if (cost <= 0)
+      return;
+
+    EnsureSize_(features.size());
+    double target = std::log(cost);
+    double error = target - Predict(features);
+
+    observations_++;
+    for (unsigned i = 0; i < features.size(); i++)
+    {
+      double delta = features[i] - feature_mean_[i];
+      feature_mean_[i] += delta / double(observations_);
+      feature_m2_[i] += delta * (features[i] - feature_mean_[i]);
+    }
+    target_mean_ += (target - target_mean_) / double(observations_);
+
+    double rate = 1.0 / std::sqrt(double(observations_) + 100.0);
+    for (unsigned i = 0; i < features.size(); i++)
+    {
+      weights_[i] += rate * error * Standardize_(i, features[i]);
+    }
+
+    abs_error_ewma_ = 0.99 * abs_error_ewma_ + 0.01 * std::fabs(error);
+  }
+
+  // Should this mapping's full evaluation be skipped? True only once the
+  // model is warmed up and the predicted log cost clears the incumbent's
+  // by the calibrated margin plus an allowance for the model's own error.
+  bool PredictSkip(const std::vector<double>& features, double incumbent_cost)
+  {
+    if (!Trained() || incumbent_cost <= 0)
+      return false;
+    return Predict(features) >
+      std::log(incumbent_cost) + margin_ + 2.0 * abs_error_ewma_;
+  }
+
+  // Called once per positive skip decision; true on the decisions that
+  // must be audited (fully evaluated despite the prediction).
+  bool ShouldAudit()
+  {
+    return (++skip_decisions_ % kAuditInterval) == 0;
+  }
+
+  // Outcome of an audited mapping: false_reject means it actually beat
+  // the incumbent, i.e., the filter would have discarded an upgrade.
+  // Widen the margin on any false reject or whenever the observed rate
+  // exceeds the target; tighten slowly while it stays under.
+  void AuditOutcome(bool false_reject)
+  {
+    audits_++;
+    if (false_reject)
+      false_rejects_++;
+
+    double observed_rate = double(false_rejects_) / double(audits_);
+    if (false_reject || observed_rate > target_false_reject_rate_)
+      margin_ += 0.7;  // ~log(2): demand 2x more predicted headroom
+    else if (margin_ > kMinMargin)
+      margin_ *= 0.995;
+  }
+
+  std::uint64_t SkipDecisions() const { return skip_decisions_; }
+  std::uint64_t Audits() const { return audits_; }
+  std::uint64_t FalseRejects() const { return false_rejects_; }
+  double Margin() const { return margin_; }
+};
@@ -51,8 +51,19 @@ int main(int argc, char* argv[])
   }
   std::cout << std::endl;
   
+  // Batch mode: a "metrics" node with an arch-files list analyzes many
+  // architecture configs in one invocation (see BatchApplication).
+  auto rootNode = cConfig->getRoot();
+  if (rootNode.exists("metrics") &&
+      rootNode.lookup("metrics").exists("arch-files"))
+  {
+    BatchApplication application(cConfig);
+    application.Run();
+    return 0;
+  }
+
   Application application(cConfig);
-  
+
   application.Run();
 
   return 0;
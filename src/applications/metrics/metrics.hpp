@@ -31,7 +31,11 @@
 #include "compound-config/compound-config.hpp"
 #include "util/accelergy_interface.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <sstream>
+#include <thread>
 
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/array.hpp>
@@ -56,8 +60,13 @@ class Application
  
  public:
 
-  Application(config::CompoundConfig* config)
+  // The out_prefix must be unique per concurrent instance: the Accelergy
+  // invocation drops its reference tables at <out_prefix>.ERT/ART.yaml.
+  Application(config::CompoundConfig* config,
+              std::string out_prefix = "timeloop-metric")
   {
+    out_prefix_ = out_prefix;
+
     auto rootNode = config->getRoot();
     // Architecture configuration.
     config::CompoundConfigNode arch;
@@ -115,5 +124,107 @@ class Application
   {
     std::cout << engine_ << std::endl;
   }
+
+  model::Engine& GetEngine()
+  {
+    return engine_;
+  }
+};
+
+//--------------------------------------------//
+//             Batch Application              //
+//--------------------------------------------//
+
+// Analyze many architecture configs in one invocation, emitting the
+// per-arch metrics tables into a single output file. Specs are parsed
+// (and Accelergy invoked) in a parallel loop; identical arch specs
+// additionally hit the content-hashed reference-table cache (see
+// TIMELOOP_ACCELERGY_CACHE in util/accelergy_interface.hpp), so a
+// regression sweep pays the Python cost only for distinct variants.
+//
+// Configured via a root "metrics" node:
+//   metrics:
+//     arch-files: [ variant0.yaml, variant1.yaml, ... ]
+//     num-threads: 8   # default: hardware concurrency
+//     out_prefix: timeloop-metrics
+class BatchApplication
+{
+ protected:
+  std::vector<std::string> arch_files_;
+  std::uint32_t num_threads_ = 0;
+  std::string out_prefix_ = "timeloop-metrics";
+
+ public:
+
+  BatchApplication(config::CompoundConfig* config)
+  {
+    auto metrics = config->getRoot().lookup("metrics");
+    metrics.lookupArrayValue("arch-files", arch_files_);
+    metrics.lookupValue("num-threads", num_threads_);
+    metrics.lookupValue("out_prefix", out_prefix_);
+
+    if (arch_files_.empty())
+    {
+      std::cerr << "ERROR: metrics.arch-files is empty." << std::endl;
+      exit(1);
+    }
+  }
+
+  // This class does not support being copied
+  BatchApplication(const BatchApplication&) = delete;
+  BatchApplication& operator=(const BatchApplication&) = delete;
+
+  void Run()
+  {
+    unsigned num_threads = num_threads_ > 0 ?
+      num_threads_ : std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::min<unsigned>(num_threads, arch_files_.size());
+
+    std::cout << "Analyzing " << arch_files_.size() << " architecture configs using "
+              << num_threads << " threads." << std::endl;
+
+    std::vector<std::string> sections(arch_files_.size());
+    std::atomic<std::size_t> next(0);
+
+    auto worker = [this, &sections, &next]()
+    {
+      while (true)
+      {
+        std::size_t i = next.fetch_add(1);
+        if (i >= arch_files_.size())
+          break;
+
+        config::CompoundConfig config(arch_files_.at(i).c_str());
+
+        // Per-arch out_prefix, so concurrent Accelergy invocations don't
+        // clobber each other's reference tables.
+        std::string name = arch_files_.at(i);
+        replace(name.begin(), name.end(), '/', '.');
+
+        Application app(&config, out_prefix_ + "." + name);
+
+        std::ostringstream section;
+        section << "=== " << arch_files_.at(i) << " ===" << std::endl;
+        section << app.GetEngine() << std::endl;
+        sections.at(i) = section.str();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; t++)
+      threads.push_back(std::thread(worker));
+    for (auto& thread: threads)
+      thread.join();
+
+    // One metrics table for the whole batch, sections in input order.
+    std::string metrics_file_name = out_prefix_ + ".metrics.txt";
+    std::ofstream metrics_file(metrics_file_name);
+    for (auto& section: sections)
+      metrics_file << section;
+    metrics_file.close();
+
+    std::cout << "Metrics for " << arch_files_.size() << " configs written to "
+              << metrics_file_name << "." << std::endl;
+  }
 };
 
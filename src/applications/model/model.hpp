@@ -27,7 +27,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <fstream>
+#include <thread>
 
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/array.hpp>
@@ -63,11 +65,18 @@ class Application
   // we can only instantiate them after certain config files have
   // been parsed.
 
-  // The mapping.
+  // The mapping (single-mapping mode).
   Mapping* mapping_;
 
-  // Abstract representation of the architecture.
-  ArchProperties* arch_props_;
+  // Batch mode: many candidate mappings evaluated against the same
+  // engine spec (e.g. post-search validation of a mapper's candidates).
+  std::vector<std::string> batch_names_;
+  std::vector<Mapping> batch_mappings_;
+  std::uint32_t num_threads_ = 0;
+
+  // Abstract representation of the architecture (immutable, shared across
+  // structurally identical arch points -- see ArchProperties::GetShared()).
+  std::shared_ptr<const ArchProperties> arch_props_;
 
   // Constraints.
   mapping::Constraints* constraints_;  
@@ -75,6 +84,7 @@ class Application
   // Application flags/config.
   bool verbose_ = false;
   bool auto_bypass_on_failure_ = false;
+  bool stats_json_ = false;
   std::string out_prefix_;
 
  private:
@@ -109,6 +119,8 @@ class Application
       model.lookupValue("verbose", verbose_);
       model.lookupValue("auto_bypass_on_failure", auto_bypass_on_failure_);
       model.lookupValue("out_prefix", semi_qualified_prefix);
+      model.lookupValue("num-threads", num_threads_);
+      model.lookupValue("stats-json", stats_json_);
     }
 
     out_prefix_ = output_dir + "/" + semi_qualified_prefix;
@@ -173,7 +185,7 @@ class Application
 #endif
     }
 
-    arch_props_ = new ArchProperties(arch_specs_);
+    arch_props_ = ArchProperties::GetShared(arch_specs_);
 
     // Architecture constraints.
     config::CompoundConfigNode arch_constraints;
@@ -191,17 +203,41 @@ class Application
     if (verbose_)
       std::cout << "Architecture configuration complete." << std::endl;
 
-    // Mapping configuration: expressed as a mapspace or mapping.
-    auto mapping = rootNode.lookup("mapping");
-    mapping_ = new Mapping(mapping::ParseAndConstruct(mapping, arch_specs_, workload_));
-    if (verbose_)
-      std::cout << "Mapping construction complete." << std::endl;
-
-    // Validate mapping against the architecture constraints.
-    if (!constraints_->SatisfiedBy(mapping_))
+    // Mapping configuration: a single "mapping" node, or a "mappings"
+    // list of candidates to evaluate as a batch against the same engine
+    // spec. Each batch entry is a group with an optional "name" and a
+    // "mapping" node in the usual directive format.
+    mapping_ = nullptr;
+    if (rootNode.exists("mappings"))
     {
-      std::cerr << "ERROR: mapping violates architecture constraints." << std::endl;
-      exit(1);
+      auto mappings = rootNode.lookup("mappings");
+      assert(mappings.isList());
+      for (int i = 0; i < mappings.getLength(); i++)
+      {
+        auto entry = mappings[i];
+        std::string entry_name = "mapping" + std::to_string(i);
+        entry.lookupValue("name", entry_name);
+        batch_names_.push_back(entry_name);
+        batch_mappings_.push_back(mapping::ParseAndConstruct(entry.lookup("mapping"),
+                                                             arch_specs_, workload_));
+      }
+      if (verbose_)
+        std::cout << "Batch mapping construction complete: "
+                  << batch_mappings_.size() << " candidates." << std::endl;
+    }
+    else
+    {
+      auto mapping = rootNode.lookup("mapping");
+      mapping_ = new Mapping(mapping::ParseAndConstruct(mapping, arch_specs_, workload_));
+      if (verbose_)
+        std::cout << "Mapping construction complete." << std::endl;
+
+      // Validate mapping against the architecture constraints.
+      if (!constraints_->SatisfiedBy(mapping_))
+      {
+        std::cerr << "ERROR: mapping violates architecture constraints." << std::endl;
+        exit(1);
+      }
     }
   }
 
@@ -214,16 +250,151 @@ class Application
     if (mapping_)
       delete mapping_;
 
-    if (arch_props_)
-      delete arch_props_;
-
     if (constraints_)
       delete constraints_;
   }
 
+ protected:
+
+  // Evaluate every candidate mapping in the batch and emit one stats row
+  // per mapping into a single CSV. The config parse, engine spec and any
+  // Accelergy invocation are paid once per process instead of once per
+  // candidate. Candidates are evaluated as-is (no auto-bypass): the point
+  // of a batch run is to judge each one faithfully, so failures are
+  // recorded in the output rather than corrected or treated as fatal.
+  void RunBatch_()
+  {
+    struct BatchResult
+    {
+      bool valid = false;
+      std::string fail_reason;
+      std::uint64_t cycles = 0;
+      std::uint64_t maccs = 0;
+      double energy = 0;
+      double utilization = 0;
+      std::string stats_json;
+    };
+
+    unsigned num_threads = num_threads_ > 0 ?
+      num_threads_ : std::max(1u, std::thread::hardware_concurrency());
+    if (verbose_)
+      std::cout << "Evaluating " << batch_mappings_.size() << " mappings using "
+                << num_threads << " threads." << std::endl;
+
+    std::vector<BatchResult> results(batch_mappings_.size());
+    std::atomic<std::size_t> next(0);
+
+    auto worker = [this, &results, &next]()
+    {
+      // Each thread specs its own engine once and reuses it across all
+      // the candidates it picks up.
+      model::Engine engine;
+      engine.Spec(arch_specs_);
+      auto level_names = arch_specs_.topology.LevelNames();
+
+      while (true)
+      {
+        std::size_t i = next.fetch_add(1);
+        if (i >= batch_mappings_.size())
+          break;
+
+        auto& mapping = batch_mappings_.at(i);
+        auto& result = results.at(i);
+
+        if (!constraints_->SatisfiedBy(&mapping))
+        {
+          result.fail_reason = "violates architecture constraints";
+          continue;
+        }
+
+        auto eval_status = engine.Evaluate(mapping, workload_);
+        for (unsigned level = 0; level < eval_status.size(); level++)
+        {
+          if (!eval_status[level].success)
+          {
+            result.fail_reason = level_names.at(level) + ": "
+              + eval_status[level].fail_reason;
+            break;
+          }
+        }
+
+        if (result.fail_reason.empty() && engine.IsEvaluated())
+        {
+          result.valid = true;
+          result.cycles = engine.Cycles();
+          result.maccs = engine.GetTopology().MACCs();
+          result.energy = engine.Energy();
+          result.utilization = engine.Utilization();
+          if (stats_json_)
+          {
+            std::ostringstream json;
+            engine.GetTopology().PrintStatsJSON(json);
+            result.stats_json = json.str();
+          }
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; t++)
+      threads.push_back(std::thread(worker));
+    for (auto& thread: threads)
+      thread.join();
+
+    // One structured output for the whole batch, rows in input order.
+    std::string batch_file_name = out_prefix_ + ".batch.csv";
+    std::ofstream batch_file(batch_file_name);
+    batch_file << "name, valid, cycles, energy_pJ, utilization, pJ/MACC, fail_reason" << std::endl;
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+      auto& result = results.at(i);
+      batch_file << batch_names_.at(i) << ", " << (result.valid ? 1 : 0);
+      if (result.valid)
+      {
+        batch_file << ", " << result.cycles
+                   << ", " << std::fixed << std::setprecision(2) << result.energy
+                   << ", " << std::setw(4) << std::fixed << std::setprecision(2)
+                   << result.utilization
+                   << ", " << std::setw(8) << std::fixed << std::setprecision(3)
+                   << result.energy / result.maccs
+                   << ", " << std::endl;
+      }
+      else
+      {
+        batch_file << ", , , , , " << result.fail_reason << std::endl;
+      }
+    }
+    batch_file.close();
+
+    // Full structured stats as JSON-lines, one object per valid mapping,
+    // rows matching the CSV (invalid mappings get an empty line).
+    if (stats_json_)
+    {
+      std::ofstream jsonl_file(out_prefix_ + ".batch.jsonl");
+      for (auto& result: results)
+      {
+        jsonl_file << result.stats_json;
+        if (result.stats_json.empty())
+          jsonl_file << std::endl;
+      }
+      jsonl_file.close();
+    }
+
+    if (verbose_)
+      std::cout << "Batch results written to " << batch_file_name << "." << std::endl;
+  }
+
+ public:
+
   // Run the evaluation.
   void Run()
   {
+    if (!batch_mappings_.empty())
+    {
+      RunBatch_();
+      return;
+    }
+
     // Output file names.
     std::string stats_file_name = out_prefix_ + ".stats.txt";
     std::string xml_file_name = out_prefix_ + ".map+stats.xml";
@@ -290,6 +461,13 @@ class Application
       std::ofstream stats_file(stats_file_name);
       stats_file << engine << std::endl;
       stats_file.close();
+
+      if (stats_json_)
+      {
+        std::ofstream stats_json_file(out_prefix_ + ".stats.json");
+        engine.GetTopology().PrintStatsJSON(stats_json_file);
+        stats_json_file.close();
+      }
     }
 
     // Print the engine stats and mapping to an XML file
@@ -0,0 +1,234 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+
+#include "compound-config/compound-config.hpp"
+#include "mapspaces/mapspace-factory.hpp"
+#include "model/engine.hpp"
+#include "util/search-trace.hpp"
+
+//--------------------------------------------//
+//                Application                 //
+//--------------------------------------------//
+
+// Replay driver for search traces recorded with mapper.search-trace
+// (see util/search-trace.hpp). Re-executes the exact per-thread sequence
+// of mappings through ConstructMapping and the staged evaluation pipeline
+// -- without the search algorithm -- so evaluation-path changes can be
+// A/B timed against an identical workload of mappings, and perf
+// regressions from randomized searches become reproducible:
+//
+//   ./build/timeloop-replay <configfile> <trace.bin> [<trace.bin> ...]
+//
+// The config must describe the same problem, architecture and mapspace
+// as the recording run. Recorded outcomes are cross-checked against the
+// replayed ones; divergence means the configurations do not match.
+class Application
+{
+ protected:
+
+  problem::Workload workload_;
+  model::Engine::Specs arch_specs_;
+  mapspace::MapSpace* mapspace_ = nullptr;
+  std::vector<std::string> trace_files_;
+
+ public:
+
+  Application(config::CompoundConfig* config,
+              std::vector<std::string> trace_files) :
+      trace_files_(trace_files)
+  {
+    auto rootNode = config->getRoot();
+
+    // Problem configuration.
+    auto problem = rootNode.lookup("problem");
+    problem::ParseWorkload(problem, workload_);
+
+    // Architecture configuration.
+    config::CompoundConfigNode arch;
+    arch = rootNode.lookup("architecture");
+    arch_specs_ = model::Engine::ParseSpecs(arch);
+
+    // MapSpace configuration (same directive spellings as the mappers).
+    config::CompoundConfigNode arch_constraints;
+    config::CompoundConfigNode mapspace;
+
+    if (arch.exists("constraints"))
+      arch_constraints = arch.lookup("constraints");
+    else if (rootNode.exists("arch_constraints"))
+      arch_constraints = rootNode.lookup("arch_constraints");
+    else if (rootNode.exists("architecture_constraints"))
+      arch_constraints = rootNode.lookup("architecture_constraints");
+
+    if (rootNode.exists("mapspace"))
+      mapspace = rootNode.lookup("mapspace");
+    else if (rootNode.exists("mapspace_constraints"))
+      mapspace = rootNode.lookup("mapspace_constraints");
+
+    mapspace_ = mapspace::ParseAndConstruct(mapspace, arch_constraints, arch_specs_, workload_);
+  }
+
+  ~Application()
+  {
+    if (mapspace_)
+    {
+      delete mapspace_;
+    }
+  }
+
+  // Returns false if any trace file was unreadable or any recorded
+  // outcome diverged from the replayed one.
+  bool Run()
+  {
+    model::Engine engine;
+    engine.Spec(arch_specs_);
+
+    bool ok = true;
+    std::uint64_t grand_total = 0;
+    double grand_elapsed = 0;
+
+    for (auto& trace_file: trace_files_)
+    {
+      searchtrace::Reader reader(trace_file);
+      if (!reader.IsValid())
+      {
+        std::cerr << "ERROR: cannot read search trace: " << trace_file << std::endl;
+        ok = false;
+        continue;
+      }
+
+      std::uint64_t total = 0;
+      std::uint64_t construct_fails = 0;
+      std::uint64_t eval_fails = 0;
+      std::uint64_t valid = 0;
+      std::uint64_t divergences = 0;
+
+      auto start = std::chrono::steady_clock::now();
+
+      searchtrace::Record record;
+      while (reader.Next(record))
+      {
+        total++;
+
+        uint128_t mapping_id =
+          (uint128_t(record.mapping_id_hi) << 64) | record.mapping_id_lo;
+
+        // Same staged pipeline as the mapper threads: construct, quick
+        // capacity screen, pre-evaluation check, full evaluation.
+        Mapping mapping;
+        auto construction_status = mapspace_->ConstructMapping(mapping_id, &mapping);
+        bool construct_ok =
+          std::accumulate(construction_status.begin(), construction_status.end(), true,
+                          [](bool cur, const mapspace::Status& status)
+                          { return cur && status.success; });
+
+        bool eval_ok = false;
+        if (construct_ok)
+        {
+          auto status_per_level = engine.QuickCapacityCheck(mapping, workload_);
+          bool success =
+            std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                            [](bool cur, const model::EvalStatus& status)
+                            { return cur && status.success; });
+          if (success)
+          {
+            status_per_level = engine.PreEvaluationCheck(mapping, workload_);
+            success =
+              std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                              [](bool cur, const model::EvalStatus& status)
+                              { return cur && status.success; });
+          }
+          if (success)
+          {
+            status_per_level = engine.Evaluate(mapping, workload_);
+            success =
+              std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                              [](bool cur, const model::EvalStatus& status)
+                              { return cur && status.success; });
+          }
+          eval_ok = success;
+        }
+
+        if (!construct_ok)
+          construct_fails++;
+        else if (!eval_ok)
+          eval_fails++;
+        else
+          valid++;
+
+        if (construct_ok != bool(record.construct_success) ||
+            eval_ok != bool(record.eval_success))
+        {
+          if (divergences == 0)
+          {
+            std::cerr << "WARNING: replayed outcome diverges from trace at record "
+                      << (total - 1) << " of " << trace_file
+                      << " (is the config identical to the recording run's?)"
+                      << std::endl;
+          }
+          divergences++;
+        }
+      }
+
+      double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+      grand_total += total;
+      grand_elapsed += elapsed;
+      if (divergences > 0)
+      {
+        ok = false;
+      }
+
+      std::cout << trace_file << ":" << std::endl
+                << "  mappings = " << total
+                << " (valid = " << valid
+                << ", construct fails = " << construct_fails
+                << ", eval fails = " << eval_fails << ")"
+                << ", divergences = " << divergences << std::endl
+                << "  wall = " << std::fixed << std::setprecision(2) << elapsed << " s"
+                << ", " << std::setprecision(1)
+                << (total > 0 ? elapsed * 1e6 / total : 0.0) << " us/mapping"
+                << std::endl;
+    }
+
+    if (trace_files_.size() > 1)
+    {
+      std::cout << "total: " << grand_total << " mappings in "
+                << std::fixed << std::setprecision(2) << grand_elapsed << " s ("
+                << std::setprecision(1)
+                << (grand_total > 0 ? grand_elapsed * 1e6 / grand_total : 0.0)
+                << " us/mapping)" << std::endl;
+    }
+
+    return ok;
+  }
+};
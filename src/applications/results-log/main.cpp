@@ -0,0 +1,92 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iomanip>
+#include <iostream>
+
+#include "util/results-log.hpp"
+
+//
+// Reader for the mapper's binary results logs (mapper.results-log = True,
+// one <out_prefix>.results.<tid>.bin file per mapper thread). Dumps the
+// records as tab-separated text for offline cost-landscape analysis.
+//
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <results.bin> [<results.bin> ...]"
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "thread\tmapping_id\tcycles\tenergy\tedp\tutilization\tmaccs"
+            << "\tlast_level_accesses\tarea" << std::endl;
+
+  int errors = 0;
+  for (int i = 1; i < argc; i++)
+  {
+    resultslog::Reader reader(argv[i]);
+    if (!reader.IsValid())
+    {
+      std::cerr << "ERROR: " << argv[i]
+                << " is not a valid results log." << std::endl;
+      errors++;
+      continue;
+    }
+
+    auto thread_id = reader.Header().thread_id;
+    resultslog::Record record;
+    while (reader.Next(record))
+    {
+      std::cout << thread_id << "\t";
+      if (record.mapping_id_hi != 0)
+      {
+        std::cout << "0x" << std::hex
+                  << record.mapping_id_hi
+                  << std::setw(16) << std::setfill('0')
+                  << record.mapping_id_lo
+                  << std::dec << std::setfill(' ');
+      }
+      else
+      {
+        std::cout << record.mapping_id_lo;
+      }
+      std::cout << "\t" << record.cycles
+                << "\t" << record.energy
+                << "\t" << (record.energy * record.cycles)
+                << "\t" << record.utilization
+                << "\t" << record.maccs
+                << "\t" << record.last_level_accesses
+                << "\t" << record.area
+                << std::endl;
+    }
+  }
+
+  return (errors == 0) ? 0 : 1;
+}
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 
@@ -49,7 +50,11 @@ class Application
 
   problem::Workload workload_;
   model::Engine::Specs arch_specs_;
-  mapspace::MapSpace* mapspace_;
+  mapspace::MapSpace* mapspace_ = nullptr;
+
+  // Beam width for the staged search in Run(). Small values keep the
+  // quick-look character of this tool; 0 is clamped to 1.
+  std::uint32_t beam_width_ = 8;
 
   std::string out_prefix_ = "timeloop-mapper";
 
@@ -104,6 +109,17 @@ class Application
     //             << "mapspace_constraints as an empty list []." << std::endl;
     //   exit(1);
     // }
+
+    mapspace_ = mapspace::ParseAndConstruct(mapspace, arch_constraints, arch_specs_, workload_);
+
+    // Application configuration.
+    if (rootNode.exists("simple-mapper"))
+    {
+      auto simple_mapper = rootNode.lookup("simple-mapper");
+      simple_mapper.lookupValue("beam-width", beam_width_);
+    }
+    if (beam_width_ == 0)
+      beam_width_ = 1;
   }
 
   ~Application()
@@ -122,68 +138,142 @@ class Application
     // Output file names.
     const std::string stats_file_name = out_prefix_ + ".stats.txt";
     const std::string map_txt_file_name = out_prefix_ + ".map.txt";
-    
+
     Mapping best_mapping;
     model::Engine best_engine;
     model::Engine engine;
+    engine.Spec(arch_specs_);
+
+    auto num_factorizations = mapspace_->Size(mapspace::Dimension::IndexFactorization);
+    auto num_permutations = mapspace_->Size(mapspace::Dimension::LoopPermutation);
+    auto num_spatial = mapspace_->Size(mapspace::Dimension::Spatial);
+    auto num_bypass = mapspace_->Size(mapspace::Dimension::DatatypeBypass);
+
+    // Construct and evaluate one fully-bound mapping ID. Returns true and
+    // the mapping's energy if the mapping is legal and fits; tracks the
+    // global best as a side effect. Candidates that share a loop nest
+    // (e.g. across the bypass subspace) hit the NestAnalysis memo table
+    // and skip the expensive delta computation.
+    auto evaluate = [&](uint128_t i, uint128_t j, uint128_t k, uint128_t l,
+                        double& energy)
+    {
+      mapspace::ID mapping_id = mapspace::ID(mapspace_->AllSizes());
+      mapping_id.Set(int(mapspace::Dimension::IndexFactorization), i);
+      mapping_id.Set(int(mapspace::Dimension::LoopPermutation), j);
+      mapping_id.Set(int(mapspace::Dimension::Spatial), k);
+      mapping_id.Set(int(mapspace::Dimension::DatatypeBypass), l);
+
+      // Construct a mapping from the mapping ID. This step can fail
+      // because the space of *legal* mappings isn't dense (unfortunately),
+      // so a mapping ID may point to an illegal mapping.
+      Mapping mapping;
+      auto construction_status = mapspace_->ConstructMapping(mapping_id, &mapping);
+      bool success = std::accumulate(construction_status.begin(), construction_status.end(), true,
+                                     [](bool cur, const mapspace::Status& status)
+                                     { return cur && status.success; });
+      if (!success)
+      {
+        return false;
+      }
+
+      auto status_per_level = engine.Evaluate(mapping, workload_);
+      success = std::accumulate(status_per_level.begin(), status_per_level.end(), true,
+                                [](bool cur, const model::EvalStatus& status)
+                                { return cur && status.success; });
+      if (!success)
+      {
+        return false;
+      }
+
+      energy = engine.Energy();
+
+      // Is the new mapping "better" than the previous best mapping?
+      // We are probing the energy consumption of the last-evaluated mapping, but
+      // we can probe any stat that the model (engine) generates.
+      if (!best_engine.IsSpecced() || engine.Energy() < best_engine.Energy())
+      {
+        best_mapping = mapping;
+        best_engine = engine;
+      }
+      return true;
+    };
+
+    // Keep a scored candidate in a beam, dropping the worst entry once
+    // the beam overflows.
+    auto beam_insert = [this](std::vector<std::pair<double, std::pair<uint128_t, uint128_t>>>& beam,
+                              double energy, uint128_t i, uint128_t j)
+    {
+      beam.push_back(std::make_pair(energy, std::make_pair(i, j)));
+      std::sort(beam.begin(), beam.end(),
+                [](const std::pair<double, std::pair<uint128_t, uint128_t>>& a,
+                   const std::pair<double, std::pair<uint128_t, uint128_t>>& b)
+                { return a.first < b.first; });
+      if (beam.size() > beam_width_)
+        beam.resize(beam_width_);
+    };
+
+    // ==================
+    // Main mapper loops.
+    // ==================
+    // Beam search instead of an exhaustive product walk: score each
+    // factorization under a canonical binding of the remaining subspaces,
+    // keep only the top-B, then refine the survivors one subspace at a
+    // time. Factorization dominates tile sizes (and hence cost), so
+    // pruning on a canonical probe rarely discards the true optimum,
+    // while the evaluation count drops from |I|*|J|*|K|*|L| to roughly
+    // |I| + B*(|J| + |K|*|L|).
+
+    // Stage 1: probe each index factorization with the first legal
+    // permutation (canonical spatial split and bypass), and keep the
+    // top-B factorizations.
+    std::vector<std::pair<double, std::pair<uint128_t, uint128_t>>> factorization_beam;
+    for (uint128_t i = 0; i < num_factorizations; i++)
+    {
+      for (uint128_t j = 0; j < num_permutations; j++)
+      {
+        double energy;
+        if (evaluate(i, j, 0, 0, energy))
+        {
+          beam_insert(factorization_beam, energy, i, 0);
+          break;
+        }
+      }
+    }
+
+    // Stage 2: sweep the permutation subspace of each surviving
+    // factorization and keep the top-B (factorization, permutation)
+    // pairs.
+    std::vector<std::pair<double, std::pair<uint128_t, uint128_t>>> permutation_beam;
+    for (auto& candidate: factorization_beam)
+    {
+      auto i = candidate.second.first;
+      for (uint128_t j = 0; j < num_permutations; j++)
+      {
+        double energy;
+        if (evaluate(i, j, 0, 0, energy))
+        {
+          beam_insert(permutation_beam, energy, i, j);
+        }
+      }
+    }
+
+    // Stage 3: exhaust the spatial and bypass subspaces of the surviving
+    // pairs. These sweeps mostly re-use the survivors' loop nests, so the
+    // NestAnalysis memo absorbs much of their cost.
+    for (auto& candidate: permutation_beam)
+    {
+      auto i = candidate.second.first;
+      auto j = candidate.second.second;
+      for (uint128_t k = 0; k < num_spatial; k++)
+      {
+        for (uint128_t l = 0; l < num_bypass; l++)
+        {
+          double energy;
+          evaluate(i, j, k, l, energy);
+        }
+      }
+    }
 
-    // =================
-    // Main mapper loop.
-    // =================
-    for (uint128_t i = 0; i < mapspace_->Size(mapspace::Dimension::IndexFactorization); i++)
-      for (uint128_t j = 0; j < mapspace_->Size(mapspace::Dimension::LoopPermutation); j++)
-        for (uint128_t k = 0; k < mapspace_->Size(mapspace::Dimension::Spatial); k++)
-          for (uint128_t l = 0; l < mapspace_->Size(mapspace::Dimension::DatatypeBypass); l++)
-          {
-            // Prepare a new mapping ID.
-            mapspace::ID mapping_id = mapspace::ID(mapspace_->AllSizes());
-
-            mapping_id.Set(int(mapspace::Dimension::IndexFactorization), i);
-            mapping_id.Set(int(mapspace::Dimension::LoopPermutation), j);
-            mapping_id.Set(int(mapspace::Dimension::Spatial), k);
-            mapping_id.Set(int(mapspace::Dimension::DatatypeBypass), l);
-
-            // We should probably hoist the i, j and k Set() calls above to the
-            // loop levels where they are actually changing. Alternatively, since
-            // we are simply walking through the space linearly, we can simply
-            // use mapping_id.Increment(), it will walk across all dimensions.
-            bool success = true;
-
-            // Construct a mapping from the mapping ID. This step can fail
-            // because the space of *legal* mappings isn't dense (unfortunately),
-            // so a mapping ID may point to an illegal mapping.
-            Mapping mapping;
-
-            auto construction_status = mapspace_->ConstructMapping(mapping_id, &mapping);
-            success &= std::accumulate(construction_status.begin(), construction_status.end(), true,
-                                       [](bool cur, const mapspace::Status& status)
-                                       { return cur && status.success; });
-            if (!success)
-            {
-              continue;
-            }
-
-            // Configure the model and evaluate the mapping.
-            //engine.Spec(arch_specs_);
-            auto status_per_level = engine.Evaluate(mapping, workload_);
-            success = std::accumulate(status_per_level.begin(), status_per_level.end(), true,
-                                      [](bool cur, const model::EvalStatus& status)
-                                      { return cur && status.success; });
-            if (!success)
-            {
-              continue;
-            }
-
-            // Is the new mapping "better" than the previous best mapping?
-            // We are probing the energy consumption of the last-evaluated mapping, but
-            // we can probe any stat that the model (engine) generates.
-            if (!best_engine.IsSpecced() || engine.Energy() < best_engine.Energy())
-            {
-              best_mapping = mapping;
-              best_engine = engine;          
-            }
-          }
-    
     if (best_engine.IsEvaluated())
     {
       std::ofstream map_txt_file(map_txt_file_name);
@@ -29,9 +29,15 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <streambuf>
 
+#include <unistd.h>
+
 #define EXCEPTION_PROLOGUE                                                          \
     try { 
 
@@ -72,6 +78,75 @@
 namespace config
 {
 
+/* Interned keys */
+
+// Canonical spellings, indexed by Key. Order must match the enum.
+static const char* kKeyNames[] =
+{
+  "name",
+  "class",
+  "attributes",
+  "word-bits",
+  "word_width",
+  "datawidth",
+  "block-size",
+  "n_words",
+  "cluster-size",
+  "width",
+  "entries",
+  "depth",
+  "memory_depth",
+  "sizeKB",
+  "technology",
+  "num-ports",
+  "num-banks",
+  "bandwidth",
+  "read_bandwidth",
+  "write_bandwidth",
+  "multiple-buffering",
+  "min-utilization",
+  "instances",
+  "meshX",
+  "meshY",
+  "network_read",
+  "network_fill",
+  "network_drain",
+  "network_update",
+  "vector-access-energy",
+  "addr-gen-energy",
+  "cluster-area",
+  "target",
+  "type",
+  "factors",
+  "permutation",
+  "split",
+  "keep",
+  "bypass",
+  "constraints",
+};
+
+static_assert(sizeof(kKeyNames) / sizeof(kKeyNames[0]) == unsigned(Key::Num),
+              "key name table out of sync with the Key enum");
+
+const char* KeyName(Key key)
+{
+  return kKeyNames[unsigned(key)];
+}
+
+// Pre-encoded YAML key nodes: yaml-cpp re-encodes a string key into a
+// node on every operator[] call, which the interned path skips.
+static const YAML::Node& KeyNode(Key key)
+{
+  static const std::vector<YAML::Node> nodes = []()
+  {
+    std::vector<YAML::Node> v;
+    for (unsigned i = 0; i < unsigned(Key::Num); i++)
+      v.push_back(YAML::Node(kKeyNames[i]));
+    return v;
+  }();
+  return nodes.at(unsigned(key));
+}
+
 /* CompoundConfigNode */
 
 CompoundConfigNode::CompoundConfigNode(libconfig::Setting* _lnode, YAML::Node _ynode) {
@@ -408,6 +483,96 @@ bool CompoundConfigNode::exists(const char *name) const {
   EXCEPTION_EPILOGUE;
 }
 
+CompoundConfigNode CompoundConfigNode::lookup(Key key) const {
+  if (LNode) return lookup(KeyName(key));
+  EXCEPTION_PROLOGUE;
+  if (!YNode[KeyNode(key)]) {
+    // See lookup(const char*) for why we force an exception here.
+    try {
+      YNode[KeyNode(key)].as<int>(); // force an exception!
+    } catch (YAML::Exception& e) {
+      throw YAML::KeyNotFound(e.mark, std::string(KeyName(key)));
+    }
+  }
+  YAML::Node nextNode = YNode[KeyNode(key)];
+  return CompoundConfigNode(nullptr, nextNode, cConfig);
+  EXCEPTION_EPILOGUE;
+}
+
+// Interned-key counterparts of the lookupValue() overloads above. The
+// libconfig path simply forwards to the string version; the YAML path
+// resolves the child once via the pre-encoded key node and then applies
+// the same conversion and variables-fallback logic.
+#define IMPLEMENT_INTERNED_LOOKUP_VALUE(TYPE)                                       \
+bool CompoundConfigNode::lookupValue(Key key, TYPE &value) const {                  \
+  if (LNode) return lookupValue(KeyName(key), value);                               \
+  EXCEPTION_PROLOGUE;                                                               \
+  if (YNode) {                                                                      \
+    if (YNode.IsScalar()) return false;                                             \
+    YAML::Node child = YNode[KeyNode(key)];                                         \
+    if (!child.IsDefined() || !child.IsScalar()) return false;                      \
+    try {                                                                           \
+      value = child.as<TYPE>();                                                     \
+    } catch (YAML::BadConversion& e) {                                              \
+      std::string variableName = child.as<std::string>();                           \
+      if (cConfig->getVariableRoot().exists(variableName)) {                        \
+        cConfig->getVariableRoot().lookupValue(variableName, value);                \
+      } else {                                                                      \
+        std::cerr << "Cannot find " << variableName << " under root key: variables" << std::endl; \
+        throw e;                                                                    \
+      }                                                                             \
+    }                                                                               \
+    return true;                                                                    \
+  }                                                                                 \
+  else {                                                                            \
+    assert(false);                                                                  \
+    return false;                                                                   \
+  }                                                                                 \
+  EXCEPTION_EPILOGUE;                                                               \
+}
+
+IMPLEMENT_INTERNED_LOOKUP_VALUE(bool)
+IMPLEMENT_INTERNED_LOOKUP_VALUE(int)
+IMPLEMENT_INTERNED_LOOKUP_VALUE(unsigned int)
+IMPLEMENT_INTERNED_LOOKUP_VALUE(long long)
+IMPLEMENT_INTERNED_LOOKUP_VALUE(unsigned long long)
+IMPLEMENT_INTERNED_LOOKUP_VALUE(double)
+IMPLEMENT_INTERNED_LOOKUP_VALUE(float)
+
+#undef IMPLEMENT_INTERNED_LOOKUP_VALUE
+
+bool CompoundConfigNode::lookupValue(Key key, std::string &value) const {
+  if (LNode) return lookupValue(KeyName(key), value);
+  EXCEPTION_PROLOGUE;
+  if (YNode) {
+    if (YNode.IsScalar()) return false;
+    YAML::Node child = YNode[KeyNode(key)];
+    if (!child.IsDefined() || !child.IsScalar()) return false;
+    value = child.as<std::string>();
+    std::string variableName = value;
+    if (cConfig->getVariableRoot().exists(variableName)) {
+      cConfig->getVariableRoot().lookupValue(variableName, value);
+    }
+    return true;
+  }
+  else {
+    assert(false);
+    return false;
+  }
+  EXCEPTION_EPILOGUE;
+}
+
+bool CompoundConfigNode::exists(Key key) const {
+  if (LNode) return exists(KeyName(key));
+  EXCEPTION_PROLOGUE;
+  if (YNode) return !YNode.IsScalar() && YNode[KeyNode(key)].IsDefined();
+  else {
+    assert(false);
+    return false;
+  }
+  EXCEPTION_EPILOGUE;
+}
+
 bool CompoundConfigNode::lookupArrayValue(const char* name, std::vector<std::string> &vectorValue) const {
   EXCEPTION_PROLOGUE;
 
@@ -519,6 +684,203 @@ bool CompoundConfigNode::getMapKeys(std::vector<std::string> &mapKeys) {
     return false;
   }
 }
+/* Binary config cache */
+
+// Optional pre-parsed binary cache for YAML inputs. When enabled (set
+// TIMELOOP_CONFIG_CACHE, matching the opt-in style of the Accelergy table
+// cache), the parsed node tree is serialized next to the source file as
+// <file>.bin, keyed by a content hash of the input text, and later runs
+// rebuild the YAML::Node tree directly from it -- skipping the YAML
+// tokenizer, which dominates startup for large design-space configs. All
+// cache failures (unwritable directory, stale or truncated file, version
+// mismatch) silently fall back to a normal parse.
+
+static const std::uint32_t kConfigCacheVersion = 1;
+static const char kConfigCacheMagic[4] = { 'T', 'L', 'C', 'C' };
+
+static bool configCacheEnabled()
+{
+  const char* env = getenv("TIMELOOP_CONFIG_CACHE");
+  return (env != NULL && *env != '\0' && strcmp(env, "0") != 0);
+}
+
+static std::uint64_t hashConfigString(const std::string& text)
+{
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (char c : text)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Node tree encoding: a type byte (0 null, 1 scalar, 2 sequence, 3 map)
+// followed by a scalar's length-prefixed bytes or a container's
+// length-prefixed children (map children are key-scalar/value pairs).
+// Aliases are expanded, which is how the accessors observe them anyway.
+static void encodeYAMLString(const std::string& s, std::ostream& out)
+{
+  std::uint32_t length = s.size();
+  out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+  out.write(s.data(), length);
+}
+
+static void encodeYAMLNode(const YAML::Node& node, std::ostream& out)
+{
+  std::uint8_t type;
+  if (node.IsScalar()) type = 1;
+  else if (node.IsSequence()) type = 2;
+  else if (node.IsMap()) type = 3;
+  else type = 0;
+  out.write(reinterpret_cast<const char*>(&type), sizeof(type));
+
+  if (type == 1)
+  {
+    encodeYAMLString(node.Scalar(), out);
+  }
+  else if (type == 2)
+  {
+    std::uint32_t length = node.size();
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    for (auto it = node.begin(); it != node.end(); it++)
+      encodeYAMLNode(*it, out);
+  }
+  else if (type == 3)
+  {
+    std::uint32_t length = node.size();
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    for (auto it = node.begin(); it != node.end(); it++)
+    {
+      encodeYAMLString(it->first.as<std::string>(), out);
+      encodeYAMLNode(it->second, out);
+    }
+  }
+}
+
+static bool decodeYAMLString(std::istream& in, std::string& s)
+{
+  std::uint32_t length;
+  if (!in.read(reinterpret_cast<char*>(&length), sizeof(length)))
+    return false;
+  s.resize(length);
+  return bool(in.read(&s[0], length));
+}
+
+static bool decodeYAMLNode(std::istream& in, YAML::Node& node)
+{
+  std::uint8_t type;
+  if (!in.read(reinterpret_cast<char*>(&type), sizeof(type)))
+    return false;
+
+  if (type == 0)
+  {
+    node = YAML::Node();
+  }
+  else if (type == 1)
+  {
+    std::string scalar;
+    if (!decodeYAMLString(in, scalar))
+      return false;
+    node = YAML::Node(scalar);
+  }
+  else if (type == 2 || type == 3)
+  {
+    std::uint32_t length;
+    if (!in.read(reinterpret_cast<char*>(&length), sizeof(length)))
+      return false;
+    node = YAML::Node(type == 2 ? YAML::NodeType::Sequence : YAML::NodeType::Map);
+    for (std::uint32_t i = 0; i < length; i++)
+    {
+      std::string key;
+      if (type == 3 && !decodeYAMLString(in, key))
+        return false;
+      YAML::Node child;
+      if (!decodeYAMLNode(in, child))
+        return false;
+      if (type == 2)
+        node.push_back(child);
+      else
+        node[key] = child;
+    }
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+static bool loadConfigCache(const std::string& path, std::uint64_t content_hash,
+                            YAML::Node& config)
+{
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+
+  char magic[4];
+  std::uint32_t version;
+  std::uint64_t hash;
+  if (!in.read(magic, sizeof(magic)) ||
+      memcmp(magic, kConfigCacheMagic, sizeof(magic)) != 0 ||
+      !in.read(reinterpret_cast<char*>(&version), sizeof(version)) ||
+      version != kConfigCacheVersion ||
+      !in.read(reinterpret_cast<char*>(&hash), sizeof(hash)) ||
+      hash != content_hash)
+    return false;
+
+  return decodeYAMLNode(in, config);
+}
+
+static void storeConfigCache(const std::string& path, std::uint64_t content_hash,
+                             const YAML::Node& config)
+{
+  // Write to a pid-suffixed temporary and rename, so concurrent processes
+  // (e.g., forked design-space sweep points) never observe a partial file.
+  std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+  {
+    std::ofstream out(tmp_path, std::ios::binary);
+    if (!out)
+      return;
+    out.write(kConfigCacheMagic, sizeof(kConfigCacheMagic));
+    out.write(reinterpret_cast<const char*>(&kConfigCacheVersion),
+              sizeof(kConfigCacheVersion));
+    out.write(reinterpret_cast<const char*>(&content_hash), sizeof(content_hash));
+    encodeYAMLNode(config, out);
+    if (!out)
+    {
+      out.close();
+      remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0)
+    remove(tmp_path.c_str());
+}
+
+// Parse YAML text, going through the binary cache at <cache_path>.bin
+// when enabled.
+static YAML::Node loadYAMLCached(const std::string& text, const std::string& cache_path)
+{
+  if (!configCacheEnabled())
+  {
+    std::istringstream stream(text);
+    return YAML::Load(stream);
+  }
+
+  std::string path = cache_path + ".bin";
+  std::uint64_t content_hash = hashConfigString(text);
+
+  YAML::Node config;
+  if (loadConfigCache(path, content_hash, config))
+    return config;
+
+  std::istringstream stream(text);
+  config = YAML::Load(stream);
+  storeConfigCache(path, content_hash, config);
+  return config;
+}
+
 /* CompoundConfig */
 
 CompoundConfig::CompoundConfig(const char* inputFile) {
@@ -528,9 +890,11 @@ CompoundConfig::CompoundConfig(const char* inputFile) {
     useLConfig = true;
     root = CompoundConfigNode(&lroot, YAML::Node(), this);
   } else if (std::strstr(inputFile, ".yml") || std::strstr(inputFile, ".yaml")) {
-    std::ifstream f;
-    f.open(inputFile);
-    YConfig = YAML::Load(f);
+    std::ifstream fin;
+    fin.open(inputFile);
+    std::string f((std::istreambuf_iterator<char>(fin)),
+                   std::istreambuf_iterator<char>());
+    YConfig = loadYAMLCached(f, inputFile);
     root = CompoundConfigNode(nullptr, YConfig, this);
     useLConfig = false;
     // std::cout << YConfig << std::endl;
@@ -560,8 +924,9 @@ CompoundConfig::CompoundConfig(std::vector<std::string> inputFiles) {
     useLConfig = true;
     root = CompoundConfigNode(&lroot, YAML::Node(), this);
   } else if (std::strstr(inputFiles[0].c_str(), ".yml") || std::strstr(inputFiles[0].c_str(), ".yaml")) {
-    std::istringstream combinedStream(combinedString);
-    YConfig = YAML::Load(combinedStream);
+    // The cache for a multi-file invocation lives next to the first file,
+    // keyed by the hash of the full combined text.
+    YConfig = loadYAMLCached(combinedString, inputFiles[0] + ".combined");
     root = CompoundConfigNode(nullptr, YConfig, this);
     useLConfig = false;
     // std::cout << YConfig << std::endl;
@@ -36,6 +36,60 @@ namespace config
 
 class CompoundConfig; // forward declaration
 
+// Interned keys for the hot spec-parsing vocabulary. The parse loops in
+// the model specs (buffer/topology/arithmetic) and the mapping
+// constraints perform thousands of lookups against this small fixed set
+// of names; passing the interned ID lets the YAML path reuse a
+// pre-encoded key node instead of re-encoding the string on every
+// operator[] call. The canonical spelling lives in one table
+// (see KeyName()), so call sites also cannot drift apart.
+enum class Key : unsigned
+{
+  Name,
+  Class,
+  Attributes,
+  WordBits,
+  WordWidth,
+  Datawidth,
+  BlockSize,
+  NWords,
+  ClusterSize,
+  Width,
+  Entries,
+  Depth,
+  MemoryDepth,
+  SizeKB,
+  Technology,
+  NumPorts,
+  NumBanks,
+  Bandwidth,
+  ReadBandwidth,
+  WriteBandwidth,
+  MultipleBuffering,
+  MinUtilization,
+  Instances,
+  MeshX,
+  MeshY,
+  NetworkRead,
+  NetworkFill,
+  NetworkDrain,
+  NetworkUpdate,
+  VectorAccessEnergy,
+  AddrGenEnergy,
+  ClusterArea,
+  Target,
+  Type,
+  Factors,
+  Permutation,
+  Split,
+  Keep,
+  Bypass,
+  Constraints,
+  Num
+};
+
+const char* KeyName(Key key);
+
 class CompoundConfigNode
 {
  private:
@@ -54,6 +108,7 @@ class CompoundConfigNode
   CompoundConfigNode lookup(const char *path) const;
   inline CompoundConfigNode lookup(const std::string &path) const
   { return(lookup(path.c_str())); }
+  CompoundConfigNode lookup(Key key) const;
 
   bool lookupValue(const char *name, bool &value) const;
   bool lookupValue(const char *name, int &value) const;
@@ -65,6 +120,15 @@ class CompoundConfigNode
   bool lookupValue(const char *name, const char *&value) const;
   bool lookupValue(const char *name, std::string &value) const;
 
+  bool lookupValue(Key key, bool &value) const;
+  bool lookupValue(Key key, int &value) const;
+  bool lookupValue(Key key, unsigned int &value) const;
+  bool lookupValue(Key key, long long &value) const;
+  bool lookupValue(Key key, unsigned long long &value) const;
+  bool lookupValue(Key key, double &value) const;
+  bool lookupValue(Key key, float &value) const;
+  bool lookupValue(Key key, std::string &value) const;
+
   inline bool lookupValue(const std::string &name, bool &value) const
   { return(lookupValue(name.c_str(), value)); }
 
@@ -98,6 +162,8 @@ class CompoundConfigNode
   inline bool exists(const std::string &name) const
   { return(exists(name.c_str())); }
 
+  bool exists(Key key) const;
+
   bool lookupArrayValue(const char* name, std::vector<std::string> &vectorValue) const;
 
   inline bool lookupArrayValue(const std::string &name, std::vector<std::string> &vectorValue) const
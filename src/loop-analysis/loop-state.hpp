@@ -28,6 +28,7 @@
 #pragma once
 
 #include "mapping/loop.hpp"
+#include "util/inline-vector.hpp"
 #include "workload/problem-shape.hpp"
 #include "workload/operation-space.hpp"
 #include "workload/workload.hpp"
@@ -45,9 +46,9 @@ struct ElementState
 
   // Multicast functionality
   // Stores accesses with various multicast factors for each data type
-  problem::PerDataSpace<std::vector<unsigned long>> accesses;
-  problem::PerDataSpace<std::vector<unsigned long>> scatter_factors;
-  problem::PerDataSpace<std::vector<double>> cumulative_hops;
+  problem::PerDataSpace<InlineVector<unsigned long>> accesses;
+  problem::PerDataSpace<InlineVector<unsigned long>> scatter_factors;
+  problem::PerDataSpace<InlineVector<double>> cumulative_hops;
   problem::PerDataSpace<std::map<unsigned long, unsigned long>> delta_histograms;
 
   // PE activity
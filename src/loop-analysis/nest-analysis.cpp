@@ -26,8 +26,10 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <stdexcept>
+#include <thread>
 
 // FIXME: num_spatial_elems, spatial_fanouts, replication_factor etc. are
 //        all maintained across datatypes. They should be per-datatype at
@@ -40,23 +42,527 @@
 //        limited to the ComputeNetworkLinkTransfers() function.
 
 #include "util/misc.hpp"
+#include "util/cycle-timer.hpp"
+#include "util/perf-counters.hpp"
+#include "util/alloc-tracker.hpp"
 
 #include "nest-analysis.hpp"
 
 extern bool gTerminateEval;
 
+// Global force-on for link-transfer modeling. Per-level opt-in now lives in
+// the arch spec (the link-transfers network attribute, see
+// NestAnalysis::SetLinkTransferLevels()); the env var is kept as an override
+// so old sweep configurations keep working.
 bool gEnableLinkTransfers = (getenv("TIMELOOP_ENABLE_LINK_TRANSFERS") != NULL);
 bool gEnableLinkTransferWarning = false;
 bool gExtrapolateUniformTemporal = true;
 bool gExtrapolateUniformSpatial = (getenv("TIMELOOP_DISABLE_SPATIAL_EXTRAPOLATION") == NULL);
+bool gEnableNestMemo = (getenv("TIMELOOP_DISABLE_NEST_MEMO") == NULL);
+bool gEnableMulticastMemo = (getenv("TIMELOOP_DISABLE_MULTICAST_MEMO") == NULL);
+// Re-use memoized analyses across nests that differ only in their spatial
+// X/Y split (see NestAnalysis::LookupSplitMemo()).
+bool gEnableSplitReplay = (getenv("TIMELOOP_DISABLE_SPLIT_REPLAY") == NULL);
+bool gAnalyticalDeltaSizes = (getenv("TIMELOOP_DISABLE_ANALYTICAL_DELTAS") == NULL);
+
+// Fan the spatial-delta extrapolation loop out across worker threads. Off by
+// default: the mapper already keeps every core busy at mapping granularity,
+// so this only helps single-evaluation workflows (e.g., the model app) on
+// architectures with very large spatial fanouts.
+bool gParallelSpatialDeltas = (getenv("TIMELOOP_NEST_PARALLEL") != NULL);
+
+// Shard one evaluation across data spaces: the per-dataspace analyses only
+// join at tile collection, so each data space can run on its own helper
+// thread (see ComputeWorkingSets()). Off by default for the same reason as
+// above -- it cuts single-evaluation latency, not mapper throughput.
+bool gParallelDataspaceAnalysis = (getenv("TIMELOOP_PARALLEL_DATASPACES") != NULL);
 
 namespace analysis
 {
 
+// Minimum number of extrapolated spatial elements before FillSpatialDeltas
+// bothers spawning worker threads; below this the spawn/join overhead wins.
+static const std::uint64_t kMinParallelSpatialDeltas = 1024;
+
+// Maximum number of completed analyses each thread retains. Search
+// algorithms revisit permutation variants around a small set of
+// factorizations, so a small working set captures most of the reuse. Kept
+// deliberately tiny: entries hold full tile nests, and eviction is a linear
+// least-recently-used scan over the table.
+static const std::size_t kNestMemoMaxEntries = 16;
+
+// Per-thread, per-level scratch buffers for ComputeSpatialWorkingSet and
+// friends. Every invocation at a given nest level used to construct (and
+// immediately free) the spatial-delta array plus half a dozen per-data-space
+// vectors; recycling the buffers across invocations keeps mapping evaluation
+// off the allocator. Frames are indexed by nest level: recursive invocations
+// are always at distinct levels, so each live stack frame gets a private
+// scratch frame.
+struct SpatialScratchFrame
+{
+  std::vector<problem::OperationSpace> spatial_deltas;
+  std::vector<bool> valid_delta;
+  std::vector<problem::PerDataSpace<bool>> unaccounted_delta;
+  std::vector<problem::PerDataSpace<bool>> inter_elem_reuse;
+
+  problem::PerDataSpace<InlineVector<std::uint64_t>>
+    accesses_without_link_transfers, accesses_with_link_transfers,
+    scatter_factors_without_link_transfers, scatter_factors_with_link_transfers;
+
+  problem::PerDataSpace<InlineVector<double>>
+    cumulative_hops_without_link_transfers, cumulative_hops_with_link_transfers;
+
+  // Flattened per-element corner records and emptiness flags for the
+  // link-transfer neighbor matching (see ComputeNetworkLinkTransfers()).
+  std::vector<Coordinate> cur_corners, prev_corners;
+  std::vector<std::uint8_t> delta_nonempty;
+
+  // Multicast group structure of the most recent accounting pass at this
+  // level, as (bin, member linear IDs) in flattened offsets/ids form.
+  // Filled by ComputeAccurateMulticastedAccesses() on both its computed
+  // and memo-replayed paths, and harvested by ComputeSpatialWorkingSet()
+  // for the split-variant replay data (see SpatialGroupReplay).
+  problem::PerDataSpace<std::vector<std::uint32_t>>
+    group_bins, group_offsets, group_ids;
+};
+
+static SpatialScratchFrame& SpatialScratch(unsigned level)
+{
+  static thread_local std::map<unsigned, SpatialScratchFrame> frames;
+  return frames[level];
+}
+
 NestAnalysis::NestAnalysis()
 {
 }
 
+std::unordered_map<std::uint64_t, NestAnalysis::MemoEntry>& NestAnalysis::MemoTable()
+{
+  static thread_local std::unordered_map<std::uint64_t, MemoEntry> table;
+  return table;
+}
+
+// Secondary index over MemoTable(): split-normalized nest hash -> exact
+// hash of a replayable representative entry. Entries may be evicted from
+// the memo table underneath this index, so lookups re-validate against
+// the table (see LookupSplitMemo()).
+std::unordered_map<std::uint64_t, std::uint64_t>& NestAnalysis::SplitIndexTable()
+{
+  static thread_local std::unordered_map<std::uint64_t, std::uint64_t> table;
+  return table;
+}
+
+// Per-thread nest-cache bookkeeping: a monotonic clock for LRU stamping,
+// plus hit/miss counters for the mapper's final stats.
+struct MemoCounters
+{
+  std::uint64_t clock = 0;
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+};
+
+static MemoCounters& MemoStats()
+{
+  static thread_local MemoCounters counters;
+  return counters;
+}
+
+std::uint64_t NestAnalysis::MemoHits()
+{
+  return MemoStats().hits;
+}
+
+std::uint64_t NestAnalysis::MemoMisses()
+{
+  return MemoStats().misses;
+}
+
+// FNV-1a over the nest structure and the workload parameters. Everything that
+// influences the analysis results must be folded in here: loop descriptors,
+// storage tiling boundaries, problem bounds, projection coefficients and
+// data densities.
+std::uint64_t NestAnalysis::HashNestAndWorkload(const loop::Nest& nest,
+                                                bool normalize_split) const
+{
+  std::uint64_t hash = 14695981039346656037ULL;
+  auto HashWord = [&hash](std::uint64_t word)
+    {
+      hash = (hash ^ word) * 1099511628211ULL;
+    };
+
+  // With normalize_split set, SpaceX and SpaceY loops hash to a common
+  // token so that nests differing only in their spatial split share a
+  // hash (the split-variant replay key, see LookupSplitMemo()).
+  const std::uint64_t kSpatialToken = std::uint64_t(-1);
+
+  for (auto& loop: nest.loops)
+  {
+    HashWord(std::uint64_t(loop.dimension));
+    HashWord(std::uint64_t(std::int64_t(loop.start)));
+    HashWord(std::uint64_t(std::int64_t(loop.end)));
+    HashWord(std::uint64_t(std::int64_t(loop.stride)));
+    if (normalize_split && loop::IsSpatial(loop.spacetime_dimension))
+      HashWord(kSpatialToken);
+    else
+      HashWord(std::uint64_t(loop.spacetime_dimension));
+  }
+
+  for (auto& boundary: nest.storage_tiling_boundaries)
+  {
+    HashWord(boundary);
+  }
+
+  for (unsigned dim = 0; dim < problem::GetShape()->NumDimensions; dim++)
+  {
+    HashWord(std::uint64_t(std::int64_t(workload_->GetBound(dim))));
+  }
+
+  for (unsigned c = 0; c < problem::GetShape()->NumCoefficients; c++)
+  {
+    HashWord(std::uint64_t(std::int64_t(workload_->GetCoefficient(c))));
+  }
+
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    std::uint64_t word;
+    double density = workload_->GetDensity(pv);
+    memcpy(&word, &density, sizeof(word));
+    HashWord(word);
+  }
+
+  // Approximate-mode and bounds-only results are not interchangeable with
+  // full-fidelity ones; keep them under separate hashes.
+  HashWord(std::uint64_t(approx_));
+  HashWord(std::uint64_t(bounds_only_));
+
+  // A masked shard's results are only valid for the same mask (empty mask
+  // == all data spaces, hashed as zero).
+  std::uint64_t mask_word = 0;
+  for (unsigned pv = 0; pv < active_data_spaces_.size(); pv++)
+  {
+    mask_word = (mask_word << 1) | (active_data_spaces_.at(pv) ? 1 : 0);
+  }
+  HashWord(mask_word);
+
+  // Link-transfer configuration changes the computed access counts, so
+  // analyses under different configurations never share results.
+  std::uint64_t link_word = 0;
+  for (unsigned l = 0; l < link_transfer_levels_.size(); l++)
+  {
+    link_word = (link_word << 1) | (link_transfer_levels_.at(l) ? 1 : 0);
+  }
+  HashWord(link_word);
+
+  return hash;
+}
+
+void NestAnalysis::FillMemoKey(MemoEntry& entry) const
+{
+  entry.nest = cached_nest;
+
+  entry.bounds.clear();
+  for (unsigned dim = 0; dim < problem::GetShape()->NumDimensions; dim++)
+  {
+    entry.bounds.push_back(workload_->GetBound(dim));
+  }
+
+  entry.coefficients.clear();
+  for (unsigned c = 0; c < problem::GetShape()->NumCoefficients; c++)
+  {
+    entry.coefficients.push_back(workload_->GetCoefficient(c));
+  }
+
+  entry.densities.clear();
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    entry.densities.push_back(workload_->GetDensity(pv));
+  }
+
+  entry.approx = approx_;
+  entry.bounds_only = bounds_only_;
+  entry.active_data_spaces = active_data_spaces_;
+  entry.link_transfer_levels = link_transfer_levels_;
+}
+
+// Collision check against the live analysis state, without materializing
+// a key MemoEntry: FillMemoKey() copies the whole nest and three vectors,
+// which shows up on every memoized evaluation, so the lookup path
+// compares in place instead. Must stay in lockstep with FillMemoKey().
+bool NestAnalysis::MatchesMemoKey(const MemoEntry& entry) const
+{
+  if (entry.approx != approx_ || entry.bounds_only != bounds_only_ ||
+      entry.active_data_spaces != active_data_spaces_ ||
+      entry.link_transfer_levels != link_transfer_levels_ ||
+      !(entry.nest == cached_nest))
+  {
+    return false;
+  }
+
+  if (entry.bounds.size() != std::size_t(problem::GetShape()->NumDimensions) ||
+      entry.coefficients.size() != std::size_t(problem::GetShape()->NumCoefficients) ||
+      entry.densities.size() != std::size_t(problem::GetShape()->NumDataSpaces))
+  {
+    return false;
+  }
+
+  for (unsigned dim = 0; dim < problem::GetShape()->NumDimensions; dim++)
+  {
+    if (entry.bounds.at(dim) != workload_->GetBound(dim))
+      return false;
+  }
+  for (unsigned c = 0; c < problem::GetShape()->NumCoefficients; c++)
+  {
+    if (entry.coefficients.at(c) != workload_->GetCoefficient(c))
+      return false;
+  }
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    if (entry.densities.at(pv) != workload_->GetDensity(pv))
+      return false;
+  }
+
+  return true;
+}
+
+// Like MatchesMemoKey(), but for split-variant replay: the nests may
+// differ in the SpaceX/SpaceY labels of their spatial loops (everything
+// else, including which loops are spatial at all, must match).
+bool NestAnalysis::MatchesMemoKeySplit(const MemoEntry& entry) const
+{
+  if (entry.approx != approx_ || entry.bounds_only != bounds_only_ ||
+      entry.active_data_spaces != active_data_spaces_ ||
+      entry.link_transfer_levels != link_transfer_levels_)
+  {
+    return false;
+  }
+
+  if (entry.nest.loops.size() != cached_nest.loops.size() ||
+      entry.nest.storage_tiling_boundaries != cached_nest.storage_tiling_boundaries)
+  {
+    return false;
+  }
+  for (unsigned l = 0; l < cached_nest.loops.size(); l++)
+  {
+    auto& a = entry.nest.loops.at(l);
+    auto& b = cached_nest.loops.at(l);
+    if (a.dimension != b.dimension || a.start != b.start ||
+        a.end != b.end || a.stride != b.stride)
+    {
+      return false;
+    }
+    bool a_spatial = loop::IsSpatial(a.spacetime_dimension);
+    bool b_spatial = loop::IsSpatial(b.spacetime_dimension);
+    if (a_spatial != b_spatial ||
+        (!a_spatial && a.spacetime_dimension != b.spacetime_dimension))
+    {
+      return false;
+    }
+  }
+
+  if (entry.bounds.size() != std::size_t(problem::GetShape()->NumDimensions) ||
+      entry.coefficients.size() != std::size_t(problem::GetShape()->NumCoefficients) ||
+      entry.densities.size() != std::size_t(problem::GetShape()->NumDataSpaces))
+  {
+    return false;
+  }
+  for (unsigned dim = 0; dim < problem::GetShape()->NumDimensions; dim++)
+  {
+    if (entry.bounds.at(dim) != workload_->GetBound(dim))
+      return false;
+  }
+  for (unsigned c = 0; c < problem::GetShape()->NumCoefficients; c++)
+  {
+    if (entry.coefficients.at(c) != workload_->GetCoefficient(c))
+      return false;
+  }
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    if (entry.densities.at(pv) != workload_->GetDensity(pv))
+      return false;
+  }
+
+  return true;
+}
+
+bool NestAnalysis::LookupMemo()
+{
+  auto& counters = MemoStats();
+  auto& table = MemoTable();
+  auto it = table.find(nest_hash_);
+  if (it == table.end())
+  {
+    counters.misses++;
+    return false;
+  }
+
+  // Verify the full key to guard against hash collisions.
+  auto& entry = it->second;
+  if (!MatchesMemoKey(entry))
+  {
+    counters.misses++;
+    return false;
+  }
+
+  working_sets_ = entry.working_sets;
+  body_info_ = entry.body_info;
+  working_sets_computed_ = true;
+
+  counters.hits++;
+  entry.last_used = ++counters.clock;
+
+  return true;
+}
+
+// Split-variant replay: if an exact lookup missed, check whether we have
+// memoized a nest that differs from this one only in how its spatial loops
+// are labeled SpaceX vs. SpaceY. Such nests generate identical spatial
+// deltas (the linearized spatial IDs are label-independent), so all tile
+// sizes, access counts, scatter factors and temporal results carry over
+// verbatim; only the hop counts depend on the physical X/Y arrangement.
+// We rebuild those from the memoized multicast group structure under this
+// nest's geometry.
+bool NestAnalysis::LookupSplitMemo()
+{
+  auto& counters = MemoStats();
+  auto& table = MemoTable();
+  auto& index = SplitIndexTable();
+
+  auto idx_it = index.find(split_hash_);
+  if (idx_it == index.end())
+  {
+    return false;
+  }
+
+  // The index may point at an entry that has since been evicted or
+  // recycled; re-validate before trusting it.
+  auto it = table.find(idx_it->second);
+  if (it == table.end() || it->second.split_hash != split_hash_ ||
+      !it->second.split_replayable || !MatchesMemoKeySplit(it->second))
+  {
+    index.erase(idx_it);
+    return false;
+  }
+
+  auto& entry = it->second;
+  working_sets_ = entry.working_sets;
+  body_info_ = entry.body_info;
+  entry.last_used = ++counters.clock;
+
+  // Re-derive this nest's per-level properties; of these only
+  // horizontal_sizes_/vertical_sizes_ differ from the memoized variant's.
+  InitializeNestProperties();
+
+  // CollectWorkingSets() emits one tile per valid level, innermost first,
+  // so recover each analysis level's tile index by walking nest_state_.
+  std::vector<unsigned> tile_index(nest_state_.size());
+  unsigned tiling_level = 0;
+  for (auto& cur: nest_state_)
+  {
+    tile_index.at(cur.level) = tiling_level;
+    bool valid_level = !loop::IsSpatial(cur.descriptor.spacetime_dimension) ||
+      master_spatial_level_[cur.level];
+    if (valid_level)
+    {
+      tiling_level++;
+    }
+  }
+
+  for (auto& replay_it: entry.spatial_groups)
+  {
+    unsigned level = replay_it.first;
+    auto& replay = replay_it.second;
+    std::uint64_t h_size = horizontal_sizes_.at(level);
+    double v_center = double(vertical_sizes_.at(level) - 1) / 2;
+
+    for (unsigned pv = 0; pv < unsigned(problem::GetShape()->NumDataSpaces); pv++)
+    {
+      auto& cumulative_hops =
+        working_sets_.at(pv).at(tile_index.at(level)).cumulative_hops;
+      for (std::uint64_t i = 0; i < cumulative_hops.size(); i++)
+      {
+        cumulative_hops[i] = 0;
+      }
+
+      auto& bins = replay.bins[pv];
+      auto& offsets = replay.offsets[pv];
+      auto& ids = replay.ids[pv];
+      for (std::size_t g = 0; g < bins.size(); g++)
+      {
+        double hops = 0;
+        std::uint64_t h_max = 0;
+        for (auto k = offsets.at(g); k < offsets.at(g + 1); k++)
+        {
+          h_max = std::max(h_max, std::uint64_t(ids.at(k)) % h_size);
+        }
+        hops += double(h_max);
+        for (auto k = offsets.at(g); k < offsets.at(g + 1); k++)
+        {
+          hops += std::abs(double(ids.at(k) / h_size) - v_center);
+        }
+        cumulative_hops.at(bins.at(g)) += hops;
+      }
+    }
+  }
+
+  // Memoize under this nest's exact hash so that its own re-evaluations
+  // become plain hits, and keep the group structure flowing so that
+  // further split variants can replay from the new entry too. Copy before
+  // InsertMemo(): insertion may rehash/evict and invalidate `entry`.
+  split_replay_capture_ = entry.spatial_groups;
+  split_replay_valid_ = true;
+  working_sets_computed_ = true;
+  InsertMemo();
+
+  counters.hits++;
+  return true;
+}
+
+void NestAnalysis::InsertMemo()
+{
+  auto& counters = MemoStats();
+  auto& table = MemoTable();
+  if (table.size() >= kNestMemoMaxEntries)
+  {
+    // Evict the least-recently-used entry. The table is small enough that a
+    // linear scan beats maintaining a separate recency list.
+    auto victim = table.begin();
+    for (auto it = table.begin(); it != table.end(); it++)
+    {
+      if (it->second.last_used < victim->second.last_used)
+      {
+        victim = it;
+      }
+    }
+    table.erase(victim);
+  }
+
+  auto& entry = table[nest_hash_];
+  FillMemoKey(entry);
+  entry.working_sets = working_sets_;
+  entry.body_info = body_info_;
+  entry.split_hash = split_hash_;
+  entry.split_replayable = split_replay_valid_;
+  if (entry.split_replayable)
+  {
+    entry.spatial_groups = split_replay_capture_;
+
+    // The index accretes keys whose memo entries have been evicted;
+    // failed lookups erase them lazily, but bound the table anyway so a
+    // long search cannot grow it without limit.
+    auto& index = SplitIndexTable();
+    if (index.size() >= 4 * kNestMemoMaxEntries)
+    {
+      index.clear();
+    }
+    index[split_hash_] = nest_hash_;
+  }
+  else
+  {
+    entry.spatial_groups.clear();
+  }
+  entry.last_used = ++counters.clock;
+}
+
 void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest)
 {
   assert(nest != NULL);
@@ -68,6 +574,50 @@ void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest)
   {
     // We've already worked on an identical nest before.
   }
+  else if (nest_state_.size() == nest->loops.size() &&
+           cached_nest.storage_tiling_boundaries == nest->storage_tiling_boundaries)
+  {
+    // Incremental re-initialization: the new nest has the same shape (same
+    // loop count and storage tiling boundaries) as the one we last analyzed,
+    // which is the common case when a search algorithm walks adjacent
+    // index-factorization or permutation points. Patch the descriptors in
+    // place and recycle every live-state allocation instead of tearing the
+    // whole analysis state down with Reset().
+    //
+    // Note that we cannot reuse the *analysis results* of the unchanged
+    // inner levels: access counts accumulated at the inner levels scale
+    // with epoch counts contributed by the outer loops, so a changed outer
+    // bound invalidates them. The memoization table handles the
+    // whole-nest-unchanged case.
+    if (!(cached_nest == *nest))
+    {
+      ltw_sizes_valid_ = false;
+    }
+    cached_nest = *nest;
+    storage_tiling_boundaries_ = nest->storage_tiling_boundaries;
+
+    for (std::uint64_t level = 0; level < nest_state_.size(); level++)
+    {
+      nest_state_[level].descriptor = nest->loops[level];
+    }
+
+    for (auto& tile_nest: working_sets_)
+    {
+      tile_nest.clear();
+    }
+    body_info_.Reset();
+    working_sets_computed_ = false;
+
+    if (gEnableNestMemo)
+    {
+      nest_hash_ = HashNestAndWorkload(*nest);
+      split_hash_ = HashNestAndWorkload(*nest, true);
+      if (!LookupMemo() && gEnableSplitReplay)
+      {
+        LookupSplitMemo();
+      }
+    }
+  }
   else
   {
     Reset();
@@ -89,7 +639,20 @@ void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest)
         cur.level = nest_state_.back().level + 1;
       }
       cur.descriptor = descriptor;
-      nest_state_.push_back(cur);    
+      nest_state_.push_back(cur);
+    }
+
+    // Consult the per-thread memo table to see if an earlier mapping
+    // (possibly from a different search point) already completed an
+    // analysis of this exact (nest, workload) pair.
+    if (gEnableNestMemo)
+    {
+      nest_hash_ = HashNestAndWorkload(*nest);
+      split_hash_ = HashNestAndWorkload(*nest, true);
+      if (!LookupMemo() && gEnableSplitReplay)
+      {
+        LookupSplitMemo();
+      }
     }
   }
 }
@@ -127,15 +690,32 @@ void NestAnalysis::Reset()
   linked_spatial_level_.clear();
 
   working_sets_computed_ = false;
-  
+  nest_hash_ = 0;
+  split_hash_ = 0;
+  split_replay_capture_.clear();
+  split_replay_valid_ = false;
+
+  ltw_sizes_.clear();
+  ltw_sizes_valid_ = false;
+
+  multicast_memo_.clear();
+  multicast_memo_clock_ = 0;
+
   body_info_.Reset();
 }
 
 // Ugly function for pre-checking capacity fits before running the heavyweight
 // ComputeWorkingSets() algorithm. FIXME: Integrate with ComputeWorkingSets().
-std::vector<problem::PerDataSpace<std::size_t>>
+const std::vector<problem::PerDataSpace<std::size_t>>&
 NestAnalysis::GetWorkingSetSizes_LTW() const
 {
+  // Bypass masks play no part in these sizes, so the cached result serves
+  // every datatype-bypass variant of the current nest.
+  if (ltw_sizes_valid_)
+  {
+    return ltw_sizes_;
+  }
+
   std::vector<problem::PerDataSpace<std::size_t>> working_set_sizes;
 
   problem::OperationPoint origin;
@@ -164,10 +744,69 @@ NestAnalysis::GetWorkingSetSizes_LTW() const
   }
 
   ASSERT(working_set_sizes.size() == storage_tiling_boundaries_.size());
-  return working_set_sizes;
+
+  ltw_sizes_ = std::move(working_set_sizes);
+  ltw_sizes_valid_ = true;
+  return ltw_sizes_;
 }
 
-problem::PerDataSpace<std::vector<tiling::TileInfo>>
+// Like GetWorkingSetSizes_LTW(), but computes per-data-space *lower bounds*
+// purely arithmetically from the loop bounds, with no analysis state and no
+// operation-space projections. For each data-space rank we take the largest
+// extent among the problem dimensions projecting onto it: any term with a
+// nonzero coefficient contributes at least its full dimension extent to the
+// rank, so the product over ranks is a true lower bound on the exact
+// working-set size. A mapping whose lower bound already exceeds a buffer's
+// capacity can therefore be rejected without constructing the nest.
+std::vector<problem::PerDataSpace<std::size_t>> NestAnalysis::MinWorkingSetSizes_LTW(
+  const loop::Nest& nest, const problem::Workload* wc)
+{
+  std::vector<problem::PerDataSpace<std::size_t>> min_sizes;
+
+  problem::PerProblemDimension<std::size_t> dimension_sizes;
+  dimension_sizes.fill(1);
+
+  unsigned tiling_level = 0;
+  for (unsigned loop_level = 0; loop_level < nest.loops.size(); loop_level++)
+  {
+    auto& loop = nest.loops.at(loop_level);
+    ASSERT(loop.stride == 1);
+    dimension_sizes[loop.dimension] *= loop.end;
+
+    if (loop_level == nest.storage_tiling_boundaries.at(tiling_level))
+    {
+      problem::PerDataSpace<std::size_t> sizes;
+      for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+      {
+        std::size_t size = 1;
+        for (auto& expression: problem::GetShape()->Projections.at(pv))
+        {
+          std::size_t extent = 1;
+          for (auto& term: expression)
+          {
+            // Skip terms that a zero coefficient wipes out of the
+            // projection.
+            if (term.first != problem::GetShape()->NumCoefficients &&
+                wc->GetCoefficient(term.first) == 0)
+            {
+              continue;
+            }
+            extent = std::max(extent, std::size_t(dimension_sizes[term.second]));
+          }
+          size *= extent;
+        }
+        sizes[pv] = size;
+      }
+      min_sizes.push_back(sizes);
+      tiling_level++;
+    }
+  }
+
+  ASSERT(min_sizes.size() == nest.storage_tiling_boundaries.size());
+  return min_sizes;
+}
+
+const problem::PerDataSpace<std::vector<tiling::TileInfo>>&
 NestAnalysis::GetWorkingSets()
 {
   if (!working_sets_computed_)
@@ -202,6 +841,70 @@ void NestAnalysis::ComputeWorkingSets()
 {
   if (nest_state_.size() != 0)
   {
+    // Arm split-variant capture for this evaluation. It may still be
+    // disarmed along the way: link transfers and the sampled (approx)
+    // spatial model make the accounting geometry-dependent.
+    split_replay_capture_.clear();
+    split_replay_valid_ = gEnableNestMemo && gEnableSplitReplay &&
+                          !approx_ && split_hash_ != 0;
+
+    unsigned num_data_spaces = problem::GetShape()->NumDataSpaces;
+    if (gParallelDataspaceAnalysis && num_data_spaces > 1 &&
+        active_data_spaces_.empty())
+    {
+      // Per-dataspace parallel mode: the individual data spaces' analyses
+      // only join at tile collection, so shard this evaluation into one
+      // masked clone per data space, run all but the first on scoped
+      // helper threads, and gather each shard's tiles. Each shard still
+      // walks the full nest but only projects and subtracts its own data
+      // space, so this trades some total work for single-evaluation
+      // latency -- which is what the model app and simple-mapper feel.
+      std::vector<NestAnalysis> shards(num_data_spaces, *this);
+      for (unsigned pv = 0; pv < num_data_spaces; pv++)
+      {
+        auto& shard = shards.at(pv);
+        shard.active_data_spaces_.assign(num_data_spaces, false);
+        shard.active_data_spaces_.at(pv) = true;
+        // Re-key the shard's memo hash: Init() hashed the unmasked
+        // analysis, and masked results must never alias it. Shards skip
+        // split-variant capture (a zero split hash disarms it) -- the
+        // merged result below is what future evaluations want.
+        shard.nest_hash_ = shard.HashNestAndWorkload(shard.cached_nest);
+        shard.split_hash_ = 0;
+      }
+
+      std::vector<std::thread> helpers;
+      for (unsigned pv = 1; pv < num_data_spaces; pv++)
+      {
+        helpers.emplace_back([&shards, pv]() { shards.at(pv).ComputeWorkingSets(); });
+      }
+      shards.at(0).ComputeWorkingSets();
+      for (auto& helper: helpers)
+      {
+        helper.join();
+      }
+
+      for (unsigned pv = 0; pv < num_data_spaces; pv++)
+      {
+        working_sets_.at(pv) = std::move(shards.at(pv).working_sets_.at(pv));
+      }
+      // The body (arithmetic) info is dataspace-independent; take it from
+      // the shard that ran on this thread.
+      body_info_ = shards.at(0).body_info_;
+
+      // Memoize the merged result under this analysis's unmasked key.
+      // No shard captured group structure, so the entry cannot seed
+      // split-variant replays.
+      split_replay_valid_ = false;
+      if (gEnableNestMemo)
+      {
+        InsertMemo();
+      }
+
+      working_sets_computed_ = true;
+      return;
+    }
+
     InitializeNestProperties();
     InitializeLiveState();
 
@@ -211,6 +914,13 @@ void NestAnalysis::ComputeWorkingSets()
     ComputeDataDensity();
 
     CollectWorkingSets();
+
+    // Memoize the completed analysis for reuse by later mappings that
+    // share this exact nest.
+    if (gEnableNestMemo)
+    {
+      InsertMemo();
+    }
   }
 
   // Done.
@@ -260,6 +970,8 @@ void NestAnalysis::InitializeLiveState()
     {
       // we don't need live state for non-master spatial levels
       loop->live_state.resize(num_spatial_elems_[loop->level]);
+      TRACK_ALLOC("live-state ElementState array",
+                  num_spatial_elems_[loop->level] * sizeof(ElementState));
     }
 
     for (auto& it : loop->live_state)
@@ -395,7 +1107,8 @@ void NestAnalysis::CollectWorkingSets()
 // Unless skip_delta is true, returns the delta between the working set of the
 // previous iteration and the current iteration of the current level.
 problem::OperationSpace NestAnalysis::ComputeDeltas(
-    std::vector<analysis::LoopState>::reverse_iterator cur, bool skip_delta)
+    std::vector<analysis::LoopState>::reverse_iterator cur, bool skip_delta,
+    bool sizes_only)
 {
   ASSERT(cur != nest_state_.rend());
   ASSERT(spatial_id_ < cur->live_state.size());
@@ -459,7 +1172,24 @@ problem::OperationSpace NestAnalysis::ComputeDeltas(
   problem::OperationSpace delta(workload_);
   if (!skip_delta)
   {
-    delta = point_set - cur_state.last_point_set;
+    if (sizes_only && bounds_only_)
+    {
+      // Bounds-only backend: the delta size is just the widening of the
+      // per-dimension extents -- interval arithmetic only, no fracture or
+      // gradient analysis. See OperationSpace::GetBoundsOnlyDeltaSizes().
+      delta_sizes_ = point_set.GetBoundsOnlyDeltaSizes(cur_state.last_point_set);
+    }
+    else if (sizes_only && gAnalyticalDeltaSizes)
+    {
+      // The caller only wants delta sizes: compute them (and the gradient
+      // updates the subtraction would have made) in closed form, and leave
+      // the returned delta empty. See ComputeDeltaSizes().
+      delta_sizes_ = point_set.GetDeltaSizes(cur_state.last_point_set);
+    }
+    else
+    {
+      delta = point_set - cur_state.last_point_set;
+    }
   }
 
   if (dump)
@@ -476,10 +1206,36 @@ problem::OperationSpace NestAnalysis::ComputeDeltas(
   return delta;
 }
 
+// Like ComputeDeltas(), but returns only the per-data-space delta *sizes*.
+// The temporal recursion never consumes delta geometry (only the spatial
+// path needs actual point sets, for the multicast and link-transfer
+// analyses), so it can use the closed-form size computation in the AAHR
+// implementation and skip materializing and subtracting point sets
+// altogether. The closed form replicates the subtraction's gradient
+// bookkeeping exactly, so access counts are identical either way.
+problem::PerDataSpace<std::size_t> NestAnalysis::ComputeDeltaSizes(
+    std::vector<analysis::LoopState>::reverse_iterator cur)
+{
+  // The bounds-only backend has no materialized form at all, so it always
+  // takes the sizes-only path regardless of the analytical-deltas switch.
+  if (gAnalyticalDeltaSizes || bounds_only_)
+  {
+    ComputeDeltas(cur, false, true);
+    return delta_sizes_;
+  }
+  else
+  {
+    return ComputeDeltas(cur).GetSizes();
+  }
+}
+
 void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::reverse_iterator cur,
                                      problem::OperationSpace& point_set,
                                      analysis::ElementState& cur_state)
 {
+  timer::Scope timer_scope(timer::Phase::TemporalWorkingSet);
+  perf::Scope perf_scope(timer::Phase::TemporalWorkingSet);
+
   // We do two things in this function: (a) calculate the size of the temporal
   // working set for this level, and (b) calculate the number of accesses to
   // this level from the inner level.
@@ -528,7 +1284,8 @@ void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::r
   // Compute the polyhedron between the low and high problem
   // points (exclusive). Note that this special constructor
   // is only available for certain point-set implementations.
-  point_set = problem::OperationSpace(workload_, low_problem_point, high_problem_point);
+  point_set = problem::OperationSpace(workload_, low_problem_point, high_problem_point,
+                                      active_data_spaces_.empty() ? nullptr : &active_data_spaces_);
 
   if (dump)
   {
@@ -606,10 +1363,10 @@ void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::r
       {
         // Invoke next (inner) loop level.
         ++cur;
-        auto temporal_delta = ComputeDeltas(cur, false);
+        auto temporal_delta_size = ComputeDeltaSizes(cur);
         --cur;
 
-        temporal_delta_sizes.push_back(temporal_delta.GetSizes());
+        temporal_delta_sizes.push_back(temporal_delta_size);
         temporal_delta_scale.push_back(1);
         cur_transform_[dim] += scale;
 
@@ -629,12 +1386,12 @@ void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::r
         num_epochs_ *= virtual_iterations;
 
         ++cur;
-        auto temporal_delta = ComputeDeltas(cur, false);
+        auto temporal_delta_size = ComputeDeltaSizes(cur);
         --cur;
 
         num_epochs_ = saved_epochs;
 
-        temporal_delta_sizes.push_back(temporal_delta.GetSizes());
+        temporal_delta_sizes.push_back(temporal_delta_size);
         temporal_delta_scale.push_back(virtual_iterations);
 
         cur_transform_[dim] += (scale * virtual_iterations);
@@ -647,7 +1404,7 @@ void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::r
       {
         // Invoke next (inner) loop level.
         ++cur;
-        auto temporal_delta = ComputeDeltas(cur, false);
+        auto temporal_delta_size = ComputeDeltaSizes(cur);
         --cur;
 
         // If we ran the virtual-iteration logic above, we shouldn't actually
@@ -660,7 +1417,7 @@ void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::r
         }
         else
         {
-          temporal_delta_sizes.push_back(temporal_delta.GetSizes());
+          temporal_delta_sizes.push_back(temporal_delta_size);
           temporal_delta_scale.push_back(1);
           cur_transform_[dim] += scale;
         }
@@ -683,10 +1440,10 @@ void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::r
       {
         // Invoke next (inner) loop level.
         ++cur;
-        auto temporal_delta = ComputeDeltas(cur);
+        auto temporal_delta_size = ComputeDeltaSizes(cur);
         --cur;
 
-        temporal_delta_sizes.push_back(temporal_delta.GetSizes());
+        temporal_delta_sizes.push_back(temporal_delta_size);
         temporal_delta_scale.push_back(1);
 
         cur_transform_[dim] += scale;
@@ -774,7 +1531,8 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
   // is only available for certain point-set implementations.
   // Note: we aren't using +=. This means we're ignoring subvolumes
   // returned to us by recursive FillSpatialDeltas calls.
-  point_set = problem::OperationSpace(workload_, low_problem_point, high_problem_point);
+  point_set = problem::OperationSpace(workload_, low_problem_point, high_problem_point,
+                                      active_data_spaces_.empty() ? nullptr : &active_data_spaces_);
 
   //
   // Step II: Compute Spatial Deltas, etc.
@@ -783,14 +1541,19 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
   std::uint64_t num_spatial_elems = spatial_fanouts_[level];
   spatial_id_ *= num_spatial_elems;
 
+  auto& scratch = SpatialScratch(level);
+
   // Deltas needed by each of the spatial elements.
   // This array will be filled by recursive calls.
-  std::vector<problem::OperationSpace> spatial_deltas(num_spatial_elems,
-                                                    problem::OperationSpace(workload_));
+  auto& spatial_deltas = scratch.spatial_deltas;
+  spatial_deltas.assign(num_spatial_elems, problem::OperationSpace(workload_));
+  TRACK_ALLOC("spatial-delta OperationSpace array",
+              num_spatial_elems * sizeof(problem::OperationSpace));
 
   // Indicates if each of the elements of the array above, was ever updated
   // by a recursive call. Only needed to ensure correctness.
-  std::vector<bool> valid_delta(num_spatial_elems, false);
+  auto& valid_delta = scratch.valid_delta;
+  valid_delta.assign(num_spatial_elems, false);
 
   FillSpatialDeltas(cur, spatial_deltas, valid_delta, 0 /* base_index */);
   
@@ -817,7 +1580,7 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
   // transfers completely obliterates access to a producer level,
   // use those link transfers only.
 
-  std::vector<problem::PerDataSpace<bool>> unaccounted_delta;
+  auto& unaccounted_delta = scratch.unaccounted_delta;
   unaccounted_delta.resize(num_spatial_elems);
   for (uint64_t i = 0; i < num_spatial_elems; i++)
   {
@@ -828,20 +1591,21 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
   //  auto& accesses = nest_state_[cur->level].live_state[spatial_id_].accesses;
   auto& cur_state = nest_state_[cur->level].live_state[spatial_id_];
 
-  problem::PerDataSpace<std::vector<std::uint64_t>>
-    accesses_without_link_transfers, accesses_with_link_transfers,
-    scatter_factors_without_link_transfers, scatter_factors_with_link_transfers;
+  auto& accesses_without_link_transfers = scratch.accesses_without_link_transfers;
+  auto& accesses_with_link_transfers = scratch.accesses_with_link_transfers;
+  auto& scatter_factors_without_link_transfers = scratch.scatter_factors_without_link_transfers;
+  auto& scatter_factors_with_link_transfers = scratch.scatter_factors_with_link_transfers;
 
-   problem::PerDataSpace<std::vector<double>>
-    cumulative_hops_without_link_transfers, cumulative_hops_with_link_transfers;
+  auto& cumulative_hops_without_link_transfers = scratch.cumulative_hops_without_link_transfers;
+  auto& cumulative_hops_with_link_transfers = scratch.cumulative_hops_with_link_transfers;
 
-  problem::PerDataSpace<std::vector<std::uint64_t>*>
+  problem::PerDataSpace<InlineVector<std::uint64_t>*>
     accesses, scatter_factors;
 
-   problem::PerDataSpace<std::vector<double>*>
+   problem::PerDataSpace<InlineVector<double>*>
        cumulative_hops;
 
-  
+
   for (unsigned pvi = 0; pvi < problem::GetShape()->NumDataSpaces; pvi++)
   {
     accesses_without_link_transfers[pvi].resize(cur_state.accesses[pvi].size());
@@ -871,12 +1635,20 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
     cumulative_hops[pvi] = &cumulative_hops_without_link_transfers[pvi];
   }
   
-  ComputeAccurateMulticastedAccesses(cur, spatial_deltas, unaccounted_delta,
-                                     accesses_without_link_transfers,
-                                     scatter_factors_without_link_transfers,
-                                     cumulative_hops_without_link_transfers);
+  if (approx_)
+    ComputeSampledMulticastedAccesses(cur, spatial_deltas, unaccounted_delta,
+                                      accesses_without_link_transfers,
+                                      scatter_factors_without_link_transfers,
+                                      cumulative_hops_without_link_transfers);
+  else
+    ComputeAccurateMulticastedAccesses(cur, spatial_deltas, unaccounted_delta,
+                                       accesses_without_link_transfers,
+                                       scatter_factors_without_link_transfers,
+                                       cumulative_hops_without_link_transfers);
 
-  if (!gEnableLinkTransfers && linked_spatial_level_[level])
+  bool link_transfers_enabled = LinkTransfersEnabled_(level);
+
+  if (!link_transfers_enabled && linked_spatial_level_[level])
   {
     static bool warning_printed = false;
     if (gEnableLinkTransferWarning && !warning_printed)
@@ -889,7 +1661,7 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
     }
   }
 
-  if (gEnableLinkTransfers && linked_spatial_level_[level])
+  if (link_transfers_enabled && linked_spatial_level_[level])
   {
     // Reset unaccounted delta, and now count with link transfers.
     for (uint64_t i = 0; i < num_spatial_elems; i++)
@@ -942,12 +1714,26 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
     }
   }
 
+  // Split-variant replay capture (see LookupSplitMemo()). Only the
+  // representative element's working sets feed CollectWorkingSets(), and
+  // a bin's hop count is pinned by whichever invocation populates it
+  // first, so capture is restricted to exactly those bins. When link
+  // transfers are live at this level, the choice between the with- and
+  // without-transfer accountings depends on the level's geometry, which
+  // is precisely what a split variant changes -- so replay is disabled
+  // for this whole evaluation.
+  if (link_transfers_enabled && linked_spatial_level_[level])
+  {
+    split_replay_valid_ = false;
+  }
+  bool capture = split_replay_valid_ && !approx_ && spatial_id_ == 0;
+
   for (unsigned pvi = 0; pvi < problem::GetShape()->NumDataSpaces; pvi++)
   {
     for (unsigned i = 0; i < cur_state.accesses[pvi].size(); i++)
     {
       cur_state.accesses[pvi][i] += (*accesses[pvi])[i];
-        
+
       // Careful: overwriting scatter factor. The multicast/scatter signature must
       // either be un-initialized, or the accesses must be 0 (special case), or
       // it must match with the updated signature.
@@ -957,6 +1743,32 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
         {
           cur_state.scatter_factors[pvi][i] = (*scatter_factors[pvi])[i];
           cur_state.cumulative_hops[pvi][i] = (*cumulative_hops[pvi])[i];
+
+          if (capture)
+          {
+            // Append this bin's multicast groups to the level's capture.
+            auto& replay = split_replay_capture_[level];
+            if (replay.offsets[pvi].empty())
+            {
+              replay.offsets[pvi].push_back(0);
+            }
+            auto& g_bins = scratch.group_bins[pvi];
+            auto& g_offsets = scratch.group_offsets[pvi];
+            auto& g_ids = scratch.group_ids[pvi];
+            for (std::size_t g = 0; g < g_bins.size(); g++)
+            {
+              if (g_bins[g] != i)
+              {
+                continue;
+              }
+              replay.bins[pvi].push_back(g_bins[g]);
+              for (auto o = g_offsets[g]; o < g_offsets[g + 1]; o++)
+              {
+                replay.ids[pvi].push_back(g_ids[o]);
+              }
+              replay.offsets[pvi].push_back(std::uint32_t(replay.ids[pvi].size()));
+            }
+          }
         }
         else
         {
@@ -964,7 +1776,7 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
           assert(cur_state.scatter_factors[pvi][i] == (*scatter_factors[pvi])[i]);
         }
       }
-    }      
+    }
   }
 
   //  auto& accesses = nest_state_[cur->level].live_state[spatial_id_].accesses;
@@ -1022,6 +1834,9 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
                                      std::uint64_t base_index,
                                      int depth)
 {
+  timer::Scope timer_scope(timer::Phase::SpatialDeltas);
+  perf::Scope perf_scope(timer::Phase::SpatialDeltas);
+
   int level = cur->level;
 
   // base_index determines which element of spatial_deltas
@@ -1130,26 +1945,69 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
         }
 
         // Iterations #num_iterations_to_run through #last.
-        problem::OperationSpace* prev_temporal_delta = &opspace_lastrun;
-        for (;
-             indices_[level] < cur->descriptor.end;
-             indices_[level] += cur->descriptor.stride, iterations_run++)
+        // Each extrapolated delta is the last computed delta translated by
+        // (k * translation vector), so the elements are independent of each
+        // other and can be computed in any order — including concurrently.
+        // For large spatial fanouts this loop dominates the evaluation of
+        // spatial mappings, so we optionally fan it out across a team of
+        // worker threads.
+        int first_index = indices_[level];
+        int stride = cur->descriptor.stride;
+        std::uint64_t num_extrapolated =
+          (cur->descriptor.end - first_index + stride - 1) / stride;
+
+        auto ExtrapolateRange = [&](std::uint64_t begin, std::uint64_t end)
+          {
+            for (std::uint64_t k = begin; k < end; k++)
+            {
+              std::uint64_t spatial_delta_index =
+                base_index + first_index + k * stride;
+              ASSERT(spatial_delta_index < spatial_deltas.size());
+
+              auto& temporal_delta = spatial_deltas[spatial_delta_index];
+              temporal_delta = opspace_lastrun;
+              for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+              {
+                Point translation = translation_vectors.at(pv);
+                translation.Scale(k + 1);
+                temporal_delta.GetDataSpace(pv).Translate(translation);
+              }
+            }
+          };
+
+        if (gParallelSpatialDeltas && depth == 0 &&
+            num_extrapolated >= kMinParallelSpatialDeltas)
         {
-          std::uint64_t spatial_delta_index = base_index + indices_[level];
-          ASSERT(spatial_delta_index < spatial_deltas.size());
-          ASSERT(!valid_delta[spatial_delta_index]);
-
-          spatial_id_ = orig_spatial_id + spatial_delta_index;
-
-          auto& temporal_delta = spatial_deltas[spatial_delta_index];
-          for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+          std::uint64_t num_workers = std::min(
+            std::uint64_t(std::max(1u, std::thread::hardware_concurrency())),
+            num_extrapolated);
+          std::vector<std::thread> workers;
+          std::uint64_t chunk = (num_extrapolated + num_workers - 1) / num_workers;
+          for (std::uint64_t w = 0; w < num_workers; w++)
           {
-            temporal_delta.GetDataSpace(pv) = prev_temporal_delta->GetDataSpace(pv);
-            temporal_delta.GetDataSpace(pv).Translate(translation_vectors.at(pv));
+            workers.push_back(std::thread(ExtrapolateRange, w * chunk,
+                                          std::min((w + 1) * chunk, num_extrapolated)));
           }
-          valid_delta[spatial_delta_index] = true;
+          for (auto& worker: workers)
+          {
+            worker.join();
+          }
+        }
+        else
+        {
+          ExtrapolateRange(0, num_extrapolated);
+        }
 
-          prev_temporal_delta = &temporal_delta;
+        // The workers don't touch valid_delta: vector<bool> packs flags into
+        // shared words, so concurrent writes would race even on disjoint
+        // index ranges. Mark validity (and advance the loop index) here.
+        for (std::uint64_t k = 0; k < num_extrapolated; k++)
+        {
+          std::uint64_t spatial_delta_index = base_index + indices_[level];
+          ASSERT(!valid_delta[spatial_delta_index]);
+          valid_delta[spatial_delta_index] = true;
+          indices_[level] += stride;
+          iterations_run++;
         } // extrapolated iterations
       } // iterations_run < num_iterations
     } // next inner loop is temporal
@@ -1166,12 +2024,168 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
     std::vector<analysis::LoopState>::reverse_iterator cur,
     const std::vector<problem::OperationSpace>& spatial_deltas,
     std::vector<problem::PerDataSpace<bool>>& unaccounted_delta,
-    problem::PerDataSpace<std::vector<std::uint64_t>>& accesses,
-    problem::PerDataSpace<std::vector<std::uint64_t>>& scatter_factors,
-    problem::PerDataSpace<std::vector<double>>& cumulative_hops)
+    problem::PerDataSpace<InlineVector<std::uint64_t>>& accesses,
+    problem::PerDataSpace<InlineVector<std::uint64_t>>& scatter_factors,
+    problem::PerDataSpace<InlineVector<double>>& cumulative_hops)
 {
+  timer::Scope timer_scope(timer::Phase::MulticastedAccesses);
+  perf::Scope perf_scope(timer::Phase::MulticastedAccesses);
+
   std::uint64_t num_deltas = spatial_deltas.size();
 
+  auto h_size = horizontal_sizes_[cur->level];
+  auto v_size = vertical_sizes_[cur->level];
+
+  // Record the multicast group structure (destination bin plus member
+  // linear IDs) as we go. Hop counts are a function of the level's
+  // physical X/Y arrangement; keeping the geometry-independent groups
+  // around lets both the memo replay below and the split-variant replay
+  // (see LookupSplitMemo()) recompute them under whatever arrangement is
+  // current.
+  auto& scratch = SpatialScratch(cur->level);
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    scratch.group_bins[pv].clear();
+    scratch.group_offsets[pv].assign(1, 0);
+    scratch.group_ids[pv].clear();
+  }
+
+  // The multicast/scatter signature rarely changes across temporal
+  // iterations, so before running the quadratic pairwise comparison we
+  // probe a small per-level memo keyed by a hash of the delta set. AAHR
+  // equality is exactly corner equality (operator== is CornersEqual), so
+  // hashing the Min/Max corners of each unaccounted delta -- plus the
+  // unaccounted mask itself, which differs between the without- and
+  // with-link-transfer invocations -- fully determines the outcome of
+  // every CheckEquality the pairwise pass would perform. Memoized
+  // increments are stored in epoch-independent units and re-scaled by
+  // num_epochs_ at replay time. Set TIMELOOP_DISABLE_MULTICAST_MEMO to
+  // fall back to the unconditional pairwise computation.
+  MulticastMemoEntry* entry = nullptr;
+  if (gEnableMulticastMemo)
+  {
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](std::uint64_t v)
+    {
+      for (unsigned b = 0; b < 8; b++)
+      {
+        hash ^= (v >> (b * 8)) & 0xff;
+        hash *= 1099511628211ULL;
+      }
+    };
+
+    mix(num_deltas);
+    for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+    {
+      mix(accesses[pv].size());
+    }
+    for (std::uint64_t i = 0; i < num_deltas; i++)
+    {
+      for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+      {
+        mix(unaccounted_delta[i][pv] ? 1 : 0);
+        if (unaccounted_delta[i][pv])
+        {
+          auto& delta = spatial_deltas[i].GetDataSpace(pv);
+          auto min = delta.Min();
+          auto max = delta.Max();
+          for (std::uint32_t d = 0; d < min.Order(); d++)
+          {
+            mix(std::uint64_t(std::int64_t(min[d])));
+            mix(std::uint64_t(std::int64_t(max[d])));
+          }
+        }
+      }
+    }
+
+    if (multicast_memo_.size() <= std::size_t(cur->level))
+    {
+      multicast_memo_.resize(cur->level + 1);
+    }
+    auto& set = multicast_memo_[cur->level];
+
+    for (auto& way : set)
+    {
+      if (way.valid && way.hash == hash)
+      {
+        way.last_used = ++multicast_memo_clock_;
+
+        // Replay the memoized increments. Hop counts are recomputed from
+        // the memoized group structure rather than replayed: the level's
+        // X/Y arrangement is not part of the memo key and may have
+        // changed since the entry was filled.
+        double v_center = double(v_size - 1) / 2;
+        for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+        {
+          for (unsigned k = 0; k < accesses[pv].size(); k++)
+          {
+            accesses[pv][k] += way.size_sums[pv][k] * num_epochs_;
+            scatter_factors[pv][k] += way.scatter_counts[pv][k];
+          }
+
+          scratch.group_bins[pv] = way.group_bins[pv];
+          scratch.group_offsets[pv] = way.group_offsets[pv];
+          scratch.group_ids[pv] = way.group_ids[pv];
+          auto& bins = scratch.group_bins[pv];
+          auto& offsets = scratch.group_offsets[pv];
+          auto& ids = scratch.group_ids[pv];
+          for (std::size_t g = 0; g < bins.size(); g++)
+          {
+            double hops = 0;
+            std::uint64_t h_max = 0;
+            for (auto k = offsets[g]; k < offsets[g + 1]; k++)
+            {
+              h_max = std::max(h_max, std::uint64_t(ids[k]) % h_size);
+            }
+            hops += double(h_max);
+            for (auto k = offsets[g]; k < offsets[g + 1]; k++)
+            {
+              hops += std::abs(double(ids[k] / h_size) - v_center);
+            }
+            cumulative_hops[pv][bins[g]] += hops;
+          }
+        }
+
+        // The pairwise pass accounts for every delta by the time it
+        // returns, so its only other side effect replays wholesale.
+        for (std::uint64_t i = 0; i < num_deltas; i++)
+        {
+          unaccounted_delta[i].fill(false);
+        }
+        return;
+      }
+    }
+
+    // Miss: victimize an invalid way, else the least-recently-used one,
+    // and have the pairwise pass below fill it in as it goes.
+    entry = &set[0];
+    for (auto& way : set)
+    {
+      if (!way.valid)
+      {
+        entry = &way;
+        break;
+      }
+      if (way.last_used < entry->last_used)
+      {
+        entry = &way;
+      }
+    }
+    entry->valid = false;
+    entry->hash = hash;
+    entry->last_used = ++multicast_memo_clock_;
+    for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+    {
+      entry->size_sums[pv].resize(accesses[pv].size());
+      entry->scatter_counts[pv].resize(accesses[pv].size());
+      for (unsigned k = 0; k < accesses[pv].size(); k++)
+      {
+        entry->size_sums[pv][k] = 0;
+        entry->scatter_counts[pv][k] = 0;
+      }
+    }
+  }
+
   // For each data type, records the number of unaccounted deltas
   // that the current delta matches with. This will be used
   // to infer the multicast factor for a specific delta.
@@ -1196,17 +2210,17 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
   //   spatial_deltas[i].Print(pv);
   // }
   
-  auto h_size = horizontal_sizes_[cur->level];
-  auto v_size = vertical_sizes_[cur->level];
+  // Hoisted out of the delta loop and recycled (clear() keeps capacity) to
+  // avoid a fresh per-data-space allocation for every delta.
+  problem::PerDataSpace<InlineVector<std::uint64_t>> match_set;
 
   for (std::uint64_t i = 0; i < num_deltas; i++)
   {
     num_matches.fill(0);
-    
-    problem::PerDataSpace<std::vector<std::uint64_t>> match_set;
 
     for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
     {
+      match_set[pv].clear();
       if (!unaccounted_delta[i][pv])
       {
         // this delta was already accounted for,
@@ -1238,7 +2252,8 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
     {
       if (num_matches[pv] > 0)
       {
-        accesses[pv][num_matches[pv] - 1] += (spatial_deltas[i].GetSize(pv) * num_epochs_);
+        auto delta_size = spatial_deltas[i].GetSize(pv);
+        accesses[pv][num_matches[pv] - 1] += (delta_size * num_epochs_);
         scatter_factors[pv][num_matches[pv] - 1]++;
 
         // Compute the average number of hops from the edge of the array
@@ -1268,36 +2283,184 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
         // Accumulate this into the running hop count. We'll finally divide this
         // by the scatter factor to get average hop count.
         cumulative_hops[pv][num_matches[pv] - 1] += hops;
+
+        scratch.group_bins[pv].push_back(std::uint32_t(num_matches[pv] - 1));
+        for (auto& linear_id : match_set[pv])
+        {
+          scratch.group_ids[pv].push_back(std::uint32_t(linear_id));
+        }
+        scratch.group_offsets[pv].push_back(std::uint32_t(scratch.group_ids[pv].size()));
+
+        if (entry != nullptr)
+        {
+          entry->size_sums[pv][num_matches[pv] - 1] += delta_size;
+          entry->scatter_counts[pv][num_matches[pv] - 1]++;
+        }
       }
     }
   }
+
+  if (entry != nullptr)
+  {
+    for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+    {
+      entry->group_bins[pv] = scratch.group_bins[pv];
+      entry->group_offsets[pv] = scratch.group_offsets[pv];
+      entry->group_ids[pv] = scratch.group_ids[pv];
+    }
+    entry->valid = true;
+  }
 }
 
-// Compares two deltas, and if they are equal,
-// records the opportunity for inter-PE link transfers.
-void CompareSpatioTemporalDeltas(
-    const std::vector<problem::OperationSpace>& cur_spatial_deltas,
-    const std::vector<problem::OperationSpace>& prev_spatial_deltas,
-    const std::uint64_t cur_spatial_index,
-    const std::uint64_t prev_spatial_index,
-    std::vector<problem::PerDataSpace<bool>>& inter_elem_reuse)
+// Sampled variant of the above for approximate (screening) mode. Instead
+// of exhaustively comparing all pairs of deltas -- quadratic in the fanout
+// -- compare the first delta against its neighbor and the last delta and
+// classify the whole level as either a full multicast or a full scatter.
+// This is exact for the two overwhelmingly common spatial patterns
+// (all deltas equal, all deltas distinct) and approximate for mixed
+// patterns, which is plenty for pruning: candidates that survive the
+// screen are re-evaluated with the accurate analysis.
+void NestAnalysis::ComputeSampledMulticastedAccesses(
+    std::vector<analysis::LoopState>::reverse_iterator cur,
+    const std::vector<problem::OperationSpace>& spatial_deltas,
+    std::vector<problem::PerDataSpace<bool>>& unaccounted_delta,
+    problem::PerDataSpace<InlineVector<std::uint64_t>>& accesses,
+    problem::PerDataSpace<InlineVector<std::uint64_t>>& scatter_factors,
+    problem::PerDataSpace<InlineVector<double>>& cumulative_hops)
 {
-  auto& cur_delta = cur_spatial_deltas[cur_spatial_index];
-  auto& prev_delta = prev_spatial_deltas[prev_spatial_index];
+  timer::Scope timer_scope(timer::Phase::MulticastedAccesses);
+  perf::Scope perf_scope(timer::Phase::MulticastedAccesses);
+
+  std::uint64_t num_deltas = spatial_deltas.size();
+
+  auto h_size = horizontal_sizes_[cur->level];
+  auto v_size = vertical_sizes_[cur->level];
+  double v_center = double(v_size - 1) / 2;
+
+  std::vector<std::uint64_t> group;
 
   for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
   {
-    if (!cur_delta.IsEmpty(pv))
+    // Gather (and account for) the unaccounted deltas for this data space.
+    group.clear();
+    for (std::uint64_t i = 0; i < num_deltas; i++)
     {
-      if (cur_delta.CheckEquality(prev_delta, pv))
+      if (unaccounted_delta[i][pv])
       {
-        // ASSERT(!inter_elem_reuse[cur_spatial_index][pv]);
-        inter_elem_reuse[cur_spatial_index][pv] = true;
+        unaccounted_delta[i][pv] = false;
+        group.push_back(i);
       }
     }
+
+    if (group.empty())
+      continue;
+
+    std::uint64_t n = group.size();
+
+    bool multicast = true;
+    if (n >= 2)
+    {
+      multicast =
+        spatial_deltas[group[0]].CheckEquality(spatial_deltas[group[1]], pv) &&
+        spatial_deltas[group[0]].CheckEquality(spatial_deltas[group[n - 1]], pv);
+    }
+
+    if (multicast)
+    {
+      // Treat as one group multicast to all n elements. Hop model matches
+      // the accurate analysis: go along H maximally, then drop vertical
+      // paths from the center of the V-axis.
+      accesses[pv][n - 1] += (spatial_deltas[group[0]].GetSize(pv) * num_epochs_);
+      scatter_factors[pv][n - 1]++;
+
+      double hops = 0;
+      std::uint64_t h_max = 0;
+      for (auto& linear_id: group)
+      {
+        h_max = std::max(h_max, linear_id % h_size);
+      }
+      hops += double(h_max);
+      for (auto& linear_id: group)
+      {
+        hops += std::abs(double(linear_id / h_size) - v_center);
+      }
+      cumulative_hops[pv][n - 1] += hops;
+    }
+    else
+    {
+      // Treat as n unicast (scatter) groups.
+      std::uint64_t total_size = 0;
+      double hops = 0;
+      for (auto& linear_id: group)
+      {
+        total_size += spatial_deltas[linear_id].GetSize(pv);
+        hops += double(linear_id % h_size) +
+                std::abs(double(linear_id / h_size) - v_center);
+      }
+      accesses[pv][0] += (total_size * num_epochs_);
+      scatter_factors[pv][0] += n;
+      cumulative_hops[pv][0] += hops;
+    }
   }
 }
 
+// True if two flattened corner records (2 * Point::MaxOrder lanes: min
+// corner followed by max corner) are identical. Mirrors
+// AxisAlignedHyperRectangle::CornersEqual(), but runs on the flat scratch
+// arrays built by ComputeNetworkLinkTransfers(), where neighboring
+// elements' records are contiguous in memory.
+static bool FlatCornersEqual(const Coordinate* a, const Coordinate* b)
+{
+#if defined(__AVX2__)
+  __m256i eq = _mm256_set1_epi32(-1);
+  for (std::uint32_t i = 0; i < 2 * Point::MaxOrder; i += 8)
+  {
+    eq = _mm256_and_si256(
+      eq,
+      _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i))));
+  }
+  return _mm256_movemask_ps(_mm256_castsi256_ps(eq)) == 0xFF;
+#else
+  for (std::uint32_t i = 0; i < 2 * Point::MaxOrder; i++)
+  {
+    if (a[i] != b[i])
+    {
+      return false;
+    }
+  }
+  return true;
+#endif
+}
+
+// Per-level link-transfer enablement. The arch spec's per-network opt-in
+// (see SetLinkTransferLevels()) is the normal path; the
+// TIMELOOP_ENABLE_LINK_TRANSFERS env var remains as a global force-on so
+// existing sweep configurations keep working.
+bool NestAnalysis::LinkTransfersEnabled_(unsigned level) const
+{
+  if (gEnableLinkTransfers)
+  {
+    return true;
+  }
+  if (link_transfer_levels_.empty())
+  {
+    return false;
+  }
+
+  // Map the loop level to its storage tiling level: tiling level t spans
+  // the loop levels up to and including storage_tiling_boundaries_[t].
+  unsigned tiling_level = 0;
+  while (tiling_level < storage_tiling_boundaries_.size() &&
+         storage_tiling_boundaries_[tiling_level] < level)
+  {
+    tiling_level++;
+  }
+
+  return tiling_level < link_transfer_levels_.size() &&
+    link_transfer_levels_[tiling_level];
+}
+
 void NestAnalysis::ComputeNetworkLinkTransfers(
     std::vector<analysis::LoopState>::reverse_iterator cur,
     const std::vector<problem::OperationSpace>& cur_spatial_deltas,
@@ -1323,16 +2486,6 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
   auto h_size = horizontal_sizes_[cur->level];
   auto v_size = vertical_sizes_[cur->level];
 
-  // Imagine origin (0,0) at the top-left corner of a 2D spatial array.
-  // Horizontal ids grow from left to right.
-  // Vertical ids grow from top to bottom.
-  auto GetLinearIndex = [&h_size, &v_size](std::uint64_t h_id, std::uint64_t v_id)
-    {
-      ASSERT(h_id < h_size && v_id < v_size);
-      std::uint64_t linearIndex = v_id * h_size + h_id;  // row major layout
-      return linearIndex;
-    };
-
   auto& cur_state = cur->live_state[spatial_id_];
   auto& prev_spatial_deltas = cur_state.prev_point_sets[0];
   ASSERT(cur_spatial_deltas.size() == prev_spatial_deltas.size());
@@ -1347,67 +2500,91 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
   
   // for each spatial elements, this array records if the data
   // needed by the element can be obtained from any of the neighboring elements.
-  std::vector<problem::PerDataSpace<bool>> inter_elem_reuse;
+  auto& scratch = SpatialScratch(cur->level);
+  auto& inter_elem_reuse = scratch.inter_elem_reuse;
   inter_elem_reuse.resize(num_spatial_elems);
   for (int i = 0; i < num_spatial_elems; i++)
   {
     inter_elem_reuse[i].fill(false);
   }
 
-  // FIXME The loops below can be codified in some way to avoid redundant LOC.
-
-  // Test for a few hard-coded transfer patterns in horizontal and vertical
-  // dimensions.
+  // Imagine origin (0,0) at the top-left corner of a 2D spatial array laid
+  // out row-major (linear index = v_id * h_size + h_id). Horizontal ids
+  // grow from left to right, vertical ids from top to bottom. An element
+  // can pick up its delta over a link if any of its four neighbors held an
+  // identical delta last iteration.
+  //
+  // One data space at a time, flatten the corner records of the current
+  // and previous delta sets into contiguous per-element arrays, then test
+  // each element against its four neighbors with an unmasked SIMD corner
+  // compare (AAHR equality is corner equality, and the unused tail lanes
+  // are pinned at zero on both sides). This replaces four directional
+  // sweeps through OperationSpace::CheckEquality -- and its per-call
+  // data-space lookup -- with streaming passes over flat arrays, and
+  // short-circuits the remaining neighbor tests once an element matches.
+  static const std::uint32_t kCornerLanes = 2 * Point::MaxOrder;
+
+  auto& cur_corners = scratch.cur_corners;
+  auto& prev_corners = scratch.prev_corners;
+  auto& delta_nonempty = scratch.delta_nonempty;
+  cur_corners.resize(num_spatial_elems * kCornerLanes);
+  prev_corners.resize(num_spatial_elems * kCornerLanes);
+  delta_nonempty.resize(num_spatial_elems);
 
-  // downward vertical transfers in each column
-  for (std::uint64_t h_id = 0; h_id < h_size; h_id++)
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
   {
-    for (std::uint64_t v_id = 1; v_id < v_size; v_id++)
+    bool any_nonempty = false;
+    for (int i = 0; i < num_spatial_elems; i++)
     {
-      auto cur_spatial_index = GetLinearIndex(h_id, v_id);
-      auto prev_spatial_index = GetLinearIndex(h_id, v_id - 1);
-      CompareSpatioTemporalDeltas(cur_spatial_deltas, prev_spatial_deltas,
-                                  cur_spatial_index, prev_spatial_index,
-                                  inter_elem_reuse);
+      delta_nonempty[i] = !cur_spatial_deltas[i].IsEmpty(pv);
+      any_nonempty |= bool(delta_nonempty[i]);
+
+      auto cur_min = cur_spatial_deltas[i].GetDataSpace(pv).Min();
+      auto cur_max = cur_spatial_deltas[i].GetDataSpace(pv).Max();
+      memcpy(&cur_corners[i * kCornerLanes], cur_min.Data(),
+             sizeof(Coordinate) * Point::MaxOrder);
+      memcpy(&cur_corners[i * kCornerLanes + Point::MaxOrder], cur_max.Data(),
+             sizeof(Coordinate) * Point::MaxOrder);
+
+      auto prev_min = prev_spatial_deltas[i].GetDataSpace(pv).Min();
+      auto prev_max = prev_spatial_deltas[i].GetDataSpace(pv).Max();
+      memcpy(&prev_corners[i * kCornerLanes], prev_min.Data(),
+             sizeof(Coordinate) * Point::MaxOrder);
+      memcpy(&prev_corners[i * kCornerLanes + Point::MaxOrder], prev_max.Data(),
+             sizeof(Coordinate) * Point::MaxOrder);
     }
-  }
 
-  // upward vertical transfers in each column
-  for (std::uint64_t h_id = 0; h_id < h_size; h_id++)
-  {
-    for (std::uint64_t v_id = 0; v_id < v_size - 1; v_id++)
+    if (!any_nonempty)
     {
-      auto cur_spatial_index = GetLinearIndex(h_id, v_id);
-      auto prev_spatial_index = GetLinearIndex(h_id, v_id + 1);
-      CompareSpatioTemporalDeltas(cur_spatial_deltas, prev_spatial_deltas,
-                                  cur_spatial_index, prev_spatial_index,
-                                  inter_elem_reuse);
+      continue;
     }
-  }
 
-  // horizontal transfers in each row from left to right
-  for (std::uint64_t v_id = 0; v_id < v_size; v_id++)
-  {
-    for (std::uint64_t h_id = 1; h_id < h_size; h_id++)
+    for (std::uint64_t v_id = 0; v_id < v_size; v_id++)
     {
-      auto cur_spatial_index = GetLinearIndex(h_id, v_id);
-      auto prev_spatial_index = GetLinearIndex(h_id - 1, v_id);
-      CompareSpatioTemporalDeltas(cur_spatial_deltas, prev_spatial_deltas,
-                                  cur_spatial_index, prev_spatial_index,
-                                  inter_elem_reuse);
-    }
-  }
+      for (std::uint64_t h_id = 0; h_id < h_size; h_id++)
+      {
+        auto i = v_id * h_size + h_id;
+        if (!delta_nonempty[i])
+        {
+          continue;
+        }
 
-  // horizontal transfers in each row from right to left
-  for (std::uint64_t v_id = 0; v_id < v_size; v_id++)
-  {
-    for (std::uint64_t h_id = 0; h_id < h_size - 1; h_id++)
-    {
-      auto cur_spatial_index = GetLinearIndex(h_id, v_id);
-      auto prev_spatial_index = GetLinearIndex(h_id + 1, v_id);
-      CompareSpatioTemporalDeltas(cur_spatial_deltas, prev_spatial_deltas,
-                                  cur_spatial_index, prev_spatial_index,
-                                  inter_elem_reuse);
+        const Coordinate* c = &cur_corners[i * kCornerLanes];
+        bool match =
+          (v_id > 0 &&
+           FlatCornersEqual(c, &prev_corners[(i - h_size) * kCornerLanes])) ||
+          (v_id + 1 < v_size &&
+           FlatCornersEqual(c, &prev_corners[(i + h_size) * kCornerLanes])) ||
+          (h_id > 0 &&
+           FlatCornersEqual(c, &prev_corners[(i - 1) * kCornerLanes])) ||
+          (h_id + 1 < h_size &&
+           FlatCornersEqual(c, &prev_corners[(i + 1) * kCornerLanes]));
+
+        if (match)
+        {
+          inter_elem_reuse[i][pv] = true;
+        }
+      }
     }
   }
 
@@ -1484,7 +2661,9 @@ void NestAnalysis::InitNumSpatialElems()
     cur_index--;
   }
 
-  linked_spatial_level_.resize(nest_state_.size(), false);
+  // assign() (not resize()) so that re-initialization over recycled state
+  // starts from pristine defaults.
+  linked_spatial_level_.assign(nest_state_.size(), false);
   for (std::uint64_t cur_level = 0; cur_level < nest_state_.size(); cur_level++)
   {
     if (master_spatial_level_[cur_level])
@@ -1508,7 +2687,7 @@ void NestAnalysis::InitNumSpatialElems()
 
 void NestAnalysis::InitStorageBoundaries()
 {
-  storage_boundary_level_.resize(nest_state_.size(), false);
+  storage_boundary_level_.assign(nest_state_.size(), false);
   for (auto& i : storage_tiling_boundaries_)
   {
     ASSERT(i < storage_boundary_level_.size());
@@ -1518,9 +2697,9 @@ void NestAnalysis::InitStorageBoundaries()
 
 void NestAnalysis::InitSpatialFanouts()
 {
-  spatial_fanouts_.resize(nest_state_.size(), 1);
-  horizontal_sizes_.resize(nest_state_.size(), 1);
-  vertical_sizes_.resize(nest_state_.size(), 1);
+  spatial_fanouts_.assign(nest_state_.size(), 1);
+  horizontal_sizes_.assign(nest_state_.size(), 1);
+  vertical_sizes_.assign(nest_state_.size(), 1);
   for (int cur_level = nest_state_.size() - 1; cur_level >= 0; cur_level--)
   {
     if (!loop::IsSpatial(nest_state_[cur_level].descriptor.spacetime_dimension))
@@ -27,6 +27,9 @@
 
 #pragma once
 
+#include <array>
+#include <unordered_map>
+
 #include "mapping/nest.hpp"
 #include "workload/per-problem-dimension.hpp"
 
@@ -87,8 +90,144 @@ class NestAnalysis
 
   bool working_sets_computed_ = false;
 
+  // Cached result of GetWorkingSetSizes_LTW(). The sizes depend only on
+  // the (nest, workload) pair -- never on the datatype-bypass masks -- so
+  // one computation serves the pre-evaluation check of every bypass
+  // variant of a nest. Invalidated whenever Init() sees a different nest.
+  mutable std::vector<problem::PerDataSpace<std::size_t>> ltw_sizes_;
+  mutable bool ltw_sizes_valid_ = false;
+
+  // Approximate (multi-fidelity screening) mode: replace the exhaustive
+  // pairwise multicast analysis with a sampled classification. See
+  // ComputeSampledMulticastedAccesses(). Set via SetApproxMode() before
+  // Init(); results computed in this mode are memoized under a distinct
+  // hash so they never leak into full-fidelity evaluations.
+  bool approx_ = false;
+
+  // Bounds-only point-set backend: delta sizes are computed with pure
+  // interval arithmetic on the working-set bounding boxes (see
+  // AxisAlignedHyperRectangle::BoundsOnlyDeltaSize), skipping the exact
+  // fracture and gradient analysis. Selected per instance via
+  // SetBoundsOnlyMode() so a screening analysis and an exact analysis can
+  // coexist in one process; like approx mode, results are memoized under
+  // a distinct hash.
+  bool bounds_only_ = false;
+
+  // Per-storage-level link-transfer enablement, innermost level first,
+  // derived from the arch spec (see Topology::LinkTransferLevels()).
+  // Empty means no level opted in; the TIMELOOP_ENABLE_LINK_TRANSFERS env
+  // var remains a global force-on for comparison runs.
+  std::vector<bool> link_transfer_levels_;
+
+  // Per-dataspace parallel analysis: when non-empty, this analysis is a
+  // shard that only computes the data spaces whose mask bit is set --
+  // the others stay empty point sets throughout, so their set algebra
+  // degenerates to no-ops. Empty (the default) means all data spaces.
+  // Set internally by ComputeWorkingSets() on its helper-thread clones.
+  std::vector<bool> active_data_spaces_;
+
   problem::Workload* workload_ = nullptr;
 
+  // The multicast group structure at one master spatial level, captured
+  // from the representative spatial element while its live state was
+  // being populated: for each data space, the delta groups as
+  // (multicast bin, member linear IDs) in flattened offsets/ids form.
+  // The linear IDs are the mixed-radix index over the spatial loops in
+  // nest order, which is independent of the SpaceX/SpaceY labels, so a
+  // spatial-split variant of the nest can recompute the
+  // geometry-dependent hop counts from them (see LookupSplitMemo()).
+  struct SpatialGroupReplay
+  {
+    problem::PerDataSpace<std::vector<std::uint32_t>> bins;
+    problem::PerDataSpace<std::vector<std::uint32_t>> offsets;
+    problem::PerDataSpace<std::vector<std::uint32_t>> ids;
+  };
+
+  // Memoization of completed analyses. Mappings in an Uber mapspace sweep
+  // frequently share identical loop nests (e.g., across the datatype-bypass
+  // subspace), so we key completed (working_sets_, body_info_) results by a
+  // hash of the (nest, workload) pair and reuse them instead of re-running
+  // the recursive delta computation. The table is per-thread (see
+  // nest-analysis.cpp) so mapper threads never contend on it.
+  struct MemoEntry
+  {
+    // Key material (stored to disambiguate hash collisions).
+    loop::Nest nest;
+    std::vector<int> bounds;
+    std::vector<int> coefficients;
+    std::vector<problem::DataDensity> densities;
+    bool approx = false;
+    bool bounds_only = false;
+    std::vector<bool> active_data_spaces;
+    std::vector<bool> link_transfer_levels;
+
+    // Memoized results.
+    tiling::CompoundTileNest working_sets;
+    tiling::BodyInfo body_info;
+
+    // Split-variant replay: the nest hash with SpaceX/SpaceY normalized
+    // away, whether this entry can seed a nest that differs only in its
+    // spatial X/Y split, and the per-master-spatial-level group
+    // structure needed to recompute hop counts under the new geometry.
+    std::uint64_t split_hash = 0;
+    bool split_replayable = false;
+    std::map<unsigned, SpatialGroupReplay> spatial_groups;
+
+    // LRU stamp (monotonic per-thread clock, see nest-analysis.cpp).
+    std::uint64_t last_used = 0;
+  };
+
+  std::uint64_t nest_hash_ = 0;
+  std::uint64_t split_hash_ = 0;
+
+  // Capture state for the evaluation in flight: the group structure per
+  // master spatial level, and whether the captured data is usable (link
+  // transfers and sampled multicast analysis make hop counts depend on
+  // more than the group structure, so they disable replay).
+  std::map<unsigned, SpatialGroupReplay> split_replay_capture_;
+  bool split_replay_valid_ = false;
+
+  // Memoization of multicast/scatter signatures. The spatial-delta set at
+  // a master spatial level rarely changes across temporal iterations, so
+  // ComputeAccurateMulticastedAccesses() keys its pairwise-comparison
+  // result by a hash of the delta corners (AAHR equality is exactly corner
+  // equality) plus the unaccounted mask, and replays the accumulated
+  // increments on a hit. Increments are stored in epoch-independent units
+  // (accesses are re-scaled by num_epochs_ at replay time). A small
+  // set-associative table per level covers the with/without-link-transfer
+  // call pair, which see different unaccounted masks.
+  // Hop counts are not memoized directly: they depend on the level's
+  // horizontal/vertical geometry, which the spatial X/Y split can change
+  // without changing the delta signature. Instead the entry stores the
+  // group structure (see SpatialGroupReplay) and hops are recomputed
+  // from it -- O(num_deltas) instead of the quadratic pairwise pass --
+  // under whatever geometry is current at replay time.
+  struct MulticastMemoEntry
+  {
+    bool valid = false;
+    std::uint64_t hash = 0;
+    std::uint64_t last_used = 0;
+    problem::PerDataSpace<InlineVector<std::uint64_t>> size_sums;
+    problem::PerDataSpace<InlineVector<std::uint64_t>> scatter_counts;
+    problem::PerDataSpace<std::vector<std::uint32_t>> group_bins;
+    problem::PerDataSpace<std::vector<std::uint32_t>> group_offsets;
+    problem::PerDataSpace<std::vector<std::uint32_t>> group_ids;
+  };
+  static const unsigned kMulticastMemoWays = 4;
+  std::vector<std::array<MulticastMemoEntry, kMulticastMemoWays>> multicast_memo_;
+  std::uint64_t multicast_memo_clock_ = 0;
+
+  static std::unordered_map<std::uint64_t, MemoEntry>& MemoTable();
+  static std::unordered_map<std::uint64_t, std::uint64_t>& SplitIndexTable();
+  std::uint64_t HashNestAndWorkload(const loop::Nest& nest,
+                                    bool normalize_split = false) const;
+  void FillMemoKey(MemoEntry& entry) const;
+  bool MatchesMemoKey(const MemoEntry& entry) const;
+  bool MatchesMemoKeySplit(const MemoEntry& entry) const;
+  bool LookupMemo();
+  bool LookupSplitMemo();
+  void InsertMemo();
+
   // Internal helper methods.
   void ComputeWorkingSets();
 
@@ -104,7 +243,15 @@ class NestAnalysis
   problem::OperationPoint IndexToOperationPoint_(const std::vector<int>& indices) const;
   
   problem::OperationSpace ComputeDeltas(
-    std::vector<analysis::LoopState>::reverse_iterator cur, bool skip_delta = false);
+    std::vector<analysis::LoopState>::reverse_iterator cur, bool skip_delta = false,
+    bool sizes_only = false);
+
+  problem::PerDataSpace<std::size_t> ComputeDeltaSizes(
+    std::vector<analysis::LoopState>::reverse_iterator cur);
+
+  // Sizes computed by the most recent sizes-only ComputeDeltas() call
+  // (see ComputeDeltaSizes()).
+  problem::PerDataSpace<std::size_t> delta_sizes_;
 
   void ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::reverse_iterator cur,
                                  problem::OperationSpace& point_set,
@@ -123,15 +270,27 @@ class NestAnalysis
       const std::vector<problem::OperationSpace>& spatial_deltas,
       std::vector<problem::PerDataSpace<bool>>&
       unaccounted_delta,
-      problem::PerDataSpace<std::vector<std::uint64_t>>& accesses,
-      problem::PerDataSpace<std::vector<std::uint64_t>>& scatter_factors,
-      problem::PerDataSpace<std::vector<double>>& cumulative_hops
+      problem::PerDataSpace<InlineVector<std::uint64_t>>& accesses,
+      problem::PerDataSpace<InlineVector<std::uint64_t>>& scatter_factors,
+      problem::PerDataSpace<InlineVector<double>>& cumulative_hops
     );
 
   void ComputeApproxMulticastedAccesses(
       std::vector<analysis::LoopState>::reverse_iterator cur,
       const std::vector<problem::OperationSpace>& spatial_deltas);
 
+  void ComputeSampledMulticastedAccesses(
+      std::vector<analysis::LoopState>::reverse_iterator cur,
+      const std::vector<problem::OperationSpace>& spatial_deltas,
+      std::vector<problem::PerDataSpace<bool>>&
+      unaccounted_delta,
+      problem::PerDataSpace<InlineVector<std::uint64_t>>& accesses,
+      problem::PerDataSpace<InlineVector<std::uint64_t>>& scatter_factors,
+      problem::PerDataSpace<InlineVector<double>>& cumulative_hops
+    );
+
+  bool LinkTransfersEnabled_(unsigned level) const;
+
   void ComputeNetworkLinkTransfers(
       std::vector<analysis::LoopState>::reverse_iterator cur,
       const std::vector<problem::OperationSpace>& cur_spatial_deltas,
@@ -146,10 +305,58 @@ class NestAnalysis
   NestAnalysis();
   void Init(problem::Workload* wc, const loop::Nest* nest);
   void Reset();
- 
-  std::vector<problem::PerDataSpace<std::size_t>> GetWorkingSetSizes_LTW() const;
 
-  problem::PerDataSpace<std::vector<tiling::TileInfo>> GetWorkingSets();
+  // Select approximate (screening) vs. full-fidelity analysis for
+  // subsequent Init()/GetWorkingSets() calls. Switching modes invalidates
+  // any completed analysis so Init() never reuses results computed at the
+  // other fidelity.
+  void SetApproxMode(bool approx)
+  {
+    if (approx != approx_)
+    {
+      approx_ = approx;
+      working_sets_computed_ = false;
+    }
+  }
+
+  void SetBoundsOnlyMode(bool bounds_only)
+  {
+    if (bounds_only != bounds_only_)
+    {
+      bounds_only_ = bounds_only;
+      working_sets_computed_ = false;
+    }
+  }
+
+  // Per-storage-level link-transfer opt-in (from the network specs in the
+  // arch config, innermost level first). Changing the configuration
+  // invalidates any completed analysis, since link transfers alter the
+  // computed access counts.
+  void SetLinkTransferLevels(const std::vector<bool>& levels)
+  {
+    if (levels != link_transfer_levels_)
+    {
+      link_transfer_levels_ = levels;
+      working_sets_computed_ = false;
+    }
+  }
+
+  const std::vector<problem::PerDataSpace<std::size_t>>& GetWorkingSetSizes_LTW() const;
+
+  // Lower-bound the per-data-space working-set sizes of each tiling level
+  // directly from the index factorization, without initializing any
+  // analysis state. Used for capacity screening before the nest analysis
+  // is even constructed.
+  static std::vector<problem::PerDataSpace<std::size_t>> MinWorkingSetSizes_LTW(
+    const loop::Nest& nest, const problem::Workload* wc);
+
+  // Cumulative nest-cache counters for the calling thread (the cache itself
+  // is per-thread). The mapper snapshots these on each worker thread and
+  // reports aggregate cache effectiveness in its final stats.
+  static std::uint64_t MemoHits();
+  static std::uint64_t MemoMisses();
+
+  const problem::PerDataSpace<std::vector<tiling::TileInfo>>& GetWorkingSets();
   tiling::BodyInfo GetBodyInfo();
 
   // Serialization.
@@ -27,8 +27,13 @@
 
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "point-set.hpp"
 
 // ---------------------------------------------
@@ -92,11 +97,88 @@ struct Gradient
 class AxisAlignedHyperRectangle
 {
  protected:
-  
+
   std::uint32_t order_;
   Point min_, max_; // min inclusive, max: exclusive
   Gradient gradient_;
 
+  // Vectorized coordinate kernels. The inline coordinate arrays in Point are
+  // a fixed Point::MaxOrder (16) lanes of int32 with unused tail lanes pinned
+  // at zero, which lets these kernels process an entire corner with a couple
+  // of SIMD ops on AVX2 targets. Scalar fallbacks are provided for other
+  // ISAs; the fallback loops have a compile-time trip count and no stores,
+  // so NEON builds auto-vectorize them well.
+
+  // Bit-mask of valid dimension lanes.
+  std::uint32_t LaneMask() const
+  {
+    return (1u << order_) - 1;
+  }
+
+  // True if both corners of s match ours along every dimension.
+  bool CornersEqual(const AxisAlignedHyperRectangle& s) const
+  {
+#if defined(__AVX2__)
+    // Tail lanes are zero on both sides, so we can compare all inline lanes
+    // unmasked. The chunk loop has a compile-time trip count (MaxOrder is 8
+    // or 16 in practice) and unrolls completely.
+    __m256i eq = _mm256_set1_epi32(-1);
+    for (std::uint32_t i = 0; i < Point::MaxOrder; i += 8)
+    {
+      eq = _mm256_and_si256(
+        eq,
+        _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(min_.Data() + i)),
+                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.min_.Data() + i))));
+      eq = _mm256_and_si256(
+        eq,
+        _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(max_.Data() + i)),
+                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.max_.Data() + i))));
+    }
+    return _mm256_movemask_ps(_mm256_castsi256_ps(eq)) == 0xFF;
+#else
+    for (std::uint32_t dim = 0; dim < Point::MaxOrder; dim++)
+    {
+      if (min_[dim] != s.min_[dim] || max_[dim] != s.max_[dim])
+      {
+        return false;
+      }
+    }
+    return true;
+#endif
+  }
+
+  // True if s and *this have an empty intersection, i.e., there is some
+  // dimension along which the two volumes do not overlap.
+  bool Disjoint(const AxisAlignedHyperRectangle& s) const
+  {
+#if defined(__AVX2__)
+    // Per-lane mask of a > b across all inline lanes.
+    auto GtMask = [](const Coordinate* a, const Coordinate* b)
+      {
+        std::uint32_t mask = 0;
+        for (std::uint32_t i = 0; i < Point::MaxOrder; i += 8)
+        {
+          __m256i gt = _mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+          mask |= std::uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(gt))) << i;
+        }
+        return mask;
+      };
+
+    // A dimension overlaps iff s.max > min and max > s.min.
+    std::uint32_t overlap = GtMask(s.max_.Data(), min_.Data()) &
+                            GtMask(max_.Data(), s.min_.Data());
+    return (overlap & LaneMask()) != LaneMask();
+#else
+    std::uint32_t overlap = 0;
+    for (std::uint32_t dim = 0; dim < Point::MaxOrder; dim++)
+    {
+      overlap |= std::uint32_t(s.max_[dim] > min_[dim] && max_[dim] > s.min_[dim]) << dim;
+    }
+    return (overlap & LaneMask()) != LaneMask();
+#endif
+  }
+
  public:
 
   AxisAlignedHyperRectangle() = delete;
@@ -219,8 +301,10 @@ class AxisAlignedHyperRectangle
     
     // Both AAHRs should have identical min_, max_ along all-but-one axes, and
     // must be contiguous along the but-one axis.
+    // Note: compile-time trip count; tail lanes beyond order_ are zero in
+    // both operands and never trigger an update.
     bool found = false;
-    for (unsigned dim = 0; dim < order_; dim++)
+    for (unsigned dim = 0; dim < Point::MaxOrder; dim++)
     {
       if (s.max_[dim] >= min_[dim] && max_[dim] >= s.min_[dim])
       {
@@ -315,16 +399,13 @@ class AxisAlignedHyperRectangle
       return Gradient(order_);
     }
 
-    for (unsigned dim = 0; dim < order_; dim++)
+    if (Disjoint(s))
     {
-      if (s.max_[dim] <= min_[dim] || s.min_[dim] >= max_[dim])
-      {
-        // No overlap along even a single dimension means there's
-        // no intersection at all. Skip this function.
-        return Gradient(order_);
-      }
+      // No overlap along even a single dimension means there's
+      // no intersection at all. Skip this function.
+      return Gradient(order_);
     }
- 
+
     auto updated = *this;
     Gradient gradient(order_);
     
@@ -332,8 +413,10 @@ class AxisAlignedHyperRectangle
     // all-but-one axes, and be contiguous or overlapping along the but-one
     // axis. If this isn't true, then torpedo everything, keep the source
     // as the result, and set gradient to 0.
+    // Note: compile-time trip count; tail lanes beyond order_ are zero in
+    // both operands and never mismatch.
     bool found = false;
-    for (unsigned dim = 0; dim < order_; dim++)
+    for (unsigned dim = 0; dim < Point::MaxOrder; dim++)
     {
       if (min_[dim] != s.min_[dim] || max_[dim] != s.max_[dim])
       {
@@ -474,18 +557,151 @@ class AxisAlignedHyperRectangle
     return delta;
   }
 
-  bool operator == (const AxisAlignedHyperRectangle& s) const
+  // Closed-form companion to operator -. Computes the size of the delta that
+  // operator - would have returned, and applies the same gradient bookkeeping
+  // to gradient_, but never materializes the delta AAHR or mutates our
+  // extents. The case analysis mirrors Subtract() and the gradient-change
+  // policy in operator - branch for branch, so callers that only consume
+  // delta *sizes* (e.g., the temporal access counting in nest-analysis) get
+  // bit-identical results from either path.
+  std::size_t DeltaSize(const AxisAlignedHyperRectangle& s)
   {
     ASSERT(order_ == s.order_);
-    
+
+    auto my_size = size();
+
+    // Phase 1 mirrors Subtract(): compute the size the subtracted delta
+    // would have, and the gradient Subtract() would report.
+    Gradient g(order_);
+    std::size_t delta_size = my_size;
+
+    if (my_size == 0 || s.size() == 0)
+    {
+      // Nothing to subtract (or subtract from): delta is all of us.
+    }
+    else if (CornersEqual(s))
+    {
+      delta_size = 0;
+    }
+    else if (Disjoint(s))
+    {
+      // No intersection at all: delta is all of us.
+    }
+    else
+    {
+      // General case. If the operands differ along more than one dimension,
+      // Subtract() torpedoes the subtraction and keeps the source intact.
+      bool found = false;
+      bool torpedo = false;
+      for (unsigned dim = 0; dim < Point::MaxOrder; dim++)
+      {
+        if (min_[dim] != s.min_[dim] || max_[dim] != s.max_[dim])
+        {
+          if (found)
+          {
+            torpedo = true;
+            break;
+          }
+          found = true;
+
+          auto extent = std::size_t(max_[dim] - min_[dim]);
+          if (s.min_[dim] <= min_[dim])
+          {
+            if (s.max_[dim] <= max_[dim])
+            {
+              g.dimension = dim;
+              g.value = s.max_[dim] - min_[dim];
+              delta_size = (my_size / extent) * (max_[dim] - s.max_[dim]);
+            }
+            else
+            {
+              // s covers us along dim: delta is null.
+              delta_size = 0;
+            }
+          }
+          else
+          {
+            // A fracture (s.max_ < max_) would have tripped the assert in
+            // Subtract(); keep the same contract here.
+            assert(s.max_[dim] >= max_[dim]);
+            g.dimension = dim;
+            g.value = s.min_[dim] - max_[dim];
+            delta_size = (my_size / extent) * (s.min_[dim] - min_[dim]);
+          }
+
+          if (delta_size == 0)
+          {
+            // Shrunk down to NULL: Subtract() resets the delta into
+            // canonical form and reports a zero gradient.
+            g.Reset();
+            break;
+          }
+        }
+      }
+      ASSERT(found);
+      if (torpedo)
+      {
+        g.Reset();
+        delta_size = my_size;
+      }
+    }
+
+    // Phase 2 mirrors the gradient-change policy in operator -.
+    if (s.gradient_.value == 0)
+    {
+      gradient_ = g;
+    }
+    else if (g.value == 0 && delta_size == 0)
+    {
+      gradient_ = g;
+    }
+    else if (s.gradient_.dimension == g.dimension &&
+             s.gradient_.Sign() == g.Sign())
+    {
+      gradient_ = g;
+    }
+    else
+    {
+      delta_size = my_size;
+      gradient_ = Gradient(order_);
+    }
+
+    return delta_size;
+  }
+
+  // Bounds-only companion to DeltaSize() for the coarse screening fidelity.
+  // Treats both operands as plain boxes: the delta size is our size minus
+  // the size of the box intersection -- pure interval arithmetic, with no
+  // fracture case analysis, no torpedo fallback and no gradient
+  // bookkeeping or any other mutation. Exact whenever s is contained in us
+  // (the steady state of a monotonically widening working set), an
+  // over-count otherwise; never use it for final stats.
+  std::size_t BoundsOnlyDeltaSize(const AxisAlignedHyperRectangle& s) const
+  {
+    ASSERT(order_ == s.order_);
+
+    auto my_size = size();
+    std::size_t intersection_size = 1;
     for (unsigned dim = 0; dim < order_; dim++)
     {
-      if (min_[dim] != s.min_[dim] || max_[dim] != s.max_[dim])
+      auto low = std::max(min_[dim], s.min_[dim]);
+      auto high = std::min(max_[dim], s.max_[dim]);
+      if (high <= low)
       {
-        return false;
+        intersection_size = 0;
+        break;
       }
+      intersection_size *= std::size_t(high - low);
     }
-    return true;
+
+    return my_size - std::min(intersection_size, my_size);
+  }
+
+  bool operator == (const AxisAlignedHyperRectangle& s) const
+  {
+    ASSERT(order_ == s.order_);
+
+    return CornersEqual(s);
   }
 
   Point GetTranslation(const AxisAlignedHyperRectangle& s) const
@@ -494,7 +710,9 @@ class AxisAlignedHyperRectangle
 
     Point vector(order_);
 
-    for (unsigned dim = 0; dim < order_; dim++)
+    // Compile-time trip count; tail lanes are zero on both sides and yield
+    // zero translation components.
+    for (unsigned dim = 0; dim < Point::MaxOrder; dim++)
     {
       auto min_delta = s.min_[dim] - min_[dim];
       auto max_delta = s.max_[dim] - max_[dim];
@@ -512,11 +730,13 @@ class AxisAlignedHyperRectangle
   {
     ASSERT(order_ == p.Order());
 
-    for (unsigned dim = 0; dim < order_; dim++)
+    // Compile-time trip count; translating the zero tail lanes by the zero
+    // tail components of p is a no-op.
+    for (unsigned dim = 0; dim < Point::MaxOrder; dim++)
     {
       min_[dim] += p[dim];
       max_[dim] += p[dim];
-    }    
+    }
   }
 
   void Print(std::ostream& out = std::cout) const
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <cassert>
 #include <iostream>
@@ -45,13 +46,37 @@
 
 #define POINT_SET_IMPL POINT_SET_AAHR
 
+#ifndef TIMELOOP_POINT_SET_MAX_ORDER
+#define TIMELOOP_POINT_SET_MAX_ORDER 16
+#endif
+
+static_assert(TIMELOOP_POINT_SET_MAX_ORDER % 8 == 0,
+              "TIMELOOP_POINT_SET_MAX_ORDER must be a multiple of 8");
+
 typedef std::int32_t Coordinate;
 
 class Point
 {
+ public:
+  // Maximum order (rank) supported by the inline coordinate storage. Points
+  // and AAHR temporaries are created and destroyed millions of times per
+  // second during delta computation, so we keep the coordinates in a
+  // fixed-capacity inline array instead of a heap-allocated vector, and the
+  // point-set implementations use this compile-time bound (not the runtime
+  // order) as the trip count of their per-dimension loops so that they
+  // fully unroll.
+  //
+  // The bound is a build-time knob: problem shapes we care about have 7-8
+  // dimensions, so the default of 16 leaves headroom, but builds dedicated
+  // to low-rank shapes can compile with e.g. -DTIMELOOP_POINT_SET_MAX_ORDER=8
+  // to tighten the unrolled loops. Must be a multiple of 8 to keep the
+  // vectorized kernels in point-set-aahr.hpp whole. Shape::Parse validates
+  // the loaded shape against this bound.
+  static const std::uint32_t MaxOrder = TIMELOOP_POINT_SET_MAX_ORDER;
+
  protected:
   std::uint32_t order_;
-  std::vector<Coordinate> coordinates_;
+  std::array<Coordinate, MaxOrder> coordinates_;
 
  public:
   Point() = delete;
@@ -65,10 +90,10 @@ class Point
   Point(std::uint32_t order) :
       order_(order)
   {
-    coordinates_.resize(order_);
+    assert(order_ <= MaxOrder);
     Reset();
   }
-  
+
   // Copy-and-swap idiom.
   Point& operator = (Point other)
   {
@@ -85,11 +110,17 @@ class Point
 
   void Reset()
   {
-    std::fill(coordinates_.begin(), coordinates_.end(), 0);
+    // Clear the entire inline array, not just the first order_ entries.
+    // Keeping the unused tail lanes at zero lets vectorized consumers
+    // (see point-set-aahr.hpp) compare whole arrays without masking.
+    coordinates_.fill(0);
   }
 
   std::uint32_t Order() const { return order_; }
 
+  // Raw access to the inline coordinate array, for vectorized kernels.
+  const Coordinate* Data() const { return coordinates_.data(); }
+
   Coordinate& operator[] (std::uint32_t i)
   {
     return coordinates_[i];
@@ -102,21 +133,21 @@ class Point
 
   void IncrementAllDimensions(Coordinate m = 1)
   {
-    for (auto& c : coordinates_)
-      c += m;
+    for (std::uint32_t i = 0; i < order_; i++)
+      coordinates_[i] += m;
   }
 
   void Scale(unsigned factor)
   {
-    for (auto& c : coordinates_)
-      c *= factor;
+    for (std::uint32_t i = 0; i < order_; i++)
+      coordinates_[i] *= factor;
   }
 
   std::ostream& Print(std::ostream& out = std::cout) const
   {
     out << "[" << order_ << "]: ";
-    for (auto& c : coordinates_)
-      out << c << " ";
+    for (std::uint32_t i = 0; i < order_; i++)
+      out << coordinates_[i] << " ";
     return out;
   }
 };
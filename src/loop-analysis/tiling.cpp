@@ -27,7 +27,9 @@
 
 #include <cassert>
 #include <sstream>
+#include <utility>
 
+#include "util/alloc-tracker.hpp"
 #include "tiling.hpp"
 
 namespace tiling
@@ -247,6 +249,8 @@ void DistributeTiles(std::vector<TileInfo>& tile_nest,
       {
         tile_nest[inner].accesses.resize(distributed_multicast_factor);
         tile_nest[inner].scatter_factors.resize(distributed_multicast_factor);
+        TRACK_ALLOC("distributed-multicast access arrays",
+                    2 * distributed_multicast_factor * sizeof(std::uint64_t));
       }
       tile_nest[inner].distributed_multicast = true;
       tile_nest[inner].distributed_fanout = distributed_multicast_factor * tile_nest[inner].fanout;
@@ -381,7 +385,7 @@ void ComputePeerAccesses(std::vector<TileInfo>& tile_nest)
 // Collapse tiles into a given number of levels.
 // Input and output are both arrays of tile nests,
 // with one nest per problem::Shape::DataSpaceID.
-CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels,
+CompoundTileNest CollapseTiles(const CompoundTileNest& tiles, int num_tiling_levels,
                                const CompoundMaskNest& tile_mask,
                                const CompoundMaskNest& distribution_supported)
 {
@@ -448,6 +452,7 @@ CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels,
       }
 
       solution[pv].push_back(collapsed_tile);
+      TRACK_ALLOC("TileInfo copy into collapsed solution", sizeof(collapsed_tile));
 
       processed_loop_count = boundary_loop_id + 1;
       cur_tiling_level++;
@@ -483,19 +488,22 @@ CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels,
 //   return CollapseTiles(tiles, num_tiling_levels, all_enabled);
 // }
 
-NestOfCompoundTiles TransposeTiles(const CompoundTileNest & tiles)
+// Transpose into a level->datatype structure. The input tile nest is dead
+// after this re-arrangement, so we move each (vector-laden) TileInfo into
+// place instead of deep-copying it.
+NestOfCompoundTiles TransposeTiles(CompoundTileNest& tiles)
 {
   NestOfCompoundTiles retval;
-  
+
   std::size_t num_levels = tiles[0].size();
   for (std::size_t level = 0; level < num_levels; level++)
   {
     CompoundTile tile_level;
     for (int pv = 0; pv < int(problem::GetShape()->NumDataSpaces); pv++)
     {
-      tile_level[pv] = tiles[pv][level];
+      tile_level[pv] = std::move(tiles[pv][level]);
     }
-    retval.push_back(tile_level);
+    retval.push_back(std::move(tile_level));
   }
 
   return retval;
@@ -30,6 +30,7 @@
 #include <bitset>
 
 #include "mapping/loop.hpp"
+#include "util/inline-vector.hpp"
 #include "util/numeric.hpp"
 #include "workload/problem-shape.hpp"
 #include "workload/per-data-space.hpp"
@@ -59,9 +60,9 @@ struct TileInfo
   std::size_t size;
   std::size_t partition_size;
   bool distributed_multicast;
-  std::vector<std::uint64_t> accesses;   // accesses at various multicast factors.
-  std::vector<std::uint64_t> scatter_factors;
-  std::vector<double> cumulative_hops;
+  InlineVector<std::uint64_t> accesses;  // accesses at various multicast factors.
+  InlineVector<std::uint64_t> scatter_factors;
+  InlineVector<double> cumulative_hops;
   std::uint64_t content_accesses;
   std::uint64_t fills;
   std::uint64_t link_transfers;
@@ -174,10 +175,11 @@ bool operator < (const TileInfo& a, const TileInfo& b);
 std::ostream& operator << (std::ostream& out, const TileInfo& info);
 
 //nCompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels);
-CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels,
+CompoundTileNest CollapseTiles(const CompoundTileNest& tiles, int num_tiling_levels,
                                const CompoundMaskNest& tile_mask,
                                const CompoundMaskNest& distribution_supported);
-NestOfCompoundTiles TransposeTiles(const CompoundTileNest& tiles);
+// Note: consumes (moves out of) the input tile nest.
+NestOfCompoundTiles TransposeTiles(CompoundTileNest& tiles);
 NestOfCompoundMasks TransposeMasks(const CompoundMaskNest& masks);
 
 }  // namespace tiling
@@ -27,11 +27,14 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include "model/engine.hpp"
 
 //
 // Derived Architecture properties that are relevant to the mapping.
-// 
+//
 
 class ArchProperties
 {
@@ -166,17 +169,17 @@ class ArchProperties
   // Accessors.
   //
   
-  std::uint64_t FanoutX(unsigned storage_level_id)
+  std::uint64_t FanoutX(unsigned storage_level_id) const
   {
     return fanoutX_map_.at(storage_level_id);
   }
-  
-  std::uint64_t FanoutY(unsigned storage_level_id)
+
+  std::uint64_t FanoutY(unsigned storage_level_id) const
   {
     return fanoutY_map_.at(storage_level_id);
   }
-  
-  std::uint64_t Fanout(unsigned storage_level_id)
+
+  std::uint64_t Fanout(unsigned storage_level_id) const
   {
     return fanoutX_map_.at(storage_level_id) * fanoutY_map_.at(storage_level_id);
   }
@@ -211,6 +214,11 @@ class ArchProperties
     return specs_;
   }
 
+  const model::Engine::Specs& Specs() const
+  {
+    return specs_;
+  }
+
   bool IsSpatial(int level) const
   {
     return spatial_mask_.at(level);
@@ -221,6 +229,96 @@ class ArchProperties
     return twoD_spatial_mask_.at(level);
   }
 
+  //
+  // Shared-instance factory.
+  //
+  // Everything derived here depends only on the *structure* of the arch
+  // specs -- the storage hierarchy, level names and mesh dimensions -- and
+  // never changes after construction. Mapspace splits (one mapspace copy
+  // per search thread) and design-space sweep points whose topology
+  // structure is unchanged can therefore share a single const instance
+  // instead of each re-deriving the fanouts and tiling maps. Lookup is by
+  // structural hash, with a full structural comparison guarding against
+  // collisions.
+  //
+
+  static std::uint64_t StructuralHash(const model::Engine::Specs& specs)
+  {
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto HashWord = [&hash](std::uint64_t word)
+      {
+        hash = (hash ^ word) * 1099511628211ULL;
+      };
+    auto HashString = [&HashWord](const std::string& s)
+      {
+        for (char c: s)
+          HashWord(std::uint64_t(c));
+        HashWord(s.size());
+      };
+
+    HashWord(specs.topology.NumLevels());
+    HashWord(specs.topology.NumStorageLevels());
+    HashWord(specs.topology.GetArithmeticLevel()->meshX.Get());
+    HashWord(specs.topology.GetArithmeticLevel()->meshY.Get());
+    for (unsigned i = 0; i < specs.topology.NumStorageLevels(); i++)
+    {
+      auto level = specs.topology.GetStorageLevel(i);
+      HashWord(level->meshX.Get());
+      HashWord(level->meshY.Get());
+      HashWord(specs.topology.StorageMap(i));
+      HashString(level->level_name);
+    }
+    return hash;
+  }
+
+  bool StructurallyMatches(const model::Engine::Specs& specs) const
+  {
+    if (specs.topology.NumLevels() != specs_.topology.NumLevels() ||
+        specs.topology.NumStorageLevels() != specs_.topology.NumStorageLevels() ||
+        specs.topology.GetArithmeticLevel()->meshX.Get() !=
+        specs_.topology.GetArithmeticLevel()->meshX.Get() ||
+        specs.topology.GetArithmeticLevel()->meshY.Get() !=
+        specs_.topology.GetArithmeticLevel()->meshY.Get())
+    {
+      return false;
+    }
+    for (unsigned i = 0; i < specs.topology.NumStorageLevels(); i++)
+    {
+      auto level = specs.topology.GetStorageLevel(i);
+      auto my_level = specs_.topology.GetStorageLevel(i);
+      if (level->meshX.Get() != my_level->meshX.Get() ||
+          level->meshY.Get() != my_level->meshY.Get() ||
+          specs.topology.StorageMap(i) != specs_.topology.StorageMap(i) ||
+          level->level_name != my_level->level_name)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static std::shared_ptr<const ArchProperties> GetShared(const model::Engine::Specs& arch_specs)
+  {
+    static std::mutex mutex;
+    static std::map<std::uint64_t, std::vector<std::shared_ptr<const ArchProperties>>> cache;
+
+    auto hash = StructuralHash(arch_specs);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& bucket = cache[hash];
+    for (auto& props: bucket)
+    {
+      if (props->StructurallyMatches(arch_specs))
+      {
+        return props;
+      }
+    }
+
+    auto props = std::make_shared<const ArchProperties>(arch_specs);
+    bucket.push_back(props);
+    return props;
+  }
+
   //
   // Helpers.
   //
@@ -26,6 +26,7 @@
  */
 
 #include <map>
+#include <mutex>
 #include <regex>
 
 #pragma once
@@ -734,6 +735,45 @@ class Constraints
   //
   // Parse user factors.
   //
+  // Tokenize a factor string ("R=3 S=3 P=1..." or "R<=3 ..." for max
+  // factors), memoized process-wide on the raw string. Design-space
+  // sweeps, batch layers and mapspace splits re-Parse the same constraint
+  // strings on every Init; with the memo the regex machinery runs exactly
+  // once per distinct string per run. Only the tokenization is cached --
+  // dimension-ID resolution and workload bound clamping stay in the
+  // per-parse code, since the same string may be compiled against
+  // different workloads.
+  static const std::vector<std::pair<std::string, int>>&
+  FactorTokens(const std::string& buffer, bool max_factors)
+  {
+    static std::mutex mutex;
+    static std::map<std::pair<std::string, bool>,
+                    std::vector<std::pair<std::string, int>>> cache;
+    static const std::regex factor_re(
+      "([A-Za-z]+)[[:space:]]*[=]*[[:space:]]*([0-9]+)", std::regex::extended);
+    static const std::regex max_factor_re(
+      "([A-Za-z]+)[[:space:]]*<=[[:space:]]*([0-9]+)", std::regex::extended);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto key = std::make_pair(buffer, max_factors);
+    auto it = cache.find(key);
+    if (it != cache.end())
+      return it->second;
+
+    std::vector<std::pair<std::string, int>> tokens;
+    std::smatch sm;
+    std::string str = buffer;
+    auto& re = max_factors ? max_factor_re : factor_re;
+    while (std::regex_search(str, sm, re))
+    {
+      tokens.push_back(std::make_pair(sm[1], std::stoi(sm[2])));
+      str = sm.suffix().str();
+    }
+
+    return cache.emplace(key, std::move(tokens)).first->second;
+  }
+
   std::map<problem::Shape::DimensionID, int> ParseFactors(config::CompoundConfigNode constraint)
   {
     std::map<problem::Shape::DimensionID, int> retval;
@@ -741,13 +781,9 @@ class Constraints
     std::string buffer;
     if (constraint.lookupValue("factors", buffer))
     {
-      std::regex re("([A-Za-z]+)[[:space:]]*[=]*[[:space:]]*([0-9]+)", std::regex::extended);
-      std::smatch sm;
-      std::string str = std::string(buffer);
-
-      while (std::regex_search(str, sm, re))
+      for (auto& token : FactorTokens(buffer, false))
       {
-        std::string dimension_name = sm[1];
+        auto& dimension_name = token.first;
         problem::Shape::DimensionID dimension;
         try
         {
@@ -760,7 +796,7 @@ class Constraints
           exit(1);
         }
 
-        int end = std::stoi(sm[2]);
+        int end = token.second;
         if (end == 0)
         {
           std::cerr << "WARNING: Interpreting 0 to mean full problem dimension instead of residue." << std::endl;
@@ -781,8 +817,6 @@ class Constraints
 
         // Found all the information we need to setup a factor!
         retval[dimension] = end;
-
-        str = sm.suffix().str();
       }
     }
 
@@ -799,13 +833,9 @@ class Constraints
     std::string buffer;
     if (constraint.lookupValue("factors", buffer))
     {
-      std::regex re("([A-Za-z]+)[[:space:]]*<=[[:space:]]*([0-9]+)", std::regex::extended);
-      std::smatch sm;
-      std::string str = std::string(buffer);
-
-      while (std::regex_search(str, sm, re))
+      for (auto& token : FactorTokens(buffer, true))
       {
-        std::string dimension_name = sm[1];
+        auto& dimension_name = token.first;
         problem::Shape::DimensionID dimension;
         try
         {
@@ -818,7 +848,7 @@ class Constraints
           exit(1);
         }
 
-        int max = std::stoi(sm[2]);
+        int max = token.second;
         if (max <= 0)
         {
           std::cerr << "ERROR: max factor must be positive in constraint: " << buffer << std::endl;
@@ -827,8 +857,6 @@ class Constraints
 
         // Found all the information we need to setup a factor!
         retval[dimension] = max;
-
-        str = sm.suffix().str();
       }
     }
 
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <list>
+#include <type_traits>
 #include <vector>
 #include <queue>
 
@@ -90,6 +91,13 @@ class Descriptor
   }
 };
 
+// Nests are assembled, cached and compared wholesale on the evaluation
+// hot path (ConstructMapping, the nest-analysis memo); keeping the
+// descriptor a flat PoD means all of those reduce to memcpy/memcmp-class
+// vector operations.
+static_assert(std::is_trivially_copyable<Descriptor>::value,
+              "loop::Descriptor must remain trivially copyable");
+
 std::ostream& operator<<(std::ostream& out, const Descriptor& loop);
 
 bool IsSpatial(spacetime::Dimension dim);
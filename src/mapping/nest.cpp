@@ -66,6 +66,12 @@ bool Nest::operator == (const Nest& n) const
           storage_tiling_boundaries == n.storage_tiling_boundaries);
 }
 
+void Nest::Reserve(std::uint64_t num_loops, std::uint64_t num_storage_levels)
+{
+  loops.reserve(num_loops);
+  storage_tiling_boundaries.reserve(num_storage_levels);
+}
+
 void Nest::AddLoop(Descriptor descriptor)
 {
   loops.push_back(descriptor);
@@ -61,6 +61,10 @@ class Nest
 
   bool operator == (const Nest& n) const; 
 
+  // Pre-size the flat descriptor and boundary arrays so a sequence of
+  // AddLoop()/AddStorageTilingBoundary() calls never reallocates.
+  void Reserve(std::uint64_t num_loops, std::uint64_t num_storage_levels);
+
   void AddLoop(Descriptor descriptor);
   void AddLoop(problem::Shape::DimensionID dimension, int start, int end, int stride,
                spacetime::Dimension spacetime_dimension);
@@ -429,6 +429,133 @@ std::vector<problem::Shape::DimensionID> ParseUserPermutations(config::CompoundC
   return retval;
 }
 
+//
+// Emit a mapping as a YAML "mapping:" node in the directive format that
+// ParseAndConstruct() reads back. Unlike Mapping::FormatAsConstraints(),
+// which emits mapspace-pruning constraints and omits all-unit spatial
+// levels, ParseAndConstruct() demands a complete directive (factors and
+// a full permutation) for every tiling level, so we emit one for each
+// temporal level and for each storage level that has a spatial fanout.
+//
+void FormatAsYAML(Mapping& mapping, model::Engine::Specs& arch_specs, std::ostream& out)
+{
+  arch_props_.Construct(arch_specs);
+
+  auto num_storage_levels = mapping.loop_nest.storage_tiling_boundaries.size();
+
+  out << "mapping:" << std::endl;
+
+  // Emit a single directive. Dimensions with unit factors are concatenated
+  // onto the tail of the permutation so that it covers all dimensions.
+  auto emit_directive = [&out](unsigned storage_level, const char* type,
+                               const std::map<problem::Shape::DimensionID, unsigned>& factors,
+                               std::string permutation, int split)
+  {
+    std::string factor_string = "";
+    for (unsigned idim = 0; idim < unsigned(problem::GetShape()->NumDimensions); idim++)
+    {
+      auto dim = problem::Shape::DimensionID(idim);
+      factor_string += problem::GetShape()->DimensionIDToName.at(dim);
+      factor_string += std::to_string(factors.at(dim));
+      if (idim != unsigned(problem::GetShape()->NumDimensions)-1)
+        factor_string += " ";
+      if (factors.at(dim) == 1)
+        permutation += problem::GetShape()->DimensionIDToName.at(dim);
+    }
+    out << "  - target: " << storage_level << std::endl;
+    out << "    type: " << type << std::endl;
+    out << "    factors: \"" << factor_string << "\"" << std::endl;
+    out << "    permutation: \"" << permutation << "\"" << std::endl;
+    if (split >= 0)
+      out << "    split: " << split << std::endl;
+  };
+
+  unsigned loop_level = 0;
+  for (unsigned storage_level = 0; storage_level < num_storage_levels; storage_level++)
+  {
+    std::map<spacetime::Dimension, std::string> permutations;
+    std::map<spacetime::Dimension, std::map<problem::Shape::DimensionID, unsigned>> factors;
+
+    for (unsigned sdi = 0; sdi < unsigned(spacetime::Dimension::Num); sdi++)
+    {
+      auto sd = spacetime::Dimension(sdi);
+      permutations[sd] = "";
+      for (unsigned idim = 0; idim < unsigned(problem::GetShape()->NumDimensions); idim++)
+        factors[sd][problem::Shape::DimensionID(idim)] = 1;
+    }
+
+    for (; loop_level <= mapping.loop_nest.storage_tiling_boundaries.at(storage_level); loop_level++)
+    {
+      auto& loop = mapping.loop_nest.loops.at(loop_level);
+      if (loop.end > 1)
+      {
+        factors.at(loop.spacetime_dimension).at(loop.dimension) = loop.end;
+        permutations.at(loop.spacetime_dimension) += problem::GetShape()->DimensionIDToName.at(loop.dimension);
+      }
+    }
+
+    // Emit a spatial directive iff this storage level has a spatial tiling
+    // level, even when all its factors are unit (the parser requires it).
+    bool has_spatial_level = true;
+    try
+    {
+      arch_props_.SpatialToTiling(storage_level);
+    }
+    catch (const std::out_of_range& oor)
+    {
+      has_spatial_level = false;
+    }
+
+    if (has_spatial_level)
+    {
+      unsigned spatial_split = permutations.at(spacetime::Dimension::SpaceX).size();
+      std::string spatial_permutation =
+        permutations.at(spacetime::Dimension::SpaceX) +
+        permutations.at(spacetime::Dimension::SpaceY);
+
+      std::map<problem::Shape::DimensionID, unsigned> spatial_factors;
+      for (unsigned idim = 0; idim < unsigned(problem::GetShape()->NumDimensions); idim++)
+      {
+        auto dim = problem::Shape::DimensionID(idim);
+        spatial_factors[dim] =
+          factors.at(spacetime::Dimension::SpaceX).at(dim) *
+          factors.at(spacetime::Dimension::SpaceY).at(dim);
+      }
+
+      emit_directive(storage_level, "spatial", spatial_factors,
+                     spatial_permutation, static_cast<int>(spatial_split));
+    }
+
+    emit_directive(storage_level, "temporal", factors.at(spacetime::Dimension::Time),
+                   permutations.at(spacetime::Dimension::Time), -1);
+  }
+
+  // Datatype bypass.
+  auto mask_nest = tiling::TransposeMasks(mapping.datatype_bypass_nest);
+
+  for (unsigned storage_level = 0; storage_level < num_storage_levels; storage_level++)
+  {
+    std::string keep_string = "";
+    std::string bypass_string = "";
+    auto& compound_mask = mask_nest.at(storage_level);
+    for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
+    {
+      problem::Shape::DataSpaceID pv = problem::Shape::DataSpaceID(pvi);
+      auto& target = compound_mask.at(pv) ? keep_string : bypass_string;
+      if (!target.empty())
+        target += ", ";
+      target += problem::GetShape()->DataSpaceIDToName.at(pv);
+    }
+
+    out << "  - target: " << storage_level << std::endl;
+    out << "    type: datatype" << std::endl;
+    if (!keep_string.empty())
+      out << "    keep: [ " << keep_string << " ]" << std::endl;
+    if (!bypass_string.empty())
+      out << "    bypass: [ " << bypass_string << " ]" << std::endl;
+  }
+}
+
 //
 // Parse user datatype bypass settings.
 //
@@ -36,4 +36,6 @@ namespace mapping
 
 Mapping ParseAndConstruct(config::CompoundConfigNode config, model::Engine::Specs& arch_specs, problem::Workload workload);
 
+void FormatAsYAML(Mapping& mapping, model::Engine::Specs& arch_specs, std::ostream& out);
+
 } // namespace mapping
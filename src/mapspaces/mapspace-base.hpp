@@ -97,11 +97,30 @@ class MapSpace
 
   virtual std::vector<Status> ConstructMapping(ID mapping_id, Mapping* mapping, bool break_on_failure = true) = 0;
 
-  std::vector<Status> ConstructMapping(const uint128_t mapping_id, Mapping* mapping, bool break_on_failure = true)
+  // Build a full-rank ID in this mapspace's coordinates from its flat
+  // integer form (the inverse of ID::Integer()).
+  ID MakeID(const uint128_t mapping_id) const
   {
     ID cmapping_id(size_);
     cmapping_id.Set(mapping_id);
-    return ConstructMapping(cmapping_id, mapping, break_on_failure); 
+    return cmapping_id;
+  }
+
+  std::vector<Status> ConstructMapping(const uint128_t mapping_id, Mapping* mapping, bool break_on_failure = true)
+  {
+    return ConstructMapping(MakeID(mapping_id), mapping, break_on_failure);
+  }
+
+  // Translate a fully-specified mapping back into this mapspace's
+  // coordinates -- the inverse of ConstructMapping() -- e.g., to
+  // warm-start a search from a previously-found mapping. Optional:
+  // mapspaces without support simply report every mapping as
+  // untranslatable.
+  virtual bool TranslateMapping(const Mapping& mapping, ID& mapping_id)
+  {
+    (void) mapping;
+    (void) mapping_id;
+    return false;
   }
 
   uint128_t Size(Dimension dim)
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <numeric>
@@ -49,6 +50,34 @@ class IndexFactorizationSpace
   problem::PerProblemDimension<Factors> dimension_factors_;
   CartesianCounterDynamic tiling_counter_;
 
+  // The nest ID the counter is currently parked at. GetFactor() is called
+  // once per (dimension, level) while constructing a single mapping, and
+  // sequential search algorithms walk nest IDs in order; memoizing the
+  // decoded position (and advancing by an O(1) carry-propagating increment
+  // when the next ID is requested) avoids a full multi-precision divmod
+  // decode on every call.
+  uint128_t current_id_;
+  bool current_id_valid_ = false;
+
+  void SetNestID(uint128_t nest_id)
+  {
+    if (current_id_valid_ && nest_id == current_id_)
+    {
+      return;
+    }
+    else if (current_id_valid_ && nest_id == current_id_ + 1 &&
+             tiling_counter_.Increment())
+    {
+      // Streamed forward: the counter advanced incrementally.
+    }
+    else
+    {
+      tiling_counter_.Set(nest_id);
+    }
+    current_id_ = nest_id;
+    current_id_valid_ = true;
+  }
+
  public:
   IndexFactorizationSpace() :
       tiling_counter_(problem::GetShape()->NumDimensions)
@@ -79,6 +108,7 @@ class IndexFactorizationSpace
     }
 
     tiling_counter_.Init(counter_base);
+    current_id_valid_ = false;
 
     std::cout << "Initializing Index Factorization subspace." << std::endl;
     for (int dim = 0; dim < int(problem::GetShape()->NumDimensions); dim++)
@@ -92,9 +122,42 @@ class IndexFactorizationSpace
   unsigned long GetFactor(uint128_t nest_id, problem::Shape::DimensionID dim, unsigned level)
   {
     auto idim = unsigned(dim);
-    tiling_counter_.Set(nest_id);
-    auto cartesian_idx = tiling_counter_.Read();    
-    return dimension_factors_[idim][std::uint64_t(cartesian_idx[idim])][level];
+    SetNestID(nest_id);
+    return dimension_factors_[idim][std::uint64_t(tiling_counter_[idim])][level];
+  }
+
+  // Inverse of GetFactor() over all (dimension, level) pairs: find the
+  // flat nest ID whose factorization matches the given per-dimension,
+  // per-level factor vectors exactly. Used to translate a fully-specified
+  // mapping back into mapspace coordinates. Returns false if some
+  // dimension's factor vector is not in the (possibly constraint-pruned)
+  // enumerated set.
+  bool TranslateFactors(const problem::PerProblemDimension<std::vector<unsigned long>>& factors,
+                        uint128_t& nest_id)
+  {
+    nest_id = 0;
+    uint128_t place = 1;
+    for (int idim = 0; idim < int(problem::GetShape()->NumDimensions); idim++)
+    {
+      std::size_t num_options = dimension_factors_[idim].size();
+      std::size_t match = num_options;
+      for (std::size_t i = 0; i < num_options; i++)
+      {
+        if (dimension_factors_[idim][i] == factors[idim])
+        {
+          match = i;
+          break;
+        }
+      }
+      if (match == num_options)
+      {
+        return false;
+      }
+      // The counter flattens with dimension 0 as the fastest-varying digit.
+      nest_id += place * match;
+      place *= num_options;
+    }
+    return true;
   }
 
   uint128_t Size() const
@@ -118,9 +181,20 @@ class PermutationSpace
   };
   std::map<unsigned, Pattern> patterns_;
   std::vector<problem::Shape::DimensionID> canonical_pattern_;
-  std::map<unsigned, std::uint64_t> size_;    
+  std::map<unsigned, std::uint64_t> size_;
   Factoradic<problem::Shape::DimensionID> factoradic_;
 
+  // Fully-decoded per-level pattern tables, built at InitLevel() time and
+  // indexed by local permutation ID (stride = NumDimensions). Searches
+  // sweep permutation IDs densely, so GetPatterns() sits on the mapping-
+  // construction hot path; a contiguous table lookup replaces the
+  // factoradic decode-and-permute there. The per-level spaces are small
+  // (at most D! over the permutable suffix), but degenerate shapes with
+  // many permutable dimensions fall back to on-demand decoding beyond the
+  // size cap below (an empty table marks the fallback).
+  static const std::uint64_t kMaxPatternTableEntries = 1 << 20;
+  std::map<unsigned, std::vector<problem::Shape::DimensionID>> pattern_tables_;
+
  public:
   PermutationSpace()
   {
@@ -135,6 +209,7 @@ class PermutationSpace
     num_levels_ = num_levels;
     patterns_.clear();
     size_.clear();
+    pattern_tables_.clear();
   }
 
   void InitLevelCanonical(uint64_t level)
@@ -173,25 +248,54 @@ class PermutationSpace
 
     patterns_[level] = { baked_prefix, permutable_suffix };
     size_[level] = factoradic_.Factorial(permutable_suffix.size());
+
+    // Precompute the decoded pattern table for this level (see the
+    // pattern_tables_ comment above). A fully-baked level degenerates to a
+    // single-entry table holding the prefix itself.
+    auto& table = pattern_tables_[level];
+    table.clear();
+    if (size_[level] <= kMaxPatternTableEntries)
+    {
+      table.reserve(std::size_t(size_[level]) *
+                    unsigned(problem::GetShape()->NumDimensions));
+      for (std::uint64_t local_id = 0; local_id < size_[level]; local_id++)
+      {
+        auto permuted_suffix = permutable_suffix;
+        if (!permuted_suffix.empty())
+          factoradic_.Permute(permuted_suffix.data(), permuted_suffix.size(), local_id);
+        table.insert(table.end(), baked_prefix.begin(), baked_prefix.end());
+        table.insert(table.end(), permuted_suffix.begin(), permuted_suffix.end());
+      }
+    }
   }
 
   std::vector<std::vector<problem::Shape::DimensionID>> GetPatterns(uint128_t id)
   {
     std::vector<std::vector<problem::Shape::DimensionID>> retval;
+    retval.reserve(num_levels_);
+
+    unsigned num_dims = unsigned(problem::GetShape()->NumDimensions);
 
     for (unsigned level = 0; level < num_levels_; level++)
     {
-      auto& pattern = patterns_.at(level);
-      if (pattern.baked_prefix.size() == unsigned(problem::GetShape()->NumDimensions))
+      // Fully-baked levels have size 1, so the local ID is 0 and the
+      // division leaves the ID untouched -- no special case needed.
+      auto local_id = std::uint64_t(id % size_.at(level));
+      id = id / size_.at(level);
+
+      auto& table = pattern_tables_.at(level);
+      if (!table.empty())
       {
-        retval.push_back(pattern.baked_prefix);
+        auto* begin = table.data() + std::size_t(local_id) * num_dims;
+        retval.emplace_back(begin, begin + num_dims);
       }
       else
       {
+        // Fallback for levels beyond the precompute cap.
+        auto& pattern = patterns_.at(level);
         std::vector<problem::Shape::DimensionID> permuted_suffix = pattern.permutable_suffix;
-        factoradic_.Permute(permuted_suffix.data(), permuted_suffix.size(),
-                            std::uint64_t(id % size_.at(level)));
-        id = id / size_.at(level);
+        if (!permuted_suffix.empty())
+          factoradic_.Permute(permuted_suffix.data(), permuted_suffix.size(), local_id);
         std::vector<problem::Shape::DimensionID> final_pattern = pattern.baked_prefix;
         final_pattern.insert(final_pattern.end(), permuted_suffix.begin(), permuted_suffix.end());
 
@@ -202,6 +306,57 @@ class PermutationSpace
     return retval;
   }
 
+  // Inverse of GetPatterns(): recover the permutation ID that produces the
+  // given per-level dimension orders. Each level's order may be partial
+  // (degenerate loops do not survive in a constructed mapping); unlisted
+  // permutable dimensions are appended after the listed ones. Dimensions
+  // pinned in a level's baked prefix are ignored, so an order that
+  // disagrees with the prefix translates to the nearest representable
+  // pattern rather than failing.
+  bool TranslatePatterns(const std::vector<std::vector<problem::Shape::DimensionID>>& orders,
+                         uint128_t& id)
+  {
+    assert(orders.size() == num_levels_);
+
+    id = 0;
+    uint128_t place = 1;
+    for (unsigned level = 0; level < num_levels_; level++)
+    {
+      auto& pattern = patterns_.at(level);
+      if (pattern.baked_prefix.size() == unsigned(problem::GetShape()->NumDimensions))
+      {
+        continue;
+      }
+
+      // Project the requested order onto the permutable suffix, then
+      // append any suffix dimensions the order did not mention.
+      std::vector<problem::Shape::DimensionID> target;
+      for (auto dim : orders.at(level))
+      {
+        if (std::find(pattern.permutable_suffix.begin(), pattern.permutable_suffix.end(),
+                      dim) != pattern.permutable_suffix.end())
+        {
+          target.push_back(dim);
+        }
+      }
+      for (auto dim : pattern.permutable_suffix)
+      {
+        if (std::find(target.begin(), target.end(), dim) == target.end())
+        {
+          target.push_back(dim);
+        }
+      }
+      assert(target.size() == pattern.permutable_suffix.size());
+
+      std::vector<problem::Shape::DimensionID> reference = pattern.permutable_suffix;
+      auto rank = factoradic_.Rank(reference.data(), target.data(), reference.size());
+
+      id += place * rank;
+      place *= size_.at(level);
+    }
+    return true;
+  }
+
   uint128_t Size() const
   {
     uint128_t product = 1;
@@ -290,13 +445,45 @@ class SpatialSplitSpace
     return retval;
   }
 
+  // Inverse of GetSplits(): recover the spatial-split ID from the number
+  // of non-degenerate X-axis loops at each spatial level. (With the unit
+  // factors pruned into the prefix, a variable level's split value is
+  // exactly unit_factors + that count.) Levels with user-specified splits
+  // contribute nothing to the ID. Returns false if a count exceeds the
+  // level's split range.
+  bool TranslateSplits(const std::map<unsigned, std::uint32_t>& x_counts, uint128_t& id)
+  {
+    id = 0;
+    uint128_t place = 1;
+    for (unsigned level = 0; level < num_levels_; level++)
+    {
+      auto it_is_user_specified = is_user_specified_.find(level);
+      if (it_is_user_specified == is_user_specified_.end() ||
+          it_is_user_specified->second)
+      {
+        continue;
+      }
+
+      auto it = x_counts.find(level);
+      std::uint32_t digit = (it != x_counts.end()) ? it->second : 0;
+      if (digit >= size_.at(level))
+      {
+        return false;
+      }
+
+      id += place * digit;
+      place *= size_.at(level);
+    }
+    return true;
+  }
+
   uint128_t Size() const
   {
     uint128_t retval = 1;
     for (auto& it : size_)
       retval *= uint128_t(it.second);
     return retval;
-  }  
+  }
 };
 
 } // namespace mapspace
@@ -34,6 +34,8 @@
 
 #include "util/numeric.hpp"
 #include "util/misc.hpp"
+#include "util/cycle-timer.hpp"
+#include "util/perf-counters.hpp"
 #include "workload/problem-shape.hpp"
 #include "mapspaces/mapspace-base.hpp"
 #include "mapspaces/subspaces.hpp"
@@ -62,9 +64,150 @@ class Uber : public MapSpace
   std::vector<Uber*> splits_;
   std::uint64_t split_id_;
   std::uint64_t num_parent_splits_;
-  
-  // Abstract representation of the architecture.
-  ArchProperties arch_props_;
+
+  // Translate a split-local index factorization ID into a global one.
+  // Splits interleave over the global ID space, with the residue class
+  // rotated by the local index: split s draws global ID i*N + (s+i) mod N
+  // at local index i. A fixed residue per split (the old i*N + s scheme)
+  // made each thread sample a biased slice of the fastest-varying
+  // factorization digit whenever that digit's base was close to a multiple
+  // of the thread count, concentrating construction-failure-dense regions
+  // onto a few unlucky threads. The rotation cycles every split through
+  // all residues, so failure density evens out regardless of alignment.
+  uint128_t GlobalIFID(uint128_t local_id) const
+  {
+    if (num_parent_splits_ < 2)
+      return local_id * num_parent_splits_ + split_id_;
+    std::uint64_t rotation = std::uint64_t((local_id + split_id_) % num_parent_splits_);
+    return local_id * num_parent_splits_ + rotation;
+  }
+
+  // Decode cache for ConstructMapping(). Search algorithms iterate one
+  // mapspace dimension at a time, so the permutation/factorization stages
+  // usually re-decode the same sub-IDs as the previous call; we snapshot
+  // the subnests after each of those stages and reuse them when the
+  // corresponding sub-IDs are unchanged. Invalidated by InitPruned(),
+  // which redefines what a permutation ID means.
+  struct DecodeCache
+  {
+    bool valid = false;
+    uint128_t permutation_id;
+    uint128_t index_factorization_id;  // global (post-split-translation)
+    loop::NestConfig permuted_subnests;
+    loop::NestConfig factored_subnests;
+  };
+  DecodeCache decode_cache_;
+
+  // Memoized spatial-fanout feasibility for the current factorization
+  // class. The product of all factors at a spatial tiling level equals
+  // x_expansion * y_expansion for every possible split, so if it exceeds
+  // that level's total hardware fanout then *every* spatial split (and
+  // every permutation and bypass choice) in this factorization class is
+  // doomed; we can reject before constructing anything. Per-split
+  // feasibility is deliberately not indexed here: for 2D spatial levels
+  // it depends on the loop permutation, not just the (factorization,
+  // split) pair.
+  struct FanoutFeasibility
+  {
+    bool valid = false;
+    uint128_t index_factorization_id;  // global (post-split-translation)
+    bool feasible;
+    unsigned fail_tiling_level;
+    std::size_t fail_product;
+  };
+  FanoutFeasibility fanout_feasibility_;
+
+  // Lazily-populated validity bitmaps over the (global) factorization
+  // subspace, backing the memo above: the first time a factorization class
+  // is proven (in)feasible its bit is set, so repeat visits anywhere in
+  // the search -- not just the immediately preceding call -- are resolved
+  // by a single bit test. Only factorization coordinates are tracked;
+  // spatial-split validity depends on the loop permutation (see the
+  // FanoutFeasibility comment) and so cannot be attributed to the split
+  // coordinate alone. Disabled when the subspace is too large to back
+  // with a bitmap.
+  static const std::uint64_t kValidityBitmapMaxEntries = 1ULL << 26;
+  bool validity_bitmap_init_ = false;
+  bool validity_bitmap_enabled_ = false;
+  std::vector<bool> if_validity_known_;
+  std::vector<bool> if_invalid_;
+
+  // Check (and memoize) whether the given factorization class can satisfy
+  // the spatial fanout limits under *any* spatial split.
+  const FanoutFeasibility& CheckFanoutFeasibility(uint128_t mapping_index_factorization_id)
+  {
+    if (fanout_feasibility_.valid &&
+        fanout_feasibility_.index_factorization_id == mapping_index_factorization_id)
+      return fanout_feasibility_;
+
+    if (!validity_bitmap_init_)
+    {
+      validity_bitmap_init_ = true;
+      validity_bitmap_enabled_ =
+        (index_factorization_space_.Size() <= kValidityBitmapMaxEntries);
+      if (validity_bitmap_enabled_)
+      {
+        auto num_entries = std::uint64_t(index_factorization_space_.Size());
+        if_validity_known_.assign(num_entries, false);
+        if_invalid_.assign(num_entries, false);
+      }
+    }
+
+    std::size_t bitmap_index = validity_bitmap_enabled_ ?
+      std::size_t(std::uint64_t(mapping_index_factorization_id)) : 0;
+
+    // Known-feasible coordinates skip the product walk entirely. Known-
+    // infeasible ones still walk (it terminates at the offending level)
+    // to recover the failure details for the status message.
+    if (validity_bitmap_enabled_ &&
+        if_validity_known_.at(bitmap_index) && !if_invalid_.at(bitmap_index))
+    {
+      fanout_feasibility_.valid = true;
+      fanout_feasibility_.index_factorization_id = mapping_index_factorization_id;
+      fanout_feasibility_.feasible = true;
+      return fanout_feasibility_;
+    }
+
+    fanout_feasibility_.valid = true;
+    fanout_feasibility_.index_factorization_id = mapping_index_factorization_id;
+    fanout_feasibility_.feasible = true;
+
+    for (uint64_t level = 0; level < arch_props_->TilingLevels(); level++)
+    {
+      if (!arch_props_->IsSpatial(level))
+        continue;
+
+      std::size_t product = 1;
+      for (unsigned idim = 0; idim < unsigned(problem::GetShape()->NumDimensions); idim++)
+      {
+        product *= index_factorization_space_.GetFactor(
+          mapping_index_factorization_id, problem::Shape::DimensionID(idim), level);
+      }
+
+      if (product > arch_props_->Fanout(arch_props_->TilingToStorage(level)))
+      {
+        fanout_feasibility_.feasible = false;
+        fanout_feasibility_.fail_tiling_level = level;
+        fanout_feasibility_.fail_product = product;
+        break;
+      }
+    }
+
+    if (validity_bitmap_enabled_)
+    {
+      if_validity_known_.at(bitmap_index) = true;
+      if_invalid_.at(bitmap_index) = !fanout_feasibility_.feasible;
+    }
+
+    return fanout_feasibility_;
+  }
+
+  // Abstract representation of the architecture. Immutable and shared:
+  // every split of this mapspace (and any other mapspace over a
+  // structurally identical topology) points at the same instance, so the
+  // fanout derivation runs once per topology structure rather than once
+  // per thread. See ArchProperties::GetShared().
+  std::shared_ptr<const ArchProperties> arch_props_;
 
   // Constraints.
   mapping::Constraints constraints_;
@@ -85,8 +228,8 @@ class Uber : public MapSpace
       MapSpace(arch_specs, workload),
       split_id_(0),
       num_parent_splits_(0),
-      arch_props_(arch_specs),
-      constraints_(arch_props_, workload)
+      arch_props_(ArchProperties::GetShared(arch_specs)),
+      constraints_(*arch_props_, workload)
   {
     if (!skip_init)
     {
@@ -108,8 +251,37 @@ class Uber : public MapSpace
 
     // Setup all the mapping sub-spaces.
     InitIndexFactorizationSpace();
-    InitLoopPermutationSpace();
-    InitSpatialSpace();
+
+    // Dimensions with a workload bound of 1 carry a unit factor at every
+    // level of every factorization, so their position within a permutation
+    // is irrelevant (the degenerate loops are dropped during construction
+    // anyway). Collapse them up front: InitPruned() does this per
+    // factorization for the pruned searches, but the non-pruned searches
+    // never call it and would enumerate every ordering of the degenerate
+    // dimensions. As in InitPruned(), leave levels with user-specified
+    // spatial splits alone, since pruning re-orders the dimensions under
+    // the user's split point.
+    std::map<unsigned, std::vector<problem::Shape::DimensionID>> degenerate_dimensions;
+    std::map<unsigned, unsigned> degenerate_unit_factors;
+    auto user_spatial_splits = constraints_.SpatialSplits();
+    for (uint64_t level = 0; level < arch_props_->TilingLevels(); level++)
+    {
+      if (user_spatial_splits.find(level) == user_spatial_splits.end())
+      {
+        for (unsigned idim = 0; idim < unsigned(problem::GetShape()->NumDimensions); idim++)
+        {
+          auto dim = problem::Shape::DimensionID(idim);
+          if (workload_.GetBound(dim) == 1)
+          {
+            degenerate_dimensions[level].push_back(dim);
+          }
+        }
+      }
+      degenerate_unit_factors[level] = degenerate_dimensions[level].size();
+    }
+
+    InitLoopPermutationSpace(degenerate_dimensions);
+    InitSpatialSpace(degenerate_unit_factors);
     InitDatatypeBypassNestSpace();
 
     // FIXME: optimization: add a "deferred" flag which bypasses
@@ -146,7 +318,7 @@ class Uber : public MapSpace
     auto user_factors = constraints_.Factors();
     auto user_max_factors = constraints_.MaxFactors();
 
-    assert(user_factors.size() <= arch_props_.TilingLevels());
+    assert(user_factors.size() <= arch_props_->TilingLevels());
 
     // We'll initialize the index_factorization_space_ object here. To do that, we first
     // need to determine the number of factors that *each* problem dimension needs to be
@@ -157,7 +329,7 @@ class Uber : public MapSpace
     for (unsigned i = 0; i < unsigned(problem::GetShape()->NumDimensions); i++)
     {
       // Factorize each problem dimension into num_tiling_levels partitions.
-      cofactors_order[problem::Shape::DimensionID(i)] = arch_props_.TilingLevels();
+      cofactors_order[problem::Shape::DimensionID(i)] = arch_props_->TilingLevels();
     }
 
     // Next, for each problem dimension, we need to tell the index_factorization_space_
@@ -167,9 +339,10 @@ class Uber : public MapSpace
     std::map<problem::Shape::DimensionID, std::map<unsigned, unsigned long>> prefactors;
     std::map<problem::Shape::DimensionID, std::map<unsigned, unsigned long>> maxfactors;
     std::vector<bool> exhausted_um_loops(int(problem::GetShape()->NumDimensions), false);
+    std::map<problem::Shape::DimensionID, unsigned> exhausted_level;
 
     // Find user-specified fixed factors.
-    for (unsigned level = 0; level < arch_props_.TilingLevels(); level++)
+    for (unsigned level = 0; level < arch_props_->TilingLevels(); level++)
     {
       auto it = user_factors.find(level);
       if (it != user_factors.end())
@@ -183,6 +356,7 @@ class Uber : public MapSpace
           {
             assert(!exhausted_um_loops[int(dimension)]);
             exhausted_um_loops[int(dimension)] = true;
+            exhausted_level[dimension] = level;
           }
           else
           {
@@ -193,7 +367,7 @@ class Uber : public MapSpace
     }
 
     // Find user-specified max factors.
-    for (unsigned level = 0; level < arch_props_.TilingLevels(); level++)
+    for (unsigned level = 0; level < arch_props_->TilingLevels(); level++)
     {
       auto it = user_max_factors.find(level);
       if (it != user_max_factors.end())
@@ -208,6 +382,40 @@ class Uber : public MapSpace
       }
     }
 
+    // Constraint propagation: at a spatial tiling level, a single factor
+    // larger than the hardware fanout of the corresponding storage level is
+    // guaranteed to fail the fanout check at mapping-construction time, so
+    // bake the fanout in as an implicit max factor. This shrinks the
+    // enumerated space to (closer to) the feasible region instead of
+    // burning threads on doomed constructions. We leave user-pinned factors
+    // and residual (-1) factors alone: if those are infeasible we want the
+    // construction-time failure and its diagnostic, not a silently emptied
+    // subspace.
+    for (unsigned level = 0; level < arch_props_->TilingLevels(); level++)
+    {
+      if (!arch_props_->IsSpatial(level))
+        continue;
+
+      auto fanout = arch_props_->Fanout(arch_props_->TilingToStorage(level));
+      for (unsigned idim = 0; idim < unsigned(problem::GetShape()->NumDimensions); idim++)
+      {
+        auto dim = problem::Shape::DimensionID(idim);
+
+        auto pf = prefactors.find(dim);
+        if (pf != prefactors.end() && pf->second.find(level) != pf->second.end())
+          continue;
+
+        auto el = exhausted_level.find(dim);
+        if (el != exhausted_level.end() && el->second == level)
+          continue;
+
+        auto& dim_max = maxfactors[dim];
+        auto it = dim_max.find(level);
+        if (it == dim_max.end() || it->second > fanout)
+          dim_max[level] = fanout;
+      }
+    }
+
     // We're now ready to initialize the object.
     index_factorization_space_.Init(workload_, cofactors_order, prefactors, maxfactors);
 
@@ -222,9 +430,9 @@ class Uber : public MapSpace
   {
     auto user_permutations = constraints_.Permutations();
 
-    permutation_space_.Init(arch_props_.TilingLevels());
+    permutation_space_.Init(arch_props_->TilingLevels());
     
-    for (uint64_t level = 0; level < arch_props_.TilingLevels(); level++)
+    for (uint64_t level = 0; level < arch_props_->TilingLevels(); level++)
     {
       // Extract the user-provided pattern for this level.
       std::vector<problem::Shape::DimensionID> user_prefix;
@@ -235,13 +443,13 @@ class Uber : public MapSpace
       }
 
       bool use_canonical_permutation = false;
-      if (arch_props_.IsSpatial(level))
+      if (arch_props_->IsSpatial(level))
       {
-        use_canonical_permutation = user_prefix.empty() && !arch_props_.IsSpatial2D(level);
+        use_canonical_permutation = user_prefix.empty() && !arch_props_->IsSpatial2D(level);
       }
       else
       {
-        use_canonical_permutation = (level == 0); // || level == arch_props_.TilingLevels()-1); // FIXME: last level?
+        use_canonical_permutation = (level == 0); // || level == arch_props_->TilingLevels()-1); // FIXME: last level?
       }
       
       if (use_canonical_permutation)
@@ -276,11 +484,11 @@ class Uber : public MapSpace
     // Given a spatial permutation, this indicates where the changeover from X
     // to Y dimension occurs. Obviously, this is limited by hardware fanout
     // capabilities at this spatial level.
-    spatial_split_space_.Init(arch_props_.TilingLevels());
+    spatial_split_space_.Init(arch_props_->TilingLevels());
     
-    for (uint64_t level = 0; level < arch_props_.TilingLevels(); level++)
+    for (uint64_t level = 0; level < arch_props_->TilingLevels(); level++)
     {
-      if (arch_props_.IsSpatial(level))
+      if (arch_props_->IsSpatial(level))
       {
         // Extract the user-provided split point for this level.
         auto it = user_spatial_splits.find(level);
@@ -430,8 +638,11 @@ class Uber : public MapSpace
     {
       Uber* mapspace = new Uber(*this);
 
-      // Last <residue> splits have 1-smaller size.
-      uint128_t if_size = (i < num_splits - split_residue) ? split_size : split_size - 1;
+      // <residue> splits have 1-smaller size: with the rotated interleave,
+      // ownership of the partial last block is decided by each split's
+      // rotated residue there.
+      std::uint64_t last_residue = std::uint64_t((split_size - 1 + i) % num_splits);
+      uint128_t if_size = (last_residue < num_splits - split_residue) ? split_size : split_size - 1;
       mapspace->InitSplit(i, if_size, num_splits);
       
       splits.push_back(mapspace);
@@ -467,6 +678,10 @@ class Uber : public MapSpace
   {
     assert(!IsSplit());
 
+    // Re-initializing the permutation/spatial subspaces changes the meaning
+    // of their sub-IDs, so cached decodes are stale.
+    decode_cache_.valid = false;
+
     auto user_permutations = constraints_.Permutations();
     auto user_spatial_splits = constraints_.SpatialSplits();
 
@@ -481,14 +696,14 @@ class Uber : public MapSpace
     }
     
     // Find global index factorization id (across all splits).
-    uint128_t mapping_index_factorization_id = index_factorization_id * num_parent_splits_ + split_id_;
+    uint128_t mapping_index_factorization_id = GlobalIFID(index_factorization_id);
 
     // Create a set of pruned dimensions (one per tiling level).
     std::map<unsigned, std::vector<problem::Shape::DimensionID>> pruned_dimensions;
     std::map<unsigned, unsigned> unit_factors;
 
     // Extract the index factors resulting from this ID for all loops at all levels.
-    for (uint64_t level = 0; level < arch_props_.TilingLevels(); level++)
+    for (uint64_t level = 0; level < arch_props_->TilingLevels(); level++)
     {
       // We won't prune spatial dimensions with user-specificed
       // spatial splits, because pruning re-orders the dimensions, which
@@ -533,10 +748,13 @@ class Uber : public MapSpace
     // FIXME: add a cache so that if any of the mapping subspace IDs are the same as the
     // last call, we can avoid some re-computing.
 
+    timer::Scope timer_scope(timer::Phase::MappingConstruct);
+    perf::Scope perf_scope(timer::Phase::MappingConstruct);
+
     assert(!IsSplit());
 
     // A set of subnests, one for each tiling level.
-    loop::NestConfig subnests(arch_props_.TilingLevels());
+    loop::NestConfig subnests(arch_props_->TilingLevels());
 
     // We will construct the mapping in several stages. At each stage,
     // we will provide a private ID that indexes into the sub-space
@@ -554,7 +772,7 @@ class Uber : public MapSpace
     
     // Find global index factorization id (across all splits).
     uint128_t mapping_index_factorization_id =
-      mapping_id[int(mapspace::Dimension::IndexFactorization)] * num_parent_splits_ + split_id_;
+      GlobalIFID(mapping_id[int(mapspace::Dimension::IndexFactorization)]);
     // uint128_t mapping_index_factorization_id =
     //   size_[int(mapspace::Dimension::IndexFactorization)] * split_id +
     //   mapping_id[int(mapspace::Dimension::IndexFactorization)];
@@ -563,14 +781,58 @@ class Uber : public MapSpace
     uint128_t mapping_spatial_id = mapping_id[int(mapspace::Dimension::Spatial)];
     uint128_t mapping_datatype_bypass_id = mapping_id[int(mapspace::Dimension::DatatypeBypass)];
 
-    // === Stage 0 ===
-    InitSubnests(subnests);
-
-    // === Stage 1 ===
-    PermuteSubnests(mapping_permutation_id, subnests);
+    // Fast reject: the product of all factors at a spatial level equals the
+    // total spatial expansion there for every split and permutation, so if
+    // it exceeds the hardware fanout, no point in this factorization class
+    // can be constructed. Skip the subnest machinery entirely.
+    auto& fanout_feasibility = CheckFanoutFeasibility(mapping_index_factorization_id);
+    if (!fanout_feasibility.feasible)
+    {
+      std::vector<Status> status(arch_props_->Specs().topology.NumLevels(),
+                                 { .success = true, .fail_reason = "" });
+      unsigned storage_level = arch_props_->TilingToStorage(fanout_feasibility.fail_tiling_level);
+      unsigned topology_level = arch_props_->Specs().topology.StorageMap(storage_level);
+      std::ostringstream fail_reason;
+      fail_reason << "mapped fanout " << fanout_feasibility.fail_product
+                  << " exceeds hardware fanout "
+                  << arch_props_->Fanout(storage_level);
+      status.at(topology_level) = { false, fail_reason.str() };
+      return status;
+    }
 
-    // === Stage 2 ===
-    AssignIndexFactors(mapping_index_factorization_id, subnests);
+    // === Stages 0-2 ===
+    // Reuse the cached decode for any prefix of stages whose sub-IDs are
+    // unchanged since the last call.
+    if (decode_cache_.valid &&
+        decode_cache_.permutation_id == mapping_permutation_id &&
+        decode_cache_.index_factorization_id == mapping_index_factorization_id)
+    {
+      subnests = decode_cache_.factored_subnests;
+    }
+    else if (decode_cache_.valid &&
+             decode_cache_.permutation_id == mapping_permutation_id)
+    {
+      subnests = decode_cache_.permuted_subnests;
+      AssignIndexFactors(mapping_index_factorization_id, subnests);
+      decode_cache_.index_factorization_id = mapping_index_factorization_id;
+      decode_cache_.factored_subnests = subnests;
+    }
+    else
+    {
+      // === Stage 0 ===
+      InitSubnests(subnests);
+
+      // === Stage 1 ===
+      PermuteSubnests(mapping_permutation_id, subnests);
+      decode_cache_.permuted_subnests = subnests;
+
+      // === Stage 2 ===
+      AssignIndexFactors(mapping_index_factorization_id, subnests);
+      decode_cache_.permutation_id = mapping_permutation_id;
+      decode_cache_.index_factorization_id = mapping_index_factorization_id;
+      decode_cache_.factored_subnests = subnests;
+      decode_cache_.valid = true;
+    }
 
     // === Stage 4 ===
     mapping->datatype_bypass_nest = ConstructDatatypeBypassNest(mapping_datatype_bypass_id);
@@ -595,9 +857,14 @@ class Uber : public MapSpace
       return status;
     }
 
-    // Concatenate the subnests to form the final mapping nest.    
+    // Concatenate the subnests to form the final mapping nest. Reserve the
+    // flat descriptor array up front (each level contributes at most one
+    // loop per problem dimension) so the appends below never reallocate.
+    mapping->loop_nest.Reserve(
+      arch_props_->TilingLevels() * problem::GetShape()->NumDimensions,
+      arch_props_->TilingLevels());
     std::uint64_t storage_level = 0;
-    for (uint64_t i = 0; i < arch_props_.TilingLevels(); i++)
+    for (uint64_t i = 0; i < arch_props_->TilingLevels(); i++)
     {
       uint64_t num_subnests_added = 0;
       for (int dim = 0; dim < int(problem::GetShape()->NumDimensions); dim++)
@@ -610,7 +877,7 @@ class Uber : public MapSpace
           num_subnests_added++;
         }
       }
-      if (!arch_props_.IsSpatial(i))
+      if (!arch_props_->IsSpatial(i))
       {
         if (num_subnests_added == 0)
         {
@@ -639,9 +906,9 @@ class Uber : public MapSpace
     // Construct num_storage_levels loop-nest partitions and assign dimensions.
     // This is the only stage at which the invariant subnests[][dim].dimension == dim
     // will hold. The subnests will later get permuted, breaking the invariant.
-    for (uint64_t level = 0; level < arch_props_.TilingLevels(); level++)
+    for (uint64_t level = 0; level < arch_props_->TilingLevels(); level++)
     {
-      auto spacetime_dim = arch_props_.IsSpatial(level)
+      auto spacetime_dim = arch_props_->IsSpatial(level)
         ? spacetime::Dimension::SpaceX // Placeholder.
         : spacetime::Dimension::Time;
         
@@ -666,13 +933,13 @@ class Uber : public MapSpace
   //
   void PermuteSubnests(uint128_t mapping_permutation_id, loop::NestConfig& subnests)
   {
-    loop::NestConfig reordered(arch_props_.TilingLevels());
+    loop::NestConfig reordered(arch_props_->TilingLevels());
     
     // Obtain a pattern of loop variables for all levels.
     auto dimensions = permutation_space_.GetPatterns(mapping_permutation_id);
     assert(dimensions.size() == subnests.size());
 
-    for (uint64_t level = 0; level < arch_props_.TilingLevels(); level++)
+    for (uint64_t level = 0; level < arch_props_->TilingLevels(); level++)
     {
       // Re-order the subnest based on the pattern. 
       assert(dimensions[level].size() == subnests[level].size());
@@ -693,7 +960,7 @@ class Uber : public MapSpace
   //
   void AssignIndexFactors(uint128_t mapping_index_factorization_id, loop::NestConfig& subnests)
   {
-    for (uint64_t level = 0; level < arch_props_.TilingLevels(); level++)
+    for (uint64_t level = 0; level < arch_props_->TilingLevels(); level++)
     {
       for (auto& loop : subnests[level])
       {
@@ -716,7 +983,7 @@ class Uber : public MapSpace
   {
     (void) datatype_bypass_nest;
 
-    std::vector<Status> status(arch_props_.Specs().topology.NumLevels(),
+    std::vector<Status> status(arch_props_->Specs().topology.NumLevels(),
                                { .success = true, .fail_reason = "" });
     bool success = true;
 
@@ -725,9 +992,9 @@ class Uber : public MapSpace
     
     double cumulative_fanout_utilization = 1.0;
 
-    for (uint64_t level = 0; level < arch_props_.TilingLevels(); level++)
+    for (uint64_t level = 0; level < arch_props_->TilingLevels(); level++)
     {
-      if (!arch_props_.IsSpatial(level))
+      if (!arch_props_->IsSpatial(level))
       {
         continue;
       }
@@ -742,8 +1009,8 @@ class Uber : public MapSpace
         level,
         cumulative_fanout_utilization);
 
-      unsigned storage_level = arch_props_.TilingToStorage(level);
-      unsigned topology_level = arch_props_.Specs().topology.StorageMap(storage_level);
+      unsigned storage_level = arch_props_->TilingToStorage(level);
+      unsigned topology_level = arch_props_->Specs().topology.StorageMap(storage_level);
 
       // Merge with existing failures at this level.
       if (status.at(topology_level).success)
@@ -765,7 +1032,7 @@ class Uber : public MapSpace
                   << "constrained min-parallelism " << constraints_.MinParallelism();
 
       // Report this as an arithmetic-level failure.
-      unsigned topology_level = arch_props_.Specs().topology.ArithmeticMap();
+      unsigned topology_level = arch_props_->Specs().topology.ArithmeticMap();
 
       // Merge with existing failures at this level.
       if (status.at(topology_level).success)
@@ -789,7 +1056,7 @@ class Uber : public MapSpace
     bool success = true;
     std::ostringstream fail_reason;
 
-    unsigned storage_level_id = arch_props_.TilingToStorage(tiling_level_id);
+    unsigned storage_level_id = arch_props_->TilingToStorage(tiling_level_id);
     auto level_specs = arch_specs_.topology.GetStorageLevel(storage_level_id);
 
     std::size_t x_expansion = 1;
@@ -822,21 +1089,21 @@ class Uber : public MapSpace
     
     // if (level_specs->SharingType() == model::DataSpaceIDSharing::Shared)
     // {
-    if (x_expansion > arch_props_.FanoutX(storage_level_id))
+    if (x_expansion > arch_props_->FanoutX(storage_level_id))
     {
       success = false;
       fail_reason << "mapped fanoutX " << x_expansion << " exceeds hardware fanoutX "
-                  << arch_props_.FanoutX(storage_level_id);
+                  << arch_props_->FanoutX(storage_level_id);
     }
       
-    if (y_expansion > arch_props_.FanoutY(storage_level_id))
+    if (y_expansion > arch_props_->FanoutY(storage_level_id))
     {
       success = false;
       fail_reason << "mapped fanoutY " << y_expansion << " exceeds hardware fanoutY "
-                  << arch_props_.FanoutY(storage_level_id);
+                  << arch_props_->FanoutY(storage_level_id);
     }
 
-    fanout_max = arch_props_.Fanout(storage_level_id);
+    fanout_max = arch_props_->Fanout(storage_level_id);
 
     // Compute fanout utilization at this level.
     // Ignore bypass and partitioning. The only purpose of this is to accumulate
@@ -861,6 +1128,159 @@ class Uber : public MapSpace
     return datatype_bypass_nest_space_.at(int(mapping_datatype_bypass_id));
   }
 
+  //------------------------------------------//
+  //           Mapping Translation            //
+  //------------------------------------------//
+
+  //
+  // TranslateMapping()
+  //   Best-effort inverse of ConstructMapping(): recover the mapping ID
+  //   that constructs (a mapping equivalent to) the given fully-specified
+  //   mapping. Used to warm-start a search from a previously-found best
+  //   mapping. Returns false if the mapping lies outside this (split of
+  //   the) mapspace, e.g., its factorization or bypass scheme was pruned
+  //   away by constraints, or its factorization belongs to another split.
+  //   Levels with canonical (don't-care) permutations translate to the
+  //   canonical pattern, so the round-tripped mapping may order loops at
+  //   those levels differently; loop bounds, spatial splits and bypasses
+  //   are exact.
+  //
+  //   Side effect: on success the permutation/spatial subspaces are left
+  //   InitPruned() at the translated factorization, which is exactly the
+  //   state a search seeded with the returned ID expects.
+  //
+  bool TranslateMapping(const Mapping& mapping, mapspace::ID& mapping_id)
+  {
+    assert(!IsSplit());
+
+    // Bucket the mapping's loops into tiling levels, recording the factor
+    // of each (dimension, level) pair, the order in which non-degenerate
+    // dimensions appear at each level, and the X-axis loop counts at
+    // spatial levels. Degenerate loops are dropped during construction, so
+    // ignore them here too.
+    problem::PerProblemDimension<std::vector<unsigned long>> factors;
+    for (unsigned idim = 0; idim < unsigned(problem::GetShape()->NumDimensions); idim++)
+    {
+      factors[idim].assign(arch_props_->TilingLevels(), 1);
+    }
+
+    std::vector<std::vector<problem::Shape::DimensionID>> level_orders(arch_props_->TilingLevels());
+    std::map<unsigned, std::uint32_t> x_counts;
+
+    unsigned storage_level = 0;
+    for (unsigned i = 0; i < mapping.loop_nest.loops.size(); i++)
+    {
+      auto& loop = mapping.loop_nest.loops.at(i);
+
+      // The tiling-level lookups fail if the mapping was generated against
+      // an architecture whose spatial structure differs from ours (e.g., a
+      // spatial loop at a level with no fanout).
+      unsigned tiling_level;
+      try
+      {
+        tiling_level = loop::IsSpatial(loop.spacetime_dimension)
+          ? arch_props_->SpatialToTiling(storage_level)
+          : arch_props_->TemporalToTiling(storage_level);
+      }
+      catch (const std::out_of_range& oor)
+      {
+        return false;
+      }
+
+      if (loop.start + loop.stride < loop.end)
+      {
+        factors[unsigned(loop.dimension)].at(tiling_level) =
+          static_cast<unsigned long>(loop.end);
+        level_orders.at(tiling_level).push_back(loop.dimension);
+        if (loop.spacetime_dimension == spacetime::Dimension::SpaceX)
+        {
+          x_counts[tiling_level]++;
+        }
+      }
+
+      if (storage_level < mapping.loop_nest.storage_tiling_boundaries.size() &&
+          mapping.loop_nest.storage_tiling_boundaries.at(storage_level) == i)
+      {
+        storage_level++;
+      }
+    }
+
+    // Stage-2 inverse: find the global index factorization ID.
+    uint128_t global_if_id;
+    if (!index_factorization_space_.TranslateFactors(factors, global_if_id))
+    {
+      return false;
+    }
+
+    // Map the global ID onto this split: invert GlobalIFID().
+    uint128_t local_if_id = global_if_id;
+    if (num_parent_splits_ >= 2)
+    {
+      local_if_id = global_if_id / num_parent_splits_;
+      std::uint64_t residue = std::uint64_t(global_if_id % num_parent_splits_);
+      std::uint64_t rotation = std::uint64_t((local_if_id + split_id_) % num_parent_splits_);
+      if (residue != rotation)
+      {
+        // Owned by another split.
+        return false;
+      }
+    }
+    if (local_if_id >= size_[int(mapspace::Dimension::IndexFactorization)])
+    {
+      return false;
+    }
+
+    // Stage-4 inverse: locate the bypass nest in the enumerated space.
+    // Done before re-pruning so that an untranslatable bypass scheme does
+    // not leave the subspaces pruned at a factorization no search visited.
+    uint128_t datatype_bypass_id = size_[int(mapspace::Dimension::DatatypeBypass)];
+    for (std::size_t i = 0; i < datatype_bypass_nest_space_.size(); i++)
+    {
+      bool match = true;
+      for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
+      {
+        if (datatype_bypass_nest_space_.at(i).at(pvi) != mapping.datatype_bypass_nest.at(pvi))
+        {
+          match = false;
+          break;
+        }
+      }
+      if (match)
+      {
+        datatype_bypass_id = i;
+        break;
+      }
+    }
+    if (datatype_bypass_id == size_[int(mapspace::Dimension::DatatypeBypass)])
+    {
+      return false;
+    }
+
+    // Prune the permutation/spatial subspaces exactly as a search visiting
+    // this factorization would; the stage-1/3 sub-IDs are only meaningful
+    // in that pruned frame.
+    InitPruned(local_if_id);
+
+    uint128_t permutation_id;
+    if (!permutation_space_.TranslatePatterns(level_orders, permutation_id))
+    {
+      return false;
+    }
+
+    uint128_t spatial_id;
+    if (!spatial_split_space_.TranslateSplits(x_counts, spatial_id))
+    {
+      return false;
+    }
+
+    mapping_id = mapspace::ID(AllSizes());
+    mapping_id.Set(int(mapspace::Dimension::IndexFactorization), local_if_id);
+    mapping_id.Set(int(mapspace::Dimension::LoopPermutation), permutation_id);
+    mapping_id.Set(int(mapspace::Dimension::Spatial), spatial_id);
+    mapping_id.Set(int(mapspace::Dimension::DatatypeBypass), datatype_bypass_id);
+    return true;
+  }
+
   //------------------------------------------//
   //                 Parsing                  // 
   //------------------------------------------//
@@ -202,10 +202,12 @@ class ArithmeticUnits : public Level
       maccs_ = utilized_instances_ * compute_cycles;
       energy_ = maccs_ * specs_.energy_per_op.Get();
 
-      // Scale energy for sparsity.
-      for (unsigned d = 0; d < problem::GetShape()->NumDataSpaces; d++)
+      // Scale energy for sparsity. Hoist the shape-registry lookup out of
+      // the loop; the shape is fixed for the lifetime of the workload.
+      auto shape = problem::GetShape();
+      for (unsigned d = 0; d < shape->NumDataSpaces; d++)
       {
-        if (!problem::GetShape()->IsReadWriteDataSpace.at(d))
+        if (!shape->IsReadWriteDataSpace.at(d))
           //energy_ *= workload.GetDensity(d);
           energy_ *= body_info.data_densities[d];
       }
@@ -71,23 +71,23 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
 
   // Name. This has to go first. Since the rest can be attributes
   std::string name;
-  if (buffer.lookupValue("name", name))
+  if (buffer.lookupValue(config::Key::Name, name))
   {
     specs.name = config::parseName(name);
   }
 
   std::string className = "";
-  if (buffer.exists("attributes"))
+  if (buffer.exists(config::Key::Attributes))
   {
-    buffer.lookupValue("class", className);
-    buffer = buffer.lookup("attributes");
+    buffer.lookupValue(config::Key::Class, className);
+    buffer = buffer.lookup(config::Key::Attributes);
   }
 
   // Word Bits.
   std::uint32_t word_bits;
-  if (buffer.lookupValue("word-bits", word_bits) ||
-      buffer.lookupValue("word_width", word_bits) ||
-      buffer.lookupValue("datawidth", word_bits) )
+  if (buffer.lookupValue(config::Key::WordBits, word_bits) ||
+      buffer.lookupValue(config::Key::WordWidth, word_bits) ||
+      buffer.lookupValue(config::Key::Datawidth, word_bits) )
   {
     specs.word_bits = word_bits;
   }
@@ -99,8 +99,8 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
   // Block size.
   std::uint32_t block_size;
   specs.block_size = 1;
-  if (buffer.lookupValue("block-size", block_size) ||
-      buffer.lookupValue("n_words", block_size) )
+  if (buffer.lookupValue(config::Key::BlockSize, block_size) ||
+      buffer.lookupValue(config::Key::NWords, block_size) )
   {
     specs.block_size = block_size;
   }
@@ -109,11 +109,11 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
   std::uint32_t cluster_size;
   specs.cluster_size = 1;
   std::uint32_t width;
-  if (buffer.lookupValue("cluster-size", cluster_size))
+  if (buffer.lookupValue(config::Key::ClusterSize, cluster_size))
   {
     specs.cluster_size = cluster_size;
   }
-  else if (buffer.lookupValue("width", width))
+  else if (buffer.lookupValue(config::Key::Width, width))
   {
     word_bits = specs.word_bits.Get();
     block_size = specs.block_size.Get();
@@ -124,19 +124,19 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
   // Size.
   // It has dependency on BlockSize and thus is initialized after BlockSize.
   std::uint32_t size;
-  if (buffer.lookupValue("entries", size) )
+  if (buffer.lookupValue(config::Key::Entries, size) )
   {
-    assert(buffer.exists("sizeKB") == false);
+    assert(buffer.exists(config::Key::SizeKB) == false);
     specs.size = size;
   }
-  else if (buffer.lookupValue("depth", size) ||
-           buffer.lookupValue("memory_depth", size))
+  else if (buffer.lookupValue(config::Key::Depth, size) ||
+           buffer.lookupValue(config::Key::MemoryDepth, size))
   {
-    assert(buffer.exists("sizeKB") == false);
-    assert(buffer.exists("entries") == false);
+    assert(buffer.exists(config::Key::SizeKB) == false);
+    assert(buffer.exists(config::Key::Entries) == false);
     specs.size = size * specs.block_size.Get();
   }
-  else if (buffer.lookupValue("sizeKB", size))
+  else if (buffer.lookupValue(config::Key::SizeKB, size))
   {
     specs.size = size * 1024 * 8 / specs.word_bits.Get();
   }
@@ -150,7 +150,7 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
   specs.technology = Technology::SRAM;
   if (className == "DRAM") specs.technology = Technology::DRAM;
 
-  if (buffer.lookupValue("technology", technology) && technology == "DRAM")
+  if (buffer.lookupValue(config::Key::Technology, technology) && technology == "DRAM")
   {
     specs.technology = Technology::DRAM;
   }
@@ -158,7 +158,7 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
   // SRAM Type.
   std::uint32_t num_ports = 2;
   specs.num_ports = num_ports;
-  if (buffer.lookupValue("num-ports", num_ports))
+  if (buffer.lookupValue(config::Key::NumPorts, num_ports))
   {
     if (num_ports == 1)
     {
@@ -173,14 +173,14 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
   // Number of Banks.
   std::uint32_t num_banks = 2;
   specs.num_banks = num_banks;
-  if (buffer.lookupValue("num-banks", num_banks))
+  if (buffer.lookupValue(config::Key::NumBanks, num_banks))
   {
     specs.num_banks = num_banks;
   }
 
   // Bandwidth.
   double bandwidth;
-  if (buffer.lookupValue("bandwidth", bandwidth))
+  if (buffer.lookupValue(config::Key::Bandwidth, bandwidth))
   {
     std::cerr << "WARNING: bandwidth is deprecated. Assuming read_bandwidth = write_bandwidth = bandwidth/2" << std::endl;
     specs.read_bandwidth  = bandwidth / 2;
@@ -188,20 +188,20 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
   }
 
   double read_bandwidth;
-  if (buffer.lookupValue("read_bandwidth", read_bandwidth))
+  if (buffer.lookupValue(config::Key::ReadBandwidth, read_bandwidth))
   {
     specs.read_bandwidth = read_bandwidth;
   }
 
   double write_bandwidth;
-  if (buffer.lookupValue("write_bandwidth", write_bandwidth))
+  if (buffer.lookupValue(config::Key::WriteBandwidth, write_bandwidth))
   {
     specs.write_bandwidth = write_bandwidth;
   }
 
   // Multiple-buffering factor (e.g., 2.0 means double buffering)
   double multiple_buffering;
-  if (buffer.lookupValue("multiple-buffering", multiple_buffering))
+  if (buffer.lookupValue(config::Key::MultipleBuffering, multiple_buffering))
   {
     specs.multiple_buffering = multiple_buffering;
   }
@@ -218,7 +218,7 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
 
   // Minimum utilization factor (e.g., 1.0 requires full utilization of effective capacity)
   double min_utilizaiton;
-  if (buffer.lookupValue("min-utilization", min_utilizaiton))
+  if (buffer.lookupValue(config::Key::MinUtilization, min_utilizaiton))
   {
     specs.min_utilization = min_utilizaiton;
   }
@@ -233,7 +233,7 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
 
   // Instances.
   std::uint32_t instances;
-  if (buffer.lookupValue("instances", instances))
+  if (buffer.lookupValue(config::Key::Instances, instances))
   {
     specs.instances = instances;
   } else {
@@ -242,39 +242,39 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
 
   // MeshX.
   std::uint32_t meshX;
-  if (buffer.lookupValue("meshX", meshX))
+  if (buffer.lookupValue(config::Key::MeshX, meshX))
   {
     specs.meshX = meshX;
   }
 
   // MeshY.
   std::uint32_t meshY;
-  if (buffer.lookupValue("meshY", meshY))
+  if (buffer.lookupValue(config::Key::MeshY, meshY))
   {
     specs.meshY = meshY;
   }
 
   // Network names;
   std::string read_network_name;
-  if (buffer.lookupValue("network_read", read_network_name))
+  if (buffer.lookupValue(config::Key::NetworkRead, read_network_name))
   {
     specs.read_network_name = read_network_name;
   }
 
   std::string fill_network_name;
-  if (buffer.lookupValue("network_fill", fill_network_name))
+  if (buffer.lookupValue(config::Key::NetworkFill, fill_network_name))
   {
     specs.fill_network_name = fill_network_name;
   }
 
   std::string drain_network_name;
-  if (buffer.lookupValue("network_drain", drain_network_name))
+  if (buffer.lookupValue(config::Key::NetworkDrain, drain_network_name))
   {
     specs.drain_network_name = drain_network_name;
   }
 
   std::string update_network_name;
-  if (buffer.lookupValue("network_update", update_network_name))
+  if (buffer.lookupValue(config::Key::NetworkUpdate, update_network_name))
   {
     specs.update_network_name = update_network_name;
   }
@@ -319,16 +319,16 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
   }
 
   // Allow user to override the access energy.
-  buffer.lookupValue("vector-access-energy", tmp_access_energy);
+  buffer.lookupValue(config::Key::VectorAccessEnergy, tmp_access_energy);
 
   // Allow user to override the addr gen energy.
   double tmp_addr_gen_energy = -0.1;
-  buffer.lookupValue("addr-gen-energy", tmp_addr_gen_energy);
+  buffer.lookupValue(config::Key::AddrGenEnergy, tmp_addr_gen_energy);
   specs.addr_gen_energy = tmp_addr_gen_energy;
 
   // Allow user to override the cluster area.
   double tmp_cluster_area = 0;
-  buffer.lookupValue("cluster-area", tmp_cluster_area);
+  buffer.lookupValue(config::Key::ClusterArea, tmp_cluster_area);
   if (tmp_cluster_area > 0)
     tmp_storage_area = tmp_cluster_area / specs.cluster_size.Get();
 
@@ -478,7 +478,56 @@ EvalStatus BufferLevel::PreEvaluationCheck(
   eval_status.success = success;
   eval_status.fail_reason = fail_reason.str();
 
-  return eval_status;  
+  return eval_status;
+}
+
+// QuickCapacityCheck(): an even cheaper screen than PreEvaluationCheck().
+// The caller supplies *lower bounds* on the working-set sizes (derived
+// arithmetically from the index factorization, without running any
+// analysis), so the only sound test is capacity-exceeded: if even the
+// lower bound doesn't fit, no evaluation of this mapping can. The
+// min-utilization check is deliberately absent here - a lower bound can't
+// prove under-utilization - and is left to PreEvaluationCheck().
+EvalStatus BufferLevel::QuickCapacityCheck(
+  const problem::PerDataSpace<std::size_t> min_working_set_sizes,
+  const tiling::CompoundMask mask)
+{
+  bool success = true;
+  std::ostringstream fail_reason;
+
+  if (specs_.size.IsSpecified())
+  {
+    // Same loose filter as PreEvaluationCheck(): a distributed multicast
+    // may shrink the required size, so give the mapping the benefit of the
+    // doubt.
+    auto available_capacity = specs_.effective_size.Get();
+    if (network_read_->DistributedMulticastSupported())
+    {
+      available_capacity *= specs_.instances.Get();
+    }
+
+    std::size_t required_capacity = 0;
+    for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
+    {
+      if (mask[pvi])
+      {
+        required_capacity += min_working_set_sizes.at(problem::Shape::DataSpaceID(pvi));
+      }
+    }
+
+    if (required_capacity > available_capacity)
+    {
+      success = false;
+      fail_reason << "minimum tile size " << required_capacity << " exceeds buffer capacity "
+                  << available_capacity;
+    }
+  }
+
+  EvalStatus eval_status;
+  eval_status.success = success;
+  eval_status.fail_reason = fail_reason.str();
+
+  return eval_status;
 }
 
 //
@@ -489,6 +538,11 @@ EvalStatus BufferLevel::Evaluate(const tiling::CompoundTile& tile, const tiling:
                                  const std::uint64_t compute_cycles,
                                  const bool break_on_failure)
 {
+  if (!energy_coeffs_.valid)
+  {
+    PrecomputeEnergyCoeffs();
+  }
+
   auto eval_status = ComputeAccesses(tile, mask, break_on_failure);
   if (!break_on_failure || eval_status.success)
   {
@@ -676,6 +730,28 @@ EvalStatus BufferLevel::ComputeAccesses(const tiling::CompoundTile& tile,
   return eval_status;
 }
 
+// Precompute per-access energy coefficients. These depend only on the
+// static spec and the word widths of the connected networks, so they are
+// derived once (on the first evaluation, after network binding) and reused
+// for every subsequent mapping; the pat technology tables are never
+// consulted on the per-mapping path.
+void BufferLevel::PrecomputeEnergyCoeffs()
+{
+  energy_coeffs_.vector_access = specs_.vector_access_energy.Get();
+
+  energy_coeffs_.temporal_reduction =
+    (network_update_ != nullptr) ?
+    pat::AdderEnergy(specs_.word_bits.Get(), network_update_->WordBits()) :
+    0.0;
+
+  energy_coeffs_.addr_gen =
+    (specs_.addr_gen_energy.Get() < 0.0) ?
+    pat::AdderEnergy(specs_.addr_gen_bits.Get(), specs_.addr_gen_bits.Get()) :
+    specs_.addr_gen_energy.Get();
+
+  energy_coeffs_.valid = true;
+}
+
 // Compute buffer energy.
 void BufferLevel::ComputeBufferEnergy()
 {
@@ -692,7 +768,7 @@ void BufferLevel::ComputeBufferEnergy()
       (instance_accesses / block_size) + 1;
     
     double cluster_access_energy = vector_accesses *
-      specs_.vector_access_energy.Get();
+      energy_coeffs_.vector_access;
 
     // Spread out the cost between the utilized instances in each cluster.
     // This is because all the later stat-processing is per-instance.
@@ -722,8 +798,8 @@ void BufferLevel::ComputeReductionEnergy()
     auto pv = problem::Shape::DataSpaceID(pvi);
     if (problem::GetShape()->IsReadWriteDataSpace.at(pv))
     {
-      stats_.temporal_reduction_energy[pv] = stats_.temporal_reductions[pv] * 
-        pat::AdderEnergy(specs_.word_bits.Get(), network_update_->WordBits());
+      stats_.temporal_reduction_energy[pv] = stats_.temporal_reductions[pv] *
+        energy_coeffs_.temporal_reduction;
     }
     else
     {
@@ -746,14 +822,8 @@ void BufferLevel::ComputeAddrGenEnergy()
     // it's probably cheaper than that. However, we can't assume
     // a 1-bit increment.
     auto pv = problem::Shape::DataSpaceID(pvi);
-    if (specs_.addr_gen_energy.Get() < 0.0) { 
-      stats_.addr_gen_energy[pv] = stats_.address_generations[pv] *
-        pat::AdderEnergy(specs_.addr_gen_bits.Get(), specs_.addr_gen_bits.Get());
-    }
-    else
-    {
-       stats_.addr_gen_energy[pv] = stats_.address_generations[pv] * specs_.addr_gen_energy.Get();
-    }
+    stats_.addr_gen_energy[pv] = stats_.address_generations[pv] *
+      energy_coeffs_.addr_gen;
   }
 }
 
@@ -207,6 +207,20 @@ class BufferLevel : public Level
   std::shared_ptr<Network> network_update_;
   std::shared_ptr<Network> network_drain_;
 
+  // Per-access energy coefficients, precomputed on first evaluation (they
+  // depend only on the static spec and the word widths of the connected
+  // networks) so the per-mapping energy computation reduces to
+  // multiply-accumulates over access counts, with no technology-model
+  // table walks on the hot path.
+  struct EnergyCoeffs
+  {
+    double vector_access = 0.0;
+    double temporal_reduction = 0.0;
+    double addr_gen = 0.0;
+    bool valid = false;
+  };
+  EnergyCoeffs energy_coeffs_;
+
   // Serialization
   friend class boost::serialization::access;
   template <class Archive>
@@ -229,6 +243,7 @@ class BufferLevel : public Level
   EvalStatus ComputeAccesses(const tiling::CompoundTile& tile, const tiling::CompoundMask& mask,
                              const bool break_on_failure);
   void ComputePerformance(const std::uint64_t compute_cycles);
+  void PrecomputeEnergyCoeffs();
   void ComputeBufferEnergy();
   void ComputeReductionEnergy();
   void ComputeAddrGenEnergy();
@@ -275,6 +290,8 @@ class BufferLevel : public Level
   EvalStatus PreEvaluationCheck(const problem::PerDataSpace<std::size_t> working_set_sizes,
                                 const tiling::CompoundMask mask,
                                 const bool break_on_failure) override;
+  EvalStatus QuickCapacityCheck(const problem::PerDataSpace<std::size_t> min_working_set_sizes,
+                                const tiling::CompoundMask mask);
   EvalStatus Evaluate(const tiling::CompoundTile& tile, const tiling::CompoundMask& mask,
                       const std::uint64_t compute_cycles,
                       const bool break_on_failure) override;
@@ -110,11 +110,35 @@ class Engine : public Module
     return topology_.PreEvaluationCheck(mapping, &nest_analysis_, break_on_failure);
   }
 
-  std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, bool break_on_failure = true)
+  // An even cheaper screen than PreEvaluationCheck(): rejects mappings
+  // whose buffer capacity requirements are doomed based on lower bounds
+  // derived directly from the index factorization, without initializing
+  // the nest analysis.
+  std::vector<EvalStatus> QuickCapacityCheck(const Mapping& mapping, problem::Workload& workload, bool break_on_failure = true)
   {
+    auto min_sizes = analysis::NestAnalysis::MinWorkingSetSizes_LTW(mapping.loop_nest, &workload);
+    return topology_.QuickCapacityCheck(mapping, min_sizes, break_on_failure);
+  }
+
+  // When approx is set, the nest analysis runs in its cheap sampled mode
+  // (see NestAnalysis::SetApproxMode()): accurate to within a few percent
+  // for typical mappings, and much faster for large spatial fanouts. Used
+  // by multi-fidelity search drivers to screen candidates before exact
+  // re-evaluation; approximate stats should never be reported as final.
+  // bounds_only additionally switches the nest analysis to its coarsest
+  // point-set backend (see NestAnalysis::SetBoundsOnlyMode()), which
+  // tracks only per-dimension extents. Both knobs are per-engine, so a
+  // screening engine and an exact engine can coexist in one process.
+  std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, bool break_on_failure = true,
+                                   const Topology::EvalCutoff& cutoff = Topology::EvalCutoff(),
+                                   bool approx = false, bool bounds_only = false)
+  {
+    nest_analysis_.SetApproxMode(approx);
+    nest_analysis_.SetBoundsOnlyMode(bounds_only);
+    nest_analysis_.SetLinkTransferLevels(topology_.LinkTransferLevels());
     nest_analysis_.Init(&workload, &mapping.loop_nest);
-    
-    auto eval_status = topology_.Evaluate(mapping, &nest_analysis_, break_on_failure);
+
+    auto eval_status = topology_.Evaluate(mapping, &nest_analysis_, break_on_failure, cutoff);
 
     is_evaluated_ = std::accumulate(eval_status.begin(), eval_status.end(), true,
                                     [](bool cur, const EvalStatus& status)
@@ -123,6 +147,59 @@ class Engine : public Module
     return eval_status;
   }
   
+  // Result of one evaluation within a batch (see EvaluateBatch()).
+  struct BatchResult
+  {
+    std::vector<EvalStatus> eval_status;
+    bool valid = false;
+    Topology::Stats stats;
+  };
+
+  // Evaluate a block of mappings (all against the topology specs bound by
+  // the earlier Spec() call) back-to-back on this engine. Spec binding
+  // happens once, and the nest analysis and topology state are reused
+  // across the evaluations, so per-mapping setup is amortized and the
+  // evaluation loop stays hot in the instruction and data caches. Each
+  // mapping goes through the cheap pre-evaluation check first; mappings
+  // that fail it are returned as invalid without running the full
+  // evaluation.
+  std::vector<BatchResult> EvaluateBatch(std::vector<Mapping>& mappings,
+                                         problem::Workload& workload,
+                                         bool break_on_failure = true)
+  {
+    assert(is_specced_);
+
+    std::vector<BatchResult> results;
+    results.reserve(mappings.size());
+
+    for (auto& mapping: mappings)
+    {
+      BatchResult result;
+
+      auto pre_status = PreEvaluationCheck(mapping, workload, break_on_failure);
+      bool pre_success = std::accumulate(pre_status.begin(), pre_status.end(), true,
+                                         [](bool cur, const EvalStatus& status)
+                                         { return cur && status.success; });
+      if (!pre_success)
+      {
+        result.eval_status = pre_status;
+        results.push_back(std::move(result));
+        continue;
+      }
+
+      result.eval_status = Evaluate(mapping, workload, break_on_failure);
+      result.valid = is_evaluated_;
+      if (result.valid)
+      {
+        result.stats = topology_.GetStats();
+      }
+
+      results.push_back(std::move(result));
+    }
+
+    return results;
+  }
+
   double Energy() const
   {
     return topology_.Energy();
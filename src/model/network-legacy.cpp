@@ -122,6 +122,15 @@ LegacyNetwork::Specs LegacyNetwork::ParseSpecs(config::CompoundConfigNode networ
       specs.energy_per_hop = energy_per_hop;
   }
 
+  // Link-transfer modeling (neighbor-to-neighbor forwarding between the
+  // elements this network feeds). Off unless the arch opts in; for
+  // inferred networks this attribute is read from the storage level whose
+  // reads the network carries.
+  bool link_transfers;
+  if (network.lookupValue("link-transfers", link_transfers)) {
+      specs.link_transfers = link_transfers;
+  }
+
   return specs;
 }
 
@@ -164,6 +173,11 @@ bool LegacyNetwork::DistributedMulticastSupported() const
   return retval;
 }
 
+bool LegacyNetwork::LinkTransfersEnabled() const
+{
+  return specs_.link_transfers;
+}
+
 // Floorplanner interface.
 void LegacyNetwork::SetTileWidth(double width_um)
 {
@@ -196,8 +210,26 @@ EvalStatus LegacyNetwork::ComputeAccesses(const tiling::CompoundTile& tile, cons
   for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
   {
     auto pv = problem::Shape::DataSpaceID(pvi);
-      
-    stats_.utilized_instances[pv] = tile[pvi].replication_factor;      
+
+    // Datatypes bypassed around our sink level were Reset() by MaskTiles()
+    // during tile collapsing: they have zero size and no access vectors.
+    // Nothing moves over this network for them, so zero out their stats
+    // and skip the access-count machinery below.
+    if (tile[pvi].size == 0 && tile[pvi].accesses.empty())
+    {
+      stats_.utilized_instances[pv] = 0;
+      stats_.ingresses[pv].clear();
+      stats_.spatial_reductions[pv] = 0;
+      stats_.distributed_multicast[pv] = false;
+      stats_.avg_hops[pv].clear();
+      stats_.link_transfers[pv] = 0;
+      stats_.fanout[pv] = 0;
+      stats_.distributed_fanout[pv] = 0;
+      stats_.multicast_factor[pv] = 0;
+      continue;
+    }
+
+    stats_.utilized_instances[pv] = tile[pvi].replication_factor;
 
     if (problem::GetShape()->IsReadWriteDataSpace.at(pv))
     {
@@ -336,6 +368,18 @@ void LegacyNetwork::ComputeNetworkEnergy()
   for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
   {
     auto pv = problem::Shape::DataSpaceID(pvi);
+
+    // Bypassed datatype: no traffic on this network (see ComputeAccesses()),
+    // so skip the wire/router energy model entirely.
+    if (stats_.ingresses.at(pv).empty())
+    {
+      stats_.energy_per_hop[pv] = 0;
+      stats_.num_hops[pv] = 0;
+      stats_.energy[pv] = 0;
+      stats_.link_transfer_energy[pv] = 0;
+      continue;
+    }
+
     // WireEnergyPerHop checks if wire energy is 0.0 before using default pat
     double wire_energy = specs_.wire_energy.IsSpecified() ? specs_.wire_energy.Get() : 0.0;
     double energy_per_hop =
@@ -422,6 +466,7 @@ void LegacyNetwork::ComputeSpatialReductionEnergy()
   {
     auto pv = problem::Shape::DataSpaceID(pvi);
     if (problem::GetShape()->IsReadWriteDataSpace.at(pv)
+            && !stats_.ingresses.at(pv).empty() // bypassed datatypes have no traffic
             && (specs_.cType & ConnectionType::UpdateDrain)) // also used for UpdateDrain connections
     {
       stats_.spatial_reduction_energy[pv] = stats_.spatial_reductions[pv] * 
@@ -185,6 +185,8 @@ class LegacyNetwork : public Network
 
   bool DistributedMulticastSupported() const;
 
+  bool LinkTransfersEnabled() const override;
+
   // Floorplanner interface.
   void SetTileWidth(double width_um);
 
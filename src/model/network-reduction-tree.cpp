@@ -176,13 +176,14 @@ EvalStatus ReductionTreeNetwork::Evaluate(const tiling::CompoundTile& tile,
     }
   } 
 
-  // Calculate energy
+  // Calculate energy. The per-hop energy is a function of the specs alone,
+  // so compute it once outside the per-datatype loop.
+  double energy_per_hop =
+    WireEnergyPerHop(specs_.word_bits.Get(), specs_.tile_width.Get(), specs_.wire_energy.Get());
   for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
   {
     auto pv = problem::Shape::DataSpaceID(pvi);
 
-    double energy_per_hop =
-      WireEnergyPerHop(specs_.word_bits.Get(), specs_.tile_width.Get(), specs_.wire_energy.Get());
     double total_wire_hops = 0;
     double total_ingresses = 0;
     for (unsigned i = 0; i < stats_.ingresses[pv].size(); i++)
@@ -193,9 +194,9 @@ EvalStatus ReductionTreeNetwork::Evaluate(const tiling::CompoundTile& tile,
       if (ingresses > 0)
       {
         if (problem::GetShape()->IsReadWriteDataSpace.at(pv)) {
-          // Modeling the reduction tree here!
-          auto reduction_factor = i + 1;
-          num_hops = std::floor(std::log2(reduction_factor)) * 0.5;
+          // Modeling the reduction tree here! The tree-structure term is
+          // cached across mappings that share a fanout signature.
+          num_hops = HopsForReductionFactor(i + 1);
         }
       }
       total_wire_hops += num_hops * ingresses;
@@ -218,6 +219,17 @@ EvalStatus ReductionTreeNetwork::Evaluate(const tiling::CompoundTile& tile,
   return eval_status;
 }
 
+// Return the (cached) tree hop count for a given reduction factor,
+// growing the cache on demand the first time a larger fanout is seen.
+double ReductionTreeNetwork::HopsForReductionFactor(std::uint64_t factor)
+{
+  while (hop_count_cache_.size() < factor)
+  {
+    hop_count_cache_.push_back(std::floor(std::log2(hop_count_cache_.size() + 1)) * 0.5);
+  }
+  return hop_count_cache_[factor - 1];
+}
+
 // FIXME: Should merge this back to the common abstract Network class
 // PAT interface.
 //
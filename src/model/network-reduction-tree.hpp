@@ -119,11 +119,20 @@ class ReductionTreeNetwork : public Network
   //
 
  private:
-  
+
   Specs specs_;
   std::weak_ptr<Level> source_;
   std::weak_ptr<Level> sink_;
 
+  // Tree-structure hop counts depend only on the slot's reduction factor
+  // (floor(log2(factor))/2), never on the tile being evaluated, and spatial
+  // fanout signatures repeat constantly across the permutation subspace.
+  // Cache the per-factor hop counts, grown on demand; Evaluate() then only
+  // does the per-access scaling. Derived state: not serialized.
+  std::vector<double> hop_count_cache_;
+
+  double HopsForReductionFactor(std::uint64_t factor);
+
  public:
   Stats stats_; // temporarily public.
 
@@ -58,6 +58,13 @@ struct NetworkSpecs
   std::string name = "UNSET";
   ConnectionType cType = Unused;
 
+  // Model inter-PE link transfers on this network (see
+  // NestAnalysis::ComputeNetworkLinkTransfers()). Per-network opt-in from
+  // the arch spec ("link-transfers" attribute) so that NoC studies can
+  // enable the analysis only on the levels that physically have neighbor
+  // links, instead of paying for it globally.
+  bool link_transfers = false;
+
   // Serialization
   friend class boost::serialization::access;
 
@@ -67,6 +74,7 @@ struct NetworkSpecs
     if (version == 0)
     {
       ar& BOOST_SERIALIZATION_NVP(name);
+      ar& BOOST_SERIALIZATION_NVP(link_transfers);
     }
   }
 }; // struct NetworkSpecs
@@ -96,6 +104,9 @@ class Network : public Module
   virtual std::string Name() const = 0;
   virtual bool DistributedMulticastSupported() const = 0;
 
+  // Whether the arch spec enabled link-transfer modeling on this network.
+  virtual bool LinkTransfersEnabled() const { return false; }
+
   // Floorplanner interface.
   virtual void SetTileWidth(double width_um) = 0;
 
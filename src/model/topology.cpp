@@ -25,12 +25,17 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <numeric>
 #include <string>
 #include <stdexcept>
 
 #include "model/topology.hpp"
 #include "model/network-legacy.hpp"
+#include "util/cycle-timer.hpp"
+#include "util/perf-counters.hpp"
 #include "model/network-factory.hpp"
 
 namespace model
@@ -466,8 +471,109 @@ std::ostream& operator << (std::ostream& out, const Topology& topology)
   return out;
 }
 
+// Emit the stats as one compact JSON object on a single line, straight
+// from the Stats structure with no intermediate human formatting. This is
+// the machine-readable counterpart of operator<< above, meant for
+// scripts that would otherwise regex-scrape the text output, and for
+// appending to JSON-lines logs at per-mapping rates.
+void Topology::PrintStatsJSON(std::ostream& out) const
+{
+  // Save ios format state.
+  std::ios state(NULL);
+  state.copyfmt(out);
+  // Full round-trip precision: this output is for machines, not eyes.
+  out << std::setprecision(17);
+
+  out << "{\"evaluated\":" << (is_evaluated_ ? "true" : "false")
+      << ",\"energy_pJ\":" << stats_.energy
+      << ",\"area_um2\":" << stats_.area
+      << ",\"cycles\":" << stats_.cycles
+      << ",\"utilization\":" << stats_.utilization
+      << ",\"maccs\":" << stats_.maccs
+      << ",\"last_level_accesses\":" << stats_.last_level_accesses;
+
+  out << ",\"levels\":[";
+  for (unsigned i = 0; i < stats_.per_level.num_levels; i++)
+  {
+    out << (i == 0 ? "" : ",")
+        << "{\"name\":\"" << GetLevel(i)->Name() << "\""
+        << ",\"energy_pJ\":" << stats_.per_level.energy.at(i)
+        << ",\"cycles\":" << stats_.per_level.cycles.at(i)
+        << ",\"accesses\":" << stats_.per_level.accesses.at(i)
+        << "}";
+  }
+  out << "]";
+
+  auto emit_per_dataspace =
+    [&out](const char* key,
+           const std::vector<problem::PerDataSpace<std::uint64_t>>& values)
+  {
+    out << ",\"" << key << "\":[";
+    for (unsigned i = 0; i < values.size(); i++)
+    {
+      out << (i == 0 ? "" : ",") << "[";
+      for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
+      {
+        out << (pvi == 0 ? "" : ",")
+            << values.at(i).at(problem::Shape::DataSpaceID(pvi));
+      }
+      out << "]";
+    }
+    out << "]";
+  };
+
+  // Per-storage-level, per-data-space tile sizes and utilized instances,
+  // in storage-level-id order (data-space order matches the shape's IDs).
+  emit_per_dataspace("tile_sizes", stats_.tile_sizes);
+  emit_per_dataspace("utilized_instances", stats_.utilized_instances);
+
+  out << "}" << std::endl;
+
+  // Restore ios format state.
+  out.copyfmt(state);
+}
+
+// Returns true if the given specs refer to the same underlying level and
+// network spec objects we were last specced from. Specs copies share these
+// via shared_ptr, so pointer identity is a sound (and cheap) test.
+bool Topology::SpecMatches(const Topology::Specs& specs) const
+{
+  if (specs.NumLevels() != specs_.NumLevels() ||
+      specs.NumNetworks() != specs_.NumNetworks())
+  {
+    return false;
+  }
+
+  for (unsigned i = 0; i < specs.NumLevels(); i++)
+  {
+    if (specs.GetLevel(i) != specs_.GetLevel(i))
+      return false;
+  }
+
+  for (unsigned i = 0; i < specs.NumNetworks(); i++)
+  {
+    if (specs.GetNetwork(i) != specs_.GetNetwork(i))
+      return false;
+  }
+
+  return true;
+}
+
 void Topology::Spec(const Topology::Specs& specs)
 {
+  // Rebind fast path: if we were already specced from the same spec tree,
+  // the level and network objects we constructed last time (and their
+  // connectivity) are still valid. Just clear their evaluation state and
+  // reuse them, instead of tearing down and re-allocating every
+  // shared_ptr<Level> and network each time an engine is re-specced per
+  // evaluation context.
+  if (is_specced_ && SpecMatches(specs))
+  {
+    specs_ = specs;
+    Reset();
+    return;
+  }
+
   specs_ = specs;
 
   for (auto& level : levels_)
@@ -701,6 +807,21 @@ void Topology::Spec(const Topology::Specs& specs)
 
   } // for all levels.
 
+  // Record which storage levels opted into link-transfer modeling: the
+  // transfers at storage level i ride on the network distributing that
+  // level's reads to the inner level's instances, i.e., connection i's
+  // read-fill network. The nest analysis consumes this vector before each
+  // evaluation (see Engine::Evaluate()).
+  link_transfer_levels_.assign(NumStorageLevels(), false);
+  for (auto& connection: connection_map_)
+  {
+    if (connection.first < link_transfer_levels_.size())
+    {
+      link_transfer_levels_[connection.first] =
+        connection.second.read_fill_network->LinkTransfersEnabled();
+    }
+  }
+
   // DeriveFanouts();
 
   is_specced_ = true;
@@ -906,6 +1027,48 @@ void Topology::Reset()
   is_evaluated_ = false;
 }
 
+// Dynamic scheduling of the fast rejection screens. Mappings drawn from
+// the same region of the mapspace tend to die at the same storage level,
+// so when the caller lets us break on the first failure we walk storage
+// levels in descending order of historical failure count instead of the
+// fixed topological order, aborting losers at minimum cost. The histogram
+// is re-sorted (and decayed, so the order can track the search as it
+// moves) every kCheckReorderInterval recorded failures.
+static bool gEnableDynamicCheckOrder =
+  (getenv("TIMELOOP_DISABLE_DYNAMIC_CHECK_ORDER") == NULL);
+
+static const std::uint64_t kCheckReorderInterval = 1024;
+
+const std::vector<unsigned>& Topology::CheckOrder_()
+{
+  if (check_order_.size() != NumStorageLevels())
+  {
+    check_order_.resize(NumStorageLevels());
+    std::iota(check_order_.begin(), check_order_.end(), 0);
+    check_fail_counts_.assign(NumStorageLevels(), 0);
+    check_fails_since_reorder_ = 0;
+  }
+  else if (check_fails_since_reorder_ >= kCheckReorderInterval)
+  {
+    std::stable_sort(check_order_.begin(), check_order_.end(),
+                     [this](unsigned a, unsigned b)
+                     { return check_fail_counts_.at(a) > check_fail_counts_.at(b); });
+    for (auto& count : check_fail_counts_)
+      count >>= 1;
+    check_fails_since_reorder_ = 0;
+  }
+  return check_order_;
+}
+
+void Topology::RecordCheckFailure_(unsigned storage_level_id)
+{
+  if (storage_level_id < check_fail_counts_.size())
+  {
+    check_fail_counts_.at(storage_level_id)++;
+    check_fails_since_reorder_++;
+  }
+}
+
 // PreEvaluationCheck(): allows for a very fast capacity-check
 // based on given working-set sizes that can be trivially derived
 // by the caller. The more powerful Evaluate() function also
@@ -921,18 +1084,60 @@ std::vector<EvalStatus> Topology::PreEvaluationCheck(const Mapping& mapping,
                                                      bool break_on_failure)
 {
   auto masks = tiling::TransposeMasks(mapping.datatype_bypass_nest);
-  auto working_set_sizes = analysis->GetWorkingSetSizes_LTW();
+  auto& working_set_sizes = analysis->GetWorkingSetSizes_LTW();
+
+  bool dynamic_order = break_on_failure && gEnableDynamicCheckOrder;
+  auto& check_order = CheckOrder_();
 
   std::vector<EvalStatus> eval_status(NumLevels(), { .success = true, .fail_reason = "" });
-  for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+  for (unsigned i = 0; i < NumStorageLevels(); i++)
   {
+    unsigned storage_level_id = dynamic_order ? check_order.at(i) : i;
     auto level_id = specs_.StorageMap(storage_level_id);
     auto s = GetStorageLevel(storage_level_id)->PreEvaluationCheck(
       working_set_sizes.at(storage_level_id), masks.at(storage_level_id),
       break_on_failure);
     eval_status.at(level_id) = s;
-    if (break_on_failure && !s.success)
-      break;
+    if (!s.success)
+    {
+      RecordCheckFailure_(storage_level_id);
+      if (break_on_failure)
+        break;
+    }
+  }
+
+  return eval_status;
+}
+
+// QuickCapacityCheck(): capacity screening against lower-bound working-set
+// sizes derived directly from the index factorization (see
+// NestAnalysis::MinWorkingSetSizes_LTW()). Cheaper than PreEvaluationCheck()
+// because it needs no analysis state at all; only capacity-exceeded failures
+// can be detected at this stage.
+std::vector<EvalStatus> Topology::QuickCapacityCheck(
+  const Mapping& mapping,
+  const std::vector<problem::PerDataSpace<std::size_t>>& min_working_set_sizes,
+  bool break_on_failure)
+{
+  auto masks = tiling::TransposeMasks(mapping.datatype_bypass_nest);
+
+  bool dynamic_order = break_on_failure && gEnableDynamicCheckOrder;
+  auto& check_order = CheckOrder_();
+
+  std::vector<EvalStatus> eval_status(NumLevels(), { .success = true, .fail_reason = "" });
+  for (unsigned i = 0; i < NumStorageLevels(); i++)
+  {
+    unsigned storage_level_id = dynamic_order ? check_order.at(i) : i;
+    auto level_id = specs_.StorageMap(storage_level_id);
+    auto s = GetStorageLevel(storage_level_id)->QuickCapacityCheck(
+      min_working_set_sizes.at(storage_level_id), masks.at(storage_level_id));
+    eval_status.at(level_id) = s;
+    if (!s.success)
+    {
+      RecordCheckFailure_(storage_level_id);
+      if (break_on_failure)
+        break;
+    }
   }
 
   return eval_status;
@@ -942,6 +1147,17 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
                                            analysis::NestAnalysis* analysis,
                                            bool break_on_failure)
 {
+  return Evaluate(mapping, analysis, break_on_failure, EvalCutoff());
+}
+
+std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
+                                           analysis::NestAnalysis* analysis,
+                                           bool break_on_failure,
+                                           const EvalCutoff& cutoff)
+{
+  timer::Scope timer_scope(timer::Phase::TopologyEvaluate);
+  perf::Scope perf_scope(timer::Phase::TopologyEvaluate);
+
   assert(is_specced_);
   Reset();
   assert(!is_evaluated_);
@@ -961,11 +1177,13 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
   std::vector<EvalStatus> eval_status(NumLevels(), { .success = true, .fail_reason = "" });
   bool success_accum = true;
   
-  // Compute working-set tile hierarchy for the nest.
-  problem::PerDataSpace<std::vector<tiling::TileInfo>> ws_tiles;
+  // Compute working-set tile hierarchy for the nest. The analysis object
+  // retains ownership of the tiles (it may serve them to repeat evaluations),
+  // so we only borrow a reference here instead of deep-copying the nest.
+  const problem::PerDataSpace<std::vector<tiling::TileInfo>>* ws_tiles = nullptr;
   try
   {
-    ws_tiles = analysis->GetWorkingSets();
+    ws_tiles = &analysis->GetWorkingSets();
   }
   catch (std::runtime_error& e)
   {
@@ -993,7 +1211,7 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
   
   // Collapse tiles into a specified number of tiling levels. The solutions are
   // received in a set of per-problem::Shape::DataSpaceID arrays.
-  auto collapsed_tiles = tiling::CollapseTiles(ws_tiles, specs_.NumStorageLevels(),
+  auto collapsed_tiles = tiling::CollapseTiles(*ws_tiles, specs_.NumStorageLevels(),
                                                mapping.datatype_bypass_nest,
                                                distribution_supported);
 
@@ -1005,10 +1223,17 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
   auto keep_masks = tiling::TransposeMasks(mapping.datatype_bypass_nest);
   assert(keep_masks.size() >= NumStorageLevels());
 
+  // Branch-and-bound: partial per-level accumulations are lower bounds on
+  // the final stats, so we can abort as soon as one exceeds its cutoff.
+  bool bounded = (cutoff.energy > 0.0 || cutoff.cycles > 0 || cutoff.edp > 0.0);
+  bool cutoff_hit = false;
+  double partial_energy = 0.0;
+  std::uint64_t partial_cycles = 0;
+
   for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
   {
     auto storage_level = GetStorageLevel(storage_level_id);
-    
+
     // Evaluate Loop Nest on hardware structures: calculate
     // primary statistics.
     auto level_id = specs_.StorageMap(storage_level_id);
@@ -1019,9 +1244,28 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
 
     if (break_on_failure && !s.success)
       break;
+
+    if (bounded && s.success)
+    {
+      partial_energy += storage_level->Energy();
+      partial_cycles = std::max(partial_cycles, storage_level->Cycles());
+      if ((cutoff.energy > 0.0 && partial_energy > cutoff.energy) ||
+          (cutoff.cycles > 0 && partial_cycles > cutoff.cycles) ||
+          (cutoff.edp > 0.0 && partial_energy * double(partial_cycles) > cutoff.edp))
+      {
+        std::ostringstream fail_reason;
+        fail_reason << "cost cutoff: partial cost after " << storage_level_id + 1
+                    << " storage levels already exceeds the incumbent";
+        eval_status.at(level_id) = { .success = false, .fail_reason = fail_reason.str() };
+        success_accum = false;
+        cutoff_hit = true;
+        break;
+      }
+    }
   }
 
-  unsigned int numConnections = NumStorageLevels();
+  // The whole point of the cutoff is to skip the remaining evaluation work.
+  unsigned int numConnections = cutoff_hit ? 0 : NumStorageLevels();
   for (uint32_t connection_id = 0; connection_id < numConnections; connection_id++)
   {
     auto connection = connection_map_[connection_id];
@@ -1074,15 +1318,26 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
 
 void Topology::ComputeStats(bool eval_success)
 {
+  // Per-level structure-of-arrays block. Filled alongside the aggregate
+  // stats below; zeroed out for failed evaluations.
+  stats_.per_level = PerLevelStats();
+
   if (eval_success)
   {
+    assert(NumLevels() <= PerLevelStats::kMaxLevels);
+    stats_.per_level.num_levels = NumLevels();
+
     // Energy.
     double energy = 0;
-    
-    for (auto level : levels_)
+
+    for (unsigned i = 0; i < NumLevels(); i++)
     {
+      auto level = levels_.at(i);
       assert(level->Energy() >= 0);
       energy += level->Energy();
+
+      stats_.per_level.energy[i] = level->Energy();
+      stats_.per_level.accesses[i] = level->Accesses();
     }
 
     for (auto& network: networks_)
@@ -1094,14 +1349,16 @@ void Topology::ComputeStats(bool eval_success)
       assert(e >= 0);
       energy += e;
     }
-    
+
     stats_.energy = energy;
 
     // Cycles.
     std::uint64_t cycles = 0;
-    for (auto level : levels_)
+    for (unsigned i = 0; i < NumLevels(); i++)
     {
-      cycles = std::max(cycles, level->Cycles());
+      auto level_cycles = levels_.at(i)->Cycles();
+      stats_.per_level.cycles[i] = level_cycles;
+      cycles = std::max(cycles, level_cycles);
     }
     stats_.cycles = cycles;
 
@@ -30,6 +30,8 @@
 #include <iostream>
 #include <memory>
 #include <algorithm>
+#include <array>
+#include <type_traits>
 
 #include "loop-analysis/tiling.hpp"
 #include "loop-analysis/nest-analysis.hpp"
@@ -148,12 +150,43 @@ class Topology : public Module
   //
   // Stats.
   //
+  // The hot per-level stats live in one contiguous, trivially copyable
+  // structure-of-arrays block with fixed-capacity inline arrays (no heap),
+  // so copying or comparing them walks contiguous memory instead of
+  // chasing per-level allocations. The reporting-oriented per-data-space
+  // vectors below it stay in their map/vector form for the pretty-printing
+  // consumers.
+  struct PerLevelStats
+  {
+    static const unsigned kMaxLevels = tiling::MaxTilingLevels;
+
+    unsigned num_levels = 0;
+    std::array<double, kMaxLevels> energy = {};          // indexed by level id
+    std::array<std::uint64_t, kMaxLevels> cycles = {};   // indexed by level id
+    std::array<std::uint64_t, kMaxLevels> accesses = {}; // indexed by level id
+  };
+  static_assert(std::is_trivially_copyable<PerLevelStats>::value,
+                "PerLevelStats must remain trivially copyable");
+
+  // Branch-and-bound cutoffs for Evaluate(). The partial accumulation of
+  // per-level energy/cycles across already-evaluated levels is a lower
+  // bound on the final stats, so once it exceeds a bound the mapping
+  // provably cannot beat the incumbent and evaluation aborts early with a
+  // "cost cutoff" failure. A zero value disables that bound.
+  struct EvalCutoff
+  {
+    double energy = 0.0;
+    std::uint64_t cycles = 0;
+    double edp = 0.0;
+  };
+
   struct Stats
   {
     double energy;
     double area;
     std::uint64_t cycles;
     double utilization;
+    PerLevelStats per_level;
     std::vector<problem::PerDataSpace<std::uint64_t>> tile_sizes;
     std::vector<problem::PerDataSpace<std::uint64_t>> utilized_instances;
     std::uint64_t maccs;
@@ -184,8 +217,22 @@ class Topology : public Module
 
   std::map<unsigned, double> tile_area_;
 
+  // Per-storage-level link-transfer enablement (innermost level first),
+  // derived at Spec() time from the read networks' link-transfers
+  // attribute. Handed to the nest analysis before each evaluation; see
+  // Engine::Evaluate().
+  std::vector<bool> link_transfer_levels_;
+
   Specs specs_;
   Stats stats_;
+
+  // Adaptive scheduling state for the fast rejection screens: per-storage-
+  // level failure histograms and the derived check order. Local to this
+  // Topology instance, i.e., to one search thread's engine. See
+  // CheckOrder_() in topology.cpp.
+  std::vector<std::uint64_t> check_fail_counts_;
+  std::vector<unsigned> check_order_;
+  std::uint64_t check_fails_since_reorder_ = 0;
   
   // Serialization
   friend class boost::serialization::access;
@@ -205,6 +252,9 @@ class Topology : public Module
   std::shared_ptr<ArithmeticUnits> GetArithmeticLevel() const;
   void FloorPlan();
   void ComputeStats(bool eval_success);
+  bool SpecMatches(const Specs& specs) const;
+  const std::vector<unsigned>& CheckOrder_();
+  void RecordCheckFailure_(unsigned storage_level_id);
 
  public:
 
@@ -227,6 +277,9 @@ class Topology : public Module
     tile_area_ = other.tile_area_;
     specs_ = other.specs_;
     stats_ = other.stats_;
+    check_fail_counts_ = other.check_fail_counts_;
+    check_order_ = other.check_order_;
+    check_fails_since_reorder_ = other.check_fails_since_reorder_;
   }
 
   // Copy-and-swap idiom.
@@ -240,6 +293,9 @@ class Topology : public Module
     swap(first.tile_area_, second.tile_area_);
     swap(first.specs_, second.specs_);
     swap(first.stats_, second.stats_);
+    swap(first.check_fail_counts_, second.check_fail_counts_);
+    swap(first.check_order_, second.check_order_);
+    swap(first.check_fails_since_reorder_, second.check_fails_since_reorder_);
   }
 
   Topology& operator = (Topology other)
@@ -260,8 +316,17 @@ class Topology : public Module
   unsigned NumStorageLevels() const;
   unsigned NumNetworks() const;
 
+  // Which storage levels (innermost first) have link-transfer modeling
+  // enabled on their read networks. Valid after Spec().
+  const std::vector<bool>& LinkTransferLevels() const { return link_transfer_levels_; }
+
   std::vector<EvalStatus> PreEvaluationCheck(const Mapping& mapping, analysis::NestAnalysis* analysis, bool break_on_failure);
+  std::vector<EvalStatus> QuickCapacityCheck(const Mapping& mapping,
+                                             const std::vector<problem::PerDataSpace<std::size_t>>& min_working_set_sizes,
+                                             bool break_on_failure);
   std::vector<EvalStatus> Evaluate(Mapping& mapping, analysis::NestAnalysis* analysis, bool break_on_failure);
+  std::vector<EvalStatus> Evaluate(Mapping& mapping, analysis::NestAnalysis* analysis, bool break_on_failure,
+                                   const EvalCutoff& cutoff);
 
   const Stats& GetStats() const { return stats_; }
 
@@ -277,6 +342,10 @@ class Topology : public Module
   std::uint64_t LastLevelAccesses() const { return stats_.last_level_accesses; }
 
   friend std::ostream& operator<<(std::ostream& out, const Topology& sh);
+
+  // Machine-readable counterpart of operator<<: one compact JSON object
+  // per call, emitted straight from the Stats structure.
+  void PrintStatsJSON(std::ostream& out) const;
 };
 
 }  // namespace model
@@ -55,6 +55,9 @@ class ExhaustiveSearch : public SearchAlgorithm
   // Live state.
   State state_;
   std::array<uint128_t, unsigned(mapspace::Dimension::Num)> iterator_;
+  // Current sweep direction of each dimension (+1/-1): the traversal is a
+  // reflected mixed-radix Gray code, see IncrementRecursive_().
+  std::array<int, unsigned(mapspace::Dimension::Num)> direction_;
   uint128_t valid_mappings_;
   std::uint64_t eval_fail_count_;
 
@@ -71,6 +74,7 @@ class ExhaustiveSearch : public SearchAlgorithm
     for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
     {
       iterator_[i] = 0;
+      direction_[i] = +1;
     }
 
     // Special case: if the index factorization space has size 0
@@ -92,17 +96,35 @@ class ExhaustiveSearch : public SearchAlgorithm
     mapspace::Dimension::IndexFactorization
   };
   
+  // Reflected mixed-radix Gray-code step: sweep the least-significant
+  // dimension back and forth, reversing its direction (without moving)
+  // when it hits a boundary and carrying into the next dimension. Every
+  // tuple is still visited exactly once, but each step changes exactly
+  // one subspace coordinate, and only by +/-1 -- so consecutive mappings
+  // differ minimally, maximizing hits in the mapspace decode caches and
+  // the incremental nest-analysis re-initialization.
   bool IncrementRecursive_(int position = 0)
   {
     auto dim = dim_order_[position];
-    if (iterator_[unsigned(dim)] + 1 < mapspace_->Size(dim))
+    auto size = mapspace_->Size(dim);
+    bool can_move = (direction_[unsigned(dim)] > 0) ?
+      (iterator_[unsigned(dim)] + 1 < size) :
+      (iterator_[unsigned(dim)] > 0);
+    if (can_move)
     {
-      iterator_[unsigned(dim)]++;
+      if (direction_[unsigned(dim)] > 0)
+      {
+        iterator_[unsigned(dim)]++;
+      }
+      else
+      {
+        iterator_[unsigned(dim)]--;
+      }
       return true;
     }
     else if (position + 1 < int(mapspace::Dimension::Num))
     {
-      iterator_[unsigned(dim)] = 0;
+      direction_[unsigned(dim)] = -direction_[unsigned(dim)];
       return IncrementRecursive_(position + 1);
     }
     else
@@ -112,6 +134,14 @@ class ExhaustiveSearch : public SearchAlgorithm
     }
   }
 
+  // The boundary coordinate of a dimension in its current sweep
+  // direction; fast-forwarding a dimension there forces the next step to
+  // carry past it.
+  uint128_t SweepEnd_(mapspace::Dimension dim)
+  {
+    return (direction_[unsigned(dim)] > 0) ? mapspace_->Size(dim) - 1 : 0;
+  }
+
   bool Next(mapspace::ID& mapping_id)
   {
     if (state_ == State::Terminated)
@@ -160,18 +190,18 @@ class ExhaustiveSearch : public SearchAlgorithm
       eval_fail_count_++;
     }
 
-    if (iterator_[unsigned(mapspace::Dimension::DatatypeBypass)] + 1 ==
-        mapspace_->Size(mapspace::Dimension::DatatypeBypass))
+    if (iterator_[unsigned(mapspace::Dimension::DatatypeBypass)] ==
+        SweepEnd_(mapspace::Dimension::DatatypeBypass))
     {
       if (eval_fail_count_ == mapspace_->Size(mapspace::Dimension::DatatypeBypass))
       {
         // All DBs failed eval for this combination of IF*LP*S. This means
         // this IF is bad. Skip to the next IF by fast-forwarding to the end of
-        // this IF.
+        // the current S and LP sweeps.
         iterator_[unsigned(mapspace::Dimension::Spatial)] =
-          mapspace_->Size(mapspace::Dimension::Spatial) - 1;
+          SweepEnd_(mapspace::Dimension::Spatial);
         iterator_[unsigned(mapspace::Dimension::LoopPermutation)] =
-          mapspace_->Size(mapspace::Dimension::LoopPermutation) - 1;
+          SweepEnd_(mapspace::Dimension::LoopPermutation);
       }
       eval_fail_count_ = 0;
     }
@@ -179,7 +209,7 @@ class ExhaustiveSearch : public SearchAlgorithm
     if (skip_datatype_bypass)
     {
       iterator_[unsigned(mapspace::Dimension::DatatypeBypass)] =
-        mapspace_->Size(mapspace::Dimension::DatatypeBypass) - 1;
+        SweepEnd_(mapspace::Dimension::DatatypeBypass);
     }
 
     bool mapspace_remaining = IncrementRecursive_();
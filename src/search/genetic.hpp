@@ -0,0 +1,272 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "mapping/mapping.hpp"
+#include "mapspaces/mapspace-base.hpp"
+#include "util/misc.hpp"
+#include "search/search.hpp"
+
+namespace search
+{
+
+// Genetic search over the mapspace. A genome is the tuple of per-dimension
+// mapspace::ID components (factorization ID, permutation ID, spatial-split
+// ID, bypass ID); uniform crossover exchanges whole components between two
+// parents, and mutation re-rolls individual components. Each generation is
+// streamed through the existing Next()/Report() contract one member at a
+// time, with the reported cost serving as (inverse) fitness; members whose
+// mapping failed construction or evaluation are treated as unfit. Parents
+// are picked by binary tournament, the best member survives unchanged, and
+// the search terminates after a fixed number of generations.
+class GeneticSearch : public SearchAlgorithm
+{
+ private:
+  enum class State
+  {
+    Ready,
+    WaitingForStatus,
+    Terminated
+  };
+
+  typedef std::array<uint128_t, int(mapspace::Dimension::Num)> Genome;
+
+ private:
+  // Config.
+  mapspace::MapSpace* mapspace_;
+  std::uint32_t population_size_;
+  std::uint32_t num_generations_;
+  double mutation_probability_;
+  double crossover_probability_;
+
+  // Submodules.
+  std::array<PatternGenerator128*, int(mapspace::Dimension::Num)> pgens_;
+  std::default_random_engine engine_;
+  std::uniform_real_distribution<double> unit_gen_;
+
+  // Live state.
+  State state_;
+  std::vector<Genome> population_;
+  std::vector<double> costs_;     // 0 = unevaluated or unfit.
+  std::uint32_t eval_index_;
+  std::uint32_t generation_;
+  uint128_t valid_mappings_;
+
+  Genome RandomGenome_()
+  {
+    Genome genome;
+    for (int dim = 0; dim < int(mapspace::Dimension::Num); dim++)
+    {
+      genome[dim] = pgens_[dim]->Next();
+    }
+    return genome;
+  }
+
+  // Binary tournament: draw two members, prefer the fit (lower-cost) one.
+  // Unfit members (cost 0) always lose against fit ones.
+  const Genome& SelectParent_()
+  {
+    std::uniform_int_distribution<std::uint32_t> member_gen(0, population_size_ - 1);
+    auto a = member_gen(engine_);
+    auto b = member_gen(engine_);
+
+    if (costs_[a] == 0)
+      return population_[b];
+    if (costs_[b] == 0)
+      return population_[a];
+    return (costs_[a] <= costs_[b]) ? population_[a] : population_[b];
+  }
+
+  void NextGeneration_()
+  {
+    // Find the fittest member (if any) for elitist survival.
+    std::uint32_t best = population_size_;
+    for (std::uint32_t i = 0; i < population_size_; i++)
+    {
+      if (costs_[i] != 0 && (best == population_size_ || costs_[i] < costs_[best]))
+      {
+        best = i;
+      }
+    }
+
+    std::vector<Genome> offspring;
+    offspring.reserve(population_size_);
+
+    if (best == population_size_)
+    {
+      // Every member failed: reseed the entire population randomly.
+      for (std::uint32_t i = 0; i < population_size_; i++)
+      {
+        offspring.push_back(RandomGenome_());
+      }
+    }
+    else
+    {
+      offspring.push_back(population_[best]);
+      while (offspring.size() < population_size_)
+      {
+        Genome child = SelectParent_();
+        if (unit_gen_(engine_) < crossover_probability_)
+        {
+          // Uniform crossover over whole mapspace-dimension components.
+          const Genome& other = SelectParent_();
+          for (int dim = 0; dim < int(mapspace::Dimension::Num); dim++)
+          {
+            if (unit_gen_(engine_) < 0.5)
+            {
+              child[dim] = other[dim];
+            }
+          }
+        }
+        for (int dim = 0; dim < int(mapspace::Dimension::Num); dim++)
+        {
+          if (unit_gen_(engine_) < mutation_probability_)
+          {
+            child[dim] = pgens_[dim]->Next();
+          }
+        }
+        offspring.push_back(child);
+      }
+    }
+
+    population_ = offspring;
+    costs_.assign(population_size_, 0);
+    eval_index_ = 0;
+    generation_++;
+  }
+
+ public:
+  GeneticSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace) :
+      SearchAlgorithm(),
+      mapspace_(mapspace),
+      unit_gen_(0.0, 1.0),
+      state_(State::Ready),
+      eval_index_(0),
+      generation_(0),
+      valid_mappings_(0)
+  {
+    population_size_ = 32;
+    config.lookupValue("population-size", population_size_);
+    assert(population_size_ > 0);
+
+    num_generations_ = 100;
+    config.lookupValue("num-generations", num_generations_);
+
+    mutation_probability_ = 0.1;
+    config.lookupValue("mutation-probability", mutation_probability_);
+
+    crossover_probability_ = 0.9;
+    config.lookupValue("crossover-probability", crossover_probability_);
+
+    pgens_[int(mapspace::Dimension::IndexFactorization)] =
+      new RandomGenerator128(mapspace_->Size(mapspace::Dimension::IndexFactorization));
+    pgens_[int(mapspace::Dimension::LoopPermutation)] =
+      new RandomGenerator128(mapspace_->Size(mapspace::Dimension::LoopPermutation));
+    pgens_[int(mapspace::Dimension::Spatial)] =
+      new RandomGenerator128(mapspace_->Size(mapspace::Dimension::Spatial));
+    pgens_[int(mapspace::Dimension::DatatypeBypass)] =
+      new RandomGenerator128(mapspace_->Size(mapspace::Dimension::DatatypeBypass));
+
+    // Special case: if the index factorization space has size 0
+    // (can happen with residual mapspaces) then we init in terminated
+    // state.
+    if (mapspace_->Size(mapspace::Dimension::IndexFactorization) == 0)
+    {
+      state_ = State::Terminated;
+    }
+    else
+    {
+      // Seed generation.
+      for (std::uint32_t i = 0; i < population_size_; i++)
+      {
+        population_.push_back(RandomGenome_());
+      }
+      costs_.assign(population_size_, 0);
+    }
+  }
+
+  // This class does not support being copied.
+  GeneticSearch(const GeneticSearch&) = delete;
+  GeneticSearch& operator=(const GeneticSearch&) = delete;
+
+  ~GeneticSearch()
+  {
+    for (int dim = 0; dim < int(mapspace::Dimension::Num); dim++)
+    {
+      delete static_cast<RandomGenerator128*>(pgens_[dim]);
+    }
+  }
+
+  bool Next(mapspace::ID& mapping_id)
+  {
+    if (state_ == State::Terminated)
+    {
+      return false;
+    }
+
+    assert(state_ == State::Ready);
+
+    mapping_id = mapspace::ID(mapspace_->AllSizes());
+    for (int dim = 0; dim < int(mapspace::Dimension::Num); dim++)
+    {
+      mapping_id.Set(dim, population_[eval_index_][dim]);
+    }
+
+    state_ = State::WaitingForStatus;
+    return true;
+  }
+
+  void Report(Status status, double cost = 0)
+  {
+    assert(state_ == State::WaitingForStatus);
+
+    if (status == Status::Success)
+    {
+      valid_mappings_++;
+      costs_[eval_index_] = cost;
+    }
+
+    eval_index_++;
+    if (eval_index_ == population_size_)
+    {
+      if (generation_ + 1 == num_generations_)
+      {
+        state_ = State::Terminated;
+        return;
+      }
+      NextGeneration_();
+    }
+
+    state_ = State::Ready;
+  }
+};
+
+} // namespace search
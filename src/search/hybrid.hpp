@@ -66,6 +66,16 @@ class HybridSearch : public SearchAlgorithm
   std::uint64_t eval_fail_count_;
   std::unordered_set<uint128_t> visited_;
 
+  // Failure steering: bypass IDs that caused a capacity failure under the
+  // current index factorization. Capacity depends on the factorization and
+  // the bypass scheme but not on loop permutation or spatial split, so once
+  // a bypass is known to blow a level's capacity there is no point
+  // re-proposing it under every other permutation/split of this
+  // factorization.
+  bool steer_on_fails_;
+  bool capacity_fail_seen_;
+  std::unordered_set<uint128_t> doomed_bypasses_;
+
   double best_cost_;
   std::ofstream best_cost_file_;
 
@@ -81,8 +91,12 @@ class HybridSearch : public SearchAlgorithm
       best_cost_(0)
   {
     filter_revisits_ = false;
-    config.lookupValue("filter-revisits", filter_revisits_);    
-    
+    config.lookupValue("filter-revisits", filter_revisits_);
+
+    steer_on_fails_ = true;
+    config.lookupValue("steer-on-fails", steer_on_fails_);
+    capacity_fail_seen_ = false;
+
     for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
     {
       iterator_[i] = 0;
@@ -161,6 +175,12 @@ class HybridSearch : public SearchAlgorithm
       // for this specific factorization index.
       mapspace_->InitPruned(iterator_[unsigned(dim)]);
 
+      // Capacity verdicts are factorization-specific. The eval-fail count
+      // also restarts: skipped doomed bypasses may have carried it past a
+      // sweep boundary without the end-of-sweep reset running.
+      doomed_bypasses_.clear();
+      eval_fail_count_ = 0;
+
 #ifdef DUMP_COSTS
       // Dump the best cost observed for this index factorization.
       // Note: best_cost_ == 0 implies this was a bad index factorization
@@ -176,22 +196,58 @@ class HybridSearch : public SearchAlgorithm
     }
     else // All other dimensions *except* IndexFactorization.
     {
-      if (iterator_[unsigned(dim)] + 1 < mapspace_->Size(dim))
+      while (iterator_[unsigned(dim)] + 1 < mapspace_->Size(dim))
       {
         // Move to next integer in this mapspace dimension.
         iterator_[unsigned(dim)]++;
+
+        // Skip bypasses known to blow a level's capacity under this
+        // factorization; they count as (virtual) eval failures so that the
+        // all-bypasses-failed factorization kill still triggers.
+        if (dim == mapspace::Dimension::DatatypeBypass &&
+            doomed_bypasses_.count(iterator_[unsigned(dim)]) != 0)
+        {
+          eval_fail_count_++;
+          continue;
+        }
         return true;
       }
+
       // Carry over to next higher-order mapspace dimension.
-      else
-      {
-        // This cannot be the last position because that is reserved for
-        // IndexFactorization.
-        assert(position + 1 < int(mapspace::Dimension::Num));
-        iterator_[unsigned(dim)] = 0;
-        return IncrementRecursive_(position + 1);
-      }
+      // This cannot be the last position because that is reserved for
+      // IndexFactorization.
+      assert(position + 1 < int(mapspace::Dimension::Num));
+      iterator_[unsigned(dim)] = 0;
+      return IncrementRecursive_(position + 1);
+    }
+  }
+
+  // Warm-start: position the frontier at the seed point. The seed's
+  // factorization is visited first (along with its neighborhood of
+  // permutations, splits and bypasses); subsequent factorizations are
+  // drawn randomly as usual.
+  bool Seed(const mapspace::ID& seed)
+  {
+    if (state_ == State::Terminated)
+    {
+      return false;
+    }
+
+    auto coordinates = seed.Read();
+    for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
+    {
+      iterator_[i] = coordinates[i];
+    }
+    mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
+
+    if (filter_revisits_)
+    {
+      visited_.insert(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
     }
+    doomed_bypasses_.clear();
+    eval_fail_count_ = 0;
+    best_cost_ = 0;
+    return true;
   }
 
   bool Next(mapspace::ID& mapping_id)
@@ -249,7 +305,16 @@ class HybridSearch : public SearchAlgorithm
       //   If all DBs cause Eval failure for an IF, then that IF is bad,
       //   no need to look at other LP, S combinations.
       eval_fail_count_++;
+
+      // If the failure detail confirmed a capacity blowout, remember this
+      // bypass as doomed for the current factorization so it is skipped
+      // (rather than re-evaluated) under other permutations/splits.
+      if (capacity_fail_seen_)
+      {
+        doomed_bypasses_.insert(iterator_[unsigned(mapspace::Dimension::DatatypeBypass)]);
+      }
     }
+    capacity_fail_seen_ = false;
 
     if (iterator_[unsigned(mapspace::Dimension::DatatypeBypass)] + 1 ==
         mapspace_->Size(mapspace::Dimension::DatatypeBypass))
@@ -284,6 +349,42 @@ class HybridSearch : public SearchAlgorithm
       state_ = State::Terminated;
     }
   }
+
+  void ReportFailureDetail(FailClass fail_class, unsigned level)
+  {
+    (void) level;
+    if (steer_on_fails_ && fail_class == FailClass::Capacity)
+    {
+      capacity_fail_seen_ = true;
+    }
+  }
+
+  // Note: the revisit filter and the doomed-bypass set are not persisted;
+  // both are re-learned after a resume.
+  void Checkpoint(std::ostream& out)
+  {
+    out << valid_mappings_ << ' ' << eval_fail_count_ << ' ' << best_cost_ << '\n';
+    for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
+    {
+      out << iterator_[i] << ' ';
+    }
+    out << '\n';
+    if_pgen_.SaveState(out);
+  }
+
+  void Restore(std::istream& in)
+  {
+    in >> valid_mappings_ >> eval_fail_count_ >> best_cost_;
+    for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
+    {
+      in >> iterator_[i];
+    }
+    if_pgen_.LoadState(in);
+    if (in && state_ != State::Terminated)
+    {
+      mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
+    }
+  }
 };
 
 } // namespace search
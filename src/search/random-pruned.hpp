@@ -36,6 +36,7 @@
 #include "mapspaces/mapspace-base.hpp"
 #include "util/misc.hpp"
 #include "search/search.hpp"
+#include "search/visited-filter.hpp"
 
 namespace search
 {
@@ -68,6 +69,8 @@ class RandomPrunedSearch : public SearchAlgorithm
   uint128_t valid_mappings_;
   std::uint64_t eval_fail_count_;
   std::unordered_set<uint128_t> visited_;
+  VisitedFilter* shared_filter_;
+  uint128_t filter_offset_;
 
   double best_cost_;
   std::ofstream best_cost_file_;
@@ -87,7 +90,23 @@ class RandomPrunedSearch : public SearchAlgorithm
     unsigned x = 16;
     config.lookupValue("max-permutations-per-if-visit", x);
     max_permutations_per_if_visit_ = x;
-    
+
+    // Optionally share a memory-bounded visited filter with the other
+    // threads' searches. Our flattened mapping IDs are not stable (the
+    // permutation subspace is re-sized by InitPruned() on every index
+    // factorization), so the shared filter runs in its probabilistic mode.
+    shared_filter_ = nullptr;
+    filter_offset_ = 0;
+    bool filter_revisits_shared = false;
+    config.lookupValue("filter-revisits-shared", filter_revisits_shared);
+    if (filter_revisits_shared)
+    {
+      std::uint32_t shared_filter_max_mb = 64;
+      config.lookupValue("shared-filter-max-mb", shared_filter_max_mb);
+      shared_filter_ = VisitedFilter::GetShared(shared_filter_max_mb);
+      filter_offset_ = shared_filter_->Attach(mapspace_->Size(), false);
+    }
+
     for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
     {
       iterator_[i] = 0;
@@ -217,6 +236,31 @@ class RandomPrunedSearch : public SearchAlgorithm
     }
   }
 
+  // Warm-start: position the frontier at the seed point. The seed's
+  // factorization and permutation are visited first; the randomized walk
+  // resumes from there.
+  bool Seed(const mapspace::ID& seed)
+  {
+    if (state_ == State::Terminated)
+    {
+      return false;
+    }
+
+    auto coordinates = seed.Read();
+    for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
+    {
+      iterator_[i] = coordinates[i];
+    }
+    mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
+
+    permutations_to_visit_ = std::min(max_permutations_per_if_visit_,
+                                      mapspace_->Size(mapspace::Dimension::LoopPermutation));
+    permutations_visited_ = 0;
+    eval_fail_count_ = 0;
+    best_cost_ = 0;
+    return true;
+  }
+
   bool Next(mapspace::ID& mapping_id)
   {
     if (state_ == State::Terminated)
@@ -231,7 +275,28 @@ class RandomPrunedSearch : public SearchAlgorithm
     {
       mapping_id.Set(i, iterator_[i]);
     }
-    
+
+    // Consult the shared filter before handing the mapping out for
+    // construction, skipping ahead past already-visited points. Note that
+    // IncrementRecursive_() may re-prune the mapspace, so the ID has to be
+    // rebuilt against the current subspace sizes on each step.
+    if (shared_filter_)
+    {
+      while (shared_filter_->TestAndSet(filter_offset_, mapping_id.Integer()))
+      {
+        if (!IncrementRecursive_())
+        {
+          state_ = State::Terminated;
+          return false;
+        }
+        mapping_id = mapspace::ID(mapspace_->AllSizes());
+        for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
+        {
+          mapping_id.Set(i, iterator_[i]);
+        }
+      }
+    }
+
     state_ = State::WaitingForStatus;
 
     // std::cerr << "MAPPING ID: IF(" << iterator_[unsigned(mapspace::Dimension::IndexFactorization)]
@@ -306,6 +371,35 @@ class RandomPrunedSearch : public SearchAlgorithm
       state_ = State::Terminated;
     }
   }
+
+  void Checkpoint(std::ostream& out)
+  {
+    out << valid_mappings_ << ' ' << eval_fail_count_ << ' ' << best_cost_ << '\n';
+    out << permutations_to_visit_ << ' ' << permutations_visited_ << '\n';
+    for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
+    {
+      out << iterator_[i] << ' ';
+    }
+    out << '\n';
+    if_pgen_.SaveState(out);
+    lp_pgen_.SaveState(out);
+  }
+
+  void Restore(std::istream& in)
+  {
+    in >> valid_mappings_ >> eval_fail_count_ >> best_cost_;
+    in >> permutations_to_visit_ >> permutations_visited_;
+    for (unsigned i = 0; i < unsigned(mapspace::Dimension::Num); i++)
+    {
+      in >> iterator_[i];
+    }
+    if_pgen_.LoadState(in);
+    lp_pgen_.LoadState(in);
+    if (in && state_ != State::Terminated)
+    {
+      mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
+    }
+  }
 };
 
 } // namespace search
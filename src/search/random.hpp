@@ -35,6 +35,7 @@
 #include "mapspaces/mapspace-base.hpp"
 #include "util/misc.hpp"
 #include "search/search.hpp"
+#include "search/visited-filter.hpp"
 
 namespace search
 {
@@ -55,12 +56,18 @@ class RandomSearch : public SearchAlgorithm
   // std::unordered_set<std::uint64_t> bad_;
   std::unordered_set<uint128_t> visited_;
   bool filter_revisits_;
+  VisitedFilter* shared_filter_;
+  uint128_t filter_offset_;
 
   // Submodules.
   std::array<PatternGenerator128*, int(mapspace::Dimension::Num)> pgens_;
   
-  // Live state.
+  // Live state. Report() only counts outcomes here, so Next() and
+  // Report() need not alternate strictly: outstanding_ tracks how many
+  // Next() results have not been reported yet, replacing the usual
+  // two-state handshake (see SupportsDeferredReport below).
   State state_;
+  std::uint64_t outstanding_;
   mapspace::ID mapping_id_;
   uint128_t masking_space_covered_;
   uint128_t valid_mappings_;
@@ -91,12 +98,28 @@ class RandomSearch : public SearchAlgorithm
       SearchAlgorithm(),
       mapspace_(mapspace),
       state_(State::Ready),
+      outstanding_(0),
       mapping_id_(mapspace->AllSizes()),
       masking_space_covered_(mapspace_->Size(mapspace::Dimension::DatatypeBypass)),
       valid_mappings_(0)
   {
     filter_revisits_ = false;
-    config.lookupValue("filter-revisits", filter_revisits_);    
+    config.lookupValue("filter-revisits", filter_revisits_);
+
+    // Optionally share a memory-bounded visited filter with the other
+    // threads' searches instead of (or in addition to) the unbounded
+    // per-thread set above.
+    shared_filter_ = nullptr;
+    filter_offset_ = 0;
+    bool filter_revisits_shared = false;
+    config.lookupValue("filter-revisits-shared", filter_revisits_shared);
+    if (filter_revisits_shared)
+    {
+      std::uint32_t shared_filter_max_mb = 64;
+      config.lookupValue("shared-filter-max-mb", shared_filter_max_mb);
+      shared_filter_ = VisitedFilter::GetShared(shared_filter_max_mb);
+      filter_offset_ = shared_filter_->Attach(mapspace_->Size(), true);
+    }
 
     pgens_[int(mapspace::Dimension::IndexFactorization)] =
       new RandomGenerator128(mapspace_->Size(mapspace::Dimension::IndexFactorization));
@@ -134,6 +157,13 @@ class RandomSearch : public SearchAlgorithm
             pgens_[int(mapspace::Dimension::DatatypeBypass)]);
   }
   
+  // Random draws are independent, so this algorithm tolerates a mapper
+  // running construction ahead of evaluation feedback.
+  bool SupportsDeferredReport() const
+  {
+    return true;
+  }
+
   bool Next(mapspace::ID& mapping_id)
   {
     if (state_ == State::Terminated)
@@ -141,8 +171,6 @@ class RandomSearch : public SearchAlgorithm
       return false;
     }
 
-    assert(state_ == State::Ready);
-    
     if (masking_space_covered_ == mapspace_->Size(mapspace::Dimension::DatatypeBypass))
     {
       while (true)
@@ -151,15 +179,16 @@ class RandomSearch : public SearchAlgorithm
         Roll(mapspace::Dimension::LoopPermutation);
         Roll(mapspace::Dimension::Spatial);
         Roll(mapspace::Dimension::DatatypeBypass);
-        if (filter_revisits_)
+        bool revisit = false;
+        if (shared_filter_)
         {
-          if (visited_.find(mapping_id_.Integer()) == visited_.end())
-          {
-            visited_.insert(mapping_id_.Integer());
-            break;
-          }
+          revisit = shared_filter_->TestAndSet(filter_offset_, mapping_id_.Integer());
         }
-        else
+        if (!revisit && filter_revisits_)
+        {
+          revisit = !visited_.insert(mapping_id_.Integer()).second;
+        }
+        if (!revisit)
         {
           break;
         }
@@ -172,8 +201,8 @@ class RandomSearch : public SearchAlgorithm
       masking_space_covered_++;
     }
 
-    state_ = State::WaitingForStatus;
-    
+    outstanding_++;
+
     mapping_id = mapping_id_;
     return true;
   }
@@ -181,8 +210,9 @@ class RandomSearch : public SearchAlgorithm
   void Report(Status status, double cost = 0)
   {
     (void) cost;
-    
-    assert(state_ == State::WaitingForStatus);
+
+    assert(outstanding_ > 0);
+    outstanding_--;
 
     if (status == Status::Success)
     {
@@ -200,9 +230,40 @@ class RandomSearch : public SearchAlgorithm
     {
       state_ = State::Terminated;
     }
-    else
+  }
+
+  // Note: the (local) revisit filter is not persisted; it is re-learned
+  // after a resume. The shared filter persists for the process lifetime
+  // only.
+  void Checkpoint(std::ostream& out)
+  {
+    out << valid_mappings_ << ' ' << masking_space_covered_ << '\n';
+    for (int i = 0; i < int(mapspace::Dimension::Num); i++)
+    {
+      out << mapping_id_[i] << ' ';
+    }
+    out << '\n';
+    for (int i = 0; i < int(mapspace::Dimension::Num); i++)
+    {
+      pgens_[i]->SaveState(out);
+    }
+  }
+
+  void Restore(std::istream& in)
+  {
+    in >> valid_mappings_ >> masking_space_covered_;
+    for (int i = 0; i < int(mapspace::Dimension::Num); i++)
+    {
+      uint128_t v;
+      in >> v;
+      if (in)
+      {
+        mapping_id_.Set(i, v);
+      }
+    }
+    for (int i = 0; i < int(mapspace::Dimension::Num); i++)
     {
-      state_ = State::Ready;
+      pgens_[i]->LoadState(in);
     }
   }
 };
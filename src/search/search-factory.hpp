@@ -34,6 +34,8 @@
 #include "search/linear-pruned.hpp"
 #include "search/hybrid.hpp"
 #include "search/random-pruned.hpp"
+#include "search/simulated-annealing.hpp"
+#include "search/genetic.hpp"
 #include "compound-config/compound-config.hpp"
 
 namespace search
@@ -72,6 +74,14 @@ SearchAlgorithm* ParseAndConstruct(config::CompoundConfigNode config,
   {
     search = new RandomPrunedSearch(config, mapspace, id);
   }
+  else if (search_alg == "simulated-annealing")
+  {
+    search = new SimulatedAnnealingSearch(config, mapspace);
+  }
+  else if (search_alg == "genetic")
+  {
+    search = new GeneticSearch(config, mapspace);
+  }
   else
   {
     std::cerr << "ERROR: unsupported search algorithm: " << search_alg << std::endl;
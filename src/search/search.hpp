@@ -39,13 +39,56 @@ enum class Status
   EvalFailure
 };
 
+// Classes of mapping failure, mirroring the classes the mapper's
+// diagnostics already aggregate per level.
+enum class FailClass
+{
+  Fanout,
+  Capacity
+};
+
 class SearchAlgorithm
-{ 
+{
  public:
   SearchAlgorithm() {}
   virtual ~SearchAlgorithm() {}
   virtual bool Next(mapspace::ID& mapping_id) = 0;
   virtual void Report(Status status, double cost = 0) = 0;
+
+  // Optional warm-start: position the search frontier at the given mapping
+  // ID so that exploration begins in its neighborhood. Called at most
+  // once, before the first Next(). Algorithms without support return
+  // false and start cold.
+  virtual bool Seed(const mapspace::ID& seed)
+  {
+    (void) seed;
+    return false;
+  }
+
+  // Whether Report() may arrive several Next() calls after the mapping it
+  // describes (and some Next() results may never be reported at all).
+  // Algorithms that return true can be driven by the mapper's pipelined
+  // construct/evaluate mode, where a helper thread runs Next() ahead of
+  // the evaluations. Algorithms that steer on per-mapping feedback must
+  // keep the default strict Next/Report alternation.
+  virtual bool SupportsDeferredReport() const { return false; }
+
+  // Optional richer failure feedback: the class of failure and the
+  // topology level it occurred at, delivered (possibly once per failing
+  // level) before the corresponding failed Report() call. Algorithms
+  // that do not steer on failure details simply ignore it.
+  virtual void ReportFailureDetail(FailClass fail_class, unsigned level)
+  {
+    (void) fail_class;
+    (void) level;
+  }
+
+  // Checkpoint/restore of search progress, used by the mapper's periodic
+  // snapshots. Algorithms without support inherit the no-ops and simply
+  // restart their frontier on resume (the best mapping found so far is
+  // preserved separately by the mapper).
+  virtual void Checkpoint(std::ostream& out) { (void) out; }
+  virtual void Restore(std::istream& in) { (void) in; }
 };
 
 } // namespace search
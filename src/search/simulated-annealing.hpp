@@ -0,0 +1,234 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <random>
+
+#include "mapping/mapping.hpp"
+#include "mapspaces/mapspace-base.hpp"
+#include "util/misc.hpp"
+#include "search/search.hpp"
+
+namespace search
+{
+
+// Simulated annealing over the mapspace. Each move perturbs a single
+// mapspace dimension of the incumbent ID (a neighborhood move over
+// mapspace::ID), and the cost fed back through Report() drives a Metropolis
+// acceptance rule: improving moves are always accepted, worsening moves
+// are accepted with probability exp(-delta / T), where delta is the cost
+// increase relative to the incumbent's cost so that the temperature is a
+// dimensionless knob independent of the optimization metric's scale. The
+// temperature decays geometrically per move, and the search terminates
+// when it cools below a floor.
+class SimulatedAnnealingSearch : public SearchAlgorithm
+{
+ private:
+  enum class State
+  {
+    Ready,
+    WaitingForStatus,
+    Terminated
+  };
+
+ private:
+  // Config.
+  mapspace::MapSpace* mapspace_;
+  double initial_temperature_;
+  double cooling_rate_;
+  double min_temperature_;
+
+  // Submodules.
+  std::array<PatternGenerator128*, int(mapspace::Dimension::Num)> pgens_;
+  std::default_random_engine engine_;
+  std::uniform_int_distribution<int> dim_gen_;
+  std::uniform_real_distribution<double> unit_gen_;
+
+  // Live state.
+  State state_;
+  double temperature_;
+  std::array<uint128_t, int(mapspace::Dimension::Num)> incumbent_;
+  double incumbent_cost_;
+  bool have_incumbent_;
+  std::array<uint128_t, int(mapspace::Dimension::Num)> candidate_;
+  uint128_t valid_mappings_;
+
+  void RollAll_()
+  {
+    for (int dim = 0; dim < int(mapspace::Dimension::Num); dim++)
+    {
+      candidate_[dim] = pgens_[dim]->Next();
+    }
+  }
+
+  void Perturb_()
+  {
+    candidate_ = incumbent_;
+
+    // Re-roll one dimension. Dimensions of size 1 have no neighbors, so
+    // keep drawing until we land on one that can actually move (at least
+    // the index factorization dimension has size > 1, else we would have
+    // terminated at construction).
+    int dim;
+    do
+    {
+      dim = dim_gen_(engine_);
+    }
+    while (mapspace_->Size(mapspace::Dimension(dim)) <= 1);
+
+    candidate_[dim] = pgens_[dim]->Next();
+  }
+
+ public:
+  SimulatedAnnealingSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace) :
+      SearchAlgorithm(),
+      mapspace_(mapspace),
+      dim_gen_(0, int(mapspace::Dimension::Num) - 1),
+      unit_gen_(0.0, 1.0),
+      state_(State::Ready),
+      incumbent_cost_(0),
+      have_incumbent_(false),
+      valid_mappings_(0)
+  {
+    initial_temperature_ = 1.0;
+    config.lookupValue("initial-temperature", initial_temperature_);
+
+    cooling_rate_ = 0.999;
+    config.lookupValue("cooling-rate", cooling_rate_);
+
+    min_temperature_ = 1e-3;
+    config.lookupValue("min-temperature", min_temperature_);
+
+    temperature_ = initial_temperature_;
+
+    pgens_[int(mapspace::Dimension::IndexFactorization)] =
+      new RandomGenerator128(mapspace_->Size(mapspace::Dimension::IndexFactorization));
+    pgens_[int(mapspace::Dimension::LoopPermutation)] =
+      new RandomGenerator128(mapspace_->Size(mapspace::Dimension::LoopPermutation));
+    pgens_[int(mapspace::Dimension::Spatial)] =
+      new RandomGenerator128(mapspace_->Size(mapspace::Dimension::Spatial));
+    pgens_[int(mapspace::Dimension::DatatypeBypass)] =
+      new RandomGenerator128(mapspace_->Size(mapspace::Dimension::DatatypeBypass));
+
+    // Special case: if the index factorization space has size 0
+    // (can happen with residual mapspaces), or if every dimension is
+    // trivial, then we init in terminated state.
+    if (mapspace_->Size(mapspace::Dimension::IndexFactorization) == 0 ||
+        mapspace_->Size() <= 1)
+    {
+      state_ = State::Terminated;
+    }
+  }
+
+  // This class does not support being copied.
+  SimulatedAnnealingSearch(const SimulatedAnnealingSearch&) = delete;
+  SimulatedAnnealingSearch& operator=(const SimulatedAnnealingSearch&) = delete;
+
+  ~SimulatedAnnealingSearch()
+  {
+    for (int dim = 0; dim < int(mapspace::Dimension::Num); dim++)
+    {
+      delete static_cast<RandomGenerator128*>(pgens_[dim]);
+    }
+  }
+
+  bool Next(mapspace::ID& mapping_id)
+  {
+    if (state_ == State::Terminated)
+    {
+      return false;
+    }
+
+    assert(state_ == State::Ready);
+
+    if (have_incumbent_)
+    {
+      Perturb_();
+    }
+    else
+    {
+      // No incumbent yet (cold start, or every mapping so far has failed):
+      // propose a fully random point.
+      RollAll_();
+    }
+
+    mapping_id = mapspace::ID(mapspace_->AllSizes());
+    for (int dim = 0; dim < int(mapspace::Dimension::Num); dim++)
+    {
+      mapping_id.Set(dim, candidate_[dim]);
+    }
+
+    state_ = State::WaitingForStatus;
+    return true;
+  }
+
+  void Report(Status status, double cost = 0)
+  {
+    assert(state_ == State::WaitingForStatus);
+
+    if (status == Status::Success)
+    {
+      valid_mappings_++;
+
+      bool accept;
+      if (!have_incumbent_ || cost <= incumbent_cost_)
+      {
+        accept = true;
+      }
+      else
+      {
+        // Metropolis rule on the relative cost increase.
+        double delta = (cost - incumbent_cost_) / incumbent_cost_;
+        accept = unit_gen_(engine_) < std::exp(-delta / temperature_);
+      }
+
+      if (accept)
+      {
+        incumbent_ = candidate_;
+        incumbent_cost_ = cost;
+        have_incumbent_ = true;
+      }
+    }
+    // Construction/eval failures are simply rejected moves: the incumbent
+    // stays put and the clock keeps cooling.
+
+    temperature_ *= cooling_rate_;
+
+    if (temperature_ < min_temperature_)
+    {
+      state_ = State::Terminated;
+    }
+    else
+    {
+      state_ = State::Ready;
+    }
+  }
+};
+
+} // namespace search
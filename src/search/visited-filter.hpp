@@ -0,0 +1,167 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "util/numeric.hpp"
+
+namespace search
+{
+
+// A memory-bounded visited-set that can be shared by all per-thread search
+// algorithms. The random search algorithms can re-roll mapping IDs they have
+// already proposed, and the per-thread std::unordered_set used to filter
+// such revisits both grows without bound and cannot see what sibling threads
+// have already covered. This filter is a single fixed-budget array of atomic
+// words instead: each mapspace split attaches a region sized from its
+// mapspace_->Size(), and membership tests are lock-free fetch_or operations.
+//
+// If every attached split's flattened ID range fits within the budget, the
+// filter operates as an exact bitmap with one bit per mapping. For larger
+// spaces it gracefully degrades to a blocked Bloom filter over hashed IDs:
+// each mapping sets two bits within a single 512-bit block (one cache line),
+// so a test-and-set touches exactly one line. In that mode the filter may
+// rarely report an unvisited mapping as visited, but it never forgets a
+// mapping it has seen.
+class VisitedFilter
+{
+ private:
+  static const std::uint64_t kBlockBits = 512;
+
+  std::uint64_t max_bits_;
+  uint128_t total_points_;
+  bool stable_ids_;
+  bool exact_;
+  std::uint64_t num_bits_;
+  std::vector<std::atomic<std::uint64_t>> bits_;
+  std::once_flag alloc_once_;
+
+  // FNV-1a over the two 64-bit halves of the key.
+  static std::uint64_t Hash(uint128_t key)
+  {
+    std::uint64_t halves[2] = { std::uint64_t(key), std::uint64_t(key >> 64) };
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (auto half : halves)
+    {
+      for (unsigned byte = 0; byte < 8; byte++)
+      {
+        hash ^= (half >> (byte * 8)) & 0xFF;
+        hash *= 1099511628211ULL;
+      }
+    }
+    return hash;
+  }
+
+  // Atomically sets a bit, returning its previous value.
+  bool SetBit(std::uint64_t bit)
+  {
+    std::uint64_t mask = 1ULL << (bit & 63);
+    return (bits_[bit >> 6].fetch_or(mask, std::memory_order_relaxed) & mask) != 0;
+  }
+
+  // All Attach() calls happen on the main thread before the mapper threads
+  // launch, so the mode decision and allocation can be deferred until the
+  // first (possibly concurrent) TestAndSet.
+  void AllocateStorage()
+  {
+    exact_ = stable_ids_ && total_points_ > 0 &&
+             total_points_ <= uint128_t(max_bits_);
+    num_bits_ = exact_ ? std::uint64_t(total_points_) : max_bits_;
+
+    // Round up to whole blocks so the blocked-Bloom block selection always
+    // lands in-range.
+    std::uint64_t num_blocks = (num_bits_ + kBlockBits - 1) / kBlockBits;
+    if (num_blocks == 0)
+      num_blocks = 1;
+    bits_ = std::vector<std::atomic<std::uint64_t>>(num_blocks * (kBlockBits / 64));
+    if (!exact_)
+      num_bits_ = num_blocks * kBlockBits;
+  }
+
+ public:
+  VisitedFilter(std::uint64_t max_mb) :
+      max_bits_(max_mb * 8 * 1024 * 1024),
+      total_points_(0),
+      stable_ids_(true),
+      exact_(false),
+      num_bits_(0)
+  { }
+
+  // This class does not support being copied.
+  VisitedFilter(const VisitedFilter&) = delete;
+  VisitedFilter& operator=(const VisitedFilter&) = delete;
+
+  // Reserve an ID region for one mapspace split; returns the region's base
+  // offset. Must be called before the first TestAndSet. stable_ids must be
+  // false if the caller's flattened mapping IDs can change meaning over the
+  // course of the search (e.g., because InitPruned() re-sizes the
+  // per-factorization subspaces), which disqualifies the exact-bitmap mode.
+  uint128_t Attach(uint128_t split_size, bool stable_ids)
+  {
+    auto offset = total_points_;
+    total_points_ += split_size;
+    stable_ids_ = stable_ids_ && stable_ids;
+    return offset;
+  }
+
+  // Marks a mapping as visited and returns true if it already was. In
+  // blocked-Bloom mode this may (rarely) return true for an unvisited
+  // mapping; it never returns false for a visited one.
+  bool TestAndSet(uint128_t offset, uint128_t point)
+  {
+    std::call_once(alloc_once_, [this]() { AllocateStorage(); });
+
+    if (exact_)
+    {
+      return SetBit(std::uint64_t(offset + point));
+    }
+    else
+    {
+      std::uint64_t hash = Hash(offset + point);
+      std::uint64_t num_blocks = num_bits_ / kBlockBits;
+      std::uint64_t block = (hash >> 18) % num_blocks;
+      bool was_set_0 = SetBit(block * kBlockBits + (hash & (kBlockBits - 1)));
+      bool was_set_1 = SetBit(block * kBlockBits + ((hash >> 9) & (kBlockBits - 1)));
+      return was_set_0 && was_set_1;
+    }
+  }
+
+  // The per-thread searches are all constructed sequentially on the main
+  // thread, so the first caller's budget wins and no locking is needed here.
+  static VisitedFilter* GetShared(std::uint64_t max_mb)
+  {
+    static VisitedFilter* shared = new VisitedFilter(max_mb);
+    return shared;
+  }
+};
+
+} // namespace search
@@ -0,0 +1,201 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Allocation-site accounting for the evaluation hot paths. TRACK_ALLOC
+// tags are placed at the known heap-allocating sites; each tag records
+// an invocation count and approximate byte volume into per-thread
+// counters (no locking on the hot path), and a ranked per-site report
+// is dumped to stderr at program exit. This is a measurement tool for
+// sizing arenas and small-buffer thresholds -- far cheaper than running
+// a full heap profiler under a many-threaded mapper search.
+//
+// Compiled out by default: without the TIMELOOP_ENABLE_ALLOC_TRACKER
+// preprocessor flag (scons --alloc-tracker), the tags expand to nothing
+// and their byte expressions are not evaluated.
+
+#ifdef TIMELOOP_ENABLE_ALLOC_TRACKER
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace alloctrack
+{
+
+#ifdef TIMELOOP_ENABLE_ALLOC_TRACKER
+
+struct SiteCounts
+{
+  std::uint64_t count = 0;
+  std::uint64_t bytes = 0;
+};
+
+struct Site;
+
+// Registry of all tag sites and all threads' counter tables, merged and
+// ranked at exit. Counter tables are shared_ptrs: a thread's counts
+// outlive the thread itself.
+struct Registry
+{
+  std::mutex mutex;
+  std::vector<const Site*> sites;
+  std::vector<std::shared_ptr<std::vector<SiteCounts>>> tables;
+
+  static Registry& Get()
+  {
+    static Registry registry;
+    return registry;
+  }
+
+  unsigned RegisterSite(const Site* site)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    sites.push_back(site);
+    return unsigned(sites.size() - 1);
+  }
+
+  void RegisterTable(std::shared_ptr<std::vector<SiteCounts>> table)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tables.push_back(table);
+  }
+
+  ~Registry();
+};
+
+// One TRACK_ALLOC tag site. Constructed once (function-local static), so
+// registration cost is paid on the first visit only.
+struct Site
+{
+  const char* label;
+  const char* file;
+  int line;
+  unsigned id;
+
+  Site(const char* _label, const char* _file, int _line) :
+      label(_label), file(_file), line(_line),
+      id(Registry::Get().RegisterSite(this))
+  {
+  }
+};
+
+struct ThreadState
+{
+  std::shared_ptr<std::vector<SiteCounts>> counts;
+
+  ThreadState() :
+      counts(std::make_shared<std::vector<SiteCounts>>())
+  {
+    Registry::Get().RegisterTable(counts);
+  }
+};
+
+inline ThreadState& State()
+{
+  static thread_local ThreadState state;
+  return state;
+}
+
+inline void Record(const Site& site, std::uint64_t bytes)
+{
+  auto& counts = *State().counts;
+  if (site.id >= counts.size())
+  {
+    // Grows only on a thread's first visit to a new site.
+    counts.resize(site.id + 1);
+  }
+  counts[site.id].count++;
+  counts[site.id].bytes += bytes;
+}
+
+// Merge all threads' counters and print the sites ranked by byte volume.
+inline Registry::~Registry()
+{
+  std::vector<SiteCounts> merged(sites.size());
+  for (auto& table: tables)
+  {
+    for (unsigned id = 0; id < table->size(); id++)
+    {
+      merged[id].count += (*table)[id].count;
+      merged[id].bytes += (*table)[id].bytes;
+    }
+  }
+
+  std::vector<unsigned> order;
+  for (unsigned id = 0; id < sites.size(); id++)
+  {
+    if (merged[id].count > 0)
+    {
+      order.push_back(id);
+    }
+  }
+  if (order.empty())
+  {
+    return;
+  }
+  std::sort(order.begin(), order.end(), [&merged](unsigned a, unsigned b)
+            { return merged[a].bytes > merged[b].bytes; });
+
+  std::cerr << "Allocation sites, ranked by byte volume (all threads):" << std::endl;
+  for (auto id: order)
+  {
+    std::cerr << "  " << std::setw(40) << std::left << sites[id]->label << std::right
+              << std::setw(16) << merged[id].bytes << " B"
+              << std::setw(14) << merged[id].count << " allocs"
+              << "  " << sites[id]->file << ":" << sites[id]->line
+              << std::endl;
+  }
+}
+
+#endif // TIMELOOP_ENABLE_ALLOC_TRACKER
+
+} // namespace alloctrack
+
+// Tag an allocation site: label is a short human-readable name, bytes an
+// approximation of the heap volume the adjacent code allocates. The byte
+// expression is evaluated only on tracker-enabled builds.
+#ifdef TIMELOOP_ENABLE_ALLOC_TRACKER
+#define TRACK_ALLOC(label, bytes)                                            \
+  do                                                                         \
+  {                                                                          \
+    static alloctrack::Site track_alloc_site_(label, __FILE__, __LINE__);    \
+    alloctrack::Record(track_alloc_site_, std::uint64_t(bytes));             \
+  } while (0)
+#else
+#define TRACK_ALLOC(label, bytes)                                            \
+  do                                                                         \
+  {                                                                          \
+    (void) sizeof(bytes);                                                    \
+  } while (0)
+#endif
@@ -33,14 +33,19 @@
 
 bool ParseArgs(int argc, char* argv[],
                std::vector<std::string>& input_files,
-               std::string& output_dir)
+               std::string& output_dir,
+               bool& resume)
 {
-  // Very rudimentary argument parsing. The only recognized pattern is "-o <odir>"
-  // and a set of .yaml or .cfg files.
+  // Very rudimentary argument parsing. The only recognized patterns are
+  // "-o <odir>", "--resume" and a set of .yaml or .cfg files.
   std::vector<std::string> input_args(argv + 1, argv + argc);
   for (auto arg = input_args.begin(); arg != input_args.end(); arg++)
   {
-    if (arg->compare("-o") == 0)
+    if (arg->compare("--resume") == 0)
+    {
+      resume = true;
+    }
+    else if (arg->compare("-o") == 0)
     {
       arg++;
       output_dir = *arg;
@@ -64,3 +69,11 @@ bool ParseArgs(int argc, char* argv[],
 
   return true;
 }
+
+bool ParseArgs(int argc, char* argv[],
+               std::vector<std::string>& input_files,
+               std::string& output_dir)
+{
+  bool resume = false;
+  return ParseArgs(argc, argv, input_files, output_dir, resume);
+}
@@ -0,0 +1,161 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Lightweight per-phase cycle accounting for the evaluation pipeline.
+// Scopes are placed at the entry of the phases we care about (the delta
+// recursion and the model evaluation); each thread accumulates inclusive
+// cycles per phase into thread-local counters, which the mapper snapshots
+// and reports per thread.
+//
+// Compiled out by default: without the TIMELOOP_ENABLE_TIMERS preprocessor
+// flag (scons --timers), scopes are empty objects and reads yield zeros, so
+// the instrumented code paths carry no overhead.
+
+#ifdef TIMELOOP_ENABLE_TIMERS
+#include <chrono>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace timer
+{
+
+enum class Phase : unsigned
+{
+  TemporalWorkingSet = 0,
+  SpatialDeltas,
+  MulticastedAccesses,
+  TopologyEvaluate,
+  MappingConstruct,
+  Num
+};
+
+const unsigned NumPhases = unsigned(Phase::Num);
+
+inline const char* PhaseName(unsigned phase)
+{
+  switch (Phase(phase))
+  {
+    case Phase::TemporalWorkingSet:  return "ComputeTemporalWorkingSet";
+    case Phase::SpatialDeltas:       return "FillSpatialDeltas";
+    case Phase::MulticastedAccesses: return "ComputeAccurateMulticastedAccesses";
+    case Phase::TopologyEvaluate:    return "Topology::Evaluate";
+    case Phase::MappingConstruct:    return "ConstructMapping";
+    default:                         return "unknown";
+  }
+}
+
+typedef std::array<std::uint64_t, NumPhases> PhaseCycles;
+
+#ifdef TIMELOOP_ENABLE_TIMERS
+
+struct ThreadState
+{
+  PhaseCycles cycles = {};
+  std::array<unsigned, NumPhases> depth = {};
+};
+
+inline ThreadState& State()
+{
+  static thread_local ThreadState state;
+  return state;
+}
+
+inline std::uint64_t ReadCycles()
+{
+#if defined(__x86_64__)
+  return __rdtsc();
+#else
+  // No cheap cycle counter available from user space; fall back to a
+  // monotonic nanosecond clock (so "cycles" are really nanoseconds).
+  return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Accumulates the cycles spent inside a phase into the calling thread's
+// counters. Recursion-safe: only the outermost scope of each phase
+// accumulates, so recursive phases are counted inclusively, exactly once.
+class Scope
+{
+ public:
+  Scope(Phase phase) :
+      phase_(unsigned(phase))
+  {
+    auto& state = State();
+    if (state.depth[phase_]++ == 0)
+    {
+      start_ = ReadCycles();
+    }
+  }
+
+  ~Scope()
+  {
+    auto& state = State();
+    if (--state.depth[phase_] == 0)
+    {
+      state.cycles[phase_] += ReadCycles() - start_;
+    }
+  }
+
+ private:
+  unsigned phase_;
+  std::uint64_t start_ = 0;
+};
+
+// Snapshot of the calling thread's accumulated cycles.
+inline PhaseCycles Read()
+{
+  return State().cycles;
+}
+
+#else
+
+// Timers compiled out: scopes are empty objects and reads yield zeros.
+class Scope
+{
+ public:
+  Scope(Phase phase)
+  {
+    (void) phase;
+  }
+};
+
+inline PhaseCycles Read()
+{
+  return PhaseCycles{};
+}
+
+#endif // TIMELOOP_ENABLE_TIMERS
+
+} // namespace timer
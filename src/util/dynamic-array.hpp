@@ -28,9 +28,21 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <cassert>
 
+// Sizes up to this bound are stored inline instead of on the heap. These
+// arrays are overwhelmingly per-data-space or per-problem-dimension, i.e.,
+// a handful of elements constructed and torn down constantly on the
+// evaluation hot path; avoiding a heap round-trip per construction (and
+// keeping the elements in cache, with a trip count the compiler can see)
+// is worth the small inline footprint. Sizes above the bound fall back to
+// heap storage as before.
+#ifndef TIMELOOP_DYNAMIC_ARRAY_INLINE_SIZE
+#define TIMELOOP_DYNAMIC_ARRAY_INLINE_SIZE 8
+#endif
+
 // This is meant to be a drop-in replacement for std::array
 // that does not need a statically constant size,
 // merely a size specified at construction time.
@@ -43,26 +55,31 @@ template<class T>
 class DynamicArray
 {
  private:
+  static const size_t kInlineSize = TIMELOOP_DYNAMIC_ARRAY_INLINE_SIZE;
+
   size_t size_;
+  std::array<T, kInlineSize> inline_;
   T* data_;
 
+  bool IsInline() const { return data_ == inline_.data(); }
+
  public:
   DynamicArray(size_t size) :
     size_(size),
-    data_(new T[size])
+    data_(size <= kInlineSize ? inline_.data() : new T[size])
   {
   }
 
   DynamicArray(const DynamicArray& other) :
     size_(other.size_),
-    data_(new T[size_])
+    data_(size_ <= kInlineSize ? inline_.data() : new T[size_])
   {
     std::copy(other.begin(), other.end(), begin());
   }
 
   DynamicArray(std::initializer_list<T> l) :
     size_(l.size()),
-    data_(new T[size_])
+    data_(size_ <= kInlineSize ? inline_.data() : new T[size_])
   {
     std::copy(l.begin(), l.end(), begin());
   }
@@ -76,21 +93,51 @@ class DynamicArray
   friend void swap(DynamicArray& first, DynamicArray& second)
   {
     using std::swap;
-    swap(first.size_, second.size_);
-    swap(first.data_, second.data_);
+    if (first.IsInline() && second.IsInline())
+    {
+      swap(first.inline_, second.inline_);
+      swap(first.size_, second.size_);
+    }
+    else if (!first.IsInline() && !second.IsInline())
+    {
+      swap(first.size_, second.size_);
+      swap(first.data_, second.data_);
+    }
+    else
+    {
+      // Mixed: hand the heap buffer over, and move the inline elements
+      // into the (now-vacant) inline buffer on the other side.
+      DynamicArray& inl = first.IsInline() ? first : second;
+      DynamicArray& heap = first.IsInline() ? second : first;
+      std::move(inl.inline_.begin(), inl.inline_.begin() + inl.size_,
+                heap.inline_.begin());
+      inl.data_ = heap.data_;
+      heap.data_ = heap.inline_.data();
+      swap(first.size_, second.size_);
+    }
   }
 
   ~DynamicArray()
   {
-    delete[] data_;
+    if (!IsInline())
+    {
+      delete[] data_;
+    }
   }
 
   size_t size() { return size_; }
 
   void clear()
   {
-    delete[] data_;
-    data_ = new T[size_];
+    if (IsInline())
+    {
+      std::fill(begin(), end(), T());
+    }
+    else
+    {
+      delete[] data_;
+      data_ = new T[size_];
+    }
   }
 
   T & operator [] (size_t i)
@@ -0,0 +1,210 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+
+// Sizes up to this bound are stored inline instead of on the heap (see
+// the rationale in dynamic-array.hpp, which uses the same bound family).
+#ifndef TIMELOOP_INLINE_VECTOR_SIZE
+#define TIMELOOP_INLINE_VECTOR_SIZE 8
+#endif
+
+// A resizable vector with inline storage for small sizes and heap
+// fallback. This is the growable sibling of DynamicArray (which is fixed
+// at construction): it backs the per-multicast-factor arrays in tile and
+// loop-analysis state, which are sized by the fanout of a level -- 1 at
+// every temporal level, so in the common case an instance is constructed,
+// resized and torn down on the evaluation hot path without ever touching
+// the heap. The interface is the subset of std::vector that those call
+// sites use; conversion to std::vector is provided for stats structures
+// that keep the standard type.
+template<class T>
+class InlineVector
+{
+ private:
+  static const std::size_t kInlineSize = TIMELOOP_INLINE_VECTOR_SIZE;
+
+  std::size_t size_ = 0;
+  std::size_t capacity_ = kInlineSize;
+  std::array<T, kInlineSize> inline_;
+  T* data_ = inline_.data();
+
+  bool IsInline() const { return data_ == inline_.data(); }
+
+  void Grow(std::size_t new_capacity)
+  {
+    T* new_data = new T[new_capacity];
+    std::copy(data_, data_ + size_, new_data);
+    if (!IsInline())
+    {
+      delete[] data_;
+    }
+    data_ = new_data;
+    capacity_ = new_capacity;
+  }
+
+ public:
+  InlineVector() {}
+
+  explicit InlineVector(std::size_t size)
+  {
+    resize(size);
+  }
+
+  InlineVector(std::size_t size, const T& value)
+  {
+    resize(size);
+    std::fill(begin(), end(), value);
+  }
+
+  InlineVector(const InlineVector& other)
+  {
+    resize(other.size_);
+    std::copy(other.begin(), other.end(), begin());
+  }
+
+  InlineVector& operator=(const InlineVector& other)
+  {
+    if (this != &other)
+    {
+      resize(other.size_);
+      std::copy(other.begin(), other.end(), begin());
+    }
+    return *this;
+  }
+
+  ~InlineVector()
+  {
+    if (!IsInline())
+    {
+      delete[] data_;
+    }
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Grown elements are value-initialized, matching std::vector::resize.
+  void resize(std::size_t new_size)
+  {
+    if (new_size > capacity_)
+    {
+      Grow(std::max(new_size, 2 * capacity_));
+    }
+    for (std::size_t i = size_; i < new_size; i++)
+    {
+      data_[i] = T();
+    }
+    size_ = new_size;
+  }
+
+  void clear() { size_ = 0; }
+
+  void push_back(const T& value)
+  {
+    if (size_ == capacity_)
+    {
+      Grow(2 * capacity_);
+    }
+    data_[size_++] = value;
+  }
+
+  T& operator [] (std::size_t i) { return data_[i]; }
+  const T& operator [] (std::size_t i) const { return data_[i]; }
+
+  T& at(std::size_t i)
+  {
+    assert(i < size_);
+    return data_[i];
+  }
+  const T& at(std::size_t i) const
+  {
+    assert(i < size_);
+    return data_[i];
+  }
+
+  T& back() { return data_[size_ - 1]; }
+  const T& back() const { return data_[size_ - 1]; }
+
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+  T* begin() { return data_; }
+  const T* begin() const { return data_; }
+  T* end() { return data_ + size_; }
+  const T* end() const { return data_ + size_; }
+
+  void fill(const T& value) { std::fill(begin(), end(), value); }
+
+  operator std::vector<T>() const
+  {
+    return std::vector<T>(begin(), end());
+  }
+
+  bool operator == (const InlineVector& other) const
+  {
+    return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+  }
+
+ private:
+  // Serialization
+  friend class boost::serialization::access;
+
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const
+  {
+    (void) version;
+    ar& BOOST_SERIALIZATION_NVP(size_);
+    for (std::size_t i = 0; i < size_; i++)
+    {
+      ar& boost::serialization::make_nvp("item", data_[i]);
+    }
+  }
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version)
+  {
+    (void) version;
+    std::size_t size;
+    ar& boost::serialization::make_nvp("size_", size);
+    resize(size);
+    for (std::size_t i = 0; i < size_; i++)
+    {
+      ar& boost::serialization::make_nvp("item", data_[i]);
+    }
+  }
+
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+};
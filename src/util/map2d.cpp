@@ -34,6 +34,7 @@
 // Could use some cleanup and templatization.
 // ------------------------------------------------------------------------
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -122,3 +123,130 @@ void WriteCPPHeader(const Map2D& map, std::string name, std::string prefix)
   
   hdrfile.close();
 }
+
+//
+// SparseMap2D.
+//
+
+SparseMap2D::SparseMap2D()
+{
+  row_starts_.push_back(0);
+}
+
+SparseMap2D::SparseMap2D(const Map2D& map)
+{
+  row_keys_.reserve(map.size());
+  row_starts_.reserve(map.size() + 1);
+  row_starts_.push_back(0);
+
+  // std::map iteration is already key-ordered, so the flattened arrays
+  // come out sorted for free.
+  for (auto& row : map)
+  {
+    row_keys_.push_back(row.first);
+    for (auto& entry : row.second)
+    {
+      entries_.push_back({ entry.first, entry.second });
+    }
+    row_starts_.push_back(entries_.size());
+  }
+}
+
+SparseMap2D::SparseMap2D(std::vector<std::size_t> row_keys,
+                         std::vector<std::size_t> row_starts,
+                         std::vector<Entry> entries) :
+    row_keys_(row_keys),
+    row_starts_(row_starts),
+    entries_(entries)
+{
+  assert(row_starts_.size() == row_keys_.size() + 1);
+  assert(row_starts_.back() == entries_.size());
+}
+
+std::size_t SparseMap2D::Size() const
+{
+  return entries_.size();
+}
+
+const SparseMap2D::Entry* SparseMap2D::RowBegin(std::size_t row) const
+{
+  auto it = std::lower_bound(row_keys_.begin(), row_keys_.end(), row);
+  if (it == row_keys_.end() || *it != row)
+  {
+    return nullptr;
+  }
+  return entries_.data() + row_starts_.at(it - row_keys_.begin());
+}
+
+const SparseMap2D::Entry* SparseMap2D::RowEnd(std::size_t row) const
+{
+  auto it = std::lower_bound(row_keys_.begin(), row_keys_.end(), row);
+  if (it == row_keys_.end() || *it != row)
+  {
+    return nullptr;
+  }
+  return entries_.data() + row_starts_.at(it - row_keys_.begin() + 1);
+}
+
+bool SparseMap2D::Lookup(std::size_t row, std::size_t col, double& value) const
+{
+  auto begin = RowBegin(row);
+  auto end = RowEnd(row);
+  if (begin == nullptr)
+  {
+    return false;
+  }
+
+  auto it = std::lower_bound(begin, end, col,
+                             [](const Entry& entry, std::size_t key)
+                             { return entry.key < key; });
+  if (it == end || it->key != col)
+  {
+    return false;
+  }
+  value = it->value;
+  return true;
+}
+
+//
+// Generate a sparse map by reading a CSV file.
+//
+SparseMap2D ReadCSVSparse(std::string name, std::string prefix)
+{
+  return SparseMap2D(ReadCSV(name, prefix));
+}
+
+//
+// Dump sparse map in C++ syntax.
+//
+void WriteCPPHeader(const SparseMap2D& map, std::string name, std::string prefix)
+{
+  std::ofstream hdrfile(prefix + ".hpp");
+
+  hdrfile << "#pragma once" << std::endl;
+  hdrfile << "SparseMap2D " << name << "(" << std::endl;
+
+  hdrfile << "  {";
+  for (std::size_t row = 0; row < map.RowKeys().size(); row++)
+  {
+    hdrfile << (row == 0 ? " " : ", ") << map.RowKeys().at(row);
+  }
+  hdrfile << " }," << std::endl;
+
+  hdrfile << "  {";
+  for (std::size_t row = 0; row < map.RowStarts().size(); row++)
+  {
+    hdrfile << (row == 0 ? " " : ", ") << map.RowStarts().at(row);
+  }
+  hdrfile << " }," << std::endl;
+
+  hdrfile << "  {" << std::endl;
+  for (std::size_t i = 0; i < map.Entries().size(); i++)
+  {
+    hdrfile << "    { " << map.Entries().at(i).key << ", "
+            << map.Entries().at(i).value << " }," << std::endl;
+  }
+  hdrfile << "  });" << std::endl;
+
+  hdrfile.close();
+}
@@ -36,11 +36,69 @@
 // Could use some cleanup and templatization.
 // ------------------------------------------------------------------------
 
+#include <cstddef>
 #include <map>
 #include <string>
+#include <vector>
 
 typedef std::map<std::size_t, double> Map1D;
 typedef std::map<std::size_t, Map1D> Map2D;
 
 Map2D ReadCSV(std::string name, std::string prefix);
 void WriteCPPHeader(const Map2D& map, std::string name, std::string prefix);
+
+// ------------------------------------------------------------------------
+// Block-compressed sparse alternative to Map2D. The tree-of-trees layout
+// above allocates a node per entry and chases pointers on every lookup;
+// here the same table is three contiguous arrays (sorted row keys, row
+// start offsets, and per-row entry blocks sorted by column key), so a
+// lookup is two binary searches over cache-resident memory. Intended for
+// the CSV-derived energy/area interpolation tables consulted during spec
+// construction.
+// ------------------------------------------------------------------------
+
+class SparseMap2D
+{
+ public:
+  struct Entry
+  {
+    std::size_t key;
+    double value;
+  };
+
+ private:
+  // Sorted row (width) keys, parallel to row_starts_: row r's entries
+  // occupy entries_[row_starts_[r], row_starts_[r+1]).
+  std::vector<std::size_t> row_keys_;
+  std::vector<std::size_t> row_starts_;
+  std::vector<Entry> entries_;
+
+ public:
+  SparseMap2D();
+
+  // Flatten a Map2D (e.g. fresh out of ReadCSV()).
+  SparseMap2D(const Map2D& map);
+
+  // Raw-array constructor, used by the WriteCPPHeader() output.
+  SparseMap2D(std::vector<std::size_t> row_keys,
+              std::vector<std::size_t> row_starts,
+              std::vector<Entry> entries);
+
+  std::size_t Size() const;
+
+  // Exact lookup; returns false if (row, col) has no entry.
+  bool Lookup(std::size_t row, std::size_t col, double& value) const;
+
+  // The contiguous entry block of a row, for interpolation over
+  // neighboring column keys; returns an empty span for missing rows.
+  const Entry* RowBegin(std::size_t row) const;
+  const Entry* RowEnd(std::size_t row) const;
+
+  // Raw-array accessors, used by WriteCPPHeader().
+  const std::vector<std::size_t>& RowKeys() const { return row_keys_; }
+  const std::vector<std::size_t>& RowStarts() const { return row_starts_; }
+  const std::vector<Entry>& Entries() const { return entries_; }
+};
+
+SparseMap2D ReadCSVSparse(std::string name, std::string prefix);
+void WriteCPPHeader(const SparseMap2D& map, std::string name, std::string prefix);
@@ -27,13 +27,20 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <utility>
 #include <iostream>
 #include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <fstream>
 #include <map>
+#include <mutex>
 #include <random>
+#include <sstream>
+#include <tuple>
 #include <boost/multiprecision/cpp_int.hpp>
 
 using namespace boost::multiprecision;
@@ -42,6 +49,11 @@ using namespace boost::multiprecision;
 //              Factors
 //------------------------------------
 
+// Design-space runs re-Init mapspaces once per layer, re-factorizing the
+// same handful of workload bounds each time; the process-wide memo below
+// makes every Factors construction after the first a table lookup.
+static bool gEnableFactorsMemo = (getenv("TIMELOOP_DISABLE_FACTORS_MEMO") == NULL);
+
 typedef std::pair<unsigned long, int> Factor;
 
 class Factors
@@ -74,20 +86,101 @@ class Factors
     return res;
   }
 
+  // Primes up to at least limit, grown on demand by re-sieving. Limits are
+  // small (square roots of loop bounds) and growth is rare.
+  static const std::vector<unsigned long>& Primes_(unsigned long limit)
+  {
+    static std::vector<unsigned long> primes;
+    static unsigned long sieved_to = 1;
+    if (limit > sieved_to)
+    {
+      unsigned long new_limit = std::max(limit, std::max(sieved_to * 2, 256UL));
+      std::vector<bool> composite(new_limit + 1, false);
+      primes.clear();
+      for (unsigned long p = 2; p <= new_limit; p++)
+      {
+        if (!composite[p])
+        {
+          primes.push_back(p);
+          for (unsigned long m = p * p; m <= new_limit; m += p)
+          {
+            composite[m] = true;
+          }
+        }
+      }
+      sieved_to = new_limit;
+    }
+    return primes;
+  }
+
   void CalculateAllFactors_()
   {
     all_factors_.clear();
-    for (unsigned long i = 1; i <= ISqrt_(n_); i++)
+    if (n_ == 0)
     {
-      if (n_ % i == 0)
+      return;
+    }
+
+    // Factorize n over the precomputed primes (only primes up to sqrt(n)
+    // need to be tried) instead of trial-dividing by every integer up to
+    // sqrt(n).
+    unsigned long sqrt_n = ISqrt_(n_);
+    std::vector<Factor> prime_factors;
+    unsigned long residue = n_;
+    for (auto p : Primes_(sqrt_n))
+    {
+      if (p * p > residue)
       {
-        all_factors_.push_back(i);
-        if (i * i != n_)
+        break;
+      }
+      int power = 0;
+      while (residue % p == 0)
+      {
+        residue /= p;
+        power++;
+      }
+      if (power > 0)
+      {
+        prime_factors.push_back(std::make_pair(p, power));
+      }
+    }
+    if (residue > 1)
+    {
+      prime_factors.push_back(std::make_pair(residue, 1));
+    }
+
+    // Expand the prime powers into the divisor set.
+    std::vector<unsigned long> divisors = { 1 };
+    for (auto& pf : prime_factors)
+    {
+      std::size_t num_divisors = divisors.size();
+      unsigned long power = 1;
+      for (int i = 0; i < pf.second; i++)
+      {
+        power *= pf.first;
+        for (std::size_t d = 0; d < num_divisors; d++)
         {
-          all_factors_.push_back(n_ / i);
+          divisors.push_back(divisors[d] * power);
         }
       }
     }
+    std::sort(divisors.begin(), divisors.end());
+
+    // Emit divisors as (i, n/i) pairs in ascending order of i, preserving the
+    // enumeration order of the old trial-division loop (and therefore the
+    // meaning of existing factorization-space IDs).
+    for (auto i : divisors)
+    {
+      if (i > sqrt_n)
+      {
+        break;
+      }
+      all_factors_.push_back(i);
+      if (i * i != n_)
+      {
+        all_factors_.push_back(n_ / i);
+      }
+    }
   }
 
   // Return a vector of all order-way cofactor sets of n.
@@ -133,13 +226,166 @@ class Factors
     }
   }
 
+  // Process-wide memo of fully-constructed factorizations, keyed by
+  // (n, order, given factors). PruneMax() mutates cofactors_ in place, so
+  // hits copy out of the table rather than aliasing it. The mutex only
+  // guards the table; construction outside it may be duplicated across
+  // threads but is idempotent.
+  typedef std::tuple<unsigned long, int, std::map<unsigned, unsigned long>> MemoKey;
+  struct MemoEntry
+  {
+    std::vector<unsigned long> all_factors;
+    std::vector<std::vector<unsigned long>> cofactors;
+  };
+
+  static std::map<MemoKey, MemoEntry>& MemoTable_()
+  {
+    static std::map<MemoKey, MemoEntry> table;
+    return table;
+  }
+
+  static std::mutex& MemoMutex_()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  // Optional disk persistence of the memo, enabled by pointing
+  // TIMELOOP_FACTORS_CACHE at a cache file. The file is append-only: every
+  // freshly-computed factorization is appended as one line, and the whole
+  // file is replayed into the memo on first use, so a killed-and-resumed
+  // run pays the enumeration cost only for factorizations its previous
+  // incarnations never reached. The keys are exact, so entries are valid
+  // across workloads and architectures; loading stops at the first
+  // malformed (e.g., mid-write truncated) line.
+  static const char* CachePath_()
+  {
+    static const char* path = getenv("TIMELOOP_FACTORS_CACHE");
+    return path;
+  }
+
+  // Called once, with MemoMutex_ held.
+  static void LoadCache_()
+  {
+    if (CachePath_() == NULL)
+      return;
+
+    std::ifstream in(CachePath_());
+    unsigned long n;
+    int order;
+    std::size_t given_size;
+    while (in >> n >> order >> given_size)
+    {
+      std::map<unsigned, unsigned long> given;
+      MemoEntry entry;
+      bool ok = true;
+
+      for (std::size_t i = 0; ok && i < given_size; i++)
+      {
+        unsigned index;
+        unsigned long value;
+        if (in >> index >> value)
+          given[index] = value;
+        else
+          ok = false;
+      }
+
+      std::size_t num_factors = 0;
+      ok = ok && bool(in >> num_factors);
+      for (std::size_t i = 0; ok && i < num_factors; i++)
+      {
+        unsigned long factor;
+        if (in >> factor)
+          entry.all_factors.push_back(factor);
+        else
+          ok = false;
+      }
+
+      std::size_t num_sets = 0;
+      ok = ok && bool(in >> num_sets);
+      for (std::size_t i = 0; ok && i < num_sets; i++)
+      {
+        std::vector<unsigned long> cofactors(order);
+        for (int j = 0; ok && j < order; j++)
+        {
+          if (!(in >> cofactors[j]))
+            ok = false;
+        }
+        if (ok)
+          entry.cofactors.push_back(cofactors);
+      }
+
+      if (!ok)
+        break;
+
+      MemoTable_()[MemoKey(n, order, given)] = entry;
+    }
+  }
+
+  // Called with MemoMutex_ held.
+  void AppendToCache_(const MemoKey& key)
+  {
+    if (CachePath_() == NULL)
+      return;
+
+    std::ofstream out(CachePath_(), std::ios::app);
+    if (!out)
+      return;
+
+    std::ostringstream line;
+    line << std::get<0>(key) << ' ' << std::get<1>(key);
+    auto& given = std::get<2>(key);
+    line << ' ' << given.size();
+    for (auto& g : given)
+      line << ' ' << g.first << ' ' << g.second;
+    line << ' ' << all_factors_.size();
+    for (auto f : all_factors_)
+      line << ' ' << f;
+    line << ' ' << cofactors_.size();
+    for (auto& cofactors : cofactors_)
+      for (auto c : cofactors)
+        line << ' ' << c;
+    line << '\n';
+    out << line.str();
+  }
+
+  bool LookupMemo_(const MemoKey& key)
+  {
+    if (!gEnableFactorsMemo)
+      return false;
+    std::lock_guard<std::mutex> lock(MemoMutex_());
+    static bool cache_loaded = (LoadCache_(), true);
+    (void) cache_loaded;
+    auto it = MemoTable_().find(key);
+    if (it == MemoTable_().end())
+      return false;
+    all_factors_ = it->second.all_factors;
+    cofactors_ = it->second.cofactors;
+    return true;
+  }
+
+  void InsertMemo_(const MemoKey& key)
+  {
+    if (!gEnableFactorsMemo)
+      return;
+    std::lock_guard<std::mutex> lock(MemoMutex_());
+    MemoTable_()[key] = { all_factors_, cofactors_ };
+    AppendToCache_(key);
+  }
+
  public:
   Factors() : n_(0) {}
 
   Factors(const unsigned long n, const int order) : n_(n), cofactors_()
   {
+    MemoKey key(n, order, std::map<unsigned, unsigned long>());
+    if (LookupMemo_(key))
+      return;
+
     CalculateAllFactors_();
     cofactors_ = MultiplicativeSplitRecursive_(n, order);
+
+    InsertMemo_(key);
   }
 
   Factors(const unsigned long n, const int order, std::map<unsigned, unsigned long> given)
@@ -147,6 +393,12 @@ class Factors
   {
     assert(given.size() <= std::size_t(order));
 
+    // Key on the caller's given-factor map; the local copy may be edited
+    // below if a given factor turns out not to divide n.
+    MemoKey key(n, order, given);
+    if (LookupMemo_(key))
+      return;
+
     // If any of the given factors is not a factor of n, forcibly reset that to
     // be a free variable, otherwise accumulate them into a partial product.
     unsigned long partial_product = 1;
@@ -203,6 +455,8 @@ class Factors
         cofactors.insert(cofactors.begin() + index, value);
       }
     }
+
+    InsertMemo_(key);
   }
 
   void PruneMax(std::map<unsigned, unsigned long>& max)
@@ -302,6 +556,15 @@ class CartesianCounter
   checked_uint128_t integer_;
   checked_uint128_t endint_;
 
+  // 64-bit fast path: when the full counter range fits in 64 bits (the
+  // overwhelmingly common case -- mapspace sizes run ~1e9-1e15), the
+  // decode/encode loops below run on native integers and the
+  // multi-precision type is only touched to store the results. Set by
+  // Init() from the product of the bases, which also bounds every
+  // intermediate, so the native arithmetic cannot overflow.
+  bool fits64_;
+  std::array<std::uint64_t, order> base64_;
+
   bool IncrementRecursive_(int position)
   {
     if (value_[position] < base_[position] - 1)
@@ -327,6 +590,19 @@ class CartesianCounter
 
   void UpdateIntegerFromValue()
   {
+    if (fits64_)
+    {
+      std::uint64_t integer = 0;
+      std::uint64_t base = 1;
+      for (int i = 0; i < order; i++)
+      {
+        integer += static_cast<std::uint64_t>(value_[i]) * base;
+        base *= base64_[i];
+      }
+      integer_ = integer;
+      return;
+    }
+
     integer_ = 0;
     checked_uint128_t base = 1;
     for (int i = 0; i < order; i++)
@@ -338,6 +614,17 @@ class CartesianCounter
 
   void UpdateValueFromInteger()
   {
+    if (fits64_)
+    {
+      std::uint64_t n = static_cast<std::uint64_t>(uint128_t(integer_));
+      for (int i = 0; i < order; i++)
+      {
+        value_[i] = n % base64_[i];
+        n = n / base64_[i];
+      }
+      return;
+    }
+
     uint128_t n = integer_;
     for (int i = 0; i < order; i++)
     {
@@ -363,6 +650,13 @@ class CartesianCounter
       base_[i] = base[i];
       endint_ *= checked_uint128_t(base_[i]);
     }
+
+    fits64_ = (endint_ <= std::numeric_limits<std::uint64_t>::max());
+    if (fits64_)
+    {
+      for (int i = 0; i < order; i++)
+        base64_[i] = static_cast<std::uint64_t>(base_[i]);
+    }
   }
 
   bool Increment()
@@ -432,6 +726,10 @@ class CartesianCounterDynamic
   checked_uint128_t integer_;
   checked_uint128_t endint_;
 
+  // 64-bit fast path; see CartesianCounter above.
+  bool fits64_ = false;
+  std::vector<std::uint64_t> base64_;
+
   bool IncrementRecursive_(int position)
   {
     if (value_[position] < base_[position] - 1)
@@ -457,6 +755,19 @@ class CartesianCounterDynamic
 
   void UpdateIntegerFromValue()
   {
+    if (fits64_)
+    {
+      std::uint64_t integer = 0;
+      std::uint64_t base = 1;
+      for (int i = 0; i < order_; i++)
+      {
+        integer += static_cast<std::uint64_t>(value_[i]) * base;
+        base *= base64_[i];
+      }
+      integer_ = integer;
+      return;
+    }
+
     integer_ = 0;
     checked_uint128_t base = 1;
     for (int i = 0; i < order_; i++)
@@ -468,6 +779,17 @@ class CartesianCounterDynamic
 
   void UpdateValueFromInteger()
   {
+    if (fits64_)
+    {
+      std::uint64_t n = static_cast<std::uint64_t>(uint128_t(integer_));
+      for (int i = 0; i < order_; i++)
+      {
+        value_[i] = n % base64_[i];
+        n = n / base64_[i];
+      }
+      return;
+    }
+
     uint128_t n = integer_;
     for (int i = 0; i < order_; i++)
     {
@@ -503,6 +825,14 @@ class CartesianCounterDynamic
       endint_ *= checked_uint128_t(base_[i]);
       value_[i] = 0;
     }
+
+    fits64_ = (endint_ <= std::numeric_limits<std::uint64_t>::max());
+    if (fits64_)
+    {
+      base64_.resize(order_);
+      for (int i = 0; i < order_; i++)
+        base64_[i] = static_cast<std::uint64_t>(base_[i]);
+    }
   }
 
   bool Increment()
@@ -526,6 +856,80 @@ class CartesianCounterDynamic
     return value_[dim];
   }
 
+  // Decode a strided run of count IDs starting at start in one pass. Only
+  // the first ID pays the per-position multi-precision divmods; each
+  // subsequent ID is derived by digit-wise addition of the (pre-decomposed)
+  // stride with carry propagation. Returns a structure-of-arrays block:
+  // one vector per counter position, each holding count digits. The counter
+  // is left parked at the last decoded ID.
+  std::vector<std::vector<uint128_t>> ReadBatch(uint128_t start, std::uint64_t count,
+                                                uint128_t stride = 1)
+  {
+    assert(order_ != 0);
+    assert(count > 0);
+    assert(checked_uint128_t(start) + checked_uint128_t(stride) * (count - 1) < endint_);
+
+    // Decompose the stride into counter digits, once.
+    std::vector<uint128_t> stride_digits(order_);
+    if (fits64_)
+    {
+      std::uint64_t s = static_cast<std::uint64_t>(stride);
+      for (int i = 0; i < order_; i++)
+      {
+        stride_digits[i] = s % base64_[i];
+        s = s / base64_[i];
+      }
+    }
+    else
+    {
+      uint128_t s = stride;
+      for (int i = 0; i < order_; i++)
+      {
+        stride_digits[i] = s % base_[i];
+        s = s / base_[i];
+      }
+    }
+
+    Set(start);
+
+    std::vector<std::vector<uint128_t>> digits(order_);
+    for (int i = 0; i < order_; i++)
+    {
+      digits[i].reserve(count);
+    }
+
+    for (std::uint64_t n = 0; n < count; n++)
+    {
+      if (n != 0)
+      {
+        // Advance by the stride. Each digit sum is < 2 * base, so a single
+        // conditional subtraction and a 0/1 carry suffice.
+        uint128_t carry = 0;
+        for (int i = 0; i < order_; i++)
+        {
+          value_[i] += stride_digits[i] + carry;
+          if (value_[i] >= base_[i])
+          {
+            value_[i] -= base_[i];
+            carry = 1;
+          }
+          else
+          {
+            carry = 0;
+          }
+        }
+        integer_ += stride;
+      }
+
+      for (int i = 0; i < order_; i++)
+      {
+        digits[i].push_back(value_[i]);
+      }
+    }
+
+    return digits;
+  }
+
   void Set(uint128_t n)
   {
     assert(order_ != 0);
@@ -608,6 +1012,40 @@ class Factoradic
       }
     }
   }
+
+  // Inverse of Permute(): given a target arrangement of the same elements,
+  // recover the index that Permute() would consume to transform buffer
+  // into it. The buffer is edited in place with the same rotations
+  // Permute() applies, so on return it matches the target.
+  std::uint64_t Rank(T* buffer, const T* target, std::size_t length)
+  {
+    if (length < 2)
+    {
+      return 0;
+    }
+
+    std::uint64_t scale = factorial_table_[length];
+    std::uint64_t index = 0;
+
+    for (std::size_t i = 0; i < length - 1; i++)
+    {
+      scale /= (std::uint64_t)(length - i);
+      std::size_t d = 0;
+      while (d < length - i && !(buffer[i + d] == target[i]))
+      {
+        d++;
+      }
+      assert(d < length - i);
+      index += d * scale;
+      if (d > 0)
+      {
+        const T c = buffer[i + d];
+        memmove(buffer + i + 1, buffer + i, d * sizeof(T));
+        buffer[i] = c;
+      }
+    }
+    return index;
+  }
 };
 
 //------------------------------------
@@ -627,6 +1065,12 @@ class PatternGenerator128
   }
 
   virtual uint128_t Next() = 0;
+
+  // Checkpoint support: save/restore the generator's position so a resumed
+  // search replays the same stream. Generators without internal state keep
+  // the no-op defaults.
+  virtual void SaveState(std::ostream& out) { (void) out; }
+  virtual void LoadState(std::istream& in) { (void) in; }
 };
 
 class SequenceGenerator128 final : public PatternGenerator128
@@ -657,6 +1101,16 @@ class SequenceGenerator128 final : public PatternGenerator128
     }
     return retval;
   }
+
+  void SaveState(std::ostream& out)
+  {
+    out << cur_ << '\n';
+  }
+
+  void LoadState(std::istream& in)
+  {
+    in >> cur_;
+  }
 };
 
 class RandomGenerator128 final : public PatternGenerator128
@@ -689,9 +1143,19 @@ class RandomGenerator128 final : public PatternGenerator128
 
     uint128_t rand = low + ((uint128_t)high * uint64_max_);
     assert(rand < bound_);
-    
+
     return rand;
   }
+
+  void SaveState(std::ostream& out)
+  {
+    out << engine_ << '\n';
+  }
+
+  void LoadState(std::istream& in)
+  {
+    in >> engine_;
+  }
 };
 
 //------------------------------------
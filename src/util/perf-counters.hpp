@@ -0,0 +1,266 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "util/cycle-timer.hpp"
+
+// Per-thread hardware performance counters (cycles, instructions, LLC
+// misses, branch misses) via the Linux perf_event interface. Each thread
+// lazily opens one counter group on itself, so unlike system-wide perf
+// the readings are attributable to a specific worker thread, and the
+// Scope class slices them along the same phase boundaries as the cycle
+// timers -- enough to tell a memory-bound phase (high LLC misses per
+// instruction) from a branch-bound one.
+//
+// Compiled out by default: without the TIMELOOP_ENABLE_PERF_COUNTERS
+// preprocessor flag (scons --perf-counters), scopes are empty objects and
+// reads yield zeros. Reads also yield zeros if the kernel refuses
+// perf_event_open (see /proc/sys/kernel/perf_event_paranoid).
+
+#if defined(TIMELOOP_ENABLE_PERF_COUNTERS) && defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perf
+{
+
+enum class Counter : unsigned
+{
+  Cycles = 0,
+  Instructions,
+  LLCMisses,
+  BranchMisses,
+  Num
+};
+
+const unsigned NumCounters = unsigned(Counter::Num);
+
+inline const char* CounterName(unsigned counter)
+{
+  switch (Counter(counter))
+  {
+    case Counter::Cycles:       return "cycles";
+    case Counter::Instructions: return "instructions";
+    case Counter::LLCMisses:    return "LLC misses";
+    case Counter::BranchMisses: return "branch misses";
+    default:                    return "unknown";
+  }
+}
+
+typedef std::array<std::uint64_t, NumCounters> CounterValues;
+typedef std::array<CounterValues, timer::NumPhases> PhaseCounters;
+
+#if defined(TIMELOOP_ENABLE_PERF_COUNTERS) && defined(__linux__)
+
+struct ThreadState
+{
+  int group_fd = -1;
+  // Position of each Counter in the group's read buffer, or -1 if that
+  // event failed to open (the kernel may lack e.g. an LLC-miss event).
+  std::array<int, NumCounters> slot;
+  unsigned num_open = 0;
+  PhaseCounters phase = {};
+  std::array<unsigned, timer::NumPhases> depth = {};
+
+  static int Open(std::uint64_t config, int leader_fd)
+  {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (leader_fd == -1) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    // pid = 0, cpu = -1: count this thread, on whatever CPU it runs on.
+    return int(syscall(__NR_perf_event_open, &attr, 0, -1, leader_fd, 0));
+  }
+
+  ThreadState()
+  {
+    slot.fill(-1);
+
+    const std::array<std::uint64_t, NumCounters> configs =
+    {{
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES
+    }};
+
+    for (unsigned c = 0; c < NumCounters; c++)
+    {
+      int fd = Open(configs[c], group_fd);
+      if (fd == -1)
+      {
+        if (c == unsigned(Counter::Cycles))
+        {
+          // No group leader: the whole facility is unavailable.
+          static std::once_flag warn_once;
+          std::call_once(warn_once, []()
+          {
+            std::cerr << "WARNING: perf_event_open failed ("
+                      << std::strerror(errno) << "); hardware counters "
+                      << "disabled. Check /proc/sys/kernel/perf_event_paranoid."
+                      << std::endl;
+          });
+          return;
+        }
+        continue;
+      }
+      if (group_fd == -1)
+      {
+        group_fd = fd;
+      }
+      slot[c] = int(num_open++);
+    }
+
+    ioctl(group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  ~ThreadState()
+  {
+    // Closing the group leader tears down the siblings too.
+    if (group_fd != -1)
+    {
+      close(group_fd);
+    }
+  }
+};
+
+inline ThreadState& State()
+{
+  static thread_local ThreadState state;
+  return state;
+}
+
+// Snapshot of the calling thread's counters since they were opened
+// (i.e., since this thread's first perf:: call). Zeros if unavailable.
+inline CounterValues Read()
+{
+  auto& state = State();
+  CounterValues values = {};
+  if (state.group_fd == -1)
+  {
+    return values;
+  }
+
+  // PERF_FORMAT_GROUP layout: nr, then one u64 per open event.
+  std::uint64_t buffer[1 + NumCounters] = {};
+  if (read(state.group_fd, buffer, sizeof(buffer)) < 0)
+  {
+    return values;
+  }
+  for (unsigned c = 0; c < NumCounters; c++)
+  {
+    if (state.slot[c] != -1)
+    {
+      values[c] = buffer[1 + state.slot[c]];
+    }
+  }
+  return values;
+}
+
+// Accumulates the counter deltas spent inside a phase into the calling
+// thread's per-phase totals. Recursion-safe like timer::Scope: only the
+// outermost scope of each phase accumulates.
+class Scope
+{
+ public:
+  Scope(timer::Phase phase) :
+      phase_(unsigned(phase))
+  {
+    auto& state = State();
+    if (state.depth[phase_]++ == 0)
+    {
+      start_ = Read();
+    }
+  }
+
+  ~Scope()
+  {
+    auto& state = State();
+    if (--state.depth[phase_] == 0)
+    {
+      auto now = Read();
+      for (unsigned c = 0; c < NumCounters; c++)
+      {
+        state.phase[phase_][c] += now[c] - start_[c];
+      }
+    }
+  }
+
+ private:
+  unsigned phase_;
+  CounterValues start_ = {};
+};
+
+// Snapshot of the calling thread's accumulated per-phase counters.
+inline PhaseCounters ReadPhases()
+{
+  return State().phase;
+}
+
+#else
+
+// Counters compiled out (or not on Linux): scopes are empty objects and
+// reads yield zeros.
+class Scope
+{
+ public:
+  Scope(timer::Phase phase)
+  {
+    (void) phase;
+  }
+};
+
+inline CounterValues Read()
+{
+  return CounterValues{};
+}
+
+inline PhaseCounters ReadPhases()
+{
+  return PhaseCounters{};
+}
+
+#endif // TIMELOOP_ENABLE_PERF_COUNTERS && __linux__
+
+} // namespace perf
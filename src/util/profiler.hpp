@@ -0,0 +1,280 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+// Hierarchical scope profiler for attributing time to subsystems. Unlike
+// the flat per-phase counters in cycle-timer.hpp, scopes nest: each RAII
+// Scope("name") becomes a node under the enclosing scope in a per-thread
+// call tree, accumulating inclusive cycles and invocation counts with no
+// locking on the hot path. Report() merges all threads' trees by scope
+// name and prints them with inclusive and exclusive times.
+//
+// Compiled out by default: without the TIMELOOP_ENABLE_PROFILER
+// preprocessor flag (scons --profiler), scopes are empty objects and
+// Report() prints nothing.
+
+#ifdef TIMELOOP_ENABLE_PROFILER
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <chrono>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace profiler
+{
+
+#ifdef TIMELOOP_ENABLE_PROFILER
+
+inline std::uint64_t ReadCycles()
+{
+#if defined(__x86_64__)
+  return __rdtsc();
+#else
+  // No cheap cycle counter available from user space; fall back to a
+  // monotonic nanosecond clock (so "cycles" are really nanoseconds).
+  return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// One node of a thread's call tree. Children are found by name with a
+// linear scan: scope trees are shallow and narrow (a handful of names per
+// level), so this beats hashing on the hot path.
+struct Node
+{
+  const char* name;
+  Node* parent;
+  std::uint64_t cycles = 0;
+  std::uint64_t calls = 0;
+  std::vector<std::unique_ptr<Node>> children;
+
+  Node(const char* _name, Node* _parent) :
+      name(_name), parent(_parent)
+  {
+  }
+
+  Node* Child(const char* child_name)
+  {
+    for (auto& child: children)
+    {
+      // Scope names are string literals, so pointer equality catches the
+      // common case; strcmp handles identical literals across TUs.
+      if (child->name == child_name || std::strcmp(child->name, child_name) == 0)
+      {
+        return child.get();
+      }
+    }
+    children.emplace_back(new Node(child_name, this));
+    return children.back().get();
+  }
+};
+
+// Registry of all threads' root nodes, so Report() can merge them after
+// the worker threads have been joined. Roots are shared_ptrs: a thread's
+// tree outlives the thread itself.
+struct Registry
+{
+  std::mutex mutex;
+  std::vector<std::shared_ptr<Node>> roots;
+
+  static Registry& Get()
+  {
+    static Registry registry;
+    return registry;
+  }
+};
+
+struct ThreadState
+{
+  std::shared_ptr<Node> root;
+  Node* current;
+
+  ThreadState() :
+      root(std::make_shared<Node>("thread", nullptr)),
+      current(root.get())
+  {
+    auto& registry = Registry::Get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.roots.push_back(root);
+  }
+};
+
+inline ThreadState& State()
+{
+  static thread_local ThreadState state;
+  return state;
+}
+
+class Scope
+{
+ public:
+  Scope(const char* name)
+  {
+    auto& state = State();
+    node_ = state.current->Child(name);
+    node_->calls++;
+    state.current = node_;
+    start_ = ReadCycles();
+  }
+
+  ~Scope()
+  {
+    node_->cycles += ReadCycles() - start_;
+    State().current = node_->parent;
+  }
+
+ private:
+  Node* node_;
+  std::uint64_t start_;
+};
+
+// Name-merged view of the per-thread trees, built at report time.
+struct MergedNode
+{
+  std::string name;
+  std::uint64_t cycles = 0;
+  std::uint64_t calls = 0;
+  std::vector<MergedNode> children;
+
+  MergedNode& Child(const char* child_name)
+  {
+    for (auto& child: children)
+    {
+      if (child.name == child_name)
+      {
+        return child;
+      }
+    }
+    children.push_back(MergedNode{ child_name, 0, 0, {} });
+    return children.back();
+  }
+};
+
+inline void MergeInto(MergedNode& dst, const Node& src)
+{
+  dst.cycles += src.cycles;
+  dst.calls += src.calls;
+  for (auto& child: src.children)
+  {
+    MergeInto(dst.Child(child->name), *child);
+  }
+}
+
+inline void PrintNode(std::ostream& out, const MergedNode& node,
+                      std::uint64_t total, unsigned depth)
+{
+  std::uint64_t children_cycles = 0;
+  for (auto& child: node.children)
+  {
+    children_cycles += child.cycles;
+  }
+  std::uint64_t exclusive =
+    node.cycles > children_cycles ? node.cycles - children_cycles : 0;
+
+  out << "  " << std::setw(44)
+      << std::left << (std::string(2 * depth, ' ') + node.name) << std::right
+      << std::setw(16) << node.cycles
+      << std::setw(7) << std::fixed << std::setprecision(1)
+      << (total > 0 ? 100.0 * node.cycles / total : 0.0) << "%"
+      << std::setw(16) << exclusive
+      << std::setw(12) << node.calls
+      << std::endl;
+
+  for (auto& child: node.children)
+  {
+    PrintNode(out, child, total, depth + 1);
+  }
+}
+
+// Merge all threads' trees by scope name and print them. Meant to be
+// called after the instrumented threads have been joined.
+inline void Report(std::ostream& out)
+{
+  MergedNode merged{ "all threads", 0, 0, {} };
+  {
+    auto& registry = Registry::Get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto& root: registry.roots)
+    {
+      MergeInto(merged, *root);
+    }
+  }
+
+  if (merged.children.empty())
+  {
+    return;
+  }
+
+  std::uint64_t total = 0;
+  for (auto& child: merged.children)
+  {
+    total += child.cycles;
+  }
+
+  out << "Profile (all threads, merged by scope name):" << std::endl;
+  out << "  " << std::setw(44) << std::left << "scope" << std::right
+      << std::setw(16) << "inclusive"
+      << std::setw(8) << "%"
+      << std::setw(16) << "exclusive"
+      << std::setw(12) << "calls"
+      << std::endl;
+  for (auto& child: merged.children)
+  {
+    PrintNode(out, child, total, 0);
+  }
+}
+
+#else
+
+// Profiler compiled out: scopes are empty objects, reports print nothing.
+class Scope
+{
+ public:
+  Scope(const char* name)
+  {
+    (void) name;
+  }
+};
+
+inline void Report(std::ostream& out)
+{
+  (void) out;
+}
+
+#endif // TIMELOOP_ENABLE_PROFILER
+
+} // namespace profiler
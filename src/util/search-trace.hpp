@@ -0,0 +1,167 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//
+// Append-only binary trace of the exact per-thread sequence of mappings a
+// search visited, including failed constructions -- unlike the results log
+// (util/results-log.hpp), which records only successful evaluations. The
+// replay driver (timeloop-replay) re-executes the identical sequence
+// through ConstructMapping/Evaluate without the search algorithm, which
+// isolates evaluation-path performance from search-decision variance.
+// Same file conventions as the results log: one file per mapper thread,
+// fixed header, fixed-size records, native byte order.
+//
+
+namespace searchtrace
+{
+
+const std::uint32_t kMagic = 0x54534c54u;  // "TLST"
+const std::uint32_t kVersion = 1;
+
+struct FileHeader
+{
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t record_size;
+  std::uint32_t thread_id;
+};
+
+// One attempted mapping, in visit order. The mapping ID is the flat
+// 128-bit per-split mapspace ID, stored as two 64-bit halves; the flags
+// record whether construction succeeded and (if so) whether the mapping
+// evaluated as valid.
+struct Record
+{
+  std::uint64_t mapping_id_lo;
+  std::uint64_t mapping_id_hi;
+  std::uint8_t construct_success;
+  std::uint8_t eval_success;
+  std::uint8_t pad[6];
+};
+
+static_assert(sizeof(FileHeader) == 16, "search-trace file header layout changed");
+static_assert(sizeof(Record) == 24, "search-trace record layout changed");
+
+// Buffered append-only writer, mirroring resultslog::Writer.
+class Writer
+{
+ private:
+  static const std::size_t kFlushRecords = 4096;
+
+  std::ofstream out_;
+  std::vector<Record> buffer_;
+
+  void Flush_()
+  {
+    if (!buffer_.empty())
+    {
+      out_.write(reinterpret_cast<const char*>(buffer_.data()),
+                 buffer_.size() * sizeof(Record));
+      buffer_.clear();
+    }
+  }
+
+ public:
+  Writer(const std::string& filename, std::uint32_t thread_id) :
+      out_(filename, std::ios::binary | std::ios::trunc)
+  {
+    buffer_.reserve(kFlushRecords);
+    FileHeader header = { kMagic, kVersion, sizeof(Record), thread_id };
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+
+  // This class does not support being copied
+  Writer(const Writer&) = delete;
+  Writer& operator=(const Writer&) = delete;
+
+  ~Writer()
+  {
+    Flush_();
+  }
+
+  bool IsOpen() const
+  {
+    return out_.good();
+  }
+
+  void Append(const Record& record)
+  {
+    buffer_.push_back(record);
+    if (buffer_.size() >= kFlushRecords)
+    {
+      Flush_();
+    }
+  }
+};
+
+// Sequential reader for one trace file.
+class Reader
+{
+ private:
+  std::ifstream in_;
+  FileHeader header_;
+  bool valid_;
+
+ public:
+  Reader(const std::string& filename) :
+      in_(filename, std::ios::binary),
+      header_(),
+      valid_(false)
+  {
+    if (in_.read(reinterpret_cast<char*>(&header_), sizeof(header_)))
+    {
+      valid_ = (header_.magic == kMagic &&
+                header_.version == kVersion &&
+                header_.record_size == sizeof(Record));
+    }
+  }
+
+  bool IsValid() const
+  {
+    return valid_;
+  }
+
+  const FileHeader& Header() const
+  {
+    return header_;
+  }
+
+  bool Next(Record& record)
+  {
+    return valid_ &&
+      bool(in_.read(reinterpret_cast<char*>(&record), sizeof(record)));
+  }
+};
+
+} // namespace searchtrace
@@ -25,11 +25,105 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+
+#include "util/alloc-tracker.hpp"
 #include "operation-space.hpp"
 
 namespace problem
 {
 
+// ======================================= //
+//         Built-in CNN-Layer shape        //
+// ======================================= //
+
+// Compile-time projection tables for the built-in CNN-Layer shape (see
+// Shape::InitBuiltin in problem-shape.cpp, which these IDs mirror). With
+// the structure fixed at compile time the projections below reduce to
+// straight-line multiply-adds instead of a walk over per-term expression
+// lists with a coefficient-existence branch on every term.
+namespace cnn
+{
+constexpr Shape::DimensionID R = 0, S = 1, P = 2, Q = 3, C = 4, K = 5, N = 6;
+constexpr Shape::CoefficientID Wstride = 0, Hstride = 1,
+                               Wdilation = 2, Hdilation = 3;
+constexpr Shape::DataSpaceID Weights = 0, Inputs = 1;
+}
+
+static inline void ProjectCNN(Shape::DataSpaceID d,
+                              const Workload* wc,
+                              const OperationPoint& p,
+                              Point& out)
+{
+  switch (d)
+  {
+    case cnn::Weights:
+      out[0] = p[cnn::C];
+      out[1] = p[cnn::K];
+      out[2] = p[cnn::R];
+      out[3] = p[cnn::S];
+      break;
+    case cnn::Inputs:
+      out[0] = p[cnn::N];
+      out[1] = p[cnn::C];
+      out[2] = p[cnn::R] * wc->GetCoefficient(cnn::Wdilation) +
+               p[cnn::P] * wc->GetCoefficient(cnn::Wstride);
+      out[3] = p[cnn::S] * wc->GetCoefficient(cnn::Hdilation) +
+               p[cnn::Q] * wc->GetCoefficient(cnn::Hstride);
+      break;
+    default: // Outputs
+      out[0] = p[cnn::N];
+      out[1] = p[cnn::K];
+      out[2] = p[cnn::Q];
+      out[3] = p[cnn::P];
+      break;
+  }
+}
+
+static inline void ProjectLowHighCNN(Shape::DataSpaceID d,
+                                     const Workload* wc,
+                                     const OperationPoint& lo,
+                                     const OperationPoint& hi,
+                                     Point& out_lo,
+                                     Point& out_hi)
+{
+  switch (d)
+  {
+    case cnn::Weights:
+      out_lo[0] = lo[cnn::C]; out_hi[0] = hi[cnn::C];
+      out_lo[1] = lo[cnn::K]; out_hi[1] = hi[cnn::K];
+      out_lo[2] = lo[cnn::R]; out_hi[2] = hi[cnn::R];
+      out_lo[3] = lo[cnn::S]; out_hi[3] = hi[cnn::S];
+      break;
+    case cnn::Inputs:
+    {
+      out_lo[0] = lo[cnn::N]; out_hi[0] = hi[cnn::N];
+      out_lo[1] = lo[cnn::C]; out_hi[1] = hi[cnn::C];
+      // min/max instead of a sign branch: handles (degenerate) negative
+      // strides/dilations the same way the generic path does.
+      auto wd = wc->GetCoefficient(cnn::Wdilation);
+      auto ws = wc->GetCoefficient(cnn::Wstride);
+      auto hd = wc->GetCoefficient(cnn::Hdilation);
+      auto hs = wc->GetCoefficient(cnn::Hstride);
+      out_lo[2] = std::min(lo[cnn::R] * wd, hi[cnn::R] * wd) +
+                  std::min(lo[cnn::P] * ws, hi[cnn::P] * ws);
+      out_hi[2] = std::max(lo[cnn::R] * wd, hi[cnn::R] * wd) +
+                  std::max(lo[cnn::P] * ws, hi[cnn::P] * ws);
+      out_lo[3] = std::min(lo[cnn::S] * hd, hi[cnn::S] * hd) +
+                  std::min(lo[cnn::Q] * hs, hi[cnn::Q] * hs);
+      out_hi[3] = std::max(lo[cnn::S] * hd, hi[cnn::S] * hd) +
+                  std::max(lo[cnn::Q] * hs, hi[cnn::Q] * hs);
+      break;
+    }
+    default: // Outputs
+      out_lo[0] = lo[cnn::N]; out_hi[0] = hi[cnn::N];
+      out_lo[1] = lo[cnn::K]; out_hi[1] = hi[cnn::K];
+      out_lo[2] = lo[cnn::Q]; out_hi[2] = hi[cnn::Q];
+      out_lo[3] = lo[cnn::P]; out_hi[3] = hi[cnn::P];
+      break;
+  }
+}
+
 // ======================================= //
 //              OperationSpace             //
 // ======================================= //
@@ -39,29 +133,46 @@ OperationSpace::OperationSpace(const Workload* wc) :
 {
   for (unsigned space_id = 0; space_id < wc->GetShape()->NumDataSpaces; space_id++)
     data_spaces_.push_back(DataSpace(wc->GetShape()->DataSpaceOrder.at(space_id)));
+  TRACK_ALLOC("OperationSpace data-space vector (empty)",
+              data_spaces_.size() * sizeof(DataSpace));
 }
 
 OperationSpace::OperationSpace() :
     OperationSpace(nullptr)
 { }
 
-OperationSpace::OperationSpace(const Workload* wc, const OperationPoint& low, const OperationPoint& high) :
+OperationSpace::OperationSpace(const Workload* wc, const OperationPoint& low, const OperationPoint& high,
+                               const std::vector<bool>* active) :
     workload_(wc)
 {
   // Note: high *must* be inclusive. Projecting an exclusive high operation-point into
   // a data-space may not result in the exclusive high point in that data-space.
+  bool is_builtin_cnn = wc->GetShape()->Variant == Shape::Builtin::CNNLayer;
   for (unsigned space_id = 0; space_id < wc->GetShape()->NumDataSpaces; space_id++)
   {
+    // Inactive data spaces stay empty: all the downstream set algebra
+    // degenerates to cheap no-ops on them.
+    if (active != nullptr && !active->at(space_id))
+    {
+      data_spaces_.push_back(DataSpace(wc->GetShape()->DataSpaceOrder.at(space_id)));
+      continue;
+    }
+
     Point space_low(workload_->GetShape()->DataSpaceOrder.at(space_id));
     Point space_high(workload_->GetShape()->DataSpaceOrder.at(space_id));
 
-    ProjectLowHigh(space_id, workload_, low, high, space_low, space_high);
+    if (is_builtin_cnn)
+      ProjectLowHighCNN(space_id, workload_, low, high, space_low, space_high);
+    else
+      ProjectLowHigh(space_id, workload_, low, high, space_low, space_high);
 
     // Increment the high points by 1 because the AAHR constructor wants
     // an exclusive max point.
     space_high.IncrementAllDimensions();
     data_spaces_.push_back(DataSpace(wc->GetShape()->DataSpaceOrder.at(space_id), space_low, space_high));
   }
+  TRACK_ALLOC("OperationSpace data-space vector (corner)",
+              data_spaces_.size() * sizeof(DataSpace));
 }
 
 void OperationSpace::ProjectLowHigh(Shape::DataSpaceID d,
@@ -71,6 +182,31 @@ void OperationSpace::ProjectLowHigh(Shape::DataSpaceID d,
                                     Point& data_space_low,
                                     Point& data_space_high)
 {
+  // Fast path: same coefficient table as Project(). min/max per product
+  // instead of a sign branch, matching the generic code's handling of
+  // negative coefficients.
+  if (wc->HasProjectionTables())
+  {
+    auto& table = wc->ProjectionTable(d);
+    unsigned num_dims = wc->GetShape()->NumDimensions;
+    for (unsigned data_space_dim = 0; data_space_dim < table.size(); data_space_dim++)
+    {
+      auto& row = table[data_space_dim];
+      Coordinate low = 0;
+      Coordinate high = 0;
+      for (unsigned dim = 0; dim < num_dims; dim++)
+      {
+        Coordinate a = row[dim] * problem_low[dim];
+        Coordinate b = row[dim] * problem_high[dim];
+        low += std::min(a, b);
+        high += std::max(a, b);
+      }
+      data_space_low[data_space_dim] = low;
+      data_space_high[data_space_dim] = high;
+    }
+    return;
+  }
+
   for (unsigned data_space_dim = 0; data_space_dim < wc->GetShape()->DataSpaceOrder.at(d); data_space_dim++)
   {
     data_space_low[data_space_dim] = 0;
@@ -110,14 +246,30 @@ Point OperationSpace::Project(Shape::DataSpaceID d,
 {
   Point data_space_point(wc->GetShape()->DataSpaceOrder.at(d));
 
+  // Fast path: dense integer coefficient table derived at workload load
+  // (coefficients pre-folded), reducing the projection to a tight
+  // matrix-vector product with no per-term branch or coefficient lookup.
+  if (wc->HasProjectionTables())
+  {
+    auto& table = wc->ProjectionTable(d);
+    unsigned num_dims = wc->GetShape()->NumDimensions;
+    for (unsigned data_space_dim = 0; data_space_dim < table.size(); data_space_dim++)
+    {
+      auto& row = table[data_space_dim];
+      Coordinate x = 0;
+      for (unsigned dim = 0; dim < num_dims; dim++)
+        x += row[dim] * problem_point[dim];
+      data_space_point[data_space_dim] = x;
+    }
+    return data_space_point;
+  }
+
   for (unsigned data_space_dim = 0; data_space_dim < wc->GetShape()->DataSpaceOrder.at(d); data_space_dim++)
   {
     data_space_point[data_space_dim] = 0;
     for (auto& term : wc->GetShape()->Projections.at(d).at(data_space_dim))
     {
       Coordinate x = problem_point[term.second];
-      // FIXME: somehow "compile" the coefficients down for a given
-      // workload config so that we avoid the branch and lookup below.
       if (term.first != wc->GetShape()->NumCoefficients)
         data_space_point[data_space_dim] += (x * wc->GetCoefficient(term.first));
       else
@@ -139,6 +291,11 @@ DataSpace& OperationSpace::GetDataSpace(Shape::DataSpaceID pv)
   return data_spaces_.at(pv);
 }
 
+const DataSpace& OperationSpace::GetDataSpace(Shape::DataSpaceID pv) const
+{
+  return data_spaces_.at(pv);
+}
+
 
 OperationSpace& OperationSpace::operator += (const OperationSpace& s)
 {
@@ -150,8 +307,20 @@ OperationSpace& OperationSpace::operator += (const OperationSpace& s)
 
 OperationSpace& OperationSpace::operator += (const OperationPoint& p)
 {
-  for (unsigned i = 0; i < data_spaces_.size(); i++)
-    data_spaces_.at(i) += Project(i, workload_, p);
+  if (workload_->GetShape()->Variant == Shape::Builtin::CNNLayer)
+  {
+    for (unsigned i = 0; i < data_spaces_.size(); i++)
+    {
+      Point projected(workload_->GetShape()->DataSpaceOrder.at(i));
+      ProjectCNN(i, workload_, p, projected);
+      data_spaces_.at(i) += projected;
+    }
+  }
+  else
+  {
+    for (unsigned i = 0; i < data_spaces_.size(); i++)
+      data_spaces_.at(i) += Project(i, workload_, p);
+  }
 
   return (*this);
 }
@@ -174,6 +343,32 @@ OperationSpace OperationSpace::operator - (const OperationSpace& p)
   return retval;
 }
 
+// Closed-form equivalent of ((*this) - prev).GetSizes(), including the same
+// gradient side-effects on our data spaces, but without materializing the
+// delta operation space.
+PerDataSpace<std::size_t> OperationSpace::GetDeltaSizes(const OperationSpace& prev)
+{
+  PerDataSpace<std::size_t> retval;
+
+  for (unsigned i = 0; i < data_spaces_.size(); i++)
+    retval.at(i) = data_spaces_.at(i).DeltaSize(prev.data_spaces_.at(i));
+
+  return retval;
+}
+
+// Bounds-only variant for the coarse screening fidelity: pure interval
+// arithmetic on the data-space extents, with no gradient side-effects
+// (see AxisAlignedHyperRectangle::BoundsOnlyDeltaSize for the contract).
+PerDataSpace<std::size_t> OperationSpace::GetBoundsOnlyDeltaSizes(const OperationSpace& prev) const
+{
+  PerDataSpace<std::size_t> retval;
+
+  for (unsigned i = 0; i < data_spaces_.size(); i++)
+    retval.at(i) = data_spaces_.at(i).BoundsOnlyDeltaSize(prev.data_spaces_.at(i));
+
+  return retval;
+}
+
 PerDataSpace<std::size_t> OperationSpace::GetSizes() const
 {
   PerDataSpace<std::size_t> retval;
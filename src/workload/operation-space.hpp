@@ -71,8 +71,13 @@ class OperationSpace
  public:
   OperationSpace();
   OperationSpace(const Workload* wc);
+  // active (optional) restricts the corner projections to a subset of the
+  // data spaces; inactive ones are left as empty point sets. Used by the
+  // per-dataspace parallel nest analysis, where each helper thread only
+  // consumes its own data space's results.
   OperationSpace(const Workload* wc, const OperationPoint& low,
-                 const OperationPoint& high);
+                 const OperationPoint& high,
+                 const std::vector<bool>* active = nullptr);
 
   void Reset();
   OperationSpace& operator+=(const OperationSpace& s);
@@ -80,6 +85,9 @@ class OperationSpace
   OperationSpace& ExtrudeAdd(const OperationSpace& s);
   OperationSpace operator-(const OperationSpace& p);
   DataSpace& GetDataSpace(Shape::DataSpaceID pv);
+  const DataSpace& GetDataSpace(Shape::DataSpaceID pv) const;
+  PerDataSpace<std::size_t> GetDeltaSizes(const OperationSpace& prev);
+  PerDataSpace<std::size_t> GetBoundsOnlyDeltaSizes(const OperationSpace& prev) const;
   PerDataSpace<std::size_t> GetSizes() const;
   std::size_t GetSize(const int t) const;
   bool IsEmpty(const int t) const;
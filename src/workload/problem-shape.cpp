@@ -38,6 +38,10 @@ namespace problem
 
 void Shape::Parse(config::CompoundConfigNode shape)
 {
+  // A shape parsed from a config description is never one of the
+  // built-in variants, even if it happens to be structurally identical.
+  Variant = Builtin::None;
+
   // Not sure what to do with the name, since we only ever
   // parse one shape per invocation.
   std::string name = "";
@@ -62,6 +66,18 @@ void Shape::Parse(config::CompoundConfigNode shape)
     NumDimensions++;
   }
 
+  // The point-set implementation fixes its rank bound at compile time so
+  // that the per-dimension loops unroll. Validate the loaded shape against
+  // that bound here, once, instead of relying on asserts deep inside the
+  // point-set code.
+  if (NumDimensions > Point::MaxOrder)
+  {
+    std::cerr << "ERROR: problem shape has " << NumDimensions << " dimensions, but this "
+              << "build supports a maximum of " << Point::MaxOrder << ". Rebuild with a "
+              << "larger -DTIMELOOP_POINT_SET_MAX_ORDER." << std::endl;
+    exit(1);
+  }
+
   // Coefficients (optional).
   NumCoefficients = 0;
   if (shape.exists("coefficients"))
@@ -167,4 +183,77 @@ void Shape::Parse(config::CompoundConfigNode shape)
   }
 }
 
+// Compile-time shape registry. Each built-in is equivalent to the YAML
+// description of the same name under problem-shapes/, but is constructed
+// without touching the filesystem and tags the shape with its Variant so
+// projection code can specialize on it. The dimension, coefficient and
+// dataspace ID assignments here are mirrored by the constants in
+// operation-space.cpp -- keep them in sync.
+bool Shape::InitBuiltin(const std::string& name)
+{
+  if (name != "cnn-layer" && name != "CNN-Layer")
+  {
+    return false;
+  }
+
+  *this = Shape();
+
+  const std::vector<std::string> dim_names = { "R", "S", "P", "Q", "C", "K", "N" };
+  NumDimensions = 0;
+  for (auto& dim_name: dim_names)
+  {
+    DimensionIDToName[NumDimensions] = dim_name;
+    DimensionNameToID[dim_name] = NumDimensions;
+    NumDimensions++;
+  }
+  assert(NumDimensions <= Point::MaxOrder);
+
+  const std::vector<std::string> coefficient_names =
+    { "Wstride", "Hstride", "Wdilation", "Hdilation" };
+  NumCoefficients = 0;
+  for (auto& coefficient_name: coefficient_names)
+  {
+    CoefficientIDToName[NumCoefficients] = coefficient_name;
+    CoefficientNameToID[coefficient_name] = NumCoefficients;
+    DefaultCoefficients[NumCoefficients] = 1;
+    NumCoefficients++;
+  }
+
+  auto dim = [this](const char* dim_name)
+  {
+    return DimensionNameToID.at(dim_name);
+  };
+  auto term = [this, &dim](const char* dim_name, const char* coeff_name = nullptr)
+  {
+    return ProjectionTerm(coeff_name ? CoefficientNameToID.at(coeff_name)
+                                     : NumCoefficients,
+                          dim(dim_name));
+  };
+
+  NumDataSpaces = 0;
+  auto add_data_space = [this](const char* ds_name, bool read_write,
+                               const Projection& projection)
+  {
+    DataSpaceIDToName[NumDataSpaces] = ds_name;
+    DataSpaceNameToID[ds_name] = NumDataSpaces;
+    IsReadWriteDataSpace[NumDataSpaces] = read_write;
+    DataSpaceOrder[NumDataSpaces] = projection.size();
+    Projections.push_back(projection);
+    NumDataSpaces++;
+  };
+
+  add_data_space("Weights", false,
+                 {{ term("C") }, { term("K") }, { term("R") }, { term("S") }});
+  add_data_space("Inputs", false,
+                 {{ term("N") },
+                  { term("C") },
+                  { term("R", "Wdilation"), term("P", "Wstride") },
+                  { term("S", "Hdilation"), term("Q", "Hstride") }});
+  add_data_space("Outputs", true,
+                 {{ term("N") }, { term("K") }, { term("Q") }, { term("P") }});
+
+  Variant = Builtin::CNNLayer;
+  return true;
+}
+
 }  // namespace problem
@@ -72,8 +72,25 @@ class Shape
 
   std::vector<Projection> Projections;
 
- public: 
-  void Parse(config::CompoundConfigNode config); 
+  // Compile-time registered shape variants. Shapes parsed from YAML are
+  // always None; selecting a built-in by name tags the shape so that hot
+  // projection code (see operation-space.cpp) can dispatch to a
+  // specialized straight-line implementation instead of walking the
+  // per-term projection expression lists above.
+  enum class Builtin
+  {
+    None,
+    CNNLayer
+  };
+  Builtin Variant = Builtin::None;
+
+ public:
+  void Parse(config::CompoundConfigNode config);
+
+  // Populate this shape from the compile-time registry. Returns false if
+  // no built-in shape matches the given name, in which case the caller
+  // should fall back to the YAML shape-file search path.
+  bool InitBuiltin(const std::string& name);
 };
 
 } // namespace problem
@@ -0,0 +1,106 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iomanip>
+#include <sstream>
+
+#include "workload-registry.hpp"
+
+namespace problem
+{
+
+std::string WorkloadRegistry::CanonicalKey(const Workload& workload)
+{
+  auto shape = workload.GetShape();
+
+  // Walk the shape's dimensions, coefficients and data spaces in ID
+  // order, so that the key is independent of how the workload's maps
+  // were populated. Densities print at full precision so that shapes
+  // differing only in density never alias.
+  std::ostringstream key;
+  key << std::setprecision(17);
+
+  key << "bounds:";
+  for (unsigned i = 0; i < unsigned(shape->NumDimensions); i++)
+    key << " " << workload.GetBound(i);
+
+  key << " coefficients:";
+  for (unsigned i = 0; i < unsigned(shape->NumCoefficients); i++)
+    key << " " << workload.GetCoefficient(i);
+
+  key << " densities:";
+  for (unsigned i = 0; i < unsigned(shape->NumDataSpaces); i++)
+    key << " " << workload.GetDensity(i);
+
+  return key.str();
+}
+
+std::shared_ptr<const Workload> WorkloadRegistry::Intern(const Workload& workload, bool* first)
+{
+  auto key = CanonicalKey(workload);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = unique_.find(key);
+  if (it != unique_.end())
+  {
+    if (first != nullptr)
+      *first = false;
+    return it->second;
+  }
+
+  auto shared = std::make_shared<const Workload>(workload);
+  unique_[key] = shared;
+  if (first != nullptr)
+    *first = true;
+  return shared;
+}
+
+std::shared_ptr<const Workload> WorkloadRegistry::Find(const Workload& workload) const
+{
+  return Find(CanonicalKey(workload));
+}
+
+std::shared_ptr<const Workload> WorkloadRegistry::Find(const std::string& canonical_key) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = unique_.find(canonical_key);
+  return (it != unique_.end()) ? it->second : nullptr;
+}
+
+std::size_t WorkloadRegistry::NumUnique() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return unique_.size();
+}
+
+WorkloadRegistry& GetWorkloadRegistry()
+{
+  static WorkloadRegistry registry;
+  return registry;
+}
+
+} // namespace problem
@@ -0,0 +1,80 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "workload.hpp"
+
+namespace problem
+{
+
+// ======================================== //
+//             Workload Registry            //
+// ======================================== //
+// Networks repeat layer shapes heavily (e.g., the residual blocks of a
+// ResNet), and two workloads with identical bounds, coefficients and
+// densities span identical mapspaces and have identical optimal
+// mappings. The registry canonicalizes workloads by those fields and
+// maps duplicates to a single shared instance, so a batch consumer can
+// map each unique shape once and replicate the result, and scripts can
+// query how a set of layers collapses into unique shapes.
+
+class WorkloadRegistry
+{
+ public:
+  // The canonical textual key of a workload: its bounds, coefficients
+  // and densities listed in shape order. Two workloads have the same
+  // key iff they are interchangeable for mapping purposes.
+  static std::string CanonicalKey(const Workload& workload);
+
+  // Return the shared instance holding this workload's canonical shape,
+  // registering a copy of the argument on first sight. If first is
+  // non-null it is set to whether this call created the instance.
+  std::shared_ptr<const Workload> Intern(const Workload& workload, bool* first = nullptr);
+
+  // Query API: the shared instance for an already-interned shape, or
+  // null if no matching workload has been interned.
+  std::shared_ptr<const Workload> Find(const Workload& workload) const;
+  std::shared_ptr<const Workload> Find(const std::string& canonical_key) const;
+
+  // Number of unique shapes interned so far.
+  std::size_t NumUnique() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<const Workload>> unique_;
+};
+
+// Global registry instance, shared by the applications (cf. GetShape()).
+WorkloadRegistry& GetWorkloadRegistry();
+
+} // namespace problem
@@ -136,15 +136,23 @@ void ParseWorkload(config::CompoundConfigNode config, Workload& workload)
   if (!config.exists("shape"))
   {
     std::cerr << "WARNING: found neither a problem shape description nor a string corresponding to a to a pre-existing shape description. Assuming shape: cnn-layer." << std::endl;
-    config::CompoundConfig shape_config(ShapeFileName("cnn-layer").c_str());
-    auto shape = shape_config.getRoot().lookup("shape");
-    shape_.Parse(shape);    
+    assert(shape_.InitBuiltin("cnn-layer"));
+    std::cerr << "MESSAGE: using built-in problem shape: CNN-Layer." << std::endl;
   }
   else if (config.lookupValue("shape", shape_name))
-  {    
-    config::CompoundConfig shape_config(ShapeFileName(shape_name).c_str());
-    auto shape = shape_config.getRoot().lookup("shape");
-    shape_.Parse(shape);    
+  {
+    // Shape names are checked against the compile-time registry first;
+    // only unregistered names hit the YAML shape-file search path.
+    if (shape_.InitBuiltin(shape_name))
+    {
+      std::cerr << "MESSAGE: using built-in problem shape: " << shape_name << std::endl;
+    }
+    else
+    {
+      config::CompoundConfig shape_config(ShapeFileName(shape_name).c_str());
+      auto shape = shape_config.getRoot().lookup("shape");
+      shape_.Parse(shape);
+    }
   }
   else
   {
@@ -152,8 +160,17 @@ void ParseWorkload(config::CompoundConfigNode config, Workload& workload)
     shape_.Parse(shape);
   }
 
-  // Bounds may be specified directly (backwards-compat) or under a subkey.
-  if (config.exists("instance"))
+  // Bounds may be specified directly (backwards-compat), under a subkey,
+  // or as a batch list under "instances". In the batch case the first
+  // entry seeds this workload; applications with batch support parse the
+  // remaining entries themselves via ParseWorkloadInstance().
+  if (config.exists("instances"))
+  {
+    auto instances = config.lookup("instances");
+    assert(instances.getLength() > 0);
+    ParseWorkloadInstance(instances[0], workload);
+  }
+  else if (config.exists("instance"))
   {
     auto bounds = config.lookup("instance");
     ParseWorkloadInstance(bounds, workload);
@@ -199,6 +216,8 @@ void ParseWorkloadInstance(config::CompoundConfigNode config, Workload& workload
       densities[i] = 1.0;
   }
   workload.SetDensities(densities);
+
+  workload.DeriveProjectionTables();
 }
 
 } // namespace problem
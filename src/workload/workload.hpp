@@ -70,6 +70,16 @@ class Workload
   Coefficients coefficients_;
   Densities densities_;
 
+  // Flattened integer projection tables, derived once per workload from
+  // the shape's projection expressions with this workload's coefficients
+  // folded in: projection_tables_[d][ds_dim][prob_dim] holds the summed
+  // coefficient of problem dimension prob_dim in dimension ds_dim of
+  // data space d. Point projection then becomes a dense matrix-vector
+  // product (see OperationSpace::Project) instead of a walk over
+  // per-term expression lists. Not serialized; deserialized workloads
+  // fall back to the expression walk until rederived.
+  std::vector<std::vector<std::vector<int>>> projection_tables_;
+
  public:
   Workload() {}
 
@@ -109,6 +119,38 @@ class Workload
     densities_ = densities;
   }
 
+  void DeriveProjectionTables()
+  {
+    auto shape = GetShape();
+    projection_tables_.clear();
+    projection_tables_.resize(shape->NumDataSpaces);
+    for (unsigned d = 0; d < shape->NumDataSpaces; d++)
+    {
+      auto& table = projection_tables_.at(d);
+      table.resize(shape->DataSpaceOrder.at(d),
+                   std::vector<int>(shape->NumDimensions, 0));
+      for (unsigned ds_dim = 0; ds_dim < shape->DataSpaceOrder.at(d); ds_dim++)
+      {
+        for (auto& term : shape->Projections.at(d).at(ds_dim))
+        {
+          int coeff = (term.first != shape->NumCoefficients) ?
+            GetCoefficient(term.first) : 1;
+          table.at(ds_dim).at(term.second) += coeff;
+        }
+      }
+    }
+  }
+
+  bool HasProjectionTables() const
+  {
+    return !projection_tables_.empty();
+  }
+
+  const std::vector<std::vector<int>>& ProjectionTable(Shape::DataSpaceID d) const
+  {
+    return projection_tables_.at(d);
+  }
+
  private:
   // Serialization
   friend class boost::serialization::access;
@@ -0,0 +1,252 @@
+#! /usr/bin/env python3
+
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# End-to-end performance regression harness. Companion to test_changes.py,
+# which guards *what* the mapper produces; this file guards *how fast* it
+# produces it. Each test runs timeloop-mapper single-threaded with the
+# exhaustive search algorithm (deterministic, seed-free) for a fixed valid-
+# mapping budget over a pinned (arch config, CNN layer) pair, records wall
+# time, throughput and -- on --timers builds -- per-phase evaluation cycles
+# into a machine-readable baseline, and diffs later runs against it with a
+# tolerance.
+#
+#   ./tests/test_performance.py --regenerate-baseline   # record a baseline
+#   ./tests/test_performance.py                         # diff against it
+#
+# Baselines are machine-specific: regenerate them on the machine (and with
+# the build flags) you intend to compare on, and do not commit them.
+
+import argparse
+import inspect
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+import libconf
+
+this_file_path = os.path.abspath(inspect.getfile(inspect.currentframe()))
+root_dir = os.path.join(os.path.dirname(this_file_path), '..')
+
+sys.path.append(os.path.join(root_dir, 'scripts'))
+import timeloop
+import cnn_layers
+
+# Pinned (config, layer) pairs. layer indexes scripts/cnn_layers.py (the
+# same corpus as data/cnn/cnn-layers.cpp); None keeps the config's own
+# problem instance.
+test_suite = [
+        { 'name': 'sample',            'config': 'configs/mapper/sample.cfg', 'layer': None },
+        { 'name': 'sample_resnet7x7',  'config': 'configs/mapper/sample.cfg', 'layer': 5    },
+        { 'name': 'sample_alexnet_c1', 'config': 'configs/mapper/sample.cfg', 'layer': 38   },
+        ]
+
+
+def get_or_make_dir(test):
+    dirname = os.path.join(root_dir, 'tests', 'results', 'performance', test['name'])
+    subprocess.check_call(['mkdir', '-p', dirname])
+    return dirname
+
+
+def get_baseline_path(dirname):
+    return os.path.join(dirname, 'baseline.json')
+
+
+def prepare_config(test, dirname, budget):
+    """Copy the test's config into dirname, rewrite the workload bounds if a
+    layer is pinned, and force the deterministic single-threaded mapper
+    setup the measurements assume."""
+    src = os.path.join(root_dir, test['config'])
+    dst = os.path.join(dirname, os.path.basename(test['config']))
+
+    if test['layer'] is not None:
+        timeloop.rewrite_workload_bounds(src, dst, cnn_layers.cnn_layers[test['layer']])
+    else:
+        subprocess.check_call(['cp', src, dst])
+
+    with open(dst, 'r') as f:
+        config = libconf.load(f)
+
+    mapper = config['mapper']
+    mapper['algorithm'] = 'exhaustive'
+    mapper['num-threads'] = 1
+    mapper['search-size'] = budget
+    mapper['victory-condition'] = 0
+    mapper['timeout'] = 0
+    mapper['live-status'] = False
+    for key in ['search_size']:
+        if key in mapper:
+            del mapper[key]
+
+    with open(dst, 'w') as f:
+        libconf.dump(config, f)
+
+    return dst
+
+
+def parse_log(logfile_path):
+    """Pull the optional self-reported counters out of the mapper log:
+    per-phase evaluation cycles (--timers builds) and the nest-analysis
+    cache hit rate."""
+    phase_cycles = {}
+    nest_memo_hit_rate = None
+    with open(logfile_path, 'r') as f:
+        in_phases = False
+        for line in f:
+            if 'Evaluation cycles by phase' in line:
+                in_phases = True
+                continue
+            if in_phases:
+                m = re.match(r'^\s+(\S.*\S)\s+(\d+)\s*$', line)
+                if m:
+                    phase_cycles[m.group(1)] = int(m.group(2))
+                    continue
+                in_phases = False
+            m = re.search(r'Nest analysis cache: .* \(([\d.]+)% hit rate\)', line)
+            if m:
+                nest_memo_hit_rate = float(m.group(1))
+    return phase_cycles, nest_memo_hit_rate
+
+
+def run_test(test, budget, repeats):
+    """Run the pinned mapper configuration `repeats` times and keep the
+    fastest run (standard practice for wall-time measurements)."""
+    dirname = get_or_make_dir(test)
+    configfile_path = prepare_config(test, dirname, budget)
+    logfile_path = os.path.join(dirname, 'timeloop.log')
+    executable = os.path.join(root_dir, 'build', 'timeloop-mapper')
+
+    best = None
+    for _ in range(repeats):
+        start = time.monotonic()
+        with open(logfile_path, 'w') as outfile:
+            status = subprocess.call([executable, configfile_path],
+                                     stdout=outfile, stderr=outfile, cwd=dirname)
+        elapsed = time.monotonic() - start
+        if status != 0:
+            subprocess.check_call(['cat', logfile_path])
+            print('Did you remember to build timeloop and set up your environment properly?')
+            sys.exit(1)
+        if best is None or elapsed < best:
+            best = elapsed
+
+    phase_cycles, nest_memo_hit_rate = parse_log(logfile_path)
+    return {
+        'budget': budget,
+        'wall_time_sec': best,
+        'valid_maps_per_sec': budget / best,
+        'phase_cycles': phase_cycles,
+        'nest_memo_hit_rate': nest_memo_hit_rate,
+    }
+
+
+def regenerate_baseline(budget, repeats):
+    print('Overwriting baseline files in tests/results/performance/ ...')
+    for test in test_suite:
+        dirname = get_or_make_dir(test)
+        print('Measuring %s ...' % test['name'])
+        result = run_test(test, budget, repeats)
+        baseline_path = get_baseline_path(dirname)
+        with open(baseline_path, 'w') as f:
+            json.dump(result, f, indent=2, sort_keys=True)
+            f.write('\n')
+        print('  wall %.2fs | %.1f valid maps/sec | written to %s'
+              % (result['wall_time_sec'], result['valid_maps_per_sec'],
+                 os.path.relpath(baseline_path)))
+    print('Done writing baseline files.')
+
+
+def run_tests(budget, repeats, tolerance):
+    error_suggestion = ('\n\nNo baseline found. Run ./%s --regenerate-baseline '
+                        'on this machine first.\n\n' % os.path.relpath(this_file_path))
+    print('Comparing against baselines in tests/results/performance/ '
+          '(tolerance %.0f%%) ...' % (tolerance * 100))
+    success = True
+    for test in test_suite:
+        dirname = get_or_make_dir(test)
+        baseline_path = get_baseline_path(dirname)
+        assert os.path.exists(baseline_path), error_suggestion
+        with open(baseline_path, 'r') as f:
+            baseline = json.load(f)
+        if baseline['budget'] != budget:
+            print('%s: SKIPPED (baseline budget %d != requested %d; regenerate)'
+                  % (test['name'], baseline['budget'], budget))
+            continue
+
+        result = run_test(test, budget, repeats)
+
+        ratio = result['wall_time_sec'] / baseline['wall_time_sec']
+        verdict = 'OK' if ratio <= 1.0 + tolerance else 'REGRESSION'
+        if verdict == 'REGRESSION':
+            success = False
+        print('%s: %s | wall %.2fs vs %.2fs baseline (%+.0f%%) | %.1f vs %.1f valid maps/sec'
+              % (test['name'], verdict,
+                 result['wall_time_sec'], baseline['wall_time_sec'],
+                 (ratio - 1.0) * 100,
+                 result['valid_maps_per_sec'], baseline['valid_maps_per_sec']))
+
+        # Per-phase cycles are reported but only informational: they need a
+        # --timers build and are noisier than end-to-end wall time.
+        for phase in sorted(set(result['phase_cycles']) & set(baseline['phase_cycles'])):
+            base_cycles = baseline['phase_cycles'][phase]
+            cur_cycles = result['phase_cycles'][phase]
+            if base_cycles > 0 and cur_cycles > base_cycles * (1.0 + tolerance):
+                print('  note: phase "%s" cycles up %.0f%% (%d -> %d)'
+                      % (phase, (cur_cycles / base_cycles - 1.0) * 100,
+                         base_cycles, cur_cycles))
+
+    if success:
+        print('All performance tests within tolerance.')
+    else:
+        print('PERFORMANCE REGRESSION DETECTED. If the slowdown is intentional, '
+              'rerun with --regenerate-baseline.')
+        sys.exit(1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Timeloop performance regression harness.')
+    parser.add_argument('--regenerate-baseline', action='store_true',
+                        help='measure and store new baselines instead of diffing')
+    parser.add_argument('--budget', type=int, default=1000,
+                        help='valid-mapping search budget per test (default 1000)')
+    parser.add_argument('--repeats', type=int, default=3,
+                        help='runs per measurement; the fastest is kept (default 3)')
+    parser.add_argument('--tolerance', type=float, default=0.25,
+                        help='allowed fractional wall-time regression (default 0.25)')
+    args = parser.parse_args()
+
+    if args.regenerate_baseline:
+        regenerate_baseline(args.budget, args.repeats)
+    else:
+        run_tests(args.budget, args.repeats, args.tolerance)
+
+
+if __name__ == '__main__':
+    main()